@@ -0,0 +1,421 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Synthetic large-tree scenarios for the core element types, run headless.
+ * Each scenario builds its tree untimed, then times one operation repeated
+ * size times. The reported figure is the median of the repeats, printed as
+ * JSON. With --baseline the results are compared against an earlier run and
+ * the exit status is non-zero when a scenario got slower than --threshold. */
+
+typedef struct benchScenario
+{
+  const char* name;
+  int size;
+  double (*run)(guihckContext* ctx, int size); /* nanoseconds spent in the timed part */
+} benchScenario;
+
+typedef struct benchResult
+{
+  const char* name;
+  int size;
+  double nsPerOp;
+} benchResult;
+
+static double now();
+static int compareDoubles(const void* a, const void* b);
+static guihckElementTypeId typeId(guihckContext* ctx, const char* name);
+static SCM bindTo(guihckElementId elementId, const char* property);
+static double benchCreateFlat(guihckContext* ctx, int size);
+static double benchCreateDeep(guihckContext* ctx, int size);
+static double benchPropertySet(guihckContext* ctx, int size);
+static double benchPropertyGet(guihckContext* ctx, int size);
+static double benchBindChain(guihckContext* ctx, int size);
+static double benchBindFanOut(guihckContext* ctx, int size);
+static double benchFindElement(guihckContext* ctx, int size);
+static double benchHitTest(guihckContext* ctx, int size);
+static double benchRenderOrder(guihckContext* ctx, int size);
+static double benchRemoveSubtree(guihckContext* ctx, int size);
+static double benchUpdateDirty(guihckContext* ctx, int size);
+static bool readBaseline(const char* path, const char* name, double* nsPerOp);
+
+static const benchScenario scenarios[] = {
+  {"create-flat", 10000, benchCreateFlat},
+  {"create-deep", 1000, benchCreateDeep},
+  {"property-set", 100000, benchPropertySet},
+  {"property-get", 100000, benchPropertyGet},
+  {"bind-chain", 1000, benchBindChain},
+  {"bind-fan-out", 1000, benchBindFanOut},
+  {"find-element", 1000, benchFindElement},
+  {"hit-test", 1000, benchHitTest},
+  {"render-order", 1000, benchRenderOrder},
+  {"remove-subtree", 10000, benchRemoveSubtree},
+  {"update-100-of-10000", 100, benchUpdateDirty}
+};
+
+#define SCENARIO_COUNT (sizeof(scenarios) / sizeof(scenarios[0]))
+#define UPDATE_ELEMENTS 10000
+#define UPDATE_DIRTY 100
+
+int main(int argc, char** argv)
+{
+  const char* outputPath = NULL;
+  const char* baselinePath = NULL;
+  double threshold = 10.0;
+  int repeats = 5;
+
+  int i;
+  for(i = 1; i < argc; ++i)
+  {
+    if(strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+      outputPath = argv[++i];
+    else if(strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)
+      baselinePath = argv[++i];
+    else if(strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+      threshold = atof(argv[++i]);
+    else if(strcmp(argv[i], "--repeats") == 0 && i + 1 < argc)
+      repeats = atoi(argv[++i]);
+    else
+    {
+      fprintf(stderr, "Usage: guihck-bench [--output file] [--baseline file] [--threshold percent] [--repeats n]\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  if(repeats <= 0)
+    repeats = 1;
+
+  guihckInit();
+  guihckTypeRegistry* types = guihckTypeRegistryNew();
+  guihckElementsRegisterAllTypes(types);
+
+  benchResult results[SCENARIO_COUNT];
+  double* samples = calloc(repeats, sizeof(double));
+  unsigned int s;
+  for(s = 0; s < SCENARIO_COUNT; ++s)
+  {
+    int r;
+    for(r = 0; r < repeats; ++r)
+    {
+      guihckContext* ctx = guihckContextNewWithTypes(types);
+      samples[r] = scenarios[s].run(ctx, scenarios[s].size) / scenarios[s].size;
+      guihckContextFree(ctx);
+    }
+
+    qsort(samples, repeats, sizeof(double), compareDoubles);
+    results[s].name = scenarios[s].name;
+    results[s].size = scenarios[s].size;
+    results[s].nsPerOp = samples[repeats / 2];
+  }
+  free(samples);
+  guihckTypeRegistryFree(types);
+
+  FILE* output = outputPath ? fopen(outputPath, "w") : stdout;
+  if(!output)
+  {
+    fprintf(stderr, "Could not open %s\n", outputPath);
+    return EXIT_FAILURE;
+  }
+
+  fprintf(output, "{\n  \"repeats\": %d,\n  \"benchmarks\": [\n", repeats);
+  for(s = 0; s < SCENARIO_COUNT; ++s)
+  {
+    fprintf(output, "    {\"name\": \"%s\", \"size\": %d, \"ns_per_op\": %.1f}%s\n",
+            results[s].name, results[s].size, results[s].nsPerOp, s + 1 < SCENARIO_COUNT ? "," : "");
+  }
+  fprintf(output, "  ]\n}\n");
+
+  if(output != stdout)
+    fclose(output);
+
+  int status = EXIT_SUCCESS;
+  if(baselinePath)
+  {
+    for(s = 0; s < SCENARIO_COUNT; ++s)
+    {
+      double baseline;
+      if(!readBaseline(baselinePath, results[s].name, &baseline) || baseline <= 0)
+      {
+        fprintf(stderr, "%-22s %12.1f ns  (no baseline)\n", results[s].name, results[s].nsPerOp);
+        continue;
+      }
+
+      double change = (results[s].nsPerOp - baseline) / baseline * 100.0;
+      bool regressed = change > threshold;
+      fprintf(stderr, "%-22s %12.1f ns  %+7.1f%%%s\n", results[s].name, results[s].nsPerOp, change, regressed ? "  REGRESSION" : "");
+      if(regressed)
+        status = EXIT_FAILURE;
+    }
+  }
+
+  return status;
+}
+
+double now()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int compareDoubles(const void* a, const void* b)
+{
+  double x = *(const double*) a;
+  double y = *(const double*) b;
+  return (x > y) - (x < y);
+}
+
+guihckElementTypeId typeId(guihckContext* ctx, const char* name)
+{
+  return guihckTypeRegistryGetType(guihckContextGetTypes(ctx), name);
+}
+
+SCM bindTo(guihckElementId elementId, const char* property)
+{
+  /* (bind ((element . property)) identity) */
+  SCM bound = scm_list_1(scm_cons(scm_from_uint64(elementId), scm_from_utf8_symbol(property)));
+  SCM identity = scm_variable_ref(scm_c_lookup("identity"));
+  return scm_list_3(scm_from_utf8_symbol("bind"), bound, identity);
+}
+
+double benchCreateFlat(guihckContext* ctx, int size)
+{
+  guihckElementTypeId item = typeId(ctx, "item");
+  guihckElementId root = guihckContextGetRootElement(ctx);
+
+  double start = now();
+  int i;
+  for(i = 0; i < size; ++i)
+    guihckElementNew(ctx, item, root);
+  return now() - start;
+}
+
+double benchCreateDeep(guihckContext* ctx, int size)
+{
+  guihckElementTypeId item = typeId(ctx, "item");
+  guihckElementId parent = guihckContextGetRootElement(ctx);
+
+  double start = now();
+  int i;
+  for(i = 0; i < size; ++i)
+    parent = guihckElementNew(ctx, item, parent);
+  return now() - start;
+}
+
+double benchPropertySet(guihckContext* ctx, int size)
+{
+  guihckElementId id = guihckElementNew(ctx, typeId(ctx, "item"), guihckContextGetRootElement(ctx));
+
+  double start = now();
+  int i;
+  for(i = 0; i < size; ++i)
+    guihckElementProperty(ctx, id, "width", scm_from_int(i & 1023));
+  return now() - start;
+}
+
+double benchPropertyGet(guihckContext* ctx, int size)
+{
+  guihckElementId id = guihckElementNew(ctx, typeId(ctx, "item"), guihckContextGetRootElement(ctx));
+  guihckElementProperty(ctx, id, "width", scm_from_int(1));
+
+  double start = now();
+  int i;
+  for(i = 0; i < size; ++i)
+    guihckElementGetProperty(ctx, id, "width");
+  return now() - start;
+}
+
+double benchBindChain(guihckContext* ctx, int size)
+{
+  /* Every element is bound to the previous one, one set walks the whole chain */
+  guihckElementTypeId item = typeId(ctx, "item");
+  guihckElementId root = guihckContextGetRootElement(ctx);
+  guihckElementId first = guihckElementNew(ctx, item, root);
+  guihckElementProperty(ctx, first, "width", scm_from_int(0));
+
+  guihckElementId previous = first;
+  int i;
+  for(i = 1; i < size; ++i)
+  {
+    guihckElementId id = guihckElementNew(ctx, item, root);
+    guihckElementProperty(ctx, id, "width", bindTo(previous, "width"));
+    previous = id;
+  }
+
+  double start = now();
+  guihckElementProperty(ctx, first, "width", scm_from_int(1));
+  return now() - start;
+}
+
+double benchBindFanOut(guihckContext* ctx, int size)
+{
+  guihckElementTypeId item = typeId(ctx, "item");
+  guihckElementId root = guihckContextGetRootElement(ctx);
+  guihckElementId source = guihckElementNew(ctx, item, root);
+  guihckElementProperty(ctx, source, "width", scm_from_int(0));
+
+  int i;
+  for(i = 0; i < size; ++i)
+  {
+    guihckElementId id = guihckElementNew(ctx, item, root);
+    guihckElementProperty(ctx, id, "width", bindTo(source, "width"));
+  }
+
+  double start = now();
+  guihckElementProperty(ctx, source, "width", scm_from_int(1));
+  return now() - start;
+}
+
+double benchFindElement(guihckContext* ctx, int size)
+{
+  /* The searched id is the last one reached breadth-first from the root */
+  guihckElementTypeId item = typeId(ctx, "item");
+  guihckElementId root = guihckContextGetRootElement(ctx);
+  int i;
+  for(i = 0; i < size; ++i)
+  {
+    guihckElementId id = guihckElementNew(ctx, item, root);
+    char name[32];
+    snprintf(name, sizeof(name), "element-%d", i);
+    guihckElementProperty(ctx, id, "id", scm_from_utf8_symbol(name));
+  }
+
+  char last[32];
+  snprintf(last, sizeof(last), "element-%d", size - 1);
+
+  double start = now();
+  for(i = 0; i < size; ++i)
+  {
+    guihckStackPushElementById(ctx, last);
+    guihckStackPopElement(ctx);
+  }
+  return now() - start;
+}
+
+double benchHitTest(guihckContext* ctx, int size)
+{
+  /* size mouse areas on a grid of 10x10 cells, the pointer sweeps across them */
+  guihckElementTypeId mouseArea = typeId(ctx, "mouse-area");
+  guihckElementId root = guihckContextGetRootElement(ctx);
+  int columns = 32;
+  int i;
+  for(i = 0; i < size; ++i)
+  {
+    guihckElementId id = guihckElementNew(ctx, mouseArea, root);
+    guihckElementProperty(ctx, id, "x", scm_from_int((i % columns) * 10));
+    guihckElementProperty(ctx, id, "y", scm_from_int((i / columns) * 10));
+    guihckElementProperty(ctx, id, "width", scm_from_int(10));
+    guihckElementProperty(ctx, id, "height", scm_from_int(10));
+  }
+  guihckContextUpdate(ctx);
+
+  /* Overlapping hits are sorted by the render order, which the first render builds */
+  guihckContextRender(ctx);
+
+  float x = 0, y = 0;
+  double start = now();
+  for(i = 0; i < size; ++i)
+  {
+    float nx = ((i * 7) % columns) * 10 + 5;
+    float ny = ((i * 3) % (size / columns + 1)) * 10 + 5;
+    guihckContextMouseMove(ctx, x, y, nx, ny);
+    x = nx;
+    y = ny;
+  }
+  return now() - start;
+}
+
+double benchRenderOrder(guihckContext* ctx, int size)
+{
+  guihckElementTypeId item = typeId(ctx, "item");
+  guihckElementId root = guihckContextGetRootElement(ctx);
+  guihckElementId first = guihckElementNew(ctx, item, root);
+  int i;
+  for(i = 1; i < size; ++i)
+    guihckElementNew(ctx, item, root);
+  guihckContextRender(ctx);
+
+  /* Reordering a child invalidates the render order of the whole tree */
+  double start = now();
+  for(i = 0; i < size; ++i)
+  {
+    guihckElementProperty(ctx, first, "order", scm_from_int(i));
+    guihckContextRender(ctx);
+  }
+  return now() - start;
+}
+
+double benchRemoveSubtree(guihckContext* ctx, int size)
+{
+  /* A two level subtree, sqrt(size) children with sqrt(size) children each */
+  guihckElementTypeId item = typeId(ctx, "item");
+  guihckElementId subtree = guihckElementNew(ctx, item, guihckContextGetRootElement(ctx));
+  int width = 1;
+  while(width * width < size)
+    ++width;
+
+  int i, j;
+  for(i = 0; i < width; ++i)
+  {
+    guihckElementId child = guihckElementNew(ctx, item, subtree);
+    for(j = 1; j < width; ++j)
+      guihckElementNew(ctx, item, child);
+  }
+
+  double start = now();
+  guihckElementRemove(ctx, subtree);
+  return now() - start;
+}
+
+double benchUpdateDirty(guihckContext* ctx, int size)
+{
+  guihckElementTypeId item = typeId(ctx, "item");
+  guihckElementId root = guihckContextGetRootElement(ctx);
+  guihckElementId* ids = calloc(UPDATE_ELEMENTS, sizeof(guihckElementId));
+  int i, j;
+  for(i = 0; i < UPDATE_ELEMENTS; ++i)
+    ids[i] = guihckElementNew(ctx, item, root);
+  guihckContextUpdate(ctx);
+
+  double start = now();
+  for(i = 0; i < size; ++i)
+  {
+    for(j = 0; j < UPDATE_DIRTY; ++j)
+      guihckElementDirty(ctx, ids[(i * 31 + j * (UPDATE_ELEMENTS / UPDATE_DIRTY)) % UPDATE_ELEMENTS]);
+    guihckContextUpdate(ctx);
+  }
+  double elapsed = now() - start;
+
+  free(ids);
+  return elapsed;
+}
+
+bool readBaseline(const char* path, const char* name, double* nsPerOp)
+{
+  /* Only needs to read files written by this program */
+  FILE* file = fopen(path, "r");
+  if(!file)
+    return false;
+
+  char pattern[128];
+  snprintf(pattern, sizeof(pattern), "\"name\": \"%s\"", name);
+
+  bool found = false;
+  char line[512];
+  while(!found && fgets(line, sizeof(line), file))
+  {
+    const char* entry = strstr(line, pattern);
+    const char* value = entry ? strstr(entry, "\"ns_per_op\":") : NULL;
+    if(value)
+      found = sscanf(value, "\"ns_per_op\": %lf", nsPerOp) == 1;
+  }
+
+  fclose(file);
+  return found;
+}
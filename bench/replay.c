@@ -0,0 +1,192 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Replays a recording made with guihckContextRecordStart against a script,
+ * headless. The clock is the recorded one: every guihckContextTime call is
+ * repeated with its original value, so animations and timers see the same
+ * times as in the recorded session. Update and render calls are timed and
+ * reported as per-frame percentiles in microseconds, printed as JSON. A frame
+ * covers everything from the end of the previous render to the end of the
+ * next one, events included. */
+
+typedef struct replaySamples
+{
+  double* values;
+  size_t count;
+  size_t capacity;
+} replaySamples;
+
+static double now();
+static int compareDoubles(const void* a, const void* b);
+static void addSample(replaySamples* samples, double value);
+static double percentile(const replaySamples* samples, double p);
+static void printSamples(FILE* output, const char* name, replaySamples* samples, bool last);
+
+int main(int argc, char** argv)
+{
+  const char* outputPath = NULL;
+  const char* scriptPath = NULL;
+  const char* recordingPath = NULL;
+  int repeats = 1;
+
+  int i;
+  for(i = 1; i < argc; ++i)
+  {
+    if(strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+      outputPath = argv[++i];
+    else if(strcmp(argv[i], "--repeats") == 0 && i + 1 < argc)
+      repeats = atoi(argv[++i]);
+    else if(!scriptPath)
+      scriptPath = argv[i];
+    else if(!recordingPath)
+      recordingPath = argv[i];
+    else
+    {
+      scriptPath = NULL;
+      break;
+    }
+  }
+
+  if(!scriptPath || !recordingPath)
+  {
+    fprintf(stderr, "Usage: guihck-replay [--output file] [--repeats n] <scm file> <recording>\n");
+    return EXIT_FAILURE;
+  }
+
+  if(repeats <= 0)
+    repeats = 1;
+
+  guihckInit();
+  guihckTypeRegistry* types = guihckTypeRegistryNew();
+  guihckElementsRegisterAllTypes(types);
+
+  replaySamples update = {NULL, 0, 0};
+  replaySamples render = {NULL, 0, 0};
+  replaySamples frame = {NULL, 0, 0};
+  size_t events = 0;
+  int r;
+  for(r = 0; r < repeats; ++r)
+  {
+    guihckReplay* replay = guihckReplayOpen(recordingPath);
+    if(!replay)
+    {
+      fprintf(stderr, "Could not open %s\n", recordingPath);
+      return EXIT_FAILURE;
+    }
+
+    guihckContext* ctx = guihckContextNewWithTypes(types);
+    if(scm_is_eq(guihckContextExecuteScriptFile(ctx, scriptPath), SCM_UNDEFINED))
+    {
+      fprintf(stderr, "Could not run %s\n", scriptPath);
+      return EXIT_FAILURE;
+    }
+
+    double frameTime = 0;
+    guihckRecordType type;
+    do
+    {
+      double start = now();
+      type = guihckReplayStep(replay, ctx);
+      double elapsed = (now() - start) / 1e3;
+
+      frameTime += elapsed;
+      if(type == GUIHCK_RECORD_UPDATE)
+      {
+        addSample(&update, elapsed);
+      }
+      else if(type == GUIHCK_RECORD_RENDER)
+      {
+        addSample(&render, elapsed);
+        addSample(&frame, frameTime);
+        frameTime = 0;
+      }
+      else if(type != GUIHCK_RECORD_END)
+      {
+        events += 1;
+      }
+    }
+    while(type != GUIHCK_RECORD_END);
+
+    guihckContextFree(ctx);
+    guihckReplayClose(replay);
+  }
+  guihckTypeRegistryFree(types);
+
+  FILE* output = outputPath ? fopen(outputPath, "w") : stdout;
+  if(!output)
+  {
+    fprintf(stderr, "Could not open %s\n", outputPath);
+    return EXIT_FAILURE;
+  }
+
+  fprintf(output, "{\n  \"repeats\": %d,\n  \"frames\": %lu,\n  \"events\": %lu,\n",
+          repeats, (unsigned long) (frame.count / repeats), (unsigned long) (events / repeats));
+  printSamples(output, "update", &update, false);
+  printSamples(output, "render", &render, false);
+  printSamples(output, "frame", &frame, true);
+  fprintf(output, "}\n");
+
+  if(output != stdout)
+    fclose(output);
+
+  free(update.values);
+  free(render.values);
+  free(frame.values);
+
+  return EXIT_SUCCESS;
+}
+
+double now()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int compareDoubles(const void* a, const void* b)
+{
+  double x = *(const double*) a;
+  double y = *(const double*) b;
+  return (x > y) - (x < y);
+}
+
+void addSample(replaySamples* samples, double value)
+{
+  if(samples->count == samples->capacity)
+  {
+    samples->capacity = samples->capacity ? samples->capacity * 2 : 256;
+    samples->values = realloc(samples->values, samples->capacity * sizeof(double));
+  }
+  samples->values[samples->count++] = value;
+}
+
+double percentile(const replaySamples* samples, double p)
+{
+  /* Nearest rank on sorted samples */
+  if(samples->count == 0)
+    return 0;
+
+  size_t rank = (size_t) (p / 100.0 * samples->count + 0.5);
+  if(rank > 0)
+    rank -= 1;
+  if(rank >= samples->count)
+    rank = samples->count - 1;
+  return samples->values[rank];
+}
+
+void printSamples(FILE* output, const char* name, replaySamples* samples, bool last)
+{
+  if(samples->count > 0)
+    qsort(samples->values, samples->count, sizeof(double), compareDoubles);
+
+  fprintf(output, "  \"%s\": {\"p50_us\": %.1f, \"p90_us\": %.1f, \"p99_us\": %.1f, \"max_us\": %.1f}%s\n",
+          name, percentile(samples, 50), percentile(samples, 90), percentile(samples, 99),
+          samples->count > 0 ? samples->values[samples->count - 1] : 0.0, last ? "" : ",");
+}
@@ -0,0 +1,121 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Measures the cold start (guihckInit + first context) and the cost of each
+ * further context. Set GUIHCK_SCM_COMPILED_PATH to compare precompiled
+ * definitions against evaluating them from source. The last run compares
+ * building a tree from script against loading it from a snapshot, and
+ * spawning subtrees through constructors against a template. */
+
+static const char* tree =
+  "(define (half x) (/ x 2))"
+  "(define (row-of n)"
+  "  (if (= n 0) '()"
+  "    (cons (item (prop 'width 10) (prop 'height (bound '(this width) half))"
+  "                (item (alias 'label 'parent 'label)))"
+  "          (row-of (- n 1)))))"
+  "(create-elements! (apply item (prop 'label \"bench\") (row-of 500)))";
+
+static double now()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+int main(int argc, char** argv)
+{
+  int iterations = argc > 1 ? atoi(argv[1]) : 100;
+  if(iterations <= 0)
+    iterations = 100;
+
+  double start = now();
+  guihckInit();
+  double initialized = now();
+  guihckContext* ctx = guihckContextNew();
+  guihckElementsAddAllTypes(ctx);
+  double created = now();
+  guihckContextFree(ctx);
+
+  printf("guihckInit: %.3f ms\n", initialized - start);
+  printf("first context: %.3f ms\n", created - initialized);
+  printf("cold start: %.3f ms\n", created - start);
+
+  start = now();
+  int i;
+  for(i = 0; i < iterations; ++i)
+  {
+    ctx = guihckContextNew();
+    guihckElementsAddAllTypes(ctx);
+    guihckContextFree(ctx);
+  }
+  printf("warm context: %.3f ms (%d iterations)\n", (now() - start) / iterations, iterations);
+
+  guihckTypeRegistry* types = guihckTypeRegistryNew();
+  guihckElementsRegisterAllTypes(types);
+  start = now();
+  for(i = 0; i < iterations; ++i)
+  {
+    ctx = guihckContextNewWithTypes(types);
+    guihckContextFree(ctx);
+  }
+  printf("shared types context: %.3f ms (%d iterations)\n", (now() - start) / iterations, iterations);
+
+  char path[] = "/tmp/guihck-bench-snapshot-XXXXXX";
+  int fd = mkstemp(path);
+  if(fd < 0)
+    return EXIT_FAILURE;
+  close(fd);
+
+  double scriptTime = 0, snapshotTime = 0;
+  for(i = 0; i < iterations; ++i)
+  {
+    ctx = guihckContextNew();
+    guihckElementsAddAllTypes(ctx);
+    start = now();
+    guihckContextExecuteScript(ctx, tree);
+    scriptTime += now() - start;
+    if(i == 0 && !guihckContextSaveSnapshot(ctx, path))
+    {
+      fprintf(stderr, "Could not save the snapshot\n");
+      unlink(path);
+      return EXIT_FAILURE;
+    }
+    guihckContextFree(ctx);
+
+    ctx = guihckContextNew();
+    guihckElementsAddAllTypes(ctx);
+    guihckContextExecuteScript(ctx, "(define (half x) (/ x 2))");
+    start = now();
+    guihckContextLoadSnapshot(ctx, path);
+    snapshotTime += now() - start;
+    guihckContextFree(ctx);
+  }
+  unlink(path);
+  guihckTypeRegistryFree(types);
+
+  printf("tree from script: %.3f ms\n", scriptTime / iterations);
+  printf("tree from snapshot: %.3f ms\n", snapshotTime / iterations);
+
+  ctx = guihckContextNew();
+  guihckElementsAddAllTypes(ctx);
+  guihckContextExecuteScript(ctx, "(define (half x) (/ x 2))"
+                                  "(define (spawn n) (item (prop 'width n) (prop 'height (bound '(this width) half)) (item (alias 'label 'parent 'label))))"
+                                  "(define spawn-template (make-template (spawn 10)))");
+  start = now();
+  guihckContextExecuteScript(ctx, "(do ((i 0 (+ i 1))) ((= i 1000)) (create-elements! (spawn i)))");
+  printf("1000 subtrees from constructors: %.3f ms\n", now() - start);
+  start = now();
+  guihckContextExecuteScript(ctx, "(do ((i 0 (+ i 1))) ((= i 1000)) (instantiate-template! spawn-template (prop 'width i)))");
+  printf("1000 subtrees from a template: %.3f ms\n", now() - start);
+  guihckContextFree(ctx);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,35 @@
+# Code generators run on the build machine. A native build exports them to
+# guihckHostTools.cmake in its binary dir, cross builds import them from there
+# through GUIHCK_HOST_TOOLS instead of building them for the target.
+
+set(GUIHCK_HOST_TOOLS "" CACHE FILEPATH "guihckHostTools.cmake of a native guihck build, required when cross compiling")
+
+if(CMAKE_CROSSCOMPILING)
+  if(NOT GUIHCK_HOST_TOOLS)
+    message(FATAL_ERROR "Cross compiling guihck needs GUIHCK_HOST_TOOLS set to guihckHostTools.cmake from a native build")
+  endif()
+  include(${GUIHCK_HOST_TOOLS})
+endif()
+
+# guihck_add_host_tool(<name> <sources...>)
+# Defines the executable <name> usable in add_custom_command, built here for
+# native builds and imported from GUIHCK_HOST_TOOLS when cross compiling.
+function(guihck_add_host_tool name)
+  if(CMAKE_CROSSCOMPILING)
+    if(NOT TARGET ${name})
+      message(FATAL_ERROR "${GUIHCK_HOST_TOOLS} does not provide ${name}")
+    endif()
+  else()
+    add_executable(${name} ${ARGN})
+    set_property(GLOBAL APPEND PROPERTY GUIHCK_HOST_TOOL_TARGETS ${name})
+  endif()
+endfunction()
+
+# guihck_export_host_tools()
+# Writes the host tools defined so far for cross builds to import.
+function(guihck_export_host_tools)
+  get_property(tools GLOBAL PROPERTY GUIHCK_HOST_TOOL_TARGETS)
+  if(NOT CMAKE_CROSSCOMPILING AND tools)
+    export(TARGETS ${tools} FILE ${CMAKE_BINARY_DIR}/guihckHostTools.cmake)
+  endif()
+endfunction()
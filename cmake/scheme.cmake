@@ -0,0 +1,54 @@
+# Embeds Scheme definition files into a C header and, when guild is found,
+# compiles them to bytecode that guihckLoadDefinitions picks up at runtime.
+
+find_program(GUILD_EXECUTABLE NAMES guild guild-2.0)
+
+set(GUIHCK_SCM_COMPILED_DIR "${CMAKE_INSTALL_PREFIX}/lib/guihck/ccache" CACHE PATH "Install directory of precompiled guihck Scheme definitions")
+
+# guihck_add_scheme(<target> <header> <scm files...>)
+# For each file foo-bar.scm the header defines GUIHCK_SCM_FOO_BAR (source) and
+# GUIHCK_SCM_FOO_BAR_NAME. The name carries a hash of the source so stale
+# bytecode is never loaded.
+function(guihck_add_scheme target header)
+  set(content "/* Generated from Scheme sources by guihck_add_scheme, do not edit */\n")
+  set(compiled)
+
+  foreach(scm ${ARGN})
+    get_filename_component(path ${scm} ABSOLUTE)
+    get_filename_component(name ${scm} NAME_WE)
+    string(TOUPPER ${name} symbol)
+    string(REPLACE "-" "_" symbol ${symbol})
+
+    file(READ ${path} source)
+    string(MD5 hash "${source}")
+    string(SUBSTRING ${hash} 0 16 hash)
+    string(REPLACE "\\" "\\\\" source "${source}")
+    string(REPLACE "\"" "\\\"" source "${source}")
+    string(REPLACE "\n" "\\n\"\n    \"" source "${source}")
+
+    set(content "${content}\nstatic const char GUIHCK_SCM_${symbol}_NAME[] = \"${name}-${hash}\";\n")
+    set(content "${content}static const char GUIHCK_SCM_${symbol}[] =\n    \"${source}\";\n")
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${path})
+
+    if(GUILD_EXECUTABLE)
+      set(go ${CMAKE_CURRENT_BINARY_DIR}/ccache/${name}-${hash}.go)
+      add_custom_command(
+        OUTPUT ${go}
+        COMMAND ${GUILD_EXECUTABLE} compile -o ${go} ${path}
+        DEPENDS ${path}
+      )
+      list(APPEND compiled ${go})
+    endif()
+  endforeach()
+
+  # configure_file only touches the header when its content changes
+  file(WRITE ${header}.in "${content}")
+  configure_file(${header}.in ${header} COPYONLY)
+
+  if(compiled)
+    add_custom_target(${target} ALL DEPENDS ${compiled})
+    install(FILES ${compiled} DESTINATION ${GUIHCK_SCM_COMPILED_DIR})
+  else()
+    message("guild not found, ${target} Scheme definitions are evaluated from source")
+  endif()
+endfunction()
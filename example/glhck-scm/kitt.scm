@@ -1,45 +1,23 @@
-(define kitt-part
-  (composite rectangle
-    (prop 'width 64)
-    (prop 'height 64)
-    (prop 'phase 1)
-    (prop 'n 1)
-    (prop 'color (bound '(this phase this n) (lambda (phase n)
-      (list (floor (/ (* 255 phase) n)) 0 0))))))
-      
-(define (kitt num-parts)
-  (define (kitt-phase i cur)
-    (- num-parts (abs (- i cur))))
+(define (kitt-color i cur n)
+  (list (floor (/ (* 255 (- n (abs (- i cur)))) n)) 0 0))
 
-  (define (kitt-bound i)
-    (bound '(parent phase) (lambda (cur)
-      (kitt-phase i cur))))
+(define (kitt num-parts)
+  ; Each part brightens as the light passes it and back, played natively
+  (define (kitt-sweep i)
+    (sequence
+      (tween 'color (kitt-color i i num-parts) (* 0.1 (- i 1)))
+      (tween 'color (kitt-color i num-parts num-parts) (* 0.1 (- num-parts i)))))
 
   (define (make-kitt-part i)
-    (kitt-part
-      (prop 'phase (kitt-bound (+ i 1)))
-      (prop 'n num-parts)))
+    (rectangle
+      (prop 'width 64)
+      (prop 'height 64)
+      (prop 'color (kitt-color i 1 num-parts))
+      (method 'init (lambda ()
+        (animate! (kitt-sweep i) (repeat -1 #t))))))
 
   (composite row
-    (prop 'phase 1)
-    (prop 'direction 1)
-    (arg-list (map make-kitt-part (iota num-parts)))
-    (timer
-      (prop 'interval 0.1)
-      (prop 'running #t)
-      (prop 'repeat -1)
-      (method 'on-timeout (lambda (c)
-        (let ((next-phase (+ (get-prop (parent) 'phase)
-                             (get-prop (parent) 'direction))))
-          (cond ((> next-phase num-parts)
-                 (begin
-                   (set-prop! (parent) 'phase (- num-parts 1))
-                   (set-prop! (parent) 'direction -1)))
-                ((< next-phase 1)
-                 (begin
-                   (set-prop! (parent) 'phase 2)
-                   (set-prop! (parent) 'direction 1)))
-                (else (set-prop! (parent) 'phase next-phase)))))))))
+    (arg-list (map make-kitt-part (iota num-parts 1)))))
 
 (define kitt-7 (kitt 7))
 (define kitt-9 (kitt 9))
@@ -48,4 +26,4 @@
   (column (prop 'spacing 64)
     (align 'center)
     (kitt-7)
-    (kitt-9)))
\ No newline at end of file
+    (kitt-9)))
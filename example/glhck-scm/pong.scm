@@ -54,9 +54,7 @@
       ((= key (keyboard 'down))
         (if (eq? action 'release)
           (set-prop! (find-element 'bat-2) 'vy 0)
-          (set-prop! (find-element 'bat-2) 'vy (get-prop 'speed))))
-      ((= key (keyboard 'escape)) 
-        (quit))))
+          (set-prop! (find-element 'bat-2) 'vy (get-prop 'speed))))))
         
   (define (update)
     (define (limit-value element property lower-bound upper-bound)
@@ -185,4 +183,9 @@
     (view "game" game
       (fill-parent))))
 
-(focus! (find-element 'game))
\ No newline at end of file
+(focus! (find-element 'game))
+
+(accelerator! 'escape '() (lambda (action)
+  (if (eq? action 'press)
+    (quit))
+  #t))
\ No newline at end of file
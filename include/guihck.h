@@ -3,6 +3,7 @@
 
 #include <libguile.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <guihckKeys.h>
 
 #ifdef __cplusplus
@@ -13,6 +14,10 @@ typedef size_t guihckElementId;
 typedef size_t guihckElementTypeId;
 typedef size_t guihckMouseAreaId;
 typedef size_t guihckPropertyListenerId;
+typedef size_t guihckAnimationId;
+
+#define GUIHCK_NO_MOUSE_AREA ((guihckMouseAreaId) -1)
+#define GUIHCK_NO_ANIMATION ((guihckAnimationId) -1)
 
 typedef enum guihckKeyAction {
   GUIHCK_KEY_PRESS = GUIHCK_PRESS,
@@ -24,18 +29,67 @@ typedef int guihckKey;
 typedef int guihckKeyMods;
 
 typedef struct _guihckContext guihckContext;
+typedef struct _guihckTypeRegistry guihckTypeRegistry;
+typedef struct _guihckTemplate guihckTemplate;
+typedef struct _guihckReplay guihckReplay;
 typedef struct _guihckElement guihckElement;
 
+// Schema entries changed since the last update, bit i for entry i.
+// Elements made dirty any other way get every bit
+typedef uint32_t guihckPropertyMask;
+#define GUIHCK_PROPERTY_BIT(index) ((guihckPropertyMask) 1 << (index))
+#define GUIHCK_PROPERTY_MASK_ALL ((guihckPropertyMask) ~0u)
+#define GUIHCK_MAX_SCHEMA_PROPERTIES 32
+
 // Element type function map
 typedef struct guihckElementTypeFunctionMap {
    void (*init)(guihckContext* ctx, guihckElementId id, void* data);
    void (*destroy)(guihckContext* ctx, guihckElementId id, void* data);
-   bool (*update)(guihckContext* ctx, guihckElementId id, void* data);
+   bool (*update)(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed);
    void (*render)(guihckContext* ctx, guihckElementId id, void* data);
    bool (*keyEvent)(guihckContext* ctx, guihckElementId id, guihckKey key, int scancode, guihckKeyAction action, guihckKeyMods mods, void* data);
    bool (*keyChar)(guihckContext* ctx, guihckElementId id, unsigned int codepoint, void* data);
+   /* Snapshots: serialize returns the size needed and writes only if it fits */
+   size_t (*serialize)(guihckContext* ctx, guihckElementId id, void* data, void* buffer, size_t size);
+   bool (*deserialize)(guihckContext* ctx, guihckElementId id, void* data, const void* buffer, size_t size);
 } guihckElementTypeFunctionMap;
 
+// Work a type skips while it is in a hidden subtree, caught up once when shown again
+typedef enum guihckSuspendFlags {
+  GUIHCK_SUSPEND_NONE = 0,
+  GUIHCK_SUSPEND_UPDATE = 1 << 0, /* dirty elements wait for their update */
+  GUIHCK_SUSPEND_BINDS = 1 << 1 /* bound properties keep their value until shown */
+} guihckSuspendFlags;
+
+// Property schemas, typed values are converted once when the property changes
+typedef enum guihckValueType {
+  GUIHCK_VALUE_SCM, /* kept as is, the schema only gives marksDirty */
+  GUIHCK_VALUE_F32,
+  GUIHCK_VALUE_I32,
+  GUIHCK_VALUE_BOOL,
+  GUIHCK_VALUE_COLOR, /* (r g b) or (r g b a), components 0-255 */
+  GUIHCK_VALUE_STRING
+} guihckValueType;
+
+typedef struct guihckColor {
+  unsigned char r, g, b, a;
+} guihckColor;
+
+typedef union guihckValue {
+  float f32;
+  int32_t i32;
+  bool boolean;
+  guihckColor color;
+  const char* string;
+} guihckValue;
+
+typedef struct guihckPropertySchema {
+  const char* name;
+  guihckValueType type;
+  guihckValue defaultValue; /* while unset or set to a value of another type */
+  bool marksDirty; /* changes mark the element dirty and set the entry's bit */
+} guihckPropertySchema;
+
 // Mouse area function map
 typedef struct guihckMouseAreaFunctionMap {
   bool (*mouseDown)(guihckContext* ctx, guihckElementId id, void* data, int button, float x, float y);
@@ -45,16 +99,137 @@ typedef struct guihckMouseAreaFunctionMap {
   bool (*mouseExit)(guihckContext* ctx, guihckElementId id, void* data, float sx, float sy, float dx, float dy);
 } guihckMouseAreaFunctionMap;
 
+// Frame profiling, phases are inclusive: binds evaluated during an update count in both
+typedef enum guihckFramePhase {
+  GUIHCK_PHASE_EVENTS,
+  GUIHCK_PHASE_BINDS,
+  GUIHCK_PHASE_ANIMATION,
+  GUIHCK_PHASE_UPDATE,
+  GUIHCK_PHASE_RENDER_ORDER,
+  GUIHCK_PHASE_RENDER,
+  GUIHCK_PHASE_COUNT
+} guihckFramePhase;
+
+typedef struct guihckPhaseStats {
+  double time; /* seconds */
+  unsigned int calls;
+} guihckPhaseStats;
+
+typedef struct guihckTypeStats {
+  const char* name;
+  unsigned int updateCalls;
+  double updateTime;
+  unsigned int renderCalls;
+  double renderTime;
+  unsigned int bindEvaluations;
+  unsigned int listenerNotifications;
+} guihckTypeStats;
+
+typedef struct guihckFrameStats {
+  unsigned long frame;
+  double frameTime; /* from the end of the previous render to the end of this one */
+  guihckPhaseStats phases[GUIHCK_PHASE_COUNT];
+  unsigned int bindEvaluations;
+  unsigned int listenerNotifications;
+  unsigned int schemeCalls;
+  unsigned int allocations; /* elements, properties and listeners created */
+  size_t typeCount;
+  const guihckTypeStats* types; /* indexed by element type, valid until the next frame ends */
+} guihckFrameStats;
+
+// Memory accounting, collected only when built with GUIHCK_MEMORY_ACCOUNTING
+typedef enum guihckMemoryCategory {
+  GUIHCK_MEMORY_ELEMENTS,
+  GUIHCK_MEMORY_PROPERTIES,
+  GUIHCK_MEMORY_LISTENERS,
+  GUIHCK_MEMORY_BINDINGS,
+  GUIHCK_MEMORY_MOUSE_AREAS,
+  GUIHCK_MEMORY_ANIMATIONS,
+  GUIHCK_MEMORY_SCRATCH,
+  GUIHCK_MEMORY_CATEGORY_COUNT
+} guihckMemoryCategory;
+
+typedef struct guihckMemoryStats {
+  size_t bytes[GUIHCK_MEMORY_CATEGORY_COUNT]; /* live, records and the buffers they own */
+  size_t allocations[GUIHCK_MEMORY_CATEGORY_COUNT];
+  size_t peakBytes;
+  size_t protectedObjects; /* SCM values kept alive with scm_gc_protect_object */
+} guihckMemoryStats;
+
+// Binding graph, nodes are element properties and edges the aliases, binds and listeners between them
+typedef enum guihckGraphFormat {
+  GUIHCK_GRAPH_DOT,
+  GUIHCK_GRAPH_JSON
+} guihckGraphFormat;
+
+// Input recording, every call that drives a context is logged in order
+typedef enum guihckRecordType {
+  GUIHCK_RECORD_END,
+  GUIHCK_RECORD_TIME,
+  GUIHCK_RECORD_MOUSE_DOWN,
+  GUIHCK_RECORD_MOUSE_UP,
+  GUIHCK_RECORD_MOUSE_MOVE,
+  GUIHCK_RECORD_KEY,
+  GUIHCK_RECORD_CHAR,
+  GUIHCK_RECORD_UPDATE,
+  GUIHCK_RECORD_RENDER
+} guihckRecordType;
+
+// Retained rendering, visual types emit commands that backends draw in bulk
+typedef enum guihckRenderCommandType {
+  GUIHCK_COMMAND_QUAD,
+  GUIHCK_COMMAND_TEXTURED_QUAD,
+  GUIHCK_COMMAND_TEXT,
+  GUIHCK_COMMAND_CLIP_PUSH, /* popped automatically after the element's children */
+  GUIHCK_COMMAND_CLIP_POP,
+  GUIHCK_COMMAND_TRANSFORM_PUSH, /* moves later commands by x and y until popped */
+  GUIHCK_COMMAND_TRANSFORM_POP
+} guihckRenderCommandType;
+
+typedef struct guihckRenderCommand {
+  guihckRenderCommandType type;
+  guihckElementId elementId;
+  float x, y, width, height; /* absolute plus enclosing transforms, text runs use x and y as the top left corner */
+  unsigned int color; /* RGBA bytes, 0xAABBGGRR */
+  const void* texture; /* backend defined, NULL for plain quads */
+  const char* text; /* text runs, valid until the next guihckContextUpdate */
+  float size;
+} guihckRenderCommand;
+
+// Damage, where visual elements changed between two renders
+#define GUIHCK_MAX_DAMAGE_RECTS 8
+
+typedef struct guihckDamageRect {
+  float x, y, width, height;
+} guihckDamageRect;
+
+typedef enum guihckEasing {
+  GUIHCK_EASING_LINEAR,
+  GUIHCK_EASING_IN_QUAD,
+  GUIHCK_EASING_OUT_QUAD,
+  GUIHCK_EASING_IN_OUT_QUAD,
+  GUIHCK_EASING_IN_CUBIC,
+  GUIHCK_EASING_OUT_CUBIC,
+  GUIHCK_EASING_IN_OUT_CUBIC,
+  GUIHCK_EASING_STEP
+} guihckEasing;
+
 typedef void (*guihckPropertyListenerCallback)(guihckContext* ctx, guihckElementId listenerId, guihckElementId listenedId, const char* property, SCM value, void* data);
+typedef bool (*guihckAcceleratorCallback)(guihckContext* ctx, guihckKey key, guihckKeyAction action, guihckKeyMods mods, void* data);
+typedef void (*guihckAcceleratorFreeCallback)(guihckContext* ctx, guihckKey key, guihckKeyMods mods, void* data);
 typedef void (*guihckPropertyListenerFreeCallback)(guihckContext* ctx, guihckElementId listenerId, guihckElementId listenedId, const char* property, SCM value, void* data);
+typedef void (*guihckAnimationCallback)(guihckContext* ctx, guihckAnimationId animationId, guihckElementId elementId, void* data);
+typedef void (*guihckAnimationFreeCallback)(guihckContext* ctx, guihckAnimationId animationId, void* data);
 
 // Init
 void guihckInit();
 void guihckRegisterFunction(const char* name, int req, int opt, int rst, scm_t_subr func);
+void guihckLoadDefinitions(const char* name, const char* source);
 
 // Context
 
 guihckContext* guihckContextNew();
+guihckContext* guihckContextNewWithTypes(guihckTypeRegistry* types);
 void guihckContextFree(guihckContext* ctx);
 void guihckContextUpdate(guihckContext* ctx);
 void guihckContextRender(guihckContext* ctx);
@@ -63,6 +238,10 @@ void guihckContextMouseDown(guihckContext* ctx, float x, float y, int button);
 void guihckContextMouseUp(guihckContext* ctx, float x, float y, int button);
 void guihckContextMouseMove(guihckContext* ctx, float sx, float sy, float dx, float dy);
 
+void guihckContextCapturePointer(guihckContext* ctx, guihckMouseAreaId mouseAreaId);
+void guihckContextReleasePointer(guihckContext* ctx);
+guihckMouseAreaId guihckContextGetPointerCapture(guihckContext* ctx);
+
 void guihckContextKeyboardFocus(guihckContext* ctx, guihckElementId elementId);
 guihckElementId guihckContextGetKeyboardFocus(guihckContext* ctx);
 
@@ -70,17 +249,91 @@ void guihckContextAddKeyBinding(guihckContext* ctx, guihckKey keyCode, const cha
 const char* guihckContextGetKeyName(guihckContext* ctx, guihckKey keyCode);
 guihckKey guihckContextGetKeyCode(guihckContext* ctx, const char* keyName);
 
+void guihckContextAddAccelerator(guihckContext* ctx, guihckKey key, guihckKeyMods mods, guihckAcceleratorCallback callback, void* data,
+                                 guihckAcceleratorFreeCallback freeCallback);
+void guihckContextRemoveAccelerator(guihckContext* ctx, guihckKey key, guihckKeyMods mods);
+
 void guihckContextKeyboardKey(guihckContext* ctx, guihckKey key, int scancode, guihckKeyAction action, guihckKeyMods mods);
 void guihckContextKeyboardChar(guihckContext* ctx, unsigned int codepoint);
 
 void guihckContextTime(guihckContext* ctx, double time);
 double guihckContextGetTime(guihckContext* ctx);
 
+void guihckContextProfiling(guihckContext* ctx, bool enabled);
+bool guihckContextGetProfiling(guihckContext* ctx);
+bool guihckContextGetFrameStats(guihckContext* ctx, guihckFrameStats* stats);
+
+void guihckContextTraceStart(guihckContext* ctx, size_t capacity);
+void guihckContextTraceStop(guihckContext* ctx);
+bool guihckContextTraceDump(guihckContext* ctx, const char* path);
+
+/* Edges carry the notifications through them since they were added or the counters were reset */
+bool guihckContextBindingGraphDump(guihckContext* ctx, const char* path, guihckGraphFormat format);
+void guihckContextResetBindingCounters(guihckContext* ctx);
+/* Property notifications nested deeper than the limit are dropped and the path is kept, 0 disables */
+void guihckContextNotifyDepthLimit(guihckContext* ctx, unsigned int limit);
+unsigned int guihckContextGetNotifyDepthLimit(guihckContext* ctx);
+/* Listeners of the last path cut by the limit, the repeating part if it was a cycle */
+size_t guihckContextGetNotifyCycle(guihckContext* ctx, const guihckPropertyListenerId** path);
+
+bool guihckContextGetMemoryStats(guihckContext* ctx, guihckMemoryStats* stats);
+const char* guihckMemoryCategoryName(guihckMemoryCategory category);
+
+bool guihckContextRecordStart(guihckContext* ctx, const char* path);
+void guihckContextRecordStop(guihckContext* ctx);
+
+guihckReplay* guihckReplayOpen(const char* path);
+void guihckReplayClose(guihckReplay* replay);
+guihckRecordType guihckReplayStep(guihckReplay* replay, guihckContext* ctx);
+
+/* Refused while a registered type renders without emitting commands, see guihckElementTypeEmitsCommands */
+bool guihckContextRetainedRendering(guihckContext* ctx, bool enabled);
+bool guihckContextGetRetainedRendering(guihckContext* ctx);
+const guihckRenderCommand* guihckContextGetRenderCommands(guihckContext* ctx, size_t* count);
+
+/* Valid from the start of guihckContextRender until the next one */
+size_t guihckContextGetDamage(guihckContext* ctx, const guihckDamageRect** rects);
+void guihckContextDamage(guihckContext* ctx, float x, float y, float width, float height);
+
+/* Dirty elements that were culled by the last render wait until they are not */
+void guihckContextCullUpdates(guihckContext* ctx, bool enabled);
+bool guihckContextGetCullUpdates(guihckContext* ctx);
+
 guihckElementId guihckContextGetRootElement(guihckContext* ctx);
 
 // Element type
 
 guihckElementTypeId guihckElementTypeAdd(guihckContext* ctx, const char* name, guihckElementTypeFunctionMap functionMap, size_t dataSize);
+void guihckElementTypeSuspendHidden(guihckContext* ctx, guihckElementTypeId typeId, int flags);
+/* The type's update emits render commands, its render callback is only used when rendering is not retained */
+void guihckElementTypeEmitsCommands(guihckContext* ctx, guihckElementTypeId typeId, bool emits);
+/* Declared before elements of the type are created, the schema is copied */
+void guihckElementTypeSchema(guihckContext* ctx, guihckElementTypeId typeId, const guihckPropertySchema* schema, size_t count);
+
+// Type registry, shared by contexts and copied on write
+/* The reference count is not atomic, contexts sharing a registry must stay on one thread.
+ * Shared registries are read-only, adding a type to one returns -1 and other changes are ignored */
+
+guihckTypeRegistry* guihckTypeRegistryNew();
+guihckTypeRegistry* guihckTypeRegistryRef(guihckTypeRegistry* types);
+void guihckTypeRegistryFree(guihckTypeRegistry* types);
+guihckElementTypeId guihckTypeRegistryAddType(guihckTypeRegistry* types, const char* name, guihckElementTypeFunctionMap functionMap, size_t dataSize);
+guihckElementTypeId guihckTypeRegistryGetType(guihckTypeRegistry* types, const char* name);
+void guihckTypeRegistrySuspendHidden(guihckTypeRegistry* types, guihckElementTypeId typeId, int flags);
+int guihckTypeRegistryGetSuspendHidden(guihckTypeRegistry* types, guihckElementTypeId typeId);
+void guihckTypeRegistryEmitsCommands(guihckTypeRegistry* types, guihckElementTypeId typeId, bool emits);
+bool guihckTypeRegistryGetEmitsCommands(guihckTypeRegistry* types, guihckElementTypeId typeId);
+void guihckTypeRegistrySchema(guihckTypeRegistry* types, guihckElementTypeId typeId, const guihckPropertySchema* schema, size_t count);
+const guihckPropertySchema* guihckTypeRegistryGetSchema(guihckTypeRegistry* types, guihckElementTypeId typeId, size_t* count);
+guihckTypeRegistry* guihckContextGetTypes(guihckContext* ctx);
+guihckTypeRegistry* guihckContextGetMutableTypes(guihckContext* ctx);
+
+// Templates, recorded by make-template and instantiated without re-running the constructors
+
+guihckTemplate* guihckTemplateNew(guihckContext* ctx, SCM description);
+void guihckTemplateFree(guihckTemplate* tmpl);
+/* Returns (guihckElementId) -1 when ctx does not have the element types the template was made with */
+guihckElementId guihckTemplateInstantiate(guihckContext* ctx, guihckTemplate* tmpl, guihckElementId parentId, SCM overrides);
 
 // Element
 
@@ -90,6 +343,15 @@ void guihckElementRemove(guihckContext* ctx, guihckElementId id);
 SCM guihckElementGetProperty(guihckContext* ctx, guihckElementId elementId, const char *key);
 void guihckElementProperty(guihckContext* ctx, guihckElementId elementId, const char* key, SCM value);
 
+/* Value of a declared property, its default when unset or invalid. Undeclared ones are converted on each call.
+ * Strings of declared properties are valid until the property changes, strings of undeclared ones
+ * until the next guihckElementGetString call. NULL when the value is not a string */
+float guihckElementGetFloat(guihckContext* ctx, guihckElementId elementId, const char* key);
+int32_t guihckElementGetInt(guihckContext* ctx, guihckElementId elementId, const char* key);
+bool guihckElementGetBool(guihckContext* ctx, guihckElementId elementId, const char* key);
+guihckColor guihckElementGetColor(guihckContext* ctx, guihckElementId elementId, const char* key);
+const char* guihckElementGetString(guihckContext* ctx, guihckElementId elementId, const char* key);
+
 guihckElementId guihckElementGetParent(guihckContext* ctx, guihckElementId elementId);
 size_t guihckElementGetChildCount(guihckContext* ctx, guihckElementId elementId);
 guihckElementId guihckElementGetChild(guihckContext* ctx, guihckElementId elementId, int childIndex);
@@ -104,17 +366,63 @@ guihckPropertyListenerId guihckElementAddListener(guihckContext* ctx, guihckElem
 void guihckElementRemoveListener(guihckContext* ctx, guihckPropertyListenerId propertyListenerId);
 bool guihckElementGetVisible(guihckContext* ctx, guihckElementId elementId);
 void guihckElementVisible(guihckContext* ctx, guihckElementId elementId, bool value);
+/* False if the element or any of its ancestors is not visible */
+bool guihckElementGetEffectiveVisible(guihckContext* ctx, guihckElementId elementId);
+bool guihckElementGetClip(guihckContext* ctx, guihckElementId elementId);
+void guihckElementClip(guihckContext* ctx, guihckElementId elementId, bool value);
+
+/* Culling is resolved by guihckContextRender, outside the root rect or a clipping ancestor */
+bool guihckElementGetCulled(guihckContext* ctx, guihckElementId elementId);
+bool guihckElementGetVisibleBounds(guihckContext* ctx, guihckElementId elementId, float* x, float* y, float* width, float* height);
+
+/* Moves the element's children when drawn and hit tested, their properties stay untouched */
+void guihckElementChildOffset(guihckContext* ctx, guihckElementId elementId, float x, float y);
+void guihckElementGetChildOffset(guihckContext* ctx, guihckElementId elementId, float* x, float* y);
+/* Sum of the ancestors' child offsets, resolved with culling. Drawn at absolute position plus translation */
+void guihckElementGetTranslation(guihckContext* ctx, guihckElementId elementId, float* x, float* y);
+
+/* Replace the element's render commands, both are no-ops unless rendering is retained */
+void guihckElementClearCommands(guihckContext* ctx, guihckElementId elementId);
+void guihckElementAddCommand(guihckContext* ctx, guihckElementId elementId, const guihckRenderCommand* command);
+
 // Mouse area
 
 guihckMouseAreaId guihckMouseAreaNew(guihckContext* ctx, guihckElementId elementId, guihckMouseAreaFunctionMap functionMap);
 void guihckMouseAreaRemove(guihckContext* ctx, guihckMouseAreaId mouseAreaId);
 void guihckMouseAreaRect(guihckContext* ctx, guihckMouseAreaId mouseAreaId, float x, float y, float width, float height);
 void guihckMouseAreaGetRect(guihckContext* ctx, guihckMouseAreaId mouseAreaId, float* x, float* y, float* width, float* height);
+/* Observing areas still get presses, releases and moves that an area above them handled,
+ * their own results are ignored then. Lets containers take over drags started on their content */
+void guihckMouseAreaObserve(guihckContext* ctx, guihckMouseAreaId mouseAreaId, bool observe);
+
+// Animation, played from the context time before elements update
+
+/* Values are numbers or lists of numbers. An undefined from starts at the current value */
+guihckAnimationId guihckAnimationTween(guihckContext* ctx, guihckElementId elementId, const char* key, SCM from, SCM to,
+                                       double duration, guihckEasing easing);
+guihckAnimationId guihckAnimationSpring(guihckContext* ctx, guihckElementId elementId, const char* key, SCM to,
+                                        double stiffness, double damping);
+/* The sequence owns its steps, they are played and removed with it */
+guihckAnimationId guihckAnimationSequence(guihckContext* ctx, const guihckAnimationId* steps, size_t count);
+/* Plays count times, forever if negative. Alternating plays every other one backwards */
+void guihckAnimationRepeat(guihckContext* ctx, guihckAnimationId animationId, int count, bool alternate);
+void guihckAnimationOnComplete(guihckContext* ctx, guihckAnimationId animationId, guihckAnimationCallback callback, void* data,
+                               guihckAnimationFreeCallback freeCallback);
+void guihckAnimationStart(guihckContext* ctx, guihckAnimationId animationId);
+void guihckAnimationStop(guihckContext* ctx, guihckAnimationId animationId);
+bool guihckAnimationGetRunning(guihckContext* ctx, guihckAnimationId animationId);
+/* Animations are also removed with their element */
+void guihckAnimationRemove(guihckContext* ctx, guihckAnimationId animationId);
 
 
 SCM guihckContextExecuteExpression(guihckContext* ctx, SCM expression);
 SCM guihckContextExecuteScript(guihckContext* ctx, const char* script);
 SCM guihckContextExecuteScriptFile(guihckContext* ctx, const char* path);
+bool guihckContextSaveSnapshot(guihckContext* ctx, const char* path);
+bool guihckContextLoadSnapshot(guihckContext* ctx, const char* path);
+
+void guihckContextSetScriptCacheDirectory(guihckContext* ctx, const char* path);
+const char* guihckContextGetScriptCacheDirectory(guihckContext* ctx);
 
 // Element stack operations
 void guihckStackPushNewElement(guihckContext* ctx, const char* typeName);
@@ -5,6 +5,7 @@
 
 void guihckElementUpdateAbsoluteCoordinates(guihckContext* ctx, guihckElementId elementId);
 void guihckElementAddParentPositionListeners(guihckContext* ctx, guihckElementId id);
+/* A listener per element, types can declare the property with marksDirty in their schema instead */
 void guihckElementAddUpdateProperty(guihckContext* ctx, guihckElementId id, const char* propertyName);
 
 #endif
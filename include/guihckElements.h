@@ -10,5 +10,16 @@ void guihckElementsAddMouseAreaType(guihckContext* ctx);
 void guihckElementsAddRowType(guihckContext* ctx);
 void guihckElementsAddColumnType(guihckContext* ctx);
 void guihckElementsAddTimerType(guihckContext* ctx);
+void guihckElementsAddScrollViewType(guihckContext* ctx);
+
+/* Same as above for a registry to be shared between contexts, before it is shared */
+void guihckElementsRegisterAllTypes(guihckTypeRegistry* types);
+
+void guihckElementsRegisterItemType(guihckTypeRegistry* types);
+void guihckElementsRegisterMouseAreaType(guihckTypeRegistry* types);
+void guihckElementsRegisterRowType(guihckTypeRegistry* types);
+void guihckElementsRegisterColumnType(guihckTypeRegistry* types);
+void guihckElementsRegisterTimerType(guihckTypeRegistry* types);
+void guihckElementsRegisterScrollViewType(guihckTypeRegistry* types);
 
 #endif
@@ -10,4 +10,11 @@ void guihckGlhckAddTextType(guihckContext* ctx);
 void guihckGlhckAddImageType(guihckContext* ctx);
 void guihckGlhckAddTextInputType(guihckContext* ctx);
 
+void guihckGlhckRegisterAllTypes(guihckTypeRegistry* types);
+
+void guihckGlhckRegisterRectangleType(guihckTypeRegistry* types);
+void guihckGlhckRegisterTextType(guihckTypeRegistry* types);
+void guihckGlhckRegisterImageType(guihckTypeRegistry* types);
+void guihckGlhckRegisterTextInputType(guihckTypeRegistry* types);
+
 #endif
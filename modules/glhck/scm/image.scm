@@ -0,0 +1,9 @@
+(define (image . args)
+  (define default-args (list
+    (prop 'x 0)
+    (prop 'y 0)
+    (prop 'source "")
+    (prop 'source-width 0)
+    (prop 'source-height 0)
+    (prop 'color '(255 255 255))))
+  (create-element 'image (append default-args args)))
@@ -0,0 +1,8 @@
+(define (rectangle . args)
+  (define default-args (list
+    (prop 'x 0)
+    (prop 'y 0)
+    (prop 'width 100)
+    (prop 'height 100)
+    (prop 'color '(255 255 255))))
+  (create-element 'rectangle (append default-args args)))
@@ -0,0 +1,45 @@
+(define (text-input-gen)
+  (define (append-char! c)
+    (set-prop! 'text
+      (list->string
+        (append
+          (string->list
+            (get-prop 'text)) (list c)))))
+  (define (pop-char!)
+    (let ((current-text (get-prop 'text)))
+      (if (> (string-length current-text) 0)
+        (set-prop! 'text (string-drop-right current-text 1)))))
+
+  (define (handle-key! key scancode action mods)
+    (cond ((and (= key (keyboard 'backspace))
+                (not (eq? action 'release)))
+          (pop-char!))))
+
+  (composite item
+    (prop 'on-char append-char!)
+    (prop 'on-key handle-key!)
+    (alias 'text 'text-content 'text)
+    (alias 'font 'text-content 'font)
+    (alias 'color 'text-content 'color)
+    (alias 'size 'text-content 'size)
+    (text
+      (id 'text-content))
+    (rectangle
+      (prop 'height (bound '(parent height)))
+      (prop 'width 1)
+      (alias 'color 'parent 'color)
+      (prop 'x (bound '(text-content width)))
+      (prop 'visible (bound '(timer value parent focus) (lambda (v f) (and v f)))))
+    (timer
+      (id 'timer)
+      (prop 'interval 0.5)
+      (prop 'repeat -1)
+      (prop 'running (bound '(parent focus)))
+      (prop 'value #t)
+      (method 'on-timeout (lambda (c) (set-prop! 'value (not (get-prop 'value))))))
+    (mouse-area
+      (prop 'width (bound '(parent width)))
+      (prop 'height (bound '(parent height)))
+      (method 'on-mouse-down (lambda (b x y) (focus! (parent)))))))
+
+(define text-input (text-input-gen))
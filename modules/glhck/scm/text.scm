@@ -0,0 +1,9 @@
+(define (text . args)
+  (define default-args (list
+    (prop 'x 0)
+    (prop 'y 0)
+    (prop 'size 12)
+    (prop 'text "")
+    (prop 'font "")
+    (prop 'color '(255 255 255))))
+  (create-element 'text (append default-args args)))
@@ -1,5 +1,6 @@
 #include "glhckElements.h"
 #include "guihckElementUtils.h"
+#include "glhckElementsScm.h"
 #include "glhck/glhck.h"
 #include "lut.h"
 #include <stdio.h>
@@ -15,91 +16,9 @@
 # warning "No Thread-local storage! Multi-threaded guihck applications may have unexpected behaviour!"
 #endif
 
-static const char GUIHCK_GLHCK_RECTANGLE_SCM[] =
-    "(define (rectangle . args)"
-    "  (define default-args (list"
-    "    (prop 'x 0)"
-    "    (prop 'y 0)"
-    "    (prop 'width 100)"
-    "    (prop 'height 100)"
-    "    (prop 'color '(255 255 255))))"
-    "  (create-element 'rectangle (append default-args args)))"
-    ;
-
-static const char GUIHCK_GLHCK_TEXT_SCM[] =
-    "(define (text . args)"
-    "  (define default-args (list"
-    "    (prop 'x 0)"
-    "    (prop 'y 0)"
-    "    (prop 'size 12)"
-    "    (prop 'text \"\")"
-    "    (prop 'font \"\")"
-    "    (prop 'color '(255 255 255))))"
-    "  (create-element 'text (append default-args args)))"
-    ;
-
-static const char GUIHCK_GLHCK_IMAGE_SCM[] =
-    "(define (image . args)"
-    "  (define default-args (list"
-    "    (prop 'x 0)"
-    "    (prop 'y 0)"
-    "    (prop 'source \"\")"
-    "    (prop 'source-width 0)"
-    "    (prop 'source-height 0)"
-    "    (prop 'color '(255 255 255))))"
-    "  (create-element 'image (append default-args args)))"
-    ;
-
-static const char GUIHCK_GLHCK_TEXT_INPUT_SCM[] =
-    "(define (text-input-gen)"
-    "  (define (append-char! c)"
-    "    (set-prop! 'text"
-    "      (list->string"
-    "        (append"
-    "          (string->list"
-    "            (get-prop 'text)) (list c)))))"
-    "  (define (pop-char!)"
-    "    (let ((current-text (get-prop 'text)))"
-    "      (if (> (string-length current-text) 0)"
-    "        (set-prop! 'text (string-drop-right current-text 1)))))"
-
-    "  (define (handle-key! key scancode action mods)"
-    "    (cond ((and (= key (keyboard 'backspace))"
-    "                (not (eq? action 'release)))"
-    "          (pop-char!))))"
-
-    "  (composite item"
-    "    (prop 'on-char append-char!)"
-    "    (prop 'on-key handle-key!)"
-    "    (alias 'text 'text-content 'text)"
-    "    (alias 'font 'text-content 'font)"
-    "    (alias 'color 'text-content 'color)"
-    "    (alias 'size 'text-content 'size)"
-    "    (text"
-    "      (id 'text-content))"
-    "    (rectangle"
-    "      (prop 'height (bound '(parent height)))"
-    "      (prop 'width 1)"
-    "      (alias 'color 'parent 'color)"
-    "      (prop 'x (bound '(text-content width)))"
-    "      (prop 'visible (bound '(timer value parent focus) (lambda (v f) (and v f)))))"
-    "    (timer"
-    "      (id 'timer)"
-    "      (prop 'interval 0.5)"
-    "      (prop 'repeat -1)"
-    "      (prop 'running (bound '(parent focus)))"
-    "      (prop 'value #t)"
-    "      (method 'on-timeout (lambda (c) (set-prop! 'value (not (get-prop 'value))))))"
-    "    (mouse-area "
-    "      (prop 'width (bound '(parent width)))"
-    "      (prop 'height (bound '(parent height)))"
-    "      (method 'on-mouse-down (lambda (b x y) (focus! (parent)))))))"
-
-    "(define text-input (text-input-gen))";
-
 static void initRectangle(guihckContext* ctx, guihckElementId id, void* data);
 static void destroyRectangle(guihckContext* ctx, guihckElementId id, void* data);
-static bool updateRectangle(guihckContext* ctx, guihckElementId id, void* data);
+static bool updateRectangle(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed);
 static void renderRectangle(guihckContext* ctx, guihckElementId id, void* data);
 
 typedef struct _guihckGlhckTextContext
@@ -115,36 +34,91 @@ typedef struct _guihckGlhckText
 {
   glhckFont font;
   glhckHandle object;
-  char* content;
-  char* fontPath;
 } _guihckGlhckText;
 
 static void initText(guihckContext* ctx, guihckElementId id, void* data);
 static void destroyText(guihckContext* ctx, guihckElementId id, void* data);
-static bool updateText(guihckContext* ctx, guihckElementId id, void* data);
+static bool updateText(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed);
 static void renderText(guihckContext* ctx, guihckElementId id, void* data);
 static unsigned int getFont(const char* fontPath);
 
 typedef struct _guihckGlhckImage
 {
   glhckHandle object;
-  char* source;
 } _guihckGlhckImage;
 
 static void initImage(guihckContext* ctx, guihckElementId id, void* data);
 static void destroyImage(guihckContext* ctx, guihckElementId id, void* data);
-static bool updateImage(guihckContext* ctx, guihckElementId id, void* data);
+static bool updateImage(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed);
 static void renderImage(guihckContext* ctx, guihckElementId id, void* data);
 
+static void renderTranslated(guihckContext* ctx, guihckElementId id, glhckHandle object);
+static glhckColor toGlhckColor(guihckColor color);
+
+static const guihckPropertySchema rectangleSchema[] = {
+  {"absolute-x", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"absolute-y", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"width", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"height", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"color", GUIHCK_VALUE_COLOR, {.color = {255, 255, 255, 255}}, true}
+};
+
+static const guihckPropertySchema textSchema[] = {
+  {"absolute-x", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"absolute-y", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"text", GUIHCK_VALUE_STRING, {.string = NULL}, true},
+  {"font", GUIHCK_VALUE_STRING, {.string = NULL}, true},
+  {"size", GUIHCK_VALUE_F32, {.f32 = 12}, true},
+  {"color", GUIHCK_VALUE_COLOR, {.color = {255, 255, 255, 255}}, true}
+};
+#define TEXT_FONT_CHANGED GUIHCK_PROPERTY_BIT(3)
+#define TEXT_LAYOUT_CHANGED (GUIHCK_PROPERTY_BIT(2) | GUIHCK_PROPERTY_BIT(3) | GUIHCK_PROPERTY_BIT(4))
+
+/* Width and height fall back to the image size, they are checked for a value first */
+static const guihckPropertySchema imageSchema[] = {
+  {"absolute-x", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"absolute-y", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"width", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"height", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"color", GUIHCK_VALUE_COLOR, {.color = {255, 255, 255, 255}}, true},
+  {"source", GUIHCK_VALUE_STRING, {.string = NULL}, true}
+};
+#define IMAGE_SOURCE_CHANGED GUIHCK_PROPERTY_BIT(5)
+
 void guihckGlhckAddAllTypes(guihckContext* ctx)
 {
-  guihckGlhckAddRectangleType(ctx);
-  guihckGlhckAddTextType(ctx);
-  guihckGlhckAddImageType(ctx);
-  guihckGlhckAddTextInputType(ctx);
+  guihckGlhckRegisterAllTypes(guihckContextGetMutableTypes(ctx));
 }
 
 void guihckGlhckAddRectangleType(guihckContext* ctx)
+{
+  guihckGlhckRegisterRectangleType(guihckContextGetMutableTypes(ctx));
+}
+
+void guihckGlhckAddTextType(guihckContext* ctx)
+{
+  guihckGlhckRegisterTextType(guihckContextGetMutableTypes(ctx));
+}
+
+void guihckGlhckAddImageType(guihckContext* ctx)
+{
+  guihckGlhckRegisterImageType(guihckContextGetMutableTypes(ctx));
+}
+
+void guihckGlhckAddTextInputType(guihckContext* ctx)
+{
+  guihckGlhckRegisterTextInputType(guihckContextGetMutableTypes(ctx));
+}
+
+void guihckGlhckRegisterAllTypes(guihckTypeRegistry* types)
+{
+  guihckGlhckRegisterRectangleType(types);
+  guihckGlhckRegisterTextType(types);
+  guihckGlhckRegisterImageType(types);
+  guihckGlhckRegisterTextInputType(types);
+}
+
+void guihckGlhckRegisterRectangleType(guihckTypeRegistry* types)
 {
   guihckElementTypeFunctionMap functionMap = {
     initRectangle,
@@ -152,10 +126,16 @@ void guihckGlhckAddRectangleType(guihckContext* ctx)
     updateRectangle,
     renderRectangle,
     NULL,
+    NULL,
+    NULL,
     NULL
   };
-  guihckElementTypeAdd(ctx, "rectangle", functionMap, sizeof(glhckHandle));
-  guihckContextExecuteScript(ctx, GUIHCK_GLHCK_RECTANGLE_SCM);
+  guihckElementTypeId typeId = guihckTypeRegistryAddType(types, "rectangle", functionMap, sizeof(glhckHandle));
+  guihckTypeRegistrySchema(types, typeId, rectangleSchema, sizeof(rectangleSchema) / sizeof(guihckPropertySchema));
+
+  /* Text and images measure themselves for layouts, rectangles only draw */
+  guihckTypeRegistrySuspendHidden(types, typeId, GUIHCK_SUSPEND_UPDATE);
+  guihckLoadDefinitions(GUIHCK_SCM_RECTANGLE_NAME, GUIHCK_SCM_RECTANGLE);
 }
 
 void initRectangle(guihckContext* ctx, guihckElementId id, void* data)
@@ -167,11 +147,6 @@ void initRectangle(guihckContext* ctx, guihckElementId id, void* data)
 
   memcpy(data, &o, sizeof(glhckHandle));
   guihckElementAddParentPositionListeners(ctx, id);
-  guihckElementAddUpdateProperty(ctx, id, "absolute-x");
-  guihckElementAddUpdateProperty(ctx, id, "absolute-y");
-  guihckElementAddUpdateProperty(ctx, id, "width");
-  guihckElementAddUpdateProperty(ctx, id, "height");
-  guihckElementAddUpdateProperty(ctx, id, "color");
 }
 
 void destroyRectangle(guihckContext* ctx, guihckElementId id, void* data)
@@ -182,58 +157,33 @@ void destroyRectangle(guihckContext* ctx, guihckElementId id, void* data)
   glhckHandleRelease(*(glhckHandle*)data);
 }
 
-bool updateRectangle(guihckContext* ctx, guihckElementId id, void* data)
+bool updateRectangle(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
 {
+  (void) changed;
+
   glhckHandle o = *(glhckHandle*)data;
-  SCM x = guihckElementGetProperty(ctx, id, "absolute-x");
-  SCM y = guihckElementGetProperty(ctx, id, "absolute-y");
-  SCM w = guihckElementGetProperty(ctx, id, "width");
-  SCM h = guihckElementGetProperty(ctx, id, "height");
-  SCM c = guihckElementGetProperty(ctx, id, "color");
 
   kmVec3 position = *glhckObjectGetPosition(o);
   kmVec3 scale = *glhckObjectGetScale(o);
-  if(scm_is_real(w)) scale.x = scm_to_double(w)/2;
-  if(scm_is_real(h)) scale.y = scm_to_double(h)/2;
-  if(scm_is_real(x)) position.x = scm_to_double(x) + scale.x;
-  if(scm_is_real(y)) position.y = scm_to_double(y) + scale.y;
+  scale.x = guihckElementGetFloat(ctx, id, "width")/2;
+  scale.y = guihckElementGetFloat(ctx, id, "height")/2;
+  position.x = guihckElementGetFloat(ctx, id, "absolute-x") + scale.x;
+  position.y = guihckElementGetFloat(ctx, id, "absolute-y") + scale.y;
 
   glhckObjectPosition(o, &position);
   glhckObjectScale(o, &scale);
-
-  if(scm_to_bool(scm_list_p(c)) && scm_to_int32(scm_length(c)) == 3)
-  {
-    glhckColor color = glhckMaterialGetDiffuse(glhckObjectGetMaterial(o));
-    SCM r = scm_list_ref(c, scm_from_int8(0));
-    SCM g = scm_list_ref(c, scm_from_int8(1));
-    SCM b = scm_list_ref(c, scm_from_int8(2));
-
-    unsigned char cr = (color & 0xFF000000) >> 24;
-    unsigned char cg = (color & 0x00FF0000) >> 16;
-    unsigned char cb = (color & 0x0000FF00) >> 8;
-    unsigned char ca = (color & 0x000000FF);
-
-    if(scm_to_bool(scm_integer_p(r))) cr = scm_to_uint8(r);
-    if(scm_to_bool(scm_integer_p(g))) cg = scm_to_uint8(g);
-    if(scm_to_bool(scm_integer_p(b))) cb = scm_to_uint8(b);
-
-    glhckColor newColor = (ca | (cb << 8) | (cg << 16) | (cr << 24));
-    glhckMaterialDiffuse(glhckObjectGetMaterial(o), newColor);
-  }
+  glhckMaterialDiffuse(glhckObjectGetMaterial(o), toGlhckColor(guihckElementGetColor(ctx, id, "color")));
 
   return false;
 }
 
 void renderRectangle(guihckContext* ctx, guihckElementId id, void* data)
 {
-  (void) ctx;
-  (void) id;
-
-  glhckRenderObject(*(glhckHandle*)data);
+  renderTranslated(ctx, id, *(glhckHandle*)data);
 }
 
 
-void guihckGlhckAddTextType(guihckContext* ctx)
+void guihckGlhckRegisterTextType(guihckTypeRegistry* types)
 {
   guihckElementTypeFunctionMap functionMap = {
     initText,
@@ -241,10 +191,13 @@ void guihckGlhckAddTextType(guihckContext* ctx)
     updateText,
     renderText,
     NULL,
+    NULL,
+    NULL,
     NULL
   };
-  guihckElementTypeAdd(ctx, "text", functionMap, sizeof(_guihckGlhckText));
-  guihckContextExecuteScript(ctx, GUIHCK_GLHCK_TEXT_SCM);
+  guihckElementTypeId typeId = guihckTypeRegistryAddType(types, "text", functionMap, sizeof(_guihckGlhckText));
+  guihckTypeRegistrySchema(types, typeId, textSchema, sizeof(textSchema) / sizeof(guihckPropertySchema));
+  guihckLoadDefinitions(GUIHCK_SCM_TEXT_NAME, GUIHCK_SCM_TEXT);
 }
 
 void initText(guihckContext* ctx, guihckElementId id, void* data)
@@ -262,15 +215,7 @@ void initText(guihckContext* ctx, guihckElementId id, void* data)
   glhckHandle m = glhckMaterialNew(0);
   glhckObjectMaterial(d->object, m);
   glhckHandleRelease(m);
-  d->content = NULL;
-  d->fontPath = NULL;
   guihckElementAddParentPositionListeners(ctx, id);
-  guihckElementAddUpdateProperty(ctx, id, "absolute-x");
-  guihckElementAddUpdateProperty(ctx, id, "absolute-y");
-  guihckElementAddUpdateProperty(ctx, id, "text");
-  guihckElementAddUpdateProperty(ctx, id, "font");
-  guihckElementAddUpdateProperty(ctx, id, "size");
-  guihckElementAddUpdateProperty(ctx, id, "color");
 }
 
 void destroyText(guihckContext* ctx, guihckElementId id, void* data)
@@ -280,8 +225,6 @@ void destroyText(guihckContext* ctx, guihckElementId id, void* data)
 
   _guihckGlhckText* d = data;
   glhckHandleRelease(d->object);
-  if(d->content)
-    free(d->content);
 
   textThreadLocalContext.textRefs -= 1;
   if(textThreadLocalContext.textRefs == 0)
@@ -300,55 +243,29 @@ void destroyText(guihckContext* ctx, guihckElementId id, void* data)
   }
 }
 
-bool updateText(guihckContext* ctx, guihckElementId id, void* data)
+bool updateText(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
 {
   _guihckGlhckText* d = data;
 
-  SCM textContent = guihckElementGetProperty(ctx, id, "text");
-  SCM fontPath = guihckElementGetProperty(ctx, id, "font");
-  SCM textSize = guihckElementGetProperty(ctx, id, "size");
-  SCM c = guihckElementGetProperty(ctx, id, "color");
+  const char* fontPath = guihckElementGetString(ctx, id, "font");
+  if((changed & TEXT_FONT_CHANGED) && fontPath)
+    d->font = getFont(fontPath);
 
-  if(scm_is_string(fontPath))
-  {
-    char* fontPathStr = scm_to_utf8_string(fontPath);
-    if(!d->fontPath || strcmp(fontPathStr, d->fontPath))
-    {
-      d->font = getFont(fontPathStr);
-      if(d->fontPath)
-        free(d->fontPath);
-      d->fontPath = fontPathStr;
-    }
-    else
-    {
-      free(fontPathStr);
-    }
-  }
-  if(scm_is_string(textContent))
+  /* The text is rendered again only when it would look different */
+  if(changed & TEXT_LAYOUT_CHANGED)
   {
-    char* textContentStr = scm_to_utf8_string(textContent);
-    if(!d->content || strcmp(textContentStr, d->content))
+    const char* textContent = guihckElementGetString(ctx, id, "text");
+    if(textContent && strlen(textContent) > 0)
     {
-      if(strlen(textContentStr) > 0)
-      {
-        float size = scm_is_real(textSize)  ? scm_to_double(textSize) : 12;
-        glhckHandle texture = glhckTextRTT(textThreadLocalContext.text, d->font, size, textContentStr, glhckTextureDefaultLinearParameters());
-        glhckMaterialTexture(glhckObjectGetMaterial(d->object), texture);
-        if(texture)
-          glhckHandleRelease(texture);
-      }
-      else
-      {
-        glhckMaterialTexture(glhckObjectGetMaterial(d->object), 0);
-      }
-
-      if(d->content)
-        free(d->content);
-      d->content = textContentStr;
+      float size = guihckElementGetFloat(ctx, id, "size");
+      glhckHandle texture = glhckTextRTT(textThreadLocalContext.text, d->font, size, textContent, glhckTextureDefaultLinearParameters());
+      glhckMaterialTexture(glhckObjectGetMaterial(d->object), texture);
+      if(texture)
+        glhckHandleRelease(texture);
     }
     else
     {
-      free(textContentStr);
+      glhckMaterialTexture(glhckObjectGetMaterial(d->object), 0);
     }
   }
 
@@ -365,49 +282,25 @@ bool updateText(guihckContext* ctx, guihckElementId id, void* data)
     guihckElementProperty(ctx, id, "height", scm_from_double(h));
   }
 
-  SCM x = guihckElementGetProperty(ctx, id, "absolute-x");
-  SCM y = guihckElementGetProperty(ctx, id, "absolute-y");
   kmVec3 position = *glhckObjectGetPosition(d->object);
   kmVec3 scale = *glhckObjectGetScale(d->object);
 
   scale.x = w/2;
   scale.y = h/2;
-  if(scm_is_real(x)) position.x = scm_to_double(x) + scale.x;
-  if(scm_is_real(y)) position.y = scm_to_double(y) + scale.y;
+  position.x = guihckElementGetFloat(ctx, id, "absolute-x") + scale.x;
+  position.y = guihckElementGetFloat(ctx, id, "absolute-y") + scale.y;
 
   glhckObjectPosition(d->object, &position);
   glhckObjectScale(d->object, &scale);
-
-  if(scm_to_bool(scm_list_p(c)) && scm_to_int32(scm_length(c)) == 3)
-  {
-    glhckColor color = glhckMaterialGetDiffuse(glhckObjectGetMaterial(d->object));
-    SCM r = scm_list_ref(c, scm_from_int8(0));
-    SCM g = scm_list_ref(c, scm_from_int8(1));
-    SCM b = scm_list_ref(c, scm_from_int8(2));
-
-    unsigned char cr = (color & 0xFF000000) >> 24;
-    unsigned char cg = (color & 0x00FF0000) >> 16;
-    unsigned char cb = (color & 0x0000FF00) >> 8;
-    unsigned char ca = (color & 0x000000FF);
-
-    if(scm_to_bool(scm_integer_p(r))) cr = scm_to_uint8(r);
-    if(scm_to_bool(scm_integer_p(g))) cg = scm_to_uint8(g);
-    if(scm_to_bool(scm_integer_p(b))) cb = scm_to_uint8(b);
-
-    glhckColor newColor = (ca | (cb << 8) | (cg << 16) | (cr << 24));
-    glhckMaterialDiffuse(glhckObjectGetMaterial(d->object), newColor);
-  }
+  glhckMaterialDiffuse(glhckObjectGetMaterial(d->object), toGlhckColor(guihckElementGetColor(ctx, id, "color")));
 
   return false;
 }
 
 void renderText(guihckContext* ctx, guihckElementId id, void* data)
 {
-  (void) ctx;
-  (void) id;
-
   _guihckGlhckText* d = data;
-  glhckRenderObject(d->object);
+  renderTranslated(ctx, id, d->object);
 }
 
 unsigned int getFont(const char* fontPath)
@@ -432,7 +325,7 @@ unsigned int getFont(const char* fontPath)
   return *result;
 }
 
-void guihckGlhckAddImageType(guihckContext* ctx)
+void guihckGlhckRegisterImageType(guihckTypeRegistry* types)
 {
   guihckElementTypeFunctionMap functionMap = {
     initImage,
@@ -440,10 +333,13 @@ void guihckGlhckAddImageType(guihckContext* ctx)
     updateImage,
     renderImage,
     NULL,
+    NULL,
+    NULL,
     NULL
   };
-  guihckElementTypeAdd(ctx, "image", functionMap, sizeof(_guihckGlhckImage));
-  guihckContextExecuteScript(ctx, GUIHCK_GLHCK_IMAGE_SCM);
+  guihckElementTypeId typeId = guihckTypeRegistryAddType(types, "image", functionMap, sizeof(_guihckGlhckImage));
+  guihckTypeRegistrySchema(types, typeId, imageSchema, sizeof(imageSchema) / sizeof(guihckPropertySchema));
+  guihckLoadDefinitions(GUIHCK_SCM_IMAGE_NAME, GUIHCK_SCM_IMAGE);
 }
 
 void initImage(guihckContext* ctx, guihckElementId id, void* data)
@@ -453,14 +349,7 @@ void initImage(guihckContext* ctx, guihckElementId id, void* data)
   glhckHandle m = glhckMaterialNew(0);
   glhckObjectMaterial(d->object, m);
   glhckHandleRelease(m);
-  d->source = NULL;
   guihckElementAddParentPositionListeners(ctx, id);
-  guihckElementAddUpdateProperty(ctx, id, "absolute-x");
-  guihckElementAddUpdateProperty(ctx, id, "absolute-y");
-  guihckElementAddUpdateProperty(ctx, id, "width");
-  guihckElementAddUpdateProperty(ctx, id, "height");
-  guihckElementAddUpdateProperty(ctx, id, "color");
-  guihckElementAddUpdateProperty(ctx, id, "source");
 }
 
 void destroyImage(guihckContext* ctx, guihckElementId id, void* data)
@@ -470,104 +359,77 @@ void destroyImage(guihckContext* ctx, guihckElementId id, void* data)
 
   _guihckGlhckImage* d = data;
   glhckHandleRelease(d->object);
-  if(d->source)
-    free(d->source);
 }
 
-bool updateImage(guihckContext* ctx, guihckElementId id, void* data)
+bool updateImage(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
 {
   _guihckGlhckImage* d = data;
 
-  SCM source = guihckElementGetProperty(ctx, id, "source");
-
-  if(scm_is_string(source))
-  {
-    char* sourceStr = scm_to_utf8_string(source);
-    if(!d->source || strcmp(sourceStr, d->source))
-    {
-      glhckHandle texture = glhckTextureNewFromFile(sourceStr, NULL, glhckTextureDefaultSpriteParameters());
-      glhckMaterialTexture(glhckObjectGetMaterial(d->object), texture);
-      glhckHandleRelease(texture);
-      free(d->source);
-      d->source = sourceStr;
-      int textureWidth, textureHeight;
-      glhckTextureGetInformation(texture, NULL, &textureWidth, &textureHeight, NULL, NULL, NULL, NULL);
-      guihckElementProperty(ctx, id, "source-width", scm_from_double(textureWidth));
-      guihckElementProperty(ctx, id, "source-height", scm_from_double(textureHeight));
-
-    }
-    else
-    {
-      free(sourceStr);
-    }
-  }
-
-  SCM width = guihckElementGetProperty(ctx, id, "width");
-  SCM height = guihckElementGetProperty(ctx, id, "height");
-
-  if(!scm_is_real(width))
-  {
-    width = guihckElementGetProperty(ctx, id, "source-width");
-    guihckElementProperty(ctx, id, "width", width);
-  }
-
-  if(!scm_is_real(height))
+  const char* source = (changed & IMAGE_SOURCE_CHANGED) ? guihckElementGetString(ctx, id, "source") : NULL;
+  if(source)
   {
-    height = guihckElementGetProperty(ctx, id, "source-height");
-    guihckElementProperty(ctx, id, "height", height);
+    glhckHandle texture = glhckTextureNewFromFile(source, NULL, glhckTextureDefaultSpriteParameters());
+    glhckMaterialTexture(glhckObjectGetMaterial(d->object), texture);
+    glhckHandleRelease(texture);
+    int textureWidth, textureHeight;
+    glhckTextureGetInformation(texture, NULL, &textureWidth, &textureHeight, NULL, NULL, NULL, NULL);
+    guihckElementProperty(ctx, id, "source-width", scm_from_double(textureWidth));
+    guihckElementProperty(ctx, id, "source-height", scm_from_double(textureHeight));
   }
 
-  float w = scm_is_real(width) ? scm_to_double(width) : 0;
-  float h = scm_is_real(height) ? scm_to_double(height) : 0;
+  if(!scm_is_real(guihckElementGetProperty(ctx, id, "width")))
+    guihckElementProperty(ctx, id, "width", guihckElementGetProperty(ctx, id, "source-width"));
 
-  SCM x = guihckElementGetProperty(ctx, id, "absolute-x");
-  SCM y = guihckElementGetProperty(ctx, id, "absolute-y");
+  if(!scm_is_real(guihckElementGetProperty(ctx, id, "height")))
+    guihckElementProperty(ctx, id, "height", guihckElementGetProperty(ctx, id, "source-height"));
 
   kmVec3 position = *glhckObjectGetPosition(d->object);
   kmVec3 scale = *glhckObjectGetScale(d->object);
-  scale.x = w/2;
-  scale.y = h/2;
-  if(scm_is_real(x)) position.x = scm_to_double(x) + scale.x;
-  if(scm_is_real(y)) position.y = scm_to_double(y) + scale.y;
+  scale.x = guihckElementGetFloat(ctx, id, "width")/2;
+  scale.y = guihckElementGetFloat(ctx, id, "height")/2;
+  position.x = guihckElementGetFloat(ctx, id, "absolute-x") + scale.x;
+  position.y = guihckElementGetFloat(ctx, id, "absolute-y") + scale.y;
 
   glhckObjectPosition(d->object, &position);
   glhckObjectScale(d->object, &scale);
-
-  SCM c = guihckElementGetProperty(ctx, id, "color");
-  if(scm_to_bool(scm_list_p(c)) && scm_to_int32(scm_length(c)) == 3)
-  {
-    glhckColor color = glhckMaterialGetDiffuse(glhckObjectGetMaterial(d->object));
-    SCM r = scm_list_ref(c, scm_from_int8(0));
-    SCM g = scm_list_ref(c, scm_from_int8(1));
-    SCM b = scm_list_ref(c, scm_from_int8(2));
-
-    unsigned char cr = (color & 0xFF000000) >> 24;
-    unsigned char cg = (color & 0x00FF0000) >> 16;
-    unsigned char cb = (color & 0x0000FF00) >> 8;
-    unsigned char ca = (color & 0x000000FF);
-
-    if(scm_to_bool(scm_integer_p(r))) cr = scm_to_uint8(r);
-    if(scm_to_bool(scm_integer_p(g))) cg = scm_to_uint8(g);
-    if(scm_to_bool(scm_integer_p(b))) cb = scm_to_uint8(b);
-
-    glhckColor newColor = (ca | (cb << 8) | (cg << 16) | (cr << 24));
-    glhckMaterialDiffuse(glhckObjectGetMaterial(d->object), newColor);
-  }
+  glhckMaterialDiffuse(glhckObjectGetMaterial(d->object), toGlhckColor(guihckElementGetColor(ctx, id, "color")));
 
   return false;
 }
 
 void renderImage(guihckContext* ctx, guihckElementId id, void* data)
 {
-  (void) ctx;
-  (void) id;
-
   _guihckGlhckImage* d = data;
-  glhckRenderObject(d->object);
+  renderTranslated(ctx, id, d->object);
 }
 
-void guihckGlhckAddTextInputType(guihckContext* ctx)
+void renderTranslated(guihckContext* ctx, guihckElementId id, glhckHandle object)
+{
+  float tx, ty;
+  guihckElementGetTranslation(ctx, id, &tx, &ty);
+  if(tx == 0 && ty == 0)
+  {
+    glhckRenderObject(object);
+    return;
+  }
+
+  /* Scrolled content is moved for the draw only, updates keep positioning it absolutely */
+  kmVec3 position = *glhckObjectGetPosition(object);
+  kmVec3 translated = position;
+  translated.x += tx;
+  translated.y += ty;
+  glhckObjectPosition(object, &translated);
+  glhckRenderObject(object);
+  glhckObjectPosition(object, &position);
+}
+
+void guihckGlhckRegisterTextInputType(guihckTypeRegistry* types)
 {
-  guihckContextExecuteScript(ctx, GUIHCK_GLHCK_TEXT_INPUT_SCM);
+  (void) types;
+  guihckLoadDefinitions(GUIHCK_SCM_TEXT_INPUT_NAME, GUIHCK_SCM_TEXT_INPUT);
 }
 
+glhckColor toGlhckColor(guihckColor color)
+{
+  return (color.a | (color.b << 8) | (color.g << 16) | ((glhckColor) color.r << 24));
+}
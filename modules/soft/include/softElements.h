@@ -0,0 +1,46 @@
+#ifndef GUIHCK_SOFT_ELEMENTS_H
+#define GUIHCK_SOFT_ELEMENTS_H
+
+#include "guihck.h"
+#include <stdint.h>
+
+/* Pixels are RGBA bytes in memory, 0xAABBGGRR read as a little endian uint32_t */
+#define GUIHCK_SOFT_RGBA(r, g, b, a) \
+  ((uint32_t) (r) | ((uint32_t) (g) << 8) | ((uint32_t) (b) << 16) | ((uint32_t) (a) << 24))
+
+typedef struct _guihckSoftTarget guihckSoftTarget;
+
+/* Returns malloc'd RGBA pixels or NULL if the file is not in a supported format */
+typedef uint32_t* (*guihckSoftImageLoader)(const char* path, int* width, int* height);
+
+void guihckSoftAddAllTypes(guihckContext* ctx);
+
+void guihckSoftAddRectangleType(guihckContext* ctx);
+void guihckSoftAddTextType(guihckContext* ctx);
+void guihckSoftAddImageType(guihckContext* ctx);
+void guihckSoftAddTextInputType(guihckContext* ctx);
+
+void guihckSoftRegisterAllTypes(guihckTypeRegistry* types);
+
+void guihckSoftRegisterRectangleType(guihckTypeRegistry* types);
+void guihckSoftRegisterTextType(guihckTypeRegistry* types);
+void guihckSoftRegisterImageType(guihckTypeRegistry* types);
+void guihckSoftRegisterTextInputType(guihckTypeRegistry* types);
+
+guihckSoftTarget* guihckSoftTargetNew(int width, int height);
+void guihckSoftTargetFree(guihckSoftTarget* target);
+void guihckSoftTargetClear(guihckSoftTarget* target, uint32_t color);
+uint32_t* guihckSoftTargetGetPixels(guihckSoftTarget* target, int* width, int* height);
+bool guihckSoftTargetSave(guihckSoftTarget* target, const char* path);
+
+/* Draws a retained command list emitted by this module's types */
+void guihckSoftTargetRenderCommands(guihckSoftTarget* target, const guihckRenderCommand* commands, size_t count);
+
+/* Elements render into the bound target of the calling thread, NULL renders nothing */
+void guihckSoftTargetBind(guihckSoftTarget* target);
+guihckSoftTarget* guihckSoftGetBoundTarget();
+
+/* Images are read with the loader first, binary PPM and PAM files are always supported */
+void guihckSoftImageLoaderSet(guihckSoftImageLoader loader);
+
+#endif
@@ -0,0 +1,657 @@
+#include "softInternal.h"
+#include "guihckElementUtils.h"
+#include "softElementsScm.h"
+#include "softFont.h"
+#include "lut.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef struct _guihckSoftGlyph
+{
+  uint8_t* coverage;
+  int width;
+  int height;
+  int left;
+  int top;
+  float advance;
+} _guihckSoftGlyph;
+
+typedef struct _guihckSoftImageData
+{
+  uint32_t* pixels;
+  int width;
+  int height;
+} _guihckSoftImageData;
+
+/* Glyphs are keyed by (pixel size << 8) | character, images by path */
+typedef struct _guihckSoftContext
+{
+  guihckSoftTarget* target;
+  guihckSoftImageLoader loader;
+  chckHashTable* glyphs;
+  chckHashTable* images;
+  int refs;
+} _guihckSoftContext;
+
+static _GUIHCK_SOFT_TLS _guihckSoftContext threadLocalContext = {NULL, NULL, NULL, NULL, 0};
+
+static void _guihckSoftContextRef();
+static void _guihckSoftContextUnref();
+static uint32_t _guihckSoftColor(guihckColor color);
+static void _guihckSoftEmit(guihckContext* ctx, guihckElementId id, guihckRenderCommandType type, float x, float y, float width, float height,
+                            uint32_t color, const void* texture, const char* text, float size);
+
+typedef struct _guihckSoftRectangle
+{
+  float x, y, width, height;
+  uint32_t color;
+} _guihckSoftRectangle;
+
+static const guihckPropertySchema rectangleSchema[] = {
+  {"absolute-x", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"absolute-y", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"width", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"height", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"color", GUIHCK_VALUE_COLOR, {.color = {255, 255, 255, 255}}, true}
+};
+
+static void initRectangle(guihckContext* ctx, guihckElementId id, void* data);
+static bool updateRectangle(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed);
+static void renderRectangle(guihckContext* ctx, guihckElementId id, void* data);
+
+typedef struct _guihckSoftText
+{
+  char* content;
+  float x, y, width, height;
+  int size;
+  uint32_t color;
+} _guihckSoftText;
+
+static const guihckPropertySchema textSchema[] = {
+  {"absolute-x", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"absolute-y", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"text", GUIHCK_VALUE_STRING, {.string = NULL}, true},
+  {"font", GUIHCK_VALUE_STRING, {.string = NULL}, true},
+  {"size", GUIHCK_VALUE_I32, {.i32 = 12}, true},
+  {"color", GUIHCK_VALUE_COLOR, {.color = {255, 255, 255, 255}}, true}
+};
+#define TEXT_LAYOUT_CHANGED (GUIHCK_PROPERTY_BIT(2) | GUIHCK_PROPERTY_BIT(4))
+
+static void initText(guihckContext* ctx, guihckElementId id, void* data);
+static void destroyText(guihckContext* ctx, guihckElementId id, void* data);
+static bool updateText(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed);
+static void renderText(guihckContext* ctx, guihckElementId id, void* data);
+static void _guihckSoftMeasureText(_guihckSoftText* d);
+static void drawText(guihckSoftTarget* target, float x, float y, int size, uint32_t color, const char* text);
+static const _guihckSoftGlyph* getGlyph(int size, unsigned char c);
+static unsigned char nextCharacter(const char** str);
+
+typedef struct _guihckSoftImage
+{
+  const _guihckSoftImageData* image;
+  float x, y, width, height;
+  uint32_t color;
+} _guihckSoftImage;
+
+static void initImage(guihckContext* ctx, guihckElementId id, void* data);
+static void destroyImage(guihckContext* ctx, guihckElementId id, void* data);
+static bool updateImage(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed);
+static void renderImage(guihckContext* ctx, guihckElementId id, void* data);
+static const _guihckSoftImageData* getImage(const char* path);
+
+/* Width and height fall back to the image size, they are checked for a value first */
+static const guihckPropertySchema imageSchema[] = {
+  {"absolute-x", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"absolute-y", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"width", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"height", GUIHCK_VALUE_F32, {.f32 = 0}, true},
+  {"color", GUIHCK_VALUE_COLOR, {.color = {255, 255, 255, 255}}, true},
+  {"source", GUIHCK_VALUE_STRING, {.string = NULL}, true}
+};
+#define IMAGE_SOURCE_CHANGED GUIHCK_PROPERTY_BIT(5)
+
+void guihckSoftAddAllTypes(guihckContext* ctx)
+{
+  guihckSoftRegisterAllTypes(guihckContextGetMutableTypes(ctx));
+}
+
+void guihckSoftAddRectangleType(guihckContext* ctx)
+{
+  guihckSoftRegisterRectangleType(guihckContextGetMutableTypes(ctx));
+}
+
+void guihckSoftAddTextType(guihckContext* ctx)
+{
+  guihckSoftRegisterTextType(guihckContextGetMutableTypes(ctx));
+}
+
+void guihckSoftAddImageType(guihckContext* ctx)
+{
+  guihckSoftRegisterImageType(guihckContextGetMutableTypes(ctx));
+}
+
+void guihckSoftAddTextInputType(guihckContext* ctx)
+{
+  guihckSoftRegisterTextInputType(guihckContextGetMutableTypes(ctx));
+}
+
+void guihckSoftRegisterAllTypes(guihckTypeRegistry* types)
+{
+  guihckSoftRegisterRectangleType(types);
+  guihckSoftRegisterTextType(types);
+  guihckSoftRegisterImageType(types);
+  guihckSoftRegisterTextInputType(types);
+}
+
+void guihckSoftTargetBind(guihckSoftTarget* target)
+{
+  threadLocalContext.target = target;
+}
+
+guihckSoftTarget* guihckSoftGetBoundTarget()
+{
+  return threadLocalContext.target;
+}
+
+void guihckSoftImageLoaderSet(guihckSoftImageLoader loader)
+{
+  threadLocalContext.loader = loader;
+}
+
+void guihckSoftTargetRenderCommands(guihckSoftTarget* target, const guihckRenderCommand* commands, size_t count)
+{
+  size_t i;
+  for(i = 0; i < count; ++i)
+  {
+    const guihckRenderCommand* command = &commands[i];
+    float x = command->x + target->translation.x;
+    float y = command->y + target->translation.y;
+    switch(command->type)
+    {
+      case GUIHCK_COMMAND_QUAD:
+        _guihckSoftFillRect(target, x, y, command->width, command->height, command->color);
+        break;
+      case GUIHCK_COMMAND_TEXTURED_QUAD:
+      {
+        const _guihckSoftImageData* image = command->texture;
+        if(image && image->pixels)
+          _guihckSoftBlitImage(target, x, y, command->width, command->height,
+                               image->pixels, image->width, image->height, command->color);
+        break;
+      }
+      case GUIHCK_COMMAND_TEXT:
+        if(command->text)
+          drawText(target, x, y, (int) command->size, command->color, command->text);
+        break;
+      case GUIHCK_COMMAND_CLIP_PUSH:
+        _guihckSoftPushClip(target, x, y, command->width, command->height);
+        break;
+      case GUIHCK_COMMAND_CLIP_POP:
+        _guihckSoftPopClip(target);
+        break;
+      case GUIHCK_COMMAND_TRANSFORM_PUSH:
+        _guihckSoftPushTranslation(target, command->x, command->y);
+        break;
+      case GUIHCK_COMMAND_TRANSFORM_POP:
+        _guihckSoftPopTranslation(target);
+        break;
+    }
+  }
+}
+
+void _guihckSoftEmit(guihckContext* ctx, guihckElementId id, guihckRenderCommandType type, float x, float y, float width, float height,
+                     uint32_t color, const void* texture, const char* text, float size)
+{
+  guihckRenderCommand command;
+  command.type = type;
+  command.elementId = id;
+  command.x = x;
+  command.y = y;
+  command.width = width;
+  command.height = height;
+  command.color = color;
+  command.texture = texture;
+  command.text = text;
+  command.size = size;
+
+  guihckElementClearCommands(ctx, id);
+  guihckElementAddCommand(ctx, id, &command);
+}
+
+void _guihckSoftContextRef()
+{
+  /* The caches are created on first use, glyphs can be measured before any text exists */
+  threadLocalContext.refs += 1;
+}
+
+void _guihckSoftContextUnref()
+{
+  threadLocalContext.refs -= 1;
+  if(threadLocalContext.refs > 0)
+    return;
+
+  if(threadLocalContext.glyphs)
+  {
+    chckHashTableIterator iter = {NULL, 0};
+    _guihckSoftGlyph* glyph;
+    while((glyph = chckHashTableIter(threadLocalContext.glyphs, &iter)))
+      free(glyph->coverage);
+    chckHashTableFree(threadLocalContext.glyphs);
+    threadLocalContext.glyphs = NULL;
+  }
+
+  if(threadLocalContext.images)
+  {
+    chckHashTableIterator imageIter = {NULL, 0};
+    _guihckSoftImageData** image;
+    while((image = chckHashTableIter(threadLocalContext.images, &imageIter)))
+    {
+      free((*image)->pixels);
+      free(*image);
+    }
+    chckHashTableFree(threadLocalContext.images);
+    threadLocalContext.images = NULL;
+  }
+}
+
+uint32_t _guihckSoftColor(guihckColor color)
+{
+  return GUIHCK_SOFT_RGBA(color.r, color.g, color.b, color.a);
+}
+
+void guihckSoftRegisterRectangleType(guihckTypeRegistry* types)
+{
+  guihckElementTypeFunctionMap functionMap = {
+    initRectangle,
+    NULL,
+    updateRectangle,
+    renderRectangle,
+    NULL,
+    NULL,
+    NULL,
+    NULL
+  };
+  guihckElementTypeId typeId = guihckTypeRegistryAddType(types, "rectangle", functionMap, sizeof(_guihckSoftRectangle));
+  guihckTypeRegistrySchema(types, typeId, rectangleSchema, sizeof(rectangleSchema) / sizeof(guihckPropertySchema));
+  guihckTypeRegistryEmitsCommands(types, typeId, true);
+
+  /* Text and images measure themselves for layouts, rectangles only draw */
+  guihckTypeRegistrySuspendHidden(types, typeId, GUIHCK_SUSPEND_UPDATE);
+  guihckLoadDefinitions(GUIHCK_SCM_RECTANGLE_NAME, GUIHCK_SCM_RECTANGLE);
+}
+
+void initRectangle(guihckContext* ctx, guihckElementId id, void* data)
+{
+  _guihckSoftRectangle* d = data;
+  memset(d, 0, sizeof(_guihckSoftRectangle));
+  d->color = GUIHCK_SOFT_RGBA(255, 255, 255, 255);
+
+  guihckElementAddParentPositionListeners(ctx, id);
+}
+
+bool updateRectangle(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
+{
+  (void) changed;
+
+  _guihckSoftRectangle* d = data;
+  d->x = guihckElementGetFloat(ctx, id, "absolute-x");
+  d->y = guihckElementGetFloat(ctx, id, "absolute-y");
+  d->width = guihckElementGetFloat(ctx, id, "width");
+  d->height = guihckElementGetFloat(ctx, id, "height");
+  d->color = _guihckSoftColor(guihckElementGetColor(ctx, id, "color"));
+
+  if(guihckContextGetRetainedRendering(ctx))
+    _guihckSoftEmit(ctx, id, GUIHCK_COMMAND_QUAD, d->x, d->y, d->width, d->height, d->color, NULL, NULL, 0);
+
+  return false;
+}
+
+void renderRectangle(guihckContext* ctx, guihckElementId id, void* data)
+{
+  _guihckSoftRectangle* d = data;
+  float tx, ty;
+  guihckElementGetTranslation(ctx, id, &tx, &ty);
+  if(threadLocalContext.target)
+    _guihckSoftFillRect(threadLocalContext.target, d->x + tx, d->y + ty, d->width, d->height, d->color);
+}
+
+
+void guihckSoftRegisterTextType(guihckTypeRegistry* types)
+{
+  guihckElementTypeFunctionMap functionMap = {
+    initText,
+    destroyText,
+    updateText,
+    renderText,
+    NULL,
+    NULL,
+    NULL,
+    NULL
+  };
+  guihckElementTypeId typeId = guihckTypeRegistryAddType(types, "text", functionMap, sizeof(_guihckSoftText));
+  guihckTypeRegistrySchema(types, typeId, textSchema, sizeof(textSchema) / sizeof(guihckPropertySchema));
+  guihckTypeRegistryEmitsCommands(types, typeId, true);
+  guihckLoadDefinitions(GUIHCK_SCM_TEXT_NAME, GUIHCK_SCM_TEXT);
+}
+
+void initText(guihckContext* ctx, guihckElementId id, void* data)
+{
+  _guihckSoftContextRef();
+
+  _guihckSoftText* d = data;
+  memset(d, 0, sizeof(_guihckSoftText));
+  d->size = 12;
+  d->color = GUIHCK_SOFT_RGBA(255, 255, 255, 255);
+
+  guihckElementAddParentPositionListeners(ctx, id);
+}
+
+void destroyText(guihckContext* ctx, guihckElementId id, void* data)
+{
+  (void) ctx;
+  (void) id;
+
+  _guihckSoftText* d = data;
+  if(d->content)
+    free(d->content);
+
+  _guihckSoftContextUnref();
+}
+
+bool updateText(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
+{
+  _guihckSoftText* d = data;
+
+  /* Only the built-in font is available, "font" is accepted and ignored.
+   * Moves and color changes keep the measured size */
+  if(changed & TEXT_LAYOUT_CHANGED)
+  {
+    const char* textContent = guihckElementGetString(ctx, id, "text");
+    free(d->content);
+    d->content = textContent ? strdup(textContent) : NULL;
+
+    int size = guihckElementGetInt(ctx, id, "size");
+    d->size = size < 1 ? 1 : size > 0xFFFF ? 0xFFFF : size;
+
+    _guihckSoftMeasureText(d);
+    guihckElementProperty(ctx, id, "width", scm_from_double(d->width));
+    guihckElementProperty(ctx, id, "height", scm_from_double(d->height));
+  }
+
+  d->x = guihckElementGetFloat(ctx, id, "absolute-x");
+  d->y = guihckElementGetFloat(ctx, id, "absolute-y");
+  d->color = _guihckSoftColor(guihckElementGetColor(ctx, id, "color"));
+
+  if(guihckContextGetRetainedRendering(ctx))
+    _guihckSoftEmit(ctx, id, GUIHCK_COMMAND_TEXT, d->x, d->y, d->width, d->height, d->color, NULL, d->content ? d->content : "", d->size);
+
+  return false;
+}
+
+void _guihckSoftMeasureText(_guihckSoftText* d)
+{
+  float w = 0;
+  float h = 0;
+  if(d->content && d->content[0])
+  {
+    float lineHeight = (float) (GUIHCK_SOFT_FONT_ASCENT + GUIHCK_SOFT_FONT_DESCENT) * d->size / GUIHCK_SOFT_FONT_PIXEL_SIZE;
+    float lineWidth = 0;
+    h = lineHeight;
+
+    const char* str = d->content;
+    unsigned char c;
+    while((c = nextCharacter(&str)))
+    {
+      if(c == '\n')
+      {
+        lineWidth = 0;
+        h += lineHeight;
+        continue;
+      }
+
+      lineWidth += getGlyph(d->size, c)->advance;
+      if(lineWidth > w)
+        w = lineWidth;
+    }
+
+    w = ceilf(w);
+    h = ceilf(h);
+  }
+
+  d->width = w;
+  d->height = h;
+}
+
+void renderText(guihckContext* ctx, guihckElementId id, void* data)
+{
+  _guihckSoftText* d = data;
+  float tx, ty;
+  guihckElementGetTranslation(ctx, id, &tx, &ty);
+  if(threadLocalContext.target && d->content)
+    drawText(threadLocalContext.target, d->x + tx, d->y + ty, d->size, d->color, d->content);
+}
+
+void drawText(guihckSoftTarget* target, float x, float y, int size, uint32_t color, const char* text)
+{
+  float scale = (float) size / GUIHCK_SOFT_FONT_PIXEL_SIZE;
+  float lineHeight = (GUIHCK_SOFT_FONT_ASCENT + GUIHCK_SOFT_FONT_DESCENT) * scale;
+  float baseline = y + GUIHCK_SOFT_FONT_ASCENT * scale;
+  float pen = x;
+
+  const char* str = text;
+  unsigned char c;
+  while((c = nextCharacter(&str)))
+  {
+    if(c == '\n')
+    {
+      pen = x;
+      baseline += lineHeight;
+      continue;
+    }
+
+    const _guihckSoftGlyph* glyph = getGlyph(size, c);
+    if(glyph->coverage)
+    {
+      int gx = (int) floorf(pen + 0.5f) + glyph->left;
+      int gy = (int) floorf(baseline + 0.5f) - glyph->top;
+      _guihckSoftBlendMask(target, gx, gy, glyph->coverage, glyph->width, glyph->height, color);
+    }
+    pen += glyph->advance;
+  }
+}
+
+const _guihckSoftGlyph* getGlyph(int size, unsigned char c)
+{
+  if(!threadLocalContext.glyphs)
+    threadLocalContext.glyphs = chckHashTableNew(256);
+
+  unsigned int key = ((unsigned int) size << 8) | c;
+  _guihckSoftGlyph* result = chckHashTableGet(threadLocalContext.glyphs, key);
+  if(result)
+    return result;
+
+  /* The atlas covers printable ASCII, everything else is drawn as '?' */
+  if(c < GUIHCK_SOFT_FONT_FIRST || c >= GUIHCK_SOFT_FONT_FIRST + GUIHCK_SOFT_FONT_COUNT)
+    c = '?';
+
+  const _guihckSoftFontGlyph* source = &GUIHCK_SOFT_FONT_GLYPHS[c - GUIHCK_SOFT_FONT_FIRST];
+  float scale = (float) size / GUIHCK_SOFT_FONT_PIXEL_SIZE;
+
+  _guihckSoftGlyph glyph;
+  glyph.advance = source->advance * scale / 64.0f;
+  glyph.left = (int) floorf(source->left * scale + 0.5f);
+  glyph.top = (int) floorf(source->top * scale + 0.5f);
+  glyph.width = (int) ceilf(source->width * scale);
+  glyph.height = (int) ceilf(source->height * scale);
+  glyph.coverage = NULL;
+
+  if(glyph.width > 0 && glyph.height > 0)
+  {
+    /* Box filter the atlas coverage, upscaling degenerates to nearest */
+    const uint8_t* atlas = GUIHCK_SOFT_FONT_COVERAGE + source->offset;
+    glyph.coverage = malloc(glyph.width * glyph.height);
+
+    int y;
+    for(y = 0; y < glyph.height; ++y)
+    {
+      int y0 = (int) (y / scale);
+      int y1 = (int) ((y + 1) / scale);
+      if(y0 >= source->height) y0 = source->height - 1;
+      if(y1 > source->height) y1 = source->height;
+      if(y1 <= y0) y1 = y0 + 1;
+
+      int x;
+      for(x = 0; x < glyph.width; ++x)
+      {
+        int x0 = (int) (x / scale);
+        int x1 = (int) ((x + 1) / scale);
+        if(x0 >= source->width) x0 = source->width - 1;
+        if(x1 > source->width) x1 = source->width;
+        if(x1 <= x0) x1 = x0 + 1;
+
+        unsigned int sum = 0;
+        int sy, sx;
+        for(sy = y0; sy < y1; ++sy)
+          for(sx = x0; sx < x1; ++sx)
+            sum += atlas[sy * source->width + sx];
+
+        glyph.coverage[y * glyph.width + x] = sum / ((y1 - y0) * (x1 - x0));
+      }
+    }
+  }
+
+  chckHashTableSet(threadLocalContext.glyphs, key, &glyph, sizeof(_guihckSoftGlyph));
+  return chckHashTableGet(threadLocalContext.glyphs, key);
+}
+
+unsigned char nextCharacter(const char** str)
+{
+  /* Multibyte UTF-8 sequences collapse into a single unsupported character */
+  const unsigned char* s = (const unsigned char*) *str;
+  if(!*s)
+    return 0;
+
+  unsigned char c = *s++;
+  if(c >= 0x80)
+  {
+    while((*s & 0xC0) == 0x80)
+      ++s;
+    c = 0x80;
+  }
+
+  *str = (const char*) s;
+  return c;
+}
+
+void guihckSoftRegisterImageType(guihckTypeRegistry* types)
+{
+  guihckElementTypeFunctionMap functionMap = {
+    initImage,
+    destroyImage,
+    updateImage,
+    renderImage,
+    NULL,
+    NULL,
+    NULL,
+    NULL
+  };
+  guihckElementTypeId typeId = guihckTypeRegistryAddType(types, "image", functionMap, sizeof(_guihckSoftImage));
+  guihckTypeRegistrySchema(types, typeId, imageSchema, sizeof(imageSchema) / sizeof(guihckPropertySchema));
+  guihckTypeRegistryEmitsCommands(types, typeId, true);
+  guihckLoadDefinitions(GUIHCK_SCM_IMAGE_NAME, GUIHCK_SCM_IMAGE);
+}
+
+void initImage(guihckContext* ctx, guihckElementId id, void* data)
+{
+  _guihckSoftContextRef();
+
+  _guihckSoftImage* d = data;
+  memset(d, 0, sizeof(_guihckSoftImage));
+  d->color = GUIHCK_SOFT_RGBA(255, 255, 255, 255);
+
+  guihckElementAddParentPositionListeners(ctx, id);
+}
+
+void destroyImage(guihckContext* ctx, guihckElementId id, void* data)
+{
+  (void) ctx;
+  (void) id;
+  (void) data;
+
+  _guihckSoftContextUnref();
+}
+
+bool updateImage(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
+{
+  _guihckSoftImage* d = data;
+
+  const char* source = (changed & IMAGE_SOURCE_CHANGED) ? guihckElementGetString(ctx, id, "source") : NULL;
+  if(source)
+  {
+    d->image = getImage(source);
+    guihckElementProperty(ctx, id, "source-width", scm_from_double(d->image->width));
+    guihckElementProperty(ctx, id, "source-height", scm_from_double(d->image->height));
+  }
+
+  if(!scm_is_real(guihckElementGetProperty(ctx, id, "width")))
+    guihckElementProperty(ctx, id, "width", guihckElementGetProperty(ctx, id, "source-width"));
+
+  if(!scm_is_real(guihckElementGetProperty(ctx, id, "height")))
+    guihckElementProperty(ctx, id, "height", guihckElementGetProperty(ctx, id, "source-height"));
+
+  d->width = guihckElementGetFloat(ctx, id, "width");
+  d->height = guihckElementGetFloat(ctx, id, "height");
+  d->x = guihckElementGetFloat(ctx, id, "absolute-x");
+  d->y = guihckElementGetFloat(ctx, id, "absolute-y");
+  d->color = _guihckSoftColor(guihckElementGetColor(ctx, id, "color"));
+
+  if(guihckContextGetRetainedRendering(ctx))
+    _guihckSoftEmit(ctx, id, GUIHCK_COMMAND_TEXTURED_QUAD, d->x, d->y, d->width, d->height, d->color, d->image, NULL, 0);
+
+  return false;
+}
+
+void renderImage(guihckContext* ctx, guihckElementId id, void* data)
+{
+  _guihckSoftImage* d = data;
+  float tx, ty;
+  guihckElementGetTranslation(ctx, id, &tx, &ty);
+  if(threadLocalContext.target && d->image && d->image->pixels)
+  {
+    _guihckSoftBlitImage(threadLocalContext.target, d->x + tx, d->y + ty, d->width, d->height,
+                         d->image->pixels, d->image->width, d->image->height, d->color);
+  }
+}
+
+const _guihckSoftImageData* getImage(const char* path)
+{
+  if(!threadLocalContext.images)
+    threadLocalContext.images = chckHashTableNew(16);
+
+  _guihckSoftImageData** result = chckHashTableStrGet(threadLocalContext.images, path);
+  if(result)
+    return *result;
+
+  /* Failed loads are cached too so a missing file is not retried every update,
+   * entries are allocated separately as elements keep pointers to them */
+  _guihckSoftImageData* image = calloc(1, sizeof(_guihckSoftImageData));
+  if(threadLocalContext.loader)
+    image->pixels = threadLocalContext.loader(path, &image->width, &image->height);
+  if(!image->pixels)
+    image->pixels = _guihckSoftLoadNetpbm(path, &image->width, &image->height);
+  if(!image->pixels)
+  {
+    image->width = 0;
+    image->height = 0;
+  }
+
+  chckHashTableStrSet(threadLocalContext.images, path, &image, sizeof(_guihckSoftImageData*));
+  return image;
+}
+
+void guihckSoftRegisterTextInputType(guihckTypeRegistry* types)
+{
+  (void) types;
+  guihckLoadDefinitions(GUIHCK_SCM_TEXT_INPUT_NAME, GUIHCK_SCM_TEXT_INPUT);
+}
@@ -0,0 +1,51 @@
+#ifndef GUIHCK_SOFT_INTERNAL_H
+#define GUIHCK_SOFT_INTERNAL_H
+
+#include "softElements.h"
+
+#if defined(_MSC_VER)
+# define _GUIHCK_SOFT_TLS __declspec(thread)
+#elif defined(__GNUC__)
+# define _GUIHCK_SOFT_TLS __thread
+#else
+# define _GUIHCK_SOFT_TLS
+# warning "No Thread-local storage! Multi-threaded guihck applications may have unexpected behaviour!"
+#endif
+
+typedef struct _guihckSoftClip
+{
+  int x0, y0, x1, y1;
+} _guihckSoftClip;
+
+typedef struct _guihckSoftTranslation
+{
+  float x, y;
+} _guihckSoftTranslation;
+
+struct _guihckSoftTarget
+{
+  uint32_t* pixels;
+  int width;
+  int height;
+  _guihckSoftClip clip; /* every primitive is limited to it */
+  _guihckSoftClip* clipStack;
+  size_t clipDepth;
+  size_t clipCapacity;
+  _guihckSoftTranslation translation; /* added to command positions */
+  _guihckSoftTranslation* translationStack;
+  size_t translationDepth;
+  size_t translationCapacity;
+};
+
+/* Rectangles are in pixels and clipped to the target, colors carry their alpha */
+void _guihckSoftFillRect(guihckSoftTarget* target, float x, float y, float width, float height, uint32_t color);
+void _guihckSoftBlendMask(guihckSoftTarget* target, int x, int y, const uint8_t* mask, int width, int height, uint32_t color);
+void _guihckSoftBlitImage(guihckSoftTarget* target, float x, float y, float width, float height,
+                          const uint32_t* pixels, int pixelsWidth, int pixelsHeight, uint32_t tint);
+void _guihckSoftPushClip(guihckSoftTarget* target, float x, float y, float width, float height);
+void _guihckSoftPopClip(guihckSoftTarget* target);
+void _guihckSoftPushTranslation(guihckSoftTarget* target, float x, float y);
+void _guihckSoftPopTranslation(guihckSoftTarget* target);
+uint32_t* _guihckSoftLoadNetpbm(const char* path, int* width, int* height);
+
+#endif
@@ -0,0 +1,362 @@
+#include "softInternal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+# include <emmintrin.h>
+# define _GUIHCK_SOFT_SSE2
+#endif
+
+/* Blending is source over: c = (s * a + d * (255 - a)) / 255 per channel,
+ * the alpha channel treats the source as 255 so it accumulates coverage. */
+
+static void _guihckSoftFillSpan(uint32_t* dst, int count, uint32_t color);
+static void _guihckSoftBlendSpan(uint32_t* dst, int count, uint32_t color);
+static uint32_t _guihckSoftBlendPixel(uint32_t dst, uint32_t color, unsigned int alpha);
+static int _guihckSoftRound(float value);
+static int _guihckSoftReadNetpbmNumber(FILE* file);
+
+guihckSoftTarget* guihckSoftTargetNew(int width, int height)
+{
+  if(width <= 0 || height <= 0)
+    return NULL;
+
+  guihckSoftTarget* target = calloc(1, sizeof(guihckSoftTarget));
+  target->pixels = calloc((size_t) width * height, sizeof(uint32_t));
+  target->width = width;
+  target->height = height;
+  target->clip.x1 = width;
+  target->clip.y1 = height;
+  return target;
+}
+
+void guihckSoftTargetFree(guihckSoftTarget* target)
+{
+  if(guihckSoftGetBoundTarget() == target)
+    guihckSoftTargetBind(NULL);
+
+  free(target->clipStack);
+  free(target->translationStack);
+  free(target->pixels);
+  free(target);
+}
+
+void guihckSoftTargetClear(guihckSoftTarget* target, uint32_t color)
+{
+  _guihckSoftFillSpan(target->pixels, target->width * target->height, color);
+}
+
+uint32_t* guihckSoftTargetGetPixels(guihckSoftTarget* target, int* width, int* height)
+{
+  if(width) *width = target->width;
+  if(height) *height = target->height;
+  return target->pixels;
+}
+
+bool guihckSoftTargetSave(guihckSoftTarget* target, const char* path)
+{
+  /* PAM keeps the alpha channel and needs no encoder */
+  FILE* file = fopen(path, "wb");
+  if(!file)
+    return false;
+
+  fprintf(file, "P7\nWIDTH %d\nHEIGHT %d\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n", target->width, target->height);
+
+  bool success = true;
+  unsigned char* row = malloc(target->width * 4);
+  int y;
+  for(y = 0; y < target->height && success; ++y)
+  {
+    const uint32_t* src = target->pixels + (size_t) y * target->width;
+    int x;
+    for(x = 0; x < target->width; ++x)
+    {
+      row[x * 4 + 0] = src[x] & 0xFF;
+      row[x * 4 + 1] = (src[x] >> 8) & 0xFF;
+      row[x * 4 + 2] = (src[x] >> 16) & 0xFF;
+      row[x * 4 + 3] = src[x] >> 24;
+    }
+    success = fwrite(row, 4, target->width, file) == (size_t) target->width;
+  }
+  free(row);
+
+  return fclose(file) == 0 && success;
+}
+
+void _guihckSoftFillRect(guihckSoftTarget* target, float x, float y, float width, float height, uint32_t color)
+{
+  int x0 = _guihckSoftRound(x), y0 = _guihckSoftRound(y);
+  int x1 = _guihckSoftRound(x + width), y1 = _guihckSoftRound(y + height);
+  if(x0 < target->clip.x0) x0 = target->clip.x0;
+  if(y0 < target->clip.y0) y0 = target->clip.y0;
+  if(x1 > target->clip.x1) x1 = target->clip.x1;
+  if(y1 > target->clip.y1) y1 = target->clip.y1;
+  if(x0 >= x1 || y0 >= y1 || (color >> 24) == 0)
+    return;
+
+  bool opaque = (color >> 24) == 0xFF;
+  int row;
+  for(row = y0; row < y1; ++row)
+  {
+    uint32_t* dst = target->pixels + (size_t) row * target->width + x0;
+    if(opaque)
+      _guihckSoftFillSpan(dst, x1 - x0, color);
+    else
+      _guihckSoftBlendSpan(dst, x1 - x0, color);
+  }
+}
+
+void _guihckSoftBlendMask(guihckSoftTarget* target, int x, int y, const uint8_t* mask, int width, int height, uint32_t color)
+{
+  int left = x < target->clip.x0 ? target->clip.x0 - x : 0;
+  int top = y < target->clip.y0 ? target->clip.y0 - y : 0;
+  int right = x + width > target->clip.x1 ? target->clip.x1 - x : width;
+  int bottom = y + height > target->clip.y1 ? target->clip.y1 - y : height;
+  unsigned int alpha = color >> 24;
+
+  int row;
+  for(row = top; row < bottom; ++row)
+  {
+    const uint8_t* coverage = mask + (size_t) row * width;
+    uint32_t* dst = target->pixels + (size_t) (y + row) * target->width + x;
+    int column;
+    for(column = left; column < right; ++column)
+    {
+      if(coverage[column])
+        dst[column] = _guihckSoftBlendPixel(dst[column], color, (coverage[column] * alpha + 127) / 255);
+    }
+  }
+}
+
+void _guihckSoftBlitImage(guihckSoftTarget* target, float x, float y, float width, float height,
+                          const uint32_t* pixels, int pixelsWidth, int pixelsHeight, uint32_t tint)
+{
+  int x0 = _guihckSoftRound(x), y0 = _guihckSoftRound(y);
+  int x1 = _guihckSoftRound(x + width), y1 = _guihckSoftRound(y + height);
+  if(x1 <= x0 || y1 <= y0 || pixelsWidth <= 0 || pixelsHeight <= 0)
+    return;
+
+  /* Nearest sampling in 16.16 fixed point, stepping from the unclipped origin */
+  int32_t stepX = (int32_t) (((int64_t) pixelsWidth << 16) / (x1 - x0));
+  int32_t stepY = (int32_t) (((int64_t) pixelsHeight << 16) / (y1 - y0));
+  int left = x0 < target->clip.x0 ? target->clip.x0 - x0 : 0;
+  int top = y0 < target->clip.y0 ? target->clip.y0 - y0 : 0;
+  int right = x1 > target->clip.x1 ? target->clip.x1 - x0 : x1 - x0;
+  int bottom = y1 > target->clip.y1 ? target->clip.y1 - y0 : y1 - y0;
+
+  unsigned int tr = tint & 0xFF, tg = (tint >> 8) & 0xFF, tb = (tint >> 16) & 0xFF, ta = tint >> 24;
+  bool plain = tint == 0xFFFFFFFF;
+
+  int row;
+  for(row = top; row < bottom; ++row)
+  {
+    const uint32_t* src = pixels + (size_t) ((row * (int64_t) stepY) >> 16) * pixelsWidth;
+    uint32_t* dst = target->pixels + (size_t) (y0 + row) * target->width + x0;
+    int column;
+    for(column = left; column < right; ++column)
+    {
+      uint32_t s = src[(column * (int64_t) stepX) >> 16];
+      unsigned int alpha = s >> 24;
+      if(!plain)
+      {
+        s = ((s & 0xFF) * tr / 255) | (((s >> 8 & 0xFF) * tg / 255) << 8) | (((s >> 16 & 0xFF) * tb / 255) << 16);
+        alpha = alpha * ta / 255;
+      }
+
+      if(alpha == 0xFF)
+        dst[column] = s | 0xFF000000;
+      else if(alpha > 0)
+        dst[column] = _guihckSoftBlendPixel(dst[column], s, alpha);
+    }
+  }
+}
+
+void _guihckSoftPushClip(guihckSoftTarget* target, float x, float y, float width, float height)
+{
+  if(target->clipDepth == target->clipCapacity)
+  {
+    target->clipCapacity = target->clipCapacity ? target->clipCapacity * 2 : 8;
+    target->clipStack = realloc(target->clipStack, target->clipCapacity * sizeof(_guihckSoftClip));
+  }
+  target->clipStack[target->clipDepth++] = target->clip;
+
+  /* Nested clips intersect, an empty one may end up inverted which clips everything */
+  int x0 = _guihckSoftRound(x), y0 = _guihckSoftRound(y);
+  int x1 = _guihckSoftRound(x + width), y1 = _guihckSoftRound(y + height);
+  if(x0 > target->clip.x0) target->clip.x0 = x0;
+  if(y0 > target->clip.y0) target->clip.y0 = y0;
+  if(x1 < target->clip.x1) target->clip.x1 = x1;
+  if(y1 < target->clip.y1) target->clip.y1 = y1;
+}
+
+void _guihckSoftPopClip(guihckSoftTarget* target)
+{
+  if(target->clipDepth > 0)
+    target->clip = target->clipStack[--target->clipDepth];
+}
+
+void _guihckSoftPushTranslation(guihckSoftTarget* target, float x, float y)
+{
+  if(target->translationDepth == target->translationCapacity)
+  {
+    target->translationCapacity = target->translationCapacity ? target->translationCapacity * 2 : 8;
+    target->translationStack = realloc(target->translationStack, target->translationCapacity * sizeof(_guihckSoftTranslation));
+  }
+  target->translationStack[target->translationDepth++] = target->translation;
+
+  /* Nested translations accumulate */
+  target->translation.x += x;
+  target->translation.y += y;
+}
+
+void _guihckSoftPopTranslation(guihckSoftTarget* target)
+{
+  if(target->translationDepth > 0)
+    target->translation = target->translationStack[--target->translationDepth];
+}
+
+uint32_t* _guihckSoftLoadNetpbm(const char* path, int* width, int* height)
+{
+  FILE* file = fopen(path, "rb");
+  if(!file)
+    return NULL;
+
+  char magic[2];
+  if(fread(magic, 1, 2, file) != 2 || magic[0] != 'P' || (magic[1] != '6' && magic[1] != '7'))
+  {
+    fclose(file);
+    return NULL;
+  }
+
+  int w = 0, h = 0, depth = 3, maxval = 0;
+  if(magic[1] == '6')
+  {
+    w = _guihckSoftReadNetpbmNumber(file);
+    h = _guihckSoftReadNetpbmNumber(file);
+    maxval = _guihckSoftReadNetpbmNumber(file);
+  }
+  else
+  {
+    char line[128];
+    while(fgets(line, sizeof(line), file) && strncmp(line, "ENDHDR", 6) != 0)
+    {
+      sscanf(line, "WIDTH %d", &w);
+      sscanf(line, "HEIGHT %d", &h);
+      sscanf(line, "DEPTH %d", &depth);
+      sscanf(line, "MAXVAL %d", &maxval);
+    }
+  }
+
+  if(w <= 0 || h <= 0 || maxval != 255 || (depth != 3 && depth != 4) || (size_t) w * h > (1u << 28))
+  {
+    fclose(file);
+    return NULL;
+  }
+
+  uint32_t* pixels = malloc((size_t) w * h * sizeof(uint32_t));
+  unsigned char* row = malloc((size_t) w * depth);
+  int y;
+  for(y = 0; y < h; ++y)
+  {
+    if(fread(row, depth, w, file) != (size_t) w)
+    {
+      free(row);
+      free(pixels);
+      fclose(file);
+      return NULL;
+    }
+
+    int x;
+    for(x = 0; x < w; ++x)
+    {
+      const unsigned char* p = row + x * depth;
+      pixels[(size_t) y * w + x] = GUIHCK_SOFT_RGBA(p[0], p[1], p[2], depth == 4 ? p[3] : 0xFF);
+    }
+  }
+
+  free(row);
+  fclose(file);
+  *width = w;
+  *height = h;
+  return pixels;
+}
+
+void _guihckSoftFillSpan(uint32_t* dst, int count, uint32_t color)
+{
+  int i = 0;
+#if defined(_GUIHCK_SOFT_SSE2)
+  __m128i c = _mm_set1_epi32((int) color);
+  for(; i + 4 <= count; i += 4)
+    _mm_storeu_si128((__m128i*) (dst + i), c);
+#endif
+  for(; i < count; ++i)
+    dst[i] = color;
+}
+
+void _guihckSoftBlendSpan(uint32_t* dst, int count, uint32_t color)
+{
+  unsigned int alpha = color >> 24;
+  int i = 0;
+#if defined(_GUIHCK_SOFT_SSE2)
+  /* Four pixels at a time in 16 bit lanes, x / 255 as (x + 128 + ((x + 128) >> 8)) >> 8 */
+  __m128i zero = _mm_setzero_si128();
+  __m128i source = _mm_unpacklo_epi8(_mm_set1_epi32((int) (color | 0xFF000000)), zero);
+  __m128i sourceTerm = _mm_mullo_epi16(source, _mm_set1_epi16((short) alpha));
+  __m128i inverse = _mm_set1_epi16((short) (255 - alpha));
+  __m128i bias = _mm_set1_epi16(128);
+  for(; i + 4 <= count; i += 4)
+  {
+    __m128i d = _mm_loadu_si128((const __m128i*) (dst + i));
+    __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inverse), sourceTerm), bias);
+    __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inverse), sourceTerm), bias);
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+    _mm_storeu_si128((__m128i*) (dst + i), _mm_packus_epi16(lo, hi));
+  }
+#endif
+  for(; i < count; ++i)
+    dst[i] = _guihckSoftBlendPixel(dst[i], color, alpha);
+}
+
+uint32_t _guihckSoftBlendPixel(uint32_t dst, uint32_t color, unsigned int alpha)
+{
+  uint32_t result = 0;
+  unsigned int inverse = 255 - alpha;
+  int shift;
+  for(shift = 0; shift < 32; shift += 8)
+  {
+    unsigned int s = shift == 24 ? 255 : (color >> shift) & 0xFF;
+    unsigned int x = s * alpha + ((dst >> shift) & 0xFF) * inverse + 128;
+    result |= ((x + (x >> 8)) >> 8) << shift;
+  }
+  return result;
+}
+
+int _guihckSoftRound(float value)
+{
+  return (int) floorf(value + 0.5f);
+}
+
+int _guihckSoftReadNetpbmNumber(FILE* file)
+{
+  int c;
+  do
+  {
+    c = fgetc(file);
+    if(c == '#')
+      while(c != '\n' && c != EOF)
+        c = fgetc(file);
+  }
+  while(c == ' ' || c == '\t' || c == '\n' || c == '\r');
+
+  int value = 0;
+  while(c >= '0' && c <= '9')
+  {
+    value = value * 10 + (c - '0');
+    c = fgetc(file);
+  }
+  return value;
+}
@@ -0,0 +1,580 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Generates softFont.h, a coverage atlas of the printable ASCII glyphs of a
+ * TrueType font rasterized at GLYPH_PIXEL_SIZE. Only what the default font
+ * needs is supported: cmap format 4, simple and composite glyf outlines. */
+
+#define GLYPH_PIXEL_SIZE 32
+#define FIRST_CHAR 32
+#define LAST_CHAR 126
+#define SUBSAMPLES 4
+#define CURVE_STEPS 8
+#define MAX_COMPONENT_DEPTH 4
+
+typedef struct _font
+{
+  const uint8_t* data;
+  size_t size;
+  uint32_t glyf;
+  uint32_t loca;
+  uint32_t hmtx;
+  uint32_t cmap;
+  int unitsPerEm;
+  int longLoca;
+  int numHMetrics;
+  int numGlyphs;
+  int ascender;
+  int descender;
+} _font;
+
+typedef struct _edge
+{
+  float x0, y0, x1, y1;
+} _edge;
+
+typedef struct _outline
+{
+  _edge* edges;
+  size_t count;
+  size_t capacity;
+} _outline;
+
+typedef struct _crossing
+{
+  float x;
+  int winding;
+} _crossing;
+
+static uint16_t readU16(const _font* font, uint32_t offset);
+static int16_t readS16(const _font* font, uint32_t offset);
+static uint32_t readU32(const _font* font, uint32_t offset);
+static uint32_t findTable(const _font* font, const char* tag);
+static int loadFont(_font* font);
+static int glyphIndex(const _font* font, int codepoint);
+static int glyphAdvance(const _font* font, int glyph);
+static uint32_t glyphOffset(const _font* font, int glyph, uint32_t* length);
+static void addEdge(_outline* outline, float x0, float y0, float x1, float y1);
+static void addQuad(_outline* outline, float x0, float y0, float cx, float cy, float x1, float y1);
+static int glyphOutline(const _font* font, int glyph, const float transform[6], _outline* outline, int depth);
+static int compareCrossings(const void* a, const void* b);
+static void rasterize(const _outline* outline, int left, int top, int width, int height, uint8_t* coverage);
+
+int main(int argc, char** argv)
+{
+  if(argc != 3)
+  {
+    fprintf(stderr, "Usage: %s <font.ttf> <output header>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  FILE* in = fopen(argv[1], "rb");
+  if(!in)
+  {
+    fprintf(stderr, "Could not open %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  fseek(in, 0, SEEK_END);
+  long size = ftell(in);
+  fseek(in, 0, SEEK_SET);
+  uint8_t* data = malloc(size > 0 ? size : 1);
+  if(size <= 0 || fread(data, 1, size, in) != (size_t) size)
+  {
+    fprintf(stderr, "Could not read %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+  fclose(in);
+
+  _font font;
+  font.data = data;
+  font.size = size;
+  if(!loadFont(&font))
+  {
+    fprintf(stderr, "%s is not a supported TrueType font\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  FILE* out = fopen(argv[2], "w");
+  if(!out)
+  {
+    fprintf(stderr, "Could not open %s\n", argv[2]);
+    return EXIT_FAILURE;
+  }
+
+  float scale = (float) GLYPH_PIXEL_SIZE / font.unitsPerEm;
+  fprintf(out, "/* Generated by softFontGen, do not edit */\n\n");
+  fprintf(out, "#define GUIHCK_SOFT_FONT_PIXEL_SIZE %d\n", GLYPH_PIXEL_SIZE);
+  fprintf(out, "#define GUIHCK_SOFT_FONT_ASCENT %d\n", (int) (font.ascender * scale + 0.5f));
+  fprintf(out, "#define GUIHCK_SOFT_FONT_DESCENT %d\n", (int) (-font.descender * scale + 0.5f));
+  fprintf(out, "#define GUIHCK_SOFT_FONT_FIRST %d\n", FIRST_CHAR);
+  fprintf(out, "#define GUIHCK_SOFT_FONT_COUNT %d\n\n", LAST_CHAR - FIRST_CHAR + 1);
+  fprintf(out, "typedef struct _guihckSoftFontGlyph\n{\n");
+  fprintf(out, "  unsigned int offset;\n  short width, height;\n  short left, top; /* from the pen position, top is up */\n");
+  fprintf(out, "  int advance; /* 1/64 pixels */\n} _guihckSoftFontGlyph;\n\n");
+
+  uint8_t* coverage = NULL;
+  size_t coverageSize = 0;
+  fprintf(out, "static const _guihckSoftFontGlyph GUIHCK_SOFT_FONT_GLYPHS[] = {\n");
+  int c;
+  for(c = FIRST_CHAR; c <= LAST_CHAR; ++c)
+  {
+    int glyph = glyphIndex(&font, c);
+    const float transform[6] = {scale, 0, 0, scale, 0, 0};
+    _outline outline = {NULL, 0, 0};
+    if(!glyphOutline(&font, glyph, transform, &outline, 0))
+    {
+      fprintf(stderr, "Could not read the outline of '%c'\n", c);
+      return EXIT_FAILURE;
+    }
+
+    int left = 0, top = 0, width = 0, height = 0;
+    if(outline.count > 0)
+    {
+      float minX = outline.edges[0].x0, maxX = minX, minY = outline.edges[0].y0, maxY = minY;
+      size_t e;
+      for(e = 0; e < outline.count; ++e)
+      {
+        const _edge* edge = &outline.edges[e];
+        if(edge->x0 < minX) minX = edge->x0;
+        if(edge->x0 > maxX) maxX = edge->x0;
+        if(edge->y0 < minY) minY = edge->y0;
+        if(edge->y0 > maxY) maxY = edge->y0;
+      }
+      left = (int) (minX < 0 ? minX - 1 : minX);
+      top = (int) (maxY + 1);
+      width = (int) (maxX + 1) - left + 1;
+      height = top - (int) (minY < 0 ? minY - 1 : minY) + 1;
+    }
+
+    coverage = realloc(coverage, coverageSize + width * height + 1);
+    rasterize(&outline, left, top, width, height, coverage + coverageSize);
+    fprintf(out, "  {%lu, %d, %d, %d, %d, %d}, /* '%s%c' */\n", (unsigned long) coverageSize, width, height, left, top,
+            (int) (glyphAdvance(&font, glyph) * scale * 64 + 0.5f), c == '\\' ? "\\" : "", c);
+    coverageSize += width * height;
+    free(outline.edges);
+  }
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "static const unsigned char GUIHCK_SOFT_FONT_COVERAGE[] = {");
+  size_t i;
+  for(i = 0; i < coverageSize; ++i)
+    fprintf(out, "%s%u,", i % 24 == 0 ? "\n  " : "", coverage[i]);
+  fprintf(out, "\n  0\n};\n");
+
+  free(coverage);
+  free(data);
+  return fclose(out) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+uint16_t readU16(const _font* font, uint32_t offset)
+{
+  if(offset + 2 > font->size)
+    return 0;
+  return (font->data[offset] << 8) | font->data[offset + 1];
+}
+
+int16_t readS16(const _font* font, uint32_t offset)
+{
+  return (int16_t) readU16(font, offset);
+}
+
+uint32_t readU32(const _font* font, uint32_t offset)
+{
+  return ((uint32_t) readU16(font, offset) << 16) | readU16(font, offset + 2);
+}
+
+uint32_t findTable(const _font* font, const char* tag)
+{
+  int count = readU16(font, 4);
+  int i;
+  for(i = 0; i < count; ++i)
+  {
+    uint32_t record = 12 + 16 * i;
+    if(record + 16 <= font->size && memcmp(font->data + record, tag, 4) == 0)
+      return readU32(font, record + 8);
+  }
+  return 0;
+}
+
+int loadFont(_font* font)
+{
+  uint32_t head = findTable(font, "head");
+  uint32_t hhea = findTable(font, "hhea");
+  uint32_t maxp = findTable(font, "maxp");
+  font->glyf = findTable(font, "glyf");
+  font->loca = findTable(font, "loca");
+  font->hmtx = findTable(font, "hmtx");
+  font->cmap = 0;
+  if(!head || !hhea || !maxp || !font->glyf || !font->loca || !font->hmtx)
+    return 0;
+
+  font->unitsPerEm = readU16(font, head + 18);
+  font->longLoca = readS16(font, head + 50);
+  font->ascender = readS16(font, hhea + 4);
+  font->descender = readS16(font, hhea + 6);
+  font->numHMetrics = readU16(font, hhea + 34);
+  font->numGlyphs = readU16(font, maxp + 4);
+
+  /* Unicode BMP subtable, Windows or Unicode platform */
+  uint32_t cmap = findTable(font, "cmap");
+  int count = cmap ? readU16(font, cmap + 2) : 0;
+  int i;
+  for(i = 0; i < count; ++i)
+  {
+    int platform = readU16(font, cmap + 4 + 8 * i);
+    int encoding = readU16(font, cmap + 6 + 8 * i);
+    uint32_t subtable = cmap + readU32(font, cmap + 8 + 8 * i);
+    if(((platform == 3 && encoding == 1) || platform == 0) && readU16(font, subtable) == 4)
+    {
+      font->cmap = subtable;
+      break;
+    }
+  }
+
+  return font->cmap && font->unitsPerEm > 0 && font->numHMetrics > 0;
+}
+
+int glyphIndex(const _font* font, int codepoint)
+{
+  uint32_t cmap = font->cmap;
+  int segments = readU16(font, cmap + 6) / 2;
+  uint32_t endCodes = cmap + 14;
+  uint32_t startCodes = endCodes + segments * 2 + 2;
+  uint32_t deltas = startCodes + segments * 2;
+  uint32_t rangeOffsets = deltas + segments * 2;
+
+  int i;
+  for(i = 0; i < segments; ++i)
+  {
+    if(codepoint > readU16(font, endCodes + i * 2))
+      continue;
+
+    int start = readU16(font, startCodes + i * 2);
+    if(codepoint < start)
+      return 0;
+
+    int delta = readS16(font, deltas + i * 2);
+    int rangeOffset = readU16(font, rangeOffsets + i * 2);
+    if(rangeOffset == 0)
+      return (codepoint + delta) & 0xFFFF;
+
+    int glyph = readU16(font, rangeOffsets + i * 2 + rangeOffset + (codepoint - start) * 2);
+    return glyph ? (glyph + delta) & 0xFFFF : 0;
+  }
+  return 0;
+}
+
+int glyphAdvance(const _font* font, int glyph)
+{
+  if(glyph >= font->numHMetrics)
+    glyph = font->numHMetrics - 1;
+  return readU16(font, font->hmtx + glyph * 4);
+}
+
+uint32_t glyphOffset(const _font* font, int glyph, uint32_t* length)
+{
+  uint32_t start, end;
+  if(font->longLoca)
+  {
+    start = readU32(font, font->loca + glyph * 4);
+    end = readU32(font, font->loca + glyph * 4 + 4);
+  }
+  else
+  {
+    start = readU16(font, font->loca + glyph * 2) * 2;
+    end = readU16(font, font->loca + glyph * 2 + 2) * 2;
+  }
+  *length = end > start ? end - start : 0;
+  return font->glyf + start;
+}
+
+void addEdge(_outline* outline, float x0, float y0, float x1, float y1)
+{
+  if(outline->count == outline->capacity)
+  {
+    outline->capacity = outline->capacity ? outline->capacity * 2 : 64;
+    outline->edges = realloc(outline->edges, outline->capacity * sizeof(_edge));
+  }
+  _edge edge = {x0, y0, x1, y1};
+  outline->edges[outline->count++] = edge;
+}
+
+void addQuad(_outline* outline, float x0, float y0, float cx, float cy, float x1, float y1)
+{
+  float px = x0, py = y0;
+  int i;
+  for(i = 1; i <= CURVE_STEPS; ++i)
+  {
+    float t = (float) i / CURVE_STEPS;
+    float u = 1 - t;
+    float x = u * u * x0 + 2 * u * t * cx + t * t * x1;
+    float y = u * u * y0 + 2 * u * t * cy + t * t * y1;
+    addEdge(outline, px, py, x, y);
+    px = x;
+    py = y;
+  }
+}
+
+int glyphOutline(const _font* font, int glyph, const float transform[6], _outline* outline, int depth)
+{
+  if(glyph >= font->numGlyphs || depth > MAX_COMPONENT_DEPTH)
+    return 0;
+
+  uint32_t length;
+  uint32_t offset = glyphOffset(font, glyph, &length);
+  if(length == 0)
+    return 1; /* empty glyph, like space */
+
+  int contours = readS16(font, offset);
+  if(contours < 0)
+  {
+    /* Composite, each component is another glyph with an offset and an optional scale */
+    uint32_t p = offset + 10;
+    int flags;
+    do
+    {
+      flags = readU16(font, p);
+      int component = readU16(font, p + 2);
+      p += 4;
+
+      float dx, dy;
+      if(flags & 0x0001)
+      {
+        dx = readS16(font, p);
+        dy = readS16(font, p + 2);
+        p += 4;
+      }
+      else
+      {
+        dx = (int8_t) font->data[p];
+        dy = (int8_t) font->data[p + 1];
+        p += 2;
+      }
+
+      float a = 1, b = 0, c = 0, d = 1;
+      if(flags & 0x0008)
+      {
+        a = d = readS16(font, p) / 16384.0f;
+        p += 2;
+      }
+      else if(flags & 0x0040)
+      {
+        a = readS16(font, p) / 16384.0f;
+        d = readS16(font, p + 2) / 16384.0f;
+        p += 4;
+      }
+      else if(flags & 0x0080)
+      {
+        a = readS16(font, p) / 16384.0f;
+        b = readS16(font, p + 2) / 16384.0f;
+        c = readS16(font, p + 4) / 16384.0f;
+        d = readS16(font, p + 6) / 16384.0f;
+        p += 8;
+      }
+
+      /* Only offsets given as x/y values are supported, point matching is not */
+      if(!(flags & 0x0002))
+        dx = dy = 0;
+
+      float combined[6] = {
+        transform[0] * a + transform[2] * b, transform[1] * a + transform[3] * b,
+        transform[0] * c + transform[2] * d, transform[1] * c + transform[3] * d,
+        transform[0] * dx + transform[2] * dy + transform[4], transform[1] * dx + transform[3] * dy + transform[5]
+      };
+      if(!glyphOutline(font, component, combined, outline, depth + 1))
+        return 0;
+    }
+    while(flags & 0x0020);
+    return 1;
+  }
+
+  uint32_t endPoints = offset + 10;
+  int pointCount = contours > 0 ? readU16(font, endPoints + (contours - 1) * 2) + 1 : 0;
+  uint32_t p = endPoints + contours * 2;
+  p += 2 + readU16(font, p); /* instructions */
+
+  uint8_t* flags = calloc(pointCount + 1, 1);
+  float* xs = calloc(pointCount + 1, sizeof(float));
+  float* ys = calloc(pointCount + 1, sizeof(float));
+
+  int i;
+  for(i = 0; i < pointCount && p < font->size;)
+  {
+    uint8_t flag = font->data[p++];
+    int repeat = (flag & 0x08) && p < font->size ? font->data[p++] : 0;
+    for(; repeat >= 0 && i < pointCount; --repeat)
+      flags[i++] = flag;
+  }
+
+  int value = 0;
+  for(i = 0; i < pointCount; ++i)
+  {
+    if(flags[i] & 0x02)
+    {
+      int delta = p < font->size ? font->data[p++] : 0;
+      value += (flags[i] & 0x10) ? delta : -delta;
+    }
+    else if(!(flags[i] & 0x10))
+    {
+      value += readS16(font, p);
+      p += 2;
+    }
+    xs[i] = value;
+  }
+
+  value = 0;
+  for(i = 0; i < pointCount; ++i)
+  {
+    if(flags[i] & 0x04)
+    {
+      int delta = p < font->size ? font->data[p++] : 0;
+      value += (flags[i] & 0x20) ? delta : -delta;
+    }
+    else if(!(flags[i] & 0x20))
+    {
+      value += readS16(font, p);
+      p += 2;
+    }
+    ys[i] = value;
+  }
+
+  for(i = 0; i < pointCount; ++i)
+  {
+    float x = xs[i], y = ys[i];
+    xs[i] = transform[0] * x + transform[2] * y + transform[4];
+    ys[i] = transform[1] * x + transform[3] * y + transform[5];
+  }
+
+  int start = 0;
+  int contour;
+  for(contour = 0; contour < contours; ++contour)
+  {
+    int end = readU16(font, endPoints + contour * 2);
+    int n = end - start + 1;
+    if(n < 2 || end >= pointCount)
+    {
+      start = end + 1;
+      continue;
+    }
+
+    /* Start from an on-curve point, or the midpoint of two off-curve ones */
+    float sx, sy;
+    int first = 0;
+    while(first < n && !(flags[start + first] & 0x01))
+      ++first;
+    if(first == n)
+    {
+      sx = (xs[start] + xs[start + 1]) / 2;
+      sy = (ys[start] + ys[start + 1]) / 2;
+      first = 0;
+    }
+    else
+    {
+      sx = xs[start + first];
+      sy = ys[start + first];
+      first += 1;
+    }
+
+    float px = sx, py = sy;
+    int hasControl = 0;
+    float cx = 0, cy = 0;
+    int k;
+    for(k = 0; k < n; ++k)
+    {
+      int index = start + (first + k) % n;
+      float x = xs[index], y = ys[index];
+      if(flags[index] & 0x01)
+      {
+        if(hasControl)
+          addQuad(outline, px, py, cx, cy, x, y);
+        else
+          addEdge(outline, px, py, x, y);
+        px = x;
+        py = y;
+        hasControl = 0;
+      }
+      else
+      {
+        if(hasControl)
+        {
+          float mx = (cx + x) / 2, my = (cy + y) / 2;
+          addQuad(outline, px, py, cx, cy, mx, my);
+          px = mx;
+          py = my;
+        }
+        cx = x;
+        cy = y;
+        hasControl = 1;
+      }
+    }
+
+    if(hasControl)
+      addQuad(outline, px, py, cx, cy, sx, sy);
+    else
+      addEdge(outline, px, py, sx, sy);
+
+    start = end + 1;
+  }
+
+  free(flags);
+  free(xs);
+  free(ys);
+  return 1;
+}
+
+int compareCrossings(const void* a, const void* b)
+{
+  float x = ((const _crossing*) a)->x;
+  float y = ((const _crossing*) b)->x;
+  return (x > y) - (x < y);
+}
+
+void rasterize(const _outline* outline, int left, int top, int width, int height, uint8_t* coverage)
+{
+  /* Nonzero winding, SUBSAMPLES x SUBSAMPLES samples per pixel */
+  memset(coverage, 0, width * height);
+  unsigned int* samples = calloc(width * height + 1, sizeof(unsigned int));
+  _crossing* crossings = malloc((outline->count + 1) * sizeof(_crossing));
+
+  int row;
+  for(row = 0; row < height * SUBSAMPLES; ++row)
+  {
+    float y = top - (row + 0.5f) / SUBSAMPLES;
+    size_t count = 0;
+    size_t e;
+    for(e = 0; e < outline->count; ++e)
+    {
+      const _edge* edge = &outline->edges[e];
+      if((edge->y0 <= y && edge->y1 > y) || (edge->y1 <= y && edge->y0 > y))
+      {
+        float t = (y - edge->y0) / (edge->y1 - edge->y0);
+        crossings[count].x = edge->x0 + t * (edge->x1 - edge->x0);
+        crossings[count].winding = edge->y1 > edge->y0 ? 1 : -1;
+        ++count;
+      }
+    }
+    qsort(crossings, count, sizeof(_crossing), compareCrossings);
+
+    int winding = 0;
+    size_t next = 0;
+    int column;
+    for(column = 0; column < width * SUBSAMPLES; ++column)
+    {
+      float x = left + (column + 0.5f) / SUBSAMPLES;
+      while(next < count && crossings[next].x <= x)
+        winding += crossings[next++].winding;
+      if(winding != 0)
+        samples[(row / SUBSAMPLES) * width + column / SUBSAMPLES] += 1;
+    }
+  }
+
+  int i;
+  for(i = 0; i < width * height; ++i)
+    coverage[i] = samples[i] * 255 / (SUBSAMPLES * SUBSAMPLES);
+
+  free(crossings);
+  free(samples);
+}
@@ -0,0 +1,553 @@
+#include "internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Animations are played at the start of guihckContextUpdate from the context
+ * time and write their values straight into the property. Scheme is only
+ * called back when an animation completes. Steps of a sequence live in the
+ * same pool and are played by their sequence. */
+
+#define _GUIHCK_SPRING_STEP (1.0 / 240.0)
+#define _GUIHCK_SPRING_MAX_ELAPSED 1.0
+#define _GUIHCK_SPRING_REST 0.001
+
+static guihckAnimationId _guihckAnimationAdd(guihckContext* ctx, _guihckAnimation* animation);
+static void _guihckAnimationFree(guihckContext* ctx, guihckAnimationId animationId);
+static void _guihckAnimationRun(guihckContext* ctx, guihckAnimationId animationId, double time);
+static void _guihckAnimationBegin(guihckContext* ctx, guihckAnimationId animationId, double time, bool reversed);
+static bool _guihckAnimationAdvance(guihckContext* ctx, guihckAnimationId animationId, double time, bool reversed, double* end);
+static bool _guihckAnimationAdvanceTween(guihckContext* ctx, _guihckAnimation* animation, double time, bool reversed, double* end);
+static bool _guihckAnimationAdvanceSpring(guihckContext* ctx, _guihckAnimation* animation, double time, double* end);
+static bool _guihckAnimationAdvanceSequence(guihckContext* ctx, guihckAnimationId animationId, double time, bool reversed, double* end);
+static void _guihckAnimationComplete(guihckContext* ctx, guihckAnimationId animationId);
+static void _guihckAnimationWrite(guihckContext* ctx, _guihckAnimation* animation, const _guihckAnimationValue* value);
+static bool _guihckAnimationValueFromScm(SCM value, _guihckAnimationValue* result);
+static double _guihckEase(guihckEasing easing, double t);
+
+guihckAnimationId guihckAnimationTween(guihckContext* ctx, guihckElementId elementId, const char* key, SCM from, SCM to,
+                                       double duration, guihckEasing easing)
+{
+  _guihckAnimation animation;
+  memset(&animation, 0, sizeof(_guihckAnimation));
+  if(!_guihckAnimationValueFromScm(to, &animation.tween.to))
+    return GUIHCK_NO_ANIMATION;
+
+  /* Without a usable start the current value is read when played */
+  animation.tween.fromCurrent = !_guihckAnimationValueFromScm(from, &animation.tween.from);
+  animation.kind = GUIHCK_ANIMATION_TWEEN;
+  animation.elementId = elementId;
+  animation.propertyName = _GUIHCK_STRDUP(ctx, GUIHCK_MEMORY_ANIMATIONS, key);
+  animation.tween.duration = duration > 0 ? duration : 0;
+  animation.tween.easing = easing;
+  return _guihckAnimationAdd(ctx, &animation);
+}
+
+guihckAnimationId guihckAnimationSpring(guihckContext* ctx, guihckElementId elementId, const char* key, SCM to,
+                                        double stiffness, double damping)
+{
+  _guihckAnimation animation;
+  memset(&animation, 0, sizeof(_guihckAnimation));
+  if(!_guihckAnimationValueFromScm(to, &animation.spring.to))
+    return GUIHCK_NO_ANIMATION;
+
+  animation.kind = GUIHCK_ANIMATION_SPRING;
+  animation.elementId = elementId;
+  animation.propertyName = _GUIHCK_STRDUP(ctx, GUIHCK_MEMORY_ANIMATIONS, key);
+  animation.spring.stiffness = stiffness;
+  animation.spring.damping = damping;
+  return _guihckAnimationAdd(ctx, &animation);
+}
+
+guihckAnimationId guihckAnimationSequence(guihckContext* ctx, const guihckAnimationId* steps, size_t count)
+{
+  _guihckAnimation animation;
+  memset(&animation, 0, sizeof(_guihckAnimation));
+  animation.kind = GUIHCK_ANIMATION_SEQUENCE;
+  animation.elementId = GUIHCK_NO_PARENT;
+  animation.sequence.steps = _GUIHCK_CALLOC(ctx, GUIHCK_MEMORY_ANIMATIONS, (count ? count : 1) * sizeof(guihckAnimationId));
+
+  size_t i;
+  for(i = 0; i < count; ++i)
+  {
+    _guihckAnimation* step = ctx->animations ? chckPoolGet(ctx->animations, steps[i]) : NULL;
+    if(!step || step->owner != GUIHCK_NO_ANIMATION)
+      continue;
+
+    /* The sequence goes away with the element of its first step */
+    if(animation.elementId == GUIHCK_NO_PARENT)
+      animation.elementId = step->elementId;
+
+    step->running = false;
+    animation.sequence.steps[animation.sequence.count++] = steps[i];
+  }
+
+  guihckAnimationId id = _guihckAnimationAdd(ctx, &animation);
+  for(i = 0; i < animation.sequence.count; ++i)
+  {
+    _guihckAnimation* step = chckPoolGet(ctx->animations, animation.sequence.steps[i]);
+    step->owner = id;
+  }
+  return id;
+}
+
+void guihckAnimationRepeat(guihckContext* ctx, guihckAnimationId animationId, int count, bool alternate)
+{
+  _guihckAnimation* animation = ctx->animations ? chckPoolGet(ctx->animations, animationId) : NULL;
+  if(!animation)
+    return;
+
+  animation->repeat = count;
+  animation->alternate = alternate;
+}
+
+void guihckAnimationOnComplete(guihckContext* ctx, guihckAnimationId animationId, guihckAnimationCallback callback, void* data,
+                               guihckAnimationFreeCallback freeCallback)
+{
+  _guihckAnimation* animation = ctx->animations ? chckPoolGet(ctx->animations, animationId) : NULL;
+  if(!animation)
+    return;
+
+  if(animation->freeCallback)
+    animation->freeCallback(ctx, animationId, animation->data);
+
+  animation->onComplete = callback;
+  animation->data = data;
+  animation->freeCallback = freeCallback;
+}
+
+void guihckAnimationStart(guihckContext* ctx, guihckAnimationId animationId)
+{
+  _guihckAnimation* animation = ctx->animations ? chckPoolGet(ctx->animations, animationId) : NULL;
+  if(!animation || animation->owner != GUIHCK_NO_ANIMATION)
+    return;
+
+  animation->running = true;
+  animation->played = 0;
+  animation->reversed = false;
+  _guihckAnimationBegin(ctx, animationId, ctx->time, false);
+}
+
+void guihckAnimationStop(guihckContext* ctx, guihckAnimationId animationId)
+{
+  _guihckAnimation* animation = ctx->animations ? chckPoolGet(ctx->animations, animationId) : NULL;
+  if(animation)
+    animation->running = false;
+}
+
+bool guihckAnimationGetRunning(guihckContext* ctx, guihckAnimationId animationId)
+{
+  _guihckAnimation* animation = ctx->animations ? chckPoolGet(ctx->animations, animationId) : NULL;
+  return animation && animation->running;
+}
+
+void guihckAnimationRemove(guihckContext* ctx, guihckAnimationId animationId)
+{
+  _guihckAnimation* animation = ctx->animations ? chckPoolGet(ctx->animations, animationId) : NULL;
+  if(!animation)
+    return;
+
+  /* Steps are removed with their sequence */
+  if(animation->owner != GUIHCK_NO_ANIMATION)
+    return;
+
+  _guihckAnimationFree(ctx, animationId);
+}
+
+void _guihckAnimationAutoRemove(guihckContext* ctx, guihckAnimationId animationId)
+{
+  _guihckAnimation* animation = ctx->animations ? chckPoolGet(ctx->animations, animationId) : NULL;
+  if(animation)
+    animation->autoRemove = true;
+}
+
+void _guihckAnimationsUpdate(guihckContext* ctx)
+{
+  if(!ctx->animations)
+    return;
+
+  chckPoolIndex iter = 0;
+  _guihckAnimation* animation;
+  while((animation = chckPoolIter(ctx->animations, &iter)))
+  {
+    if(animation->running && animation->owner == GUIHCK_NO_ANIMATION)
+      _guihckAnimationRun(ctx, iter - 1, ctx->time);
+  }
+}
+
+void _guihckAnimationsElementRemoved(guihckContext* ctx, guihckElementId elementId)
+{
+  if(!ctx->animations || chckPoolCount(ctx->animations) == 0)
+    return;
+
+  chckPoolIndex iter = 0;
+  _guihckAnimation* animation;
+  while((animation = chckPoolIter(ctx->animations, &iter)))
+  {
+    if(animation->elementId != elementId)
+      continue;
+
+    /* Steps of other elements' sequences keep their timing but write nothing */
+    animation->elementId = GUIHCK_NO_PARENT;
+    if(animation->owner == GUIHCK_NO_ANIMATION)
+      _guihckAnimationFree(ctx, iter - 1);
+  }
+}
+
+void _guihckAnimationsFree(guihckContext* ctx)
+{
+  if(!ctx->animations)
+    return;
+
+  chckPoolIndex iter = 0;
+  _guihckAnimation* animation;
+  while((animation = chckPoolIter(ctx->animations, &iter)))
+  {
+    if(animation->owner == GUIHCK_NO_ANIMATION)
+      _guihckAnimationFree(ctx, iter - 1);
+  }
+
+  chckPoolFree(ctx->animations);
+  ctx->animations = NULL;
+}
+
+guihckAnimationId _guihckAnimationAdd(guihckContext* ctx, _guihckAnimation* animation)
+{
+  if(!ctx->animations)
+    ctx->animations = chckPoolNew(16, 16, sizeof(_guihckAnimation));
+
+  animation->owner = GUIHCK_NO_ANIMATION;
+  animation->repeat = 1;
+
+  guihckAnimationId id = GUIHCK_NO_ANIMATION;
+  chckPoolAdd(ctx->animations, animation, &id);
+  _GUIHCK_PROFILE_COUNT(ctx, allocations);
+  _GUIHCK_MEMORY_COUNT(ctx, GUIHCK_MEMORY_ANIMATIONS, sizeof(_guihckAnimation));
+  return id;
+}
+
+void _guihckAnimationFree(guihckContext* ctx, guihckAnimationId animationId)
+{
+  _guihckAnimation* animation = chckPoolGet(ctx->animations, animationId);
+  if(animation->freeCallback)
+    animation->freeCallback(ctx, animationId, animation->data);
+
+  animation = chckPoolGet(ctx->animations, animationId);
+  if(animation->kind == GUIHCK_ANIMATION_SEQUENCE)
+  {
+    guihckAnimationId* steps = animation->sequence.steps;
+    size_t count = animation->sequence.count;
+    size_t i;
+    for(i = 0; i < count; ++i)
+      _guihckAnimationFree(ctx, steps[i]);
+    _GUIHCK_FREE(ctx, steps);
+  }
+  else
+  {
+    _GUIHCK_FREE(ctx, animation->propertyName);
+  }
+
+  chckPoolRemove(ctx->animations, animationId);
+  _GUIHCK_MEMORY_UNCOUNT(ctx, GUIHCK_MEMORY_ANIMATIONS, sizeof(_guihckAnimation));
+}
+
+void _guihckAnimationRun(guihckContext* ctx, guihckAnimationId animationId, double time)
+{
+  for(;;)
+  {
+    _guihckAnimation* animation = chckPoolGet(ctx->animations, animationId);
+    double end;
+    if(!_guihckAnimationAdvance(ctx, animationId, time, animation->reversed, &end))
+      return;
+
+    /* Completion callbacks of steps may have removed it */
+    animation = chckPoolGet(ctx->animations, animationId);
+    if(!animation || !animation->running)
+      return;
+
+    animation->played += 1;
+    if(animation->repeat < 0 || animation->played < animation->repeat)
+    {
+      /* A loop without length would spin, the next one waits for the next update */
+      bool empty = end <= animation->start;
+      if(animation->alternate)
+        animation->reversed = !animation->reversed;
+      _guihckAnimationBegin(ctx, animationId, end, animation->reversed);
+      if(empty)
+        return;
+      continue;
+    }
+
+    animation->running = false;
+    _guihckAnimationComplete(ctx, animationId);
+    return;
+  }
+}
+
+void _guihckAnimationBegin(guihckContext* ctx, guihckAnimationId animationId, double time, bool reversed)
+{
+  _guihckAnimation* animation = chckPoolGet(ctx->animations, animationId);
+  animation->start = time;
+
+  switch(animation->kind)
+  {
+    case GUIHCK_ANIMATION_TWEEN:
+    {
+      /* Played backwards the tween returns to where it started */
+      if(animation->tween.fromCurrent && !reversed && animation->elementId != GUIHCK_NO_PARENT)
+      {
+        SCM current = guihckElementGetProperty(ctx, animation->elementId, animation->propertyName);
+        if(!_guihckAnimationValueFromScm(current, &animation->tween.from) || animation->tween.from.count != animation->tween.to.count)
+          animation->tween.from = animation->tween.to;
+      }
+      break;
+    }
+    case GUIHCK_ANIMATION_SPRING:
+    {
+      SCM current = animation->elementId != GUIHCK_NO_PARENT
+          ? guihckElementGetProperty(ctx, animation->elementId, animation->propertyName) : SCM_UNDEFINED;
+      if(!_guihckAnimationValueFromScm(current, &animation->spring.value) || animation->spring.value.count != animation->spring.to.count)
+        animation->spring.value = animation->spring.to;
+      memset(animation->spring.velocity, 0, sizeof(animation->spring.velocity));
+      animation->spring.time = time;
+      break;
+    }
+    case GUIHCK_ANIMATION_SEQUENCE:
+    {
+      if(animation->sequence.count == 0)
+        break;
+
+      animation->sequence.index = reversed ? animation->sequence.count - 1 : 0;
+      _guihckAnimationBegin(ctx, animation->sequence.steps[animation->sequence.index], time, reversed);
+      break;
+    }
+  }
+}
+
+bool _guihckAnimationAdvance(guihckContext* ctx, guihckAnimationId animationId, double time, bool reversed, double* end)
+{
+  _guihckAnimation* animation = chckPoolGet(ctx->animations, animationId);
+  switch(animation->kind)
+  {
+    case GUIHCK_ANIMATION_TWEEN:
+      return _guihckAnimationAdvanceTween(ctx, animation, time, reversed, end);
+    case GUIHCK_ANIMATION_SPRING:
+      return _guihckAnimationAdvanceSpring(ctx, animation, time, end);
+    case GUIHCK_ANIMATION_SEQUENCE:
+      return _guihckAnimationAdvanceSequence(ctx, animationId, time, reversed, end);
+  }
+  return true;
+}
+
+bool _guihckAnimationAdvanceTween(guihckContext* ctx, _guihckAnimation* animation, double time, bool reversed, double* end)
+{
+  double duration = animation->tween.duration;
+  double progress = duration > 0 ? (time - animation->start) / duration : 1;
+  bool done = progress >= 1;
+  if(progress < 0) progress = 0;
+  if(progress > 1) progress = 1;
+
+  double eased = _guihckEase(animation->tween.easing, reversed ? 1 - progress : progress);
+  const _guihckAnimationValue* from = &animation->tween.from;
+  const _guihckAnimationValue* to = &animation->tween.to;
+
+  _guihckAnimationValue value = *to;
+  value.integral = from->integral && to->integral;
+  size_t i;
+  for(i = 0; i < value.count; ++i)
+    value.components[i] = from->components[i] + (to->components[i] - from->components[i]) * eased;
+
+  /* Listeners of the property may add animations and move this one */
+  if(done)
+    *end = animation->start + duration;
+
+  _guihckAnimationWrite(ctx, animation, &value);
+  return done;
+}
+
+bool _guihckAnimationAdvanceSpring(guihckContext* ctx, _guihckAnimation* animation, double time, double* end)
+{
+  /* Semi-implicit Euler in fixed steps, long stalls are not integrated in full */
+  double elapsed = time - animation->spring.time;
+  if(elapsed > _GUIHCK_SPRING_MAX_ELAPSED)
+    elapsed = _GUIHCK_SPRING_MAX_ELAPSED;
+  animation->spring.time = time;
+
+  _guihckAnimationValue* value = &animation->spring.value;
+  const _guihckAnimationValue* to = &animation->spring.to;
+  double* velocity = animation->spring.velocity;
+  size_t i;
+
+  while(elapsed > 0)
+  {
+    double dt = elapsed < _GUIHCK_SPRING_STEP ? elapsed : _GUIHCK_SPRING_STEP;
+    elapsed -= dt;
+    for(i = 0; i < value->count; ++i)
+    {
+      double acceleration = -animation->spring.stiffness * (value->components[i] - to->components[i])
+          - animation->spring.damping * velocity[i];
+      velocity[i] += acceleration * dt;
+      value->components[i] += velocity[i] * dt;
+    }
+  }
+
+  bool rest = true;
+  for(i = 0; i < value->count && rest; ++i)
+  {
+    double scale = to->components[i] < 0 ? -to->components[i] : to->components[i];
+    double limit = _GUIHCK_SPRING_REST * (scale > 1 ? scale : 1);
+    double offset = value->components[i] - to->components[i];
+    rest = offset < limit && offset > -limit && velocity[i] < limit && velocity[i] > -limit;
+  }
+
+  if(rest)
+    *value = *to;
+
+  value->integral = to->integral;
+  _guihckAnimationWrite(ctx, animation, value);
+
+  if(rest)
+    *end = time;
+  return rest;
+}
+
+bool _guihckAnimationAdvanceSequence(guihckContext* ctx, guihckAnimationId animationId, double time, bool reversed, double* end)
+{
+  for(;;)
+  {
+    _guihckAnimation* animation = chckPoolGet(ctx->animations, animationId);
+    if(animation->sequence.count == 0)
+    {
+      *end = animation->start;
+      return true;
+    }
+
+    guihckAnimationId stepId = animation->sequence.steps[animation->sequence.index];
+    double stepEnd;
+    if(!_guihckAnimationAdvance(ctx, stepId, time, reversed, &stepEnd))
+      return false;
+
+    _guihckAnimationComplete(ctx, stepId);
+
+    /* Callbacks may have stopped or removed the sequence */
+    animation = chckPoolGet(ctx->animations, animationId);
+    if(!animation || (!animation->running && animation->owner == GUIHCK_NO_ANIMATION))
+      return false;
+
+    bool last = reversed ? animation->sequence.index == 0 : animation->sequence.index + 1 == animation->sequence.count;
+    if(last)
+    {
+      *end = stepEnd;
+      return true;
+    }
+
+    animation->sequence.index += reversed ? -1 : 1;
+    _guihckAnimationBegin(ctx, animation->sequence.steps[animation->sequence.index], stepEnd, reversed);
+  }
+}
+
+void _guihckAnimationComplete(guihckContext* ctx, guihckAnimationId animationId)
+{
+  _guihckAnimation* animation = chckPoolGet(ctx->animations, animationId);
+  if(animation->onComplete)
+  {
+    _GUIHCK_TRACE_BEGIN(ctx, "animation", "on-complete", animation->elementId);
+    animation->onComplete(ctx, animationId, animation->elementId, animation->data);
+    _GUIHCK_TRACE_END(ctx, "animation");
+    animation = chckPoolGet(ctx->animations, animationId);
+  }
+
+  if(animation && animation->autoRemove && !animation->running && animation->owner == GUIHCK_NO_ANIMATION)
+    _guihckAnimationFree(ctx, animationId);
+}
+
+void _guihckAnimationWrite(guihckContext* ctx, _guihckAnimation* animation, const _guihckAnimationValue* value)
+{
+  if(animation->elementId == GUIHCK_NO_PARENT)
+    return;
+
+  /* Hidden elements catch up on the first write after they are shown */
+  _guihckElement* element = chckPoolGet(ctx->elements, animation->elementId);
+  if(!element || element->hidden)
+    return;
+
+  SCM components[_GUIHCK_ANIMATION_MAX_COMPONENTS];
+  size_t i;
+  for(i = 0; i < value->count; ++i)
+  {
+    double component = value->components[i];
+    if(value->integral)
+      components[i] = scm_from_int64((int64_t) (component < 0 ? component - 0.5 : component + 0.5));
+    else
+      components[i] = scm_from_double(component);
+  }
+
+  SCM result = components[0];
+  if(value->list)
+  {
+    result = SCM_EOL;
+    while(i > 0)
+      result = scm_cons(components[--i], result);
+  }
+
+  _guihckElementPropertyAssign(ctx, animation->elementId, animation->propertyName, result);
+}
+
+bool _guihckAnimationValueFromScm(SCM value, _guihckAnimationValue* result)
+{
+  memset(result, 0, sizeof(_guihckAnimationValue));
+  if(scm_is_real(value))
+  {
+    result->count = 1;
+    result->components[0] = scm_to_double(value);
+    result->integral = scm_is_integer(value) && scm_is_true(scm_exact_p(value));
+    return true;
+  }
+
+  /* Colors and other short lists of numbers */
+  result->list = true;
+  result->integral = true;
+  for(; scm_is_pair(value); value = scm_cdr(value))
+  {
+    SCM component = scm_car(value);
+    if(!scm_is_real(component) || result->count == _GUIHCK_ANIMATION_MAX_COMPONENTS)
+      return false;
+
+    result->components[result->count++] = scm_to_double(component);
+    result->integral = result->integral && scm_is_integer(component) && scm_is_true(scm_exact_p(component));
+  }
+
+  return result->count > 0 && scm_is_null(value);
+}
+
+double _guihckEase(guihckEasing easing, double t)
+{
+  switch(easing)
+  {
+    case GUIHCK_EASING_LINEAR:
+      return t;
+    case GUIHCK_EASING_IN_QUAD:
+      return t * t;
+    case GUIHCK_EASING_OUT_QUAD:
+      return t * (2 - t);
+    case GUIHCK_EASING_IN_OUT_QUAD:
+      return t < 0.5 ? 2 * t * t : -1 + (4 - 2 * t) * t;
+    case GUIHCK_EASING_IN_CUBIC:
+      return t * t * t;
+    case GUIHCK_EASING_OUT_CUBIC:
+    {
+      double u = t - 1;
+      return u * u * u + 1;
+    }
+    case GUIHCK_EASING_IN_OUT_CUBIC:
+    {
+      if(t < 0.5)
+        return 4 * t * t * t;
+      double u = 2 * t - 2;
+      return 0.5 * u * u * u + 1;
+    }
+    case GUIHCK_EASING_STEP:
+      return t < 1 ? 0 : 1;
+  }
+  return t;
+}
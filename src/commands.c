@@ -0,0 +1,309 @@
+#include "internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Each element keeps the commands it emitted, the context list concatenates
+ * them in render order. A changed element whose span kept its size is copied
+ * over the old one, anything else rebuilds the list.
+ *
+ * Around a span the list holds the element's clip, then its span, then the
+ * child offset and its children, closed by pops in reverse order. */
+
+static void _guihckElementCommandsTouch(guihckContext* ctx, guihckElementId elementId, _guihckElement* element);
+static void _guihckElementCommandsClear(_guihckElementCommands* commands);
+static void _guihckCommandsAppend(guihckContext* ctx, guihckElementId elementId);
+static guihckRenderCommand* _guihckCommandListReserve(_guihckCommandList* list, size_t count);
+static void _guihckCommandListPush(_guihckCommandList* list, guihckElementId elementId, guihckRenderCommandType type, const _guihckRect* rect);
+
+bool guihckContextRetainedRendering(guihckContext* ctx, bool enabled)
+{
+  if(enabled && !ctx->commands)
+  {
+    /* The backend only draws commands, elements of a type drawing in render would be missing */
+    chckPoolIndex typeIter = 0;
+    _guihckElementType* type;
+    while((type = chckPoolIter(ctx->types->elementTypes, &typeIter)))
+    {
+      if(type->functionMap.render && !type->emitsCommands)
+        return false;
+    }
+
+    ctx->commands = calloc(1, sizeof(_guihckCommandList));
+    ctx->commands->rebuild = true;
+
+    /* Types emit their commands when updated */
+    chckPoolIndex iter = 0;
+    _guihckElement* element;
+    while((element = chckPoolIter(ctx->elements, &iter)))
+      element->changed = GUIHCK_PROPERTY_MASK_ALL;
+  }
+  else if(!enabled && ctx->commands)
+  {
+    chckPoolIndex iter = 0;
+    _guihckElement* element;
+    while((element = chckPoolIter(ctx->elements, &iter)))
+      _guihckElementCommandsFree(ctx, element);
+
+    free(ctx->commands->changed);
+    free(ctx->commands->items);
+    free(ctx->commands);
+    ctx->commands = NULL;
+
+    /* The render order is not kept up to date while retained */
+    ctx->renderOrderChanged = true;
+  }
+
+  return true;
+}
+
+bool guihckContextGetRetainedRendering(guihckContext* ctx)
+{
+  return ctx->commands != NULL;
+}
+
+const guihckRenderCommand* guihckContextGetRenderCommands(guihckContext* ctx, size_t* count)
+{
+  if(!ctx->commands)
+  {
+    *count = 0;
+    return NULL;
+  }
+
+  *count = ctx->commands->count;
+  return ctx->commands->items;
+}
+
+void guihckElementClearCommands(guihckContext* ctx, guihckElementId elementId)
+{
+  if(!ctx->commands)
+    return;
+
+  _guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  _guihckElementCommandsTouch(ctx, elementId, element);
+  _guihckElementCommandsClear(element->commands);
+}
+
+void guihckElementAddCommand(guihckContext* ctx, guihckElementId elementId, const guihckRenderCommand* command)
+{
+  if(!ctx->commands)
+    return;
+
+  _guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  _guihckElementCommandsTouch(ctx, elementId, element);
+
+  _guihckElementCommands* commands = element->commands;
+  if(commands->count == commands->capacity)
+  {
+    commands->capacity = commands->capacity ? commands->capacity * 2 : 4;
+    commands->items = realloc(commands->items, commands->capacity * sizeof(guihckRenderCommand));
+  }
+
+  guihckRenderCommand* item = &commands->items[commands->count++];
+  *item = *command;
+  item->elementId = elementId;
+  item->text = command->text ? strdup(command->text) : NULL;
+
+  if(command->type == GUIHCK_COMMAND_CLIP_PUSH)
+    commands->clips += 1;
+  else if(command->type == GUIHCK_COMMAND_TRANSFORM_PUSH)
+    commands->transforms += 1;
+}
+
+void _guihckCommandsRefresh(guihckContext* ctx)
+{
+  _guihckCommandList* list = ctx->commands;
+  size_t i;
+
+  for(i = 0; i < list->changedCount && !list->rebuild; ++i)
+  {
+    _guihckElement* element = chckPoolGet(ctx->elements, list->changed[i]);
+    if(!element || !element->commands)
+    {
+      list->rebuild = true;
+      break;
+    }
+
+    _guihckElementCommands* commands = element->commands;
+
+    /* Hidden elements are not in the list, showing one rebuilds it */
+    if(commands->generation != list->generation)
+    {
+      commands->changed = false;
+      continue;
+    }
+
+    /* The pops after the children move when the span changes size */
+    if(commands->count != commands->listed || commands->clips != commands->listedClips
+        || commands->transforms != commands->listedTransforms)
+    {
+      list->rebuild = true;
+      break;
+    }
+
+    memcpy(list->items + commands->offset, commands->items, commands->count * sizeof(guihckRenderCommand));
+    commands->changed = false;
+  }
+
+  if(list->rebuild)
+  {
+    list->rebuild = false;
+    list->generation += 1;
+    list->count = 0;
+    _guihckCommandsAppend(ctx, ctx->rootElementId);
+
+    /* Elements that were not appended are hidden, removals force a rebuild before ids are reused */
+    for(i = 0; i < list->changedCount; ++i)
+    {
+      _guihckElement* element = chckPoolGet(ctx->elements, list->changed[i]);
+      if(element && element->commands)
+        element->commands->changed = false;
+    }
+  }
+
+  list->changedCount = 0;
+}
+
+void _guihckElementCommandsFree(guihckContext* ctx, _guihckElement* element)
+{
+  (void) ctx;
+
+  if(!element->commands)
+    return;
+
+  _guihckElementCommandsClear(element->commands);
+  free(element->commands->items);
+  free(element->commands);
+  element->commands = NULL;
+}
+
+void _guihckElementCommandsTouch(guihckContext* ctx, guihckElementId elementId, _guihckElement* element)
+{
+  _guihckCommandList* list = ctx->commands;
+  if(!element->commands)
+  {
+    /* A new span does not fit the current list */
+    element->commands = calloc(1, sizeof(_guihckElementCommands));
+    list->rebuild = true;
+  }
+
+  if(element->commands->changed)
+    return;
+
+  element->commands->changed = true;
+  if(list->changedCount == list->changedCapacity)
+  {
+    list->changedCapacity = list->changedCapacity ? list->changedCapacity * 2 : 32;
+    list->changed = realloc(list->changed, list->changedCapacity * sizeof(guihckElementId));
+  }
+  list->changed[list->changedCount++] = elementId;
+}
+
+void _guihckElementCommandsClear(_guihckElementCommands* commands)
+{
+  size_t i;
+  for(i = 0; i < commands->count; ++i)
+    free((char*) commands->items[i].text);
+
+  commands->count = 0;
+  commands->clips = 0;
+  commands->transforms = 0;
+}
+
+void _guihckCommandsAppend(guihckContext* ctx, guihckElementId elementId)
+{
+  if(!guihckElementGetVisible(ctx, elementId))
+    return;
+
+  _guihckCommandList* list = ctx->commands;
+  _guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  _guihckElementCommands* commands = element->culled ? NULL : element->commands;
+
+  if(element->culled && element->clips)
+    return;
+
+  /* Clipping elements limit themselves and their children, the rect is kept up to date
+   * by culling and is on screen, the list places it under the ancestors' offsets */
+  if(element->clips)
+  {
+    _guihckRect clip = element->visibleBounds;
+    clip.x -= element->translationX;
+    clip.y -= element->translationY;
+    _guihckCommandListPush(list, elementId, GUIHCK_COMMAND_CLIP_PUSH, &clip);
+  }
+
+  if(commands)
+  {
+    guihckRenderCommand* items = _guihckCommandListReserve(list, commands->count);
+    memcpy(items, commands->items, commands->count * sizeof(guihckRenderCommand));
+    commands->offset = list->count;
+    commands->listed = commands->count;
+    commands->listedClips = commands->clips;
+    commands->listedTransforms = commands->transforms;
+    commands->generation = list->generation;
+    commands->changed = false;
+    list->count += commands->count;
+  }
+
+  if(element->offsets)
+  {
+    _guihckRect offset = {element->offsetX, element->offsetY, 0, 0};
+    _guihckCommandListPush(list, elementId, GUIHCK_COMMAND_TRANSFORM_PUSH, &offset);
+  }
+
+  /* Same order as the render order, which pops the last child first */
+  size_t childCount = chckIterPoolCount(element->children);
+  while(childCount > 0)
+  {
+    guihckElementId* childId = chckIterPoolGet(element->children, --childCount);
+    _guihckCommandsAppend(ctx, *childId);
+  }
+
+  if(element->offsets)
+    _guihckCommandListPush(list, elementId, GUIHCK_COMMAND_TRANSFORM_POP, NULL);
+
+  /* The span's own pushes are closed in reverse */
+  if(commands && commands->clips + commands->transforms > 0)
+  {
+    size_t i = commands->count;
+    while(i > 0)
+    {
+      guihckRenderCommandType type = commands->items[--i].type;
+      if(type == GUIHCK_COMMAND_CLIP_PUSH)
+        _guihckCommandListPush(list, elementId, GUIHCK_COMMAND_CLIP_POP, NULL);
+      else if(type == GUIHCK_COMMAND_TRANSFORM_PUSH)
+        _guihckCommandListPush(list, elementId, GUIHCK_COMMAND_TRANSFORM_POP, NULL);
+    }
+  }
+
+  if(element->clips)
+    _guihckCommandListPush(list, elementId, GUIHCK_COMMAND_CLIP_POP, NULL);
+}
+
+guihckRenderCommand* _guihckCommandListReserve(_guihckCommandList* list, size_t count)
+{
+  if(list->count + count > list->capacity)
+  {
+    while(list->count + count > list->capacity)
+      list->capacity = list->capacity ? list->capacity * 2 : 64;
+    list->items = realloc(list->items, list->capacity * sizeof(guihckRenderCommand));
+  }
+
+  return list->items + list->count;
+}
+
+void _guihckCommandListPush(_guihckCommandList* list, guihckElementId elementId, guihckRenderCommandType type, const _guihckRect* rect)
+{
+  guihckRenderCommand* command = _guihckCommandListReserve(list, 1);
+  memset(command, 0, sizeof(guihckRenderCommand));
+  command->type = type;
+  command->elementId = elementId;
+  if(rect)
+  {
+    command->x = rect->x;
+    command->y = rect->y;
+    command->width = rect->w;
+    command->height = rect->h;
+  }
+  list->count += 1;
+}
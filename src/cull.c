@@ -0,0 +1,227 @@
+#include "internal.h"
+
+#include <float.h>
+#include <string.h>
+
+/* Elements with a size are culled when they fall outside the root rect or the
+ * rects of their clipping ancestors. A culled clipping element hides its whole
+ * subtree, other elements only themselves since children may be placed anywhere.
+ * Child offsets accumulate into translations on the way down, bounds and clip
+ * rects are in screen space. */
+
+static bool _guihckCullElement(guihckContext* ctx, guihckElementId elementId, const _guihckRect* clip, bool clipped, float tx, float ty);
+static bool _guihckCullGetBounds(guihckContext* ctx, guihckElementId elementId, _guihckRect* bounds);
+static bool _guihckRectIntersect(const _guihckRect* a, const _guihckRect* b, _guihckRect* result);
+static bool _guihckRectEqual(const _guihckRect* a, const _guihckRect* b);
+
+void guihckContextCullUpdates(guihckContext* ctx, bool enabled)
+{
+  ctx->cullUpdates = enabled;
+}
+
+bool guihckContextGetCullUpdates(guihckContext* ctx)
+{
+  return ctx->cullUpdates;
+}
+
+bool guihckElementGetClip(guihckContext* ctx, guihckElementId elementId)
+{
+  SCM clip = guihckElementGetProperty(ctx, elementId, "clip");
+  return !scm_is_eq(clip, SCM_UNDEFINED) && scm_is_true(clip);
+}
+
+void guihckElementClip(guihckContext* ctx, guihckElementId elementId, bool value)
+{
+  guihckElementProperty(ctx, elementId, "clip", scm_from_bool(value));
+}
+
+bool guihckElementGetCulled(guihckContext* ctx, guihckElementId elementId)
+{
+  _guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  return element->culled;
+}
+
+bool guihckElementGetVisibleBounds(guihckContext* ctx, guihckElementId elementId, float* x, float* y, float* width, float* height)
+{
+  _guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  if(element->culled)
+    return false;
+
+  if(x) *x = element->visibleBounds.x;
+  if(y) *y = element->visibleBounds.y;
+  if(width) *width = element->visibleBounds.w;
+  if(height) *height = element->visibleBounds.h;
+  return true;
+}
+
+void guihckElementChildOffset(guihckContext* ctx, guihckElementId elementId, float x, float y)
+{
+  _guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  if(element->offsets && element->offsetX == x && element->offsetY == y)
+    return;
+
+  /* The visible part of the element holds everything that moves */
+  if(!element->culled && !element->hidden)
+  {
+    _guihckRect* shown = &element->visibleBounds;
+    guihckContextDamage(ctx, shown->x, shown->y, shown->w, shown->h);
+  }
+
+  /* Transform commands are emitted once an element offsets its children */
+  if(ctx->commands)
+    ctx->commands->rebuild = true;
+
+  element->offsets = true;
+  element->offsetX = x;
+  element->offsetY = y;
+  ctx->cullChanged = true;
+  ctx->pointerDirty = true;
+}
+
+void guihckElementGetChildOffset(guihckContext* ctx, guihckElementId elementId, float* x, float* y)
+{
+  _guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  if(x) *x = element->offsetX;
+  if(y) *y = element->offsetY;
+}
+
+void guihckElementGetTranslation(guihckContext* ctx, guihckElementId elementId, float* x, float* y)
+{
+  _guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  if(x) *x = element->translationX;
+  if(y) *y = element->translationY;
+}
+
+void _guihckCullPropertyChanged(guihckContext* ctx, const char* propertyName)
+{
+  if(ctx->cullChanged)
+    return;
+
+  switch(propertyName[0])
+  {
+    case 'a':
+      ctx->cullChanged = strcmp(propertyName, "absolute-x") == 0 || strcmp(propertyName, "absolute-y") == 0;
+      break;
+    case 'w':
+      ctx->cullChanged = strcmp(propertyName, "width") == 0;
+      break;
+    case 'h':
+      ctx->cullChanged = strcmp(propertyName, "height") == 0;
+      break;
+    case 'c':
+      ctx->cullChanged = strcmp(propertyName, "clip") == 0;
+      break;
+    default:
+      break;
+  }
+}
+
+void _guihckCullRefresh(guihckContext* ctx)
+{
+  if(!ctx->cullChanged)
+    return;
+
+  /* Without a size the root does not limit anything */
+  _guihckRect viewport = {-FLT_MAX / 2, -FLT_MAX / 2, FLT_MAX, FLT_MAX};
+  SCM width = guihckElementGetProperty(ctx, ctx->rootElementId, "width");
+  SCM height = guihckElementGetProperty(ctx, ctx->rootElementId, "height");
+  if(scm_is_real(width) && scm_is_real(height))
+  {
+    viewport.x = 0;
+    viewport.y = 0;
+    viewport.w = scm_to_double(width);
+    viewport.h = scm_to_double(height);
+  }
+
+  /* Render order and command list only hold elements that are not culled */
+  if(_guihckCullElement(ctx, ctx->rootElementId, &viewport, false, 0, 0))
+    ctx->renderOrderChanged = true;
+
+  /* Defaulting visible while culling is not a change */
+  ctx->cullChanged = false;
+}
+
+bool _guihckCullElement(guihckContext* ctx, guihckElementId elementId, const _guihckRect* clip, bool clipped, float tx, float ty)
+{
+  _guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  element->translationX = tx;
+  element->translationY = ty;
+
+  bool culled = clipped;
+  bool clips = false;
+  _guihckRect visibleBounds = *clip;
+
+  /* Hidden subtrees are culled again when shown, which rebuilds the render order */
+  if(!clipped && !guihckElementGetVisible(ctx, elementId))
+    return false;
+
+  _guihckRect bounds;
+  if(!clipped && _guihckCullGetBounds(ctx, elementId, &bounds))
+  {
+    bounds.x += tx;
+    bounds.y += ty;
+    culled = !_guihckRectIntersect(&bounds, clip, &visibleBounds);
+    clips = guihckElementGetClip(ctx, elementId);
+  }
+
+  /* Clip rects end up in the command list, moving one rebuilds it */
+  bool changed = element->culled != culled || element->clips != clips
+      || (clips && !_guihckRectEqual(&element->visibleBounds, &visibleBounds));
+  element->culled = culled;
+  element->clips = clips;
+  element->visibleBounds = visibleBounds;
+
+  const _guihckRect* childClip = clips ? &visibleBounds : clip;
+  bool childClipped = clipped || (clips && culled);
+  float childX = tx + element->offsetX;
+  float childY = ty + element->offsetY;
+
+  chckPoolIndex iter = 0;
+  guihckElementId* childId;
+  while((childId = chckIterPoolIter(element->children, &iter)))
+  {
+    if(_guihckCullElement(ctx, *childId, childClip, childClipped, childX, childY))
+      changed = true;
+  }
+
+  return changed;
+}
+
+bool _guihckCullGetBounds(guihckContext* ctx, guihckElementId elementId, _guihckRect* bounds)
+{
+  SCM width = guihckElementGetProperty(ctx, elementId, "width");
+  SCM height = guihckElementGetProperty(ctx, elementId, "height");
+  if(!scm_is_real(width) || !scm_is_real(height))
+    return false;
+
+  SCM x = guihckElementGetProperty(ctx, elementId, "absolute-x");
+  SCM y = guihckElementGetProperty(ctx, elementId, "absolute-y");
+  bounds->x = scm_is_real(x) ? scm_to_double(x) : 0;
+  bounds->y = scm_is_real(y) ? scm_to_double(y) : 0;
+  bounds->w = scm_to_double(width);
+  bounds->h = scm_to_double(height);
+  return true;
+}
+
+bool _guihckRectIntersect(const _guihckRect* a, const _guihckRect* b, _guihckRect* result)
+{
+  float x0 = a->x > b->x ? a->x : b->x;
+  float y0 = a->y > b->y ? a->y : b->y;
+  float x1 = a->x + a->w < b->x + b->w ? a->x + a->w : b->x + b->w;
+  float y1 = a->y + a->h < b->y + b->h ? a->y + a->h : b->y + b->h;
+
+  /* Touching edges count, zero sized elements inside a clip are kept */
+  if(x1 < x0 || y1 < y0)
+    return false;
+
+  result->x = x0;
+  result->y = y0;
+  result->w = x1 - x0;
+  result->h = y1 - y0;
+  return true;
+}
+
+bool _guihckRectEqual(const _guihckRect* a, const _guihckRect* b)
+{
+  return a->x == b->x && a->y == b->y && a->w == b->w && a->h == b->h;
+}
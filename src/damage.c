@@ -0,0 +1,215 @@
+#include "internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Changed visual elements are queued and measured when the frame is rendered,
+ * both their old and new areas are damaged. Overlapping rectangles are merged
+ * and when there are too many the pair growing the least is joined. */
+
+static const char* _guihckDamageProperties[] = {
+  "absolute-x", "absolute-y", "width", "height", "color", "text", "source", "size", "font", NULL
+};
+
+static bool _guihckDamageIsVisual(guihckContext* ctx, _guihckElement* element);
+static void _guihckDamageQueue(guihckContext* ctx, guihckElementId elementId);
+static void _guihckDamageQueueSubtree(guihckContext* ctx, guihckElementId elementId);
+static bool _guihckDamageElementVisible(guihckContext* ctx, guihckElementId elementId);
+static float _guihckDamageReal(guihckContext* ctx, guihckElementId elementId, const char* key);
+static void _guihckDamageAdd(_guihckDamage* damage, _guihckRect rect);
+static _guihckRect _guihckRectUnion(const _guihckRect* a, const _guihckRect* b);
+static bool _guihckRectTouches(const _guihckRect* a, const _guihckRect* b);
+
+size_t guihckContextGetDamage(guihckContext* ctx, const guihckDamageRect** rects)
+{
+  *rects = ctx->damage.frame;
+  return ctx->damage.frameCount;
+}
+
+void guihckContextDamage(guihckContext* ctx, float x, float y, float width, float height)
+{
+  _guihckRect rect = {x, y, width, height};
+  _guihckDamageAdd(&ctx->damage, rect);
+}
+
+void _guihckDamagePropertyChanged(guihckContext* ctx, guihckElementId elementId, const char* propertyName)
+{
+  /* Hiding or showing anything damages every visual element below it */
+  if(strcmp(propertyName, "visible") == 0)
+  {
+    _guihckDamageQueueSubtree(ctx, elementId);
+    return;
+  }
+
+  _guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  if(element->damaged || !_guihckDamageIsVisual(ctx, element))
+    return;
+
+  const char** name;
+  for(name = _guihckDamageProperties; *name; ++name)
+  {
+    if(strcmp(propertyName, *name) == 0)
+    {
+      _guihckDamageQueue(ctx, elementId);
+      return;
+    }
+  }
+}
+
+void _guihckDamageRemoved(guihckContext* ctx, _guihckElement* element)
+{
+  if(element->hasBounds)
+    _guihckDamageAdd(&ctx->damage, element->bounds);
+}
+
+void _guihckDamageResolve(guihckContext* ctx)
+{
+  _guihckDamage* damage = &ctx->damage;
+
+  size_t i;
+  for(i = 0; i < damage->elementCount; ++i)
+  {
+    guihckElementId elementId = damage->elements[i];
+    _guihckElement* element = chckPoolGet(ctx->elements, elementId);
+    if(!element || !element->damaged)
+      continue;
+
+    element->damaged = false;
+    if(element->hasBounds)
+      _guihckDamageAdd(damage, element->bounds);
+
+    element->hasBounds = _guihckDamageElementVisible(ctx, elementId);
+    if(element->hasBounds)
+    {
+      element->bounds.x = _guihckDamageReal(ctx, elementId, "absolute-x") + element->translationX;
+      element->bounds.y = _guihckDamageReal(ctx, elementId, "absolute-y") + element->translationY;
+      element->bounds.w = _guihckDamageReal(ctx, elementId, "width");
+      element->bounds.h = _guihckDamageReal(ctx, elementId, "height");
+      _guihckDamageAdd(damage, element->bounds);
+    }
+  }
+  damage->elementCount = 0;
+
+  for(i = 0; i < damage->pendingCount; ++i)
+  {
+    damage->frame[i].x = damage->pending[i].x;
+    damage->frame[i].y = damage->pending[i].y;
+    damage->frame[i].width = damage->pending[i].w;
+    damage->frame[i].height = damage->pending[i].h;
+  }
+  damage->frameCount = damage->pendingCount;
+  damage->pendingCount = 0;
+}
+
+bool _guihckDamageIsVisual(guihckContext* ctx, _guihckElement* element)
+{
+  _guihckElementType* type = chckPoolGet(ctx->types->elementTypes, element->type);
+  return type->functionMap.render || element->commands;
+}
+
+void _guihckDamageQueue(guihckContext* ctx, guihckElementId elementId)
+{
+  _guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  if(element->damaged || !_guihckDamageIsVisual(ctx, element))
+    return;
+
+  _guihckDamage* damage = &ctx->damage;
+  if(damage->elementCount == damage->elementCapacity)
+  {
+    damage->elementCapacity = damage->elementCapacity ? damage->elementCapacity * 2 : 32;
+    damage->elements = realloc(damage->elements, damage->elementCapacity * sizeof(guihckElementId));
+  }
+
+  damage->elements[damage->elementCount++] = elementId;
+  element->damaged = true;
+}
+
+void _guihckDamageQueueSubtree(guihckContext* ctx, guihckElementId elementId)
+{
+  _guihckDamageQueue(ctx, elementId);
+
+  _guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  chckPoolIndex iter = 0;
+  guihckElementId* childId;
+  while((childId = chckIterPoolIter(element->children, &iter)))
+    _guihckDamageQueueSubtree(ctx, *childId);
+}
+
+bool _guihckDamageElementVisible(guihckContext* ctx, guihckElementId elementId)
+{
+  while(elementId != GUIHCK_NO_PARENT)
+  {
+    if(!guihckElementGetVisible(ctx, elementId))
+      return false;
+    elementId = guihckElementGetParent(ctx, elementId);
+  }
+  return true;
+}
+
+float _guihckDamageReal(guihckContext* ctx, guihckElementId elementId, const char* key)
+{
+  SCM value = guihckElementGetProperty(ctx, elementId, key);
+  return scm_is_real(value) ? scm_to_double(value) : 0;
+}
+
+void _guihckDamageAdd(_guihckDamage* damage, _guihckRect rect)
+{
+  if(rect.w <= 0 || rect.h <= 0)
+    return;
+
+  /* Absorb everything the new rectangle touches, the union may touch more */
+  size_t i = 0;
+  while(i < damage->pendingCount)
+  {
+    if(_guihckRectTouches(&damage->pending[i], &rect))
+    {
+      rect = _guihckRectUnion(&damage->pending[i], &rect);
+      damage->pending[i] = damage->pending[--damage->pendingCount];
+      i = 0;
+    }
+    else
+    {
+      ++i;
+    }
+  }
+
+  if(damage->pendingCount < GUIHCK_MAX_DAMAGE_RECTS)
+  {
+    damage->pending[damage->pendingCount++] = rect;
+    return;
+  }
+
+  /* Full, join the rectangle with the one it grows the least */
+  size_t best = 0;
+  float bestGrowth = -1;
+  for(i = 0; i < damage->pendingCount; ++i)
+  {
+    _guihckRect joined = _guihckRectUnion(&damage->pending[i], &rect);
+    float growth = joined.w * joined.h - damage->pending[i].w * damage->pending[i].h;
+    if(bestGrowth < 0 || growth < bestGrowth)
+    {
+      best = i;
+      bestGrowth = growth;
+    }
+  }
+
+  rect = _guihckRectUnion(&damage->pending[best], &rect);
+  damage->pending[best] = damage->pending[--damage->pendingCount];
+  _guihckDamageAdd(damage, rect);
+}
+
+_guihckRect _guihckRectUnion(const _guihckRect* a, const _guihckRect* b)
+{
+  float x0 = a->x < b->x ? a->x : b->x;
+  float y0 = a->y < b->y ? a->y : b->y;
+  float x1 = a->x + a->w > b->x + b->w ? a->x + a->w : b->x + b->w;
+  float y1 = a->y + a->h > b->y + b->h ? a->y + a->h : b->y + b->h;
+  _guihckRect result = {x0, y0, x1 - x0, y1 - y0};
+  return result;
+}
+
+bool _guihckRectTouches(const _guihckRect* a, const _guihckRect* b)
+{
+  return a->x <= b->x + b->w && b->x <= a->x + a->w
+      && a->y <= b->y + b->h && b->y <= a->y + a->h;
+}
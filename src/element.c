@@ -1,12 +1,15 @@
 #include "internal.h"
 
 #include <assert.h>
+#include <float.h>
 
 static void _guihckElementUpdateChildrenProperty(guihckContext* ctx, guihckElementId elementId);
 static void _guihckRemoveListeners(guihckContext* ctx, chckIterPool* pool);
 static bool _guihckPropertyIsAnAlias(SCM value);
 static bool _guihckPropertyIsBound(SCM value);
 static void _guihckElementPropertyNotifyListeners(guihckContext* ctx, _guihckProperty* property);
+static void _guihckElementPropertyChanged(guihckContext* ctx, guihckElementId elementId, _guihckProperty* property);
+static void _guihckElementPropertyMark(guihckContext* ctx, guihckElementId elementId, _guihckProperty* property);
 static void _guihckPropertyAliasListenerCallback(guihckContext* ctx, guihckElementId listenerId, guihckElementId listenedId, const char* property, SCM value, void* data);
 static void _guihckPropertyCreateAlias(guihckContext* ctx, guihckElementId elementId, const char* propertyName, SCM value, _guihckProperty* property);
 static void _guihckPropertyCreateBind(guihckContext* ctx, guihckElementId elementId, const char* propertyName, SCM value, _guihckProperty* property);
@@ -14,23 +17,47 @@ static void _guihckPropertyCreate(guihckContext* ctx, guihckElementId elementId,
 static void _guihckPropertyListenerFreeCallback(guihckContext* ctx, guihckElementId listenerId, guihckElementId listenedId, const char* property, SCM value, void* data);
 static void _guihckPropertyAliasFreeCallback(guihckContext* ctx, guihckElementId listenerId, guihckElementId listenedId, const char* property, SCM value, void* data);
 static void _guihckPropertyBindListenerCallback(guihckContext* ctx, guihckElementId listenerId, guihckElementId listenedId, const char* property, SCM value, void* data);
+static void _guihckPropertyBindEvaluate(guihckContext* ctx, guihckElementId elementId, _guihckProperty* property);
 static void _guihckVisibleListenerCallback(guihckContext* ctx, guihckElementId listenerId, guihckElementId listenedId, const char* property, SCM value, void* data);
+static void _guihckElementPropagateHidden(guihckContext* ctx, guihckElementId elementId, bool parentHidden);
+static void _guihckElementResumeBinds(guihckContext* ctx, guihckElementId elementId);
 static void _guihckOrderListenerCallback(guihckContext* ctx, guihckElementId listenerId, guihckElementId listenedId, const char* property, SCM value, void* data);
 
 guihckElementId guihckElementNew(guihckContext* ctx, guihckElementTypeId typeId, guihckElementId parentId)
 {
-  _guihckElementType* type = chckPoolGet(ctx->elementTypes, typeId);
+  _guihckElementType* type = chckPoolGet(ctx->types->elementTypes, typeId);
   guihckElement element;
   element.type = typeId;
-  element.data = type->dataSize > 0 ? calloc(1, type->dataSize) : NULL;
+  element.data = type->dataSize > 0 ? _GUIHCK_CALLOC(ctx, GUIHCK_MEMORY_ELEMENTS, type->dataSize) : NULL;
   element.parent = parentId;
   element.children = chckIterPoolNew(8, 8, sizeof(guihckElementId));
   element.properties = chckHashTableNew(32);
   element.listened = NULL;
-  element.dirty = true;
+  element.commands = NULL;
+  element.hasBounds = false;
+  element.damaged = false;
+  element.visibleBounds.x = -FLT_MAX / 2;
+  element.visibleBounds.y = -FLT_MAX / 2;
+  element.visibleBounds.w = FLT_MAX;
+  element.visibleBounds.h = FLT_MAX;
+  element.culled = false;
+  element.clips = false;
+  element.offsets = false;
+  element.offsetX = 0;
+  element.offsetY = 0;
+  element.staleBinds = false;
+  element.changed = GUIHCK_PROPERTY_MASK_ALL;
+
+  /* Children of hidden elements start out hidden and moved like their siblings */
+  guihckElement* parentElement = chckPoolGet(ctx->elements, parentId);
+  element.hidden = parentElement ? parentElement->hidden : false;
+  element.translationX = parentElement ? parentElement->translationX + parentElement->offsetX : 0;
+  element.translationY = parentElement ? parentElement->translationY + parentElement->offsetY : 0;
 
   guihckElementId id = -1;
   chckPoolAdd(ctx->elements, &element, &id);
+  _GUIHCK_PROFILE_COUNT(ctx, allocations);
+  _GUIHCK_MEMORY_COUNT(ctx, GUIHCK_MEMORY_ELEMENTS, sizeof(guihckElement));
 
 
   guihckElement* parent = chckPoolGet(ctx->elements, parentId);
@@ -39,6 +66,8 @@ guihckElementId guihckElementNew(guihckContext* ctx, guihckElementTypeId typeId,
     chckIterPoolAdd(parent->children, &id, NULL);
   }
 
+  ctx->constructing += 1;
+
   if(type->functionMap.init)
     type->functionMap.init(ctx, id, element.data);
 
@@ -51,7 +80,11 @@ guihckElementId guihckElementNew(guihckContext* ctx, guihckElementTypeId typeId,
 
   guihckElementProperty(ctx, id, "focus", SCM_BOOL_F);
   guihckElementAddListener(ctx, id, id, "visible", _guihckVisibleListenerCallback, NULL, NULL);
+  _guihckElementPropagateHidden(ctx, id, element.hidden);
+  ctx->constructing -= 1;
+
   ctx->renderOrderChanged = true;
+  ctx->cullChanged = true;
   return id;
 }
 
@@ -60,12 +93,16 @@ void guihckElementRemove(guihckContext* ctx, guihckElementId elementId)
   assert(elementId != ctx->rootElementId && "Tried to remove root element");
   guihckElement* element = chckPoolGet(ctx->elements, elementId);
   guihckElementId parentId = guihckElementGetParent(ctx, elementId);
-  _guihckElementType* type = chckPoolGet(ctx->elementTypes, element->type);
+  _guihckElementType* type = chckPoolGet(ctx->types->elementTypes, element->type);
 
   /* Execute destructor */
   if(type->functionMap.destroy)
     type->functionMap.destroy(ctx, elementId, element->data);
 
+  _guihckAnimationsElementRemoved(ctx, elementId);
+  element = chckPoolGet(ctx->elements, elementId);
+  _guihckDamageRemoved(ctx, element);
+
   /* Remove property listeners for listened */
   if(element->listened)
   {
@@ -77,6 +114,10 @@ void guihckElementRemove(guihckContext* ctx, guihckElementId elementId)
   chckHashTableIterator pIter = {NULL, 0};
   while((property = chckHashTableIter(element->properties, &pIter)))
   {
+    _GUIHCK_FREE(ctx, property->name);
+    _guihckPropertyFreeNative(ctx, property);
+    _GUIHCK_MEMORY_UNCOUNT(ctx, GUIHCK_MEMORY_PROPERTIES, sizeof(_guihckProperty));
+
     /* Remove property listeners for listeners */
     if(property->listeners)
     {
@@ -95,20 +136,27 @@ void guihckElementRemove(guihckContext* ctx, guihckElementId elementId)
       while((bound = chckIterPoolIter(property->bind.bound, &bIter)))
       {
         guihckElementRemoveListener(ctx, bound->listenerId);
+        if(!scm_is_eq(bound->value, SCM_UNDEFINED))
+          _GUIHCK_UNPROTECT(ctx, bound->value);
         bound->value = SCM_UNDEFINED;
       }
       chckIterPoolFree(property->bind.bound);
-      scm_gc_unprotect_object(property->bind.function);
+      _GUIHCK_UNPROTECT(ctx, property->bind.function);
       property->bind.function = SCM_UNDEFINED;
     }
+
+    if(!scm_is_eq(property->value, SCM_UNDEFINED))
+      _GUIHCK_UNPROTECT(ctx, property->value);
   }
 
   /* Remove properties */
   chckHashTableFree(element->properties);
 
+  _guihckElementCommandsFree(ctx, element);
+
   /* Remove element data */
   if(element->data)
-    free(element->data);
+    _GUIHCK_FREE(ctx, element->data);
 
   /* Remove children */
   chckIterPool* children = element->children; /* element may be invalidated while removing children  */
@@ -121,6 +169,7 @@ void guihckElementRemove(guihckContext* ctx, guihckElementId elementId)
   chckIterPoolFree(children);
 
   chckPoolRemove(ctx->elements, elementId);
+  _GUIHCK_MEMORY_UNCOUNT(ctx, GUIHCK_MEMORY_ELEMENTS, sizeof(guihckElement));
 
   guihckElement* parent = chckPoolGet(ctx->elements, parentId);
   if(parent)
@@ -137,7 +186,10 @@ void guihckElementRemove(guihckContext* ctx, guihckElementId elementId)
   if(ctx->focused == elementId)
     ctx->focused = ctx->rootElementId;
 
+  ctx->keyHandlersChanged = true;
+
   ctx->renderOrderChanged = true;
+  ctx->cullChanged = true;
 }
 
 
@@ -154,6 +206,14 @@ SCM guihckElementGetProperty(guihckContext* ctx, guihckElementId elementId, cons
     return SCM_UNDEFINED;
   }
 
+  /* Lazy binds are evaluated by the first read after their inputs change */
+  if(prop->type == GUIHCK_PROPERTY_BIND && prop->bind.pending)
+  {
+    _guihckPropertyBindEvaluate(ctx, elementId, prop);
+    element = chckPoolGet(ctx->elements, elementId);
+    prop = chckHashTableStrGet(element->properties, key);
+  }
+
 #if 0
   if(scm_is_eq(prop->value, SCM_UNDEFINED)) printf(" --> UNDEFINED\n");
   else printf(" --> %s\n", scm_to_utf8_string(scm_object_to_string(prop->value, SCM_UNDEFINED)));
@@ -167,7 +227,7 @@ void guihckElementProperty(guihckContext* ctx, guihckElementId elementId, const
   guihckElement* element = chckPoolGet(ctx->elements, elementId);
 #if 0
   char* valueStr = scm_to_utf8_string(scm_object_to_string(value, SCM_UNDEFINED));
-  printf("guihckElementProperty %s %d %s %s\n", ((_guihckElementType*)chckPoolGet(ctx->elementTypes, element->type))->name, (int) elementId, key, valueStr);
+  printf("guihckElementProperty %s %d %s %s\n", ((_guihckElementType*)chckPoolGet(ctx->types->elementTypes, element->type))->name, (int) elementId, key, valueStr);
   free(valueStr);
 #endif
   _guihckProperty* existing = chckHashTableStrGet(element->properties, key);
@@ -197,12 +257,12 @@ void guihckElementProperty(guihckContext* ctx, guihckElementId elementId, const
     {
       if(!scm_is_eq(bound->value, SCM_UNDEFINED))
       {
-        scm_gc_unprotect_object(bound->value);
+        _GUIHCK_UNPROTECT(ctx, bound->value);
       }
       guihckElementRemoveListener(ctx, bound->listenerId);
     }
     chckIterPoolFree(existing->bind.bound);
-    scm_gc_unprotect_object(existing->bind.function);
+    _GUIHCK_UNPROTECT(ctx, existing->bind.function);
     existing->bind.function = SCM_UNDEFINED;
   }
 
@@ -214,14 +274,19 @@ void guihckElementProperty(guihckContext* ctx, guihckElementId elementId, const
   if(!existing)
   {
     /* Create new property */
+    property.name = _GUIHCK_STRDUP(ctx, GUIHCK_MEMORY_PROPERTIES, key);
+    property.schema = _guihckPropertySchemaIndex(ctx, elementId, key);
     chckHashTableStrSet(element->properties, key, &property, sizeof(_guihckProperty));
+    _GUIHCK_PROFILE_COUNT(ctx, allocations);
+    _GUIHCK_MEMORY_COUNT(ctx, GUIHCK_MEMORY_PROPERTIES, sizeof(_guihckProperty));
+    _guihckElementPropertyChanged(ctx, elementId, chckHashTableStrGet(element->properties, key));
   }
   else if(isNewValue)
   {
     /* Update existing property */
     if(!scm_is_eq(existing->value, SCM_UNDEFINED))
     {
-      scm_gc_unprotect_object(existing->value);
+      _GUIHCK_UNPROTECT(ctx, existing->value);
     }
 
     switch(property.type)
@@ -244,10 +309,35 @@ void guihckElementProperty(guihckContext* ctx, guihckElementId elementId, const
         assert(false && "Unknown property type");
     }
 
+    _guihckElementPropertyChanged(ctx, elementId, existing);
     _guihckElementPropertyNotifyListeners(ctx, existing);
   }
 }
 
+void _guihckElementPropertyAssign(guihckContext* ctx, guihckElementId elementId, const char* key, SCM value)
+{
+  guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  _guihckProperty* existing = chckHashTableStrGet(element->properties, key);
+
+  /* Aliases, binds and new properties take the full path */
+  if(!existing || existing->type != GUIHCK_PROPERTY_VALUE)
+  {
+    guihckElementProperty(ctx, elementId, key, value);
+    return;
+  }
+
+  if(scm_is_true(scm_equal_p(existing->value, value)))
+    return;
+
+  if(!scm_is_eq(existing->value, SCM_UNDEFINED))
+    _GUIHCK_UNPROTECT(ctx, existing->value);
+  _GUIHCK_PROTECT(ctx, value);
+  existing->value = value;
+
+  _guihckElementPropertyChanged(ctx, elementId, existing);
+  _guihckElementPropertyNotifyListeners(ctx, existing);
+}
+
 guihckElementId guihckElementGetParent(guihckContext* ctx, guihckElementId elementId)
 {
   guihckElement* element = chckPoolGet(ctx->elements, elementId);
@@ -280,7 +370,7 @@ void guihckElementGetChildren(guihckContext* ctx, guihckElementId elementId, gui
 void guihckElementDirty(guihckContext* ctx, guihckElementId elementId)
 {
   guihckElement* element = chckPoolGet(ctx->elements, elementId);
-  element->dirty = true;
+  element->changed = GUIHCK_PROPERTY_MASK_ALL;
 }
 
 void* guihckElementGetData(guihckContext* ctx, guihckElementId elementId)
@@ -296,12 +386,16 @@ guihckPropertyListenerId guihckElementAddListener(guihckContext* ctx, guihckElem
   _guihckPropertyListener propertyListener;
   propertyListener.listenerId = listenerId;
   propertyListener.listenedId = listenedId;
-  propertyListener.propertyName = strdup(propertyName);
+  propertyListener.propertyName = _GUIHCK_STRDUP(ctx, GUIHCK_MEMORY_LISTENERS, propertyName);
   propertyListener.callback = callback;
   propertyListener.data = data;
   propertyListener.freeCallback = freeCallback;
+  propertyListener.constructed = ctx->constructing > 0;
+  propertyListener.calls = 0;
+  _GUIHCK_PROFILE_COUNT(ctx, allocations);
   guihckPropertyListenerId id;
   chckPoolAdd(ctx->propertyListeners, &propertyListener, &id);
+  _GUIHCK_MEMORY_COUNT(ctx, GUIHCK_MEMORY_LISTENERS, sizeof(_guihckPropertyListener));
 
   guihckElement* listenedElement = chckPoolGet(ctx->elements, listenedId);
   _guihckProperty* property = chckHashTableStrGet(listenedElement->properties, propertyName);
@@ -352,10 +446,12 @@ void guihckElementRemoveListener(guihckContext* ctx, guihckPropertyListenerId pr
 
     if(id)
       chckIterPoolRemove(listenerElement->listened, iter - 1);
-
-    free(listener->propertyName);
   }
+
+  /* The listening element may already be gone, the name is owned by the listener either way */
+  _GUIHCK_FREE(ctx, listener->propertyName);
   chckPoolRemove(ctx->propertyListeners, propertyListenerId);
+  _GUIHCK_MEMORY_UNCOUNT(ctx, GUIHCK_MEMORY_LISTENERS, sizeof(_guihckPropertyListener));
 }
 
 bool guihckElementGetVisible(guihckContext* ctx, guihckElementId elementId)
@@ -377,10 +473,42 @@ void guihckElementVisible(guihckContext* ctx, guihckElementId elementId, bool va
   guihckElementProperty(ctx, elementId, "visible", scm_from_bool(value));
 }
 
+bool guihckElementGetEffectiveVisible(guihckContext* ctx, guihckElementId elementId)
+{
+  guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  return !element->hidden;
+}
+
 /*
  * Private
  */
 
+_guihckListenerKind _guihckPropertyListenerGetKind(const _guihckPropertyListener* listener, const char** targetProperty)
+{
+  if(listener->callback == _guihckPropertyAliasListenerCallback)
+  {
+    *targetProperty = listener->data;
+    return GUIHCK_LISTENER_ALIAS;
+  }
+
+  if(listener->callback == _guihckPropertyBindListenerCallback)
+  {
+    *targetProperty = ((_guihckBoundPropertyRef*) listener->data)->propertyName;
+    return GUIHCK_LISTENER_BIND;
+  }
+
+  *targetProperty = NULL;
+  return GUIHCK_LISTENER_PLAIN;
+}
+
+bool _guihckPropertyListenerIsRestorable(const _guihckPropertyListener* listener)
+{
+  /* Constructor listeners come back with the element, aliases and binds are stored with the property */
+  return listener->constructed
+      || listener->callback == _guihckPropertyAliasListenerCallback
+      || listener->callback == _guihckPropertyBindListenerCallback;
+}
+
 
 void _guihckElementUpdateChildrenProperty(guihckContext* ctx, guihckElementId elementId)
 {
@@ -403,7 +531,7 @@ void _guihckRemoveListeners(guihckContext* ctx, chckIterPool* pool)
     /* Copy listener ids before removing as modifying the pool may break iterators */
     size_t listenedCount;
     guihckPropertyListenerId* listenerIdsOrig = chckIterPoolToCArray(pool, &listenedCount);
-    guihckPropertyListenerId* listenerIds = calloc(listenedCount, sizeof(guihckPropertyListenerId));
+    guihckPropertyListenerId* listenerIds = _GUIHCK_CALLOC(ctx, GUIHCK_MEMORY_SCRATCH, listenedCount * sizeof(guihckPropertyListenerId));
     memcpy(listenerIds, listenerIdsOrig, listenedCount * sizeof(guihckPropertyListenerId));
 
     unsigned int i;
@@ -411,7 +539,7 @@ void _guihckRemoveListeners(guihckContext* ctx, chckIterPool* pool)
     {
       guihckElementRemoveListener(ctx, listenerIds[i]);
     }
-    free(listenerIds);
+    _GUIHCK_FREE(ctx, listenerIds);
   }
 }
 
@@ -424,23 +552,64 @@ bool _guihckPropertyIsAnAlias(SCM value)
 bool _guihckPropertyIsBound(SCM value)
 {
   return scm_is_pair(value) && scm_is_symbol(SCM_CAR(value))
-      && scm_is_eq(SCM_CAR(value), scm_string_to_symbol(scm_from_utf8_string("bind")));
+      && (scm_is_eq(SCM_CAR(value), scm_string_to_symbol(scm_from_utf8_string("bind")))
+          || scm_is_eq(SCM_CAR(value), scm_string_to_symbol(scm_from_utf8_string("lazy-bind"))));
 }
 
 void _guihckElementPropertyNotifyListeners(guihckContext* ctx, _guihckProperty* property)
 {
   if(property->listeners)
   {
+    /* Runaway chains, mostly cycles, are cut at the depth limit */
+    if(ctx->notifyDepthLimit > 0 && ctx->notifyDepth >= ctx->notifyDepthLimit)
+    {
+      _guihckGraphNotifyCut(ctx);
+      return;
+    }
+
     chckPoolIndex iter = 0;
     guihckPropertyListenerId* listenerId;
     while((listenerId = chckIterPoolIter(property->listeners, &iter)))
     {
       _guihckPropertyListener* listener = chckPoolGet(ctx->propertyListeners, *listenerId);
+      if(ctx->profiler)
+        _guihckProfilerCountListener(ctx, listener->listenerId);
+      listener->calls += 1;
+      if(ctx->notifyPath)
+        ctx->notifyPath[ctx->notifyDepth] = *listenerId;
+
+      ctx->notifyDepth += 1;
       listener->callback(ctx, listener->listenerId, listener->listenedId, listener->propertyName, property->value, listener->data);
+      ctx->notifyDepth -= 1;
     }
+
+    if(ctx->notifyDepth == 0)
+      ctx->notifyCut = false;
   }
 }
 
+void _guihckElementPropertyChanged(guihckContext* ctx, guihckElementId elementId, _guihckProperty* property)
+{
+  if(property->schema >= 0)
+    _guihckPropertySchemaConvert(ctx, elementId, property);
+
+  _guihckElementPropertyMark(ctx, elementId, property);
+}
+
+void _guihckElementPropertyMark(guihckContext* ctx, guihckElementId elementId, _guihckProperty* property)
+{
+  const char* propertyName = property->name;
+  if(property->schema >= 0)
+    _guihckPropertySchemaMark(ctx, elementId, property);
+
+  _guihckDamagePropertyChanged(ctx, elementId, propertyName);
+  _guihckCullPropertyChanged(ctx, propertyName);
+
+  /* Keyboard handler chain caches the handler procedures */
+  if(propertyName[0] == 'o' && (strcmp(propertyName, "on-key") == 0 || strcmp(propertyName, "on-char") == 0))
+    ctx->keyHandlersChanged = true;
+}
+
 void _guihckPropertyAliasListenerCallback(guihckContext* ctx, guihckElementId listenerId, guihckElementId listenedId, const char* property, SCM value, void* data)
 {
   (void) listenedId;
@@ -452,16 +621,17 @@ void _guihckPropertyAliasListenerCallback(guihckContext* ctx, guihckElementId li
 
   if(!scm_is_eq(listenerProperty->value, SCM_UNDEFINED))
   {
-    scm_gc_unprotect_object(listenerProperty->value);
+    _GUIHCK_UNPROTECT(ctx, listenerProperty->value);
   }
 
   listenerProperty->value = value;
 
   if(!scm_is_eq(listenerProperty->value, SCM_UNDEFINED))
   {
-    scm_gc_protect_object(listenerProperty->value);
+    _GUIHCK_PROTECT(ctx, listenerProperty->value);
   }
 
+  _guihckElementPropertyChanged(ctx, listenerId, listenerProperty);
   _guihckElementPropertyNotifyListeners(ctx, listenerProperty);
 }
 
@@ -476,14 +646,17 @@ void _guihckPropertyCreateAlias(guihckContext* ctx, guihckElementId elementId, c
 
   guihckElementId targetId = scm_to_uint64(elementValue);
   char* targetPropertyName = scm_to_utf8_string(scm_symbol_to_string(propertyNameValue));
-  property->alias.listenerId = guihckElementAddListener(ctx, elementId, targetId, targetPropertyName,
-                                                        _guihckPropertyAliasListenerCallback, strdup(propertyName),
-                                                        _guihckPropertyAliasFreeCallback);
+
+  /* Read before listening, reading a pending lazy bind notifies its listeners
+   * and this property is not in the element yet */
   property->value = guihckElementGetProperty(ctx, targetId, targetPropertyName);
   if(!scm_is_eq(property->value, SCM_UNDEFINED))
   {
-    scm_gc_protect_object(property->value);
+    _GUIHCK_PROTECT(ctx, property->value);
   }
+  property->alias.listenerId = guihckElementAddListener(ctx, elementId, targetId, targetPropertyName,
+                                                        _guihckPropertyAliasListenerCallback, _GUIHCK_STRDUP(ctx, GUIHCK_MEMORY_BINDINGS, propertyName),
+                                                        _guihckPropertyAliasFreeCallback);
   free(targetPropertyName);
 }
 
@@ -496,17 +669,13 @@ void _guihckPropertyBindListenerCallback(guihckContext* ctx, guihckElementId lis
   guihckElement* listener = chckPoolGet(ctx->elements, listenerId);
 #if 0
   char* valueStr = scm_to_utf8_string(scm_object_to_string(value, SCM_UNDEFINED));
-  const char* listenerType = ((_guihckElementType*) chckPoolGet(ctx->elementTypes, listener->type))->name;
+  const char* listenerType = ((_guihckElementType*) chckPoolGet(ctx->types->elementTypes, listener->type))->name;
   printf("_guihckPropertyBindListenerCallback %d %s %d %s %s\n", (int) listenerId, listenerType, (int) listenedId, property, valueStr);
   free(valueStr);
 #endif
 
   _guihckProperty* listenerProperty = chckHashTableStrGet(listener->properties, ref->propertyName);
 
-  guihckStackPushElement(ctx, listenerId);
-  SCM paramsVector = scm_c_make_vector(chckIterPoolCount(listenerProperty->bind.bound), SCM_UNDEFINED);
-  bool hasUndefined = false;
-
   chckPoolIndex iter = 0;
   _guihckBoundProperty* bound;
   while((bound = chckIterPoolIter(listenerProperty->bind.bound, &iter)))
@@ -515,17 +684,58 @@ void _guihckPropertyBindListenerCallback(guihckContext* ctx, guihckElementId lis
     {
       if(!scm_is_eq(bound->value, SCM_UNDEFINED))
       {
-        scm_gc_unprotect_object(bound->value);
+        _GUIHCK_UNPROTECT(ctx, bound->value);
       }
 
       bound->value = value;
 
       if(!scm_is_eq(bound->value, SCM_UNDEFINED))
       {
-        scm_gc_protect_object(bound->value);
+        _GUIHCK_PROTECT(ctx, bound->value);
       }
     }
+  }
 
+  /* Nothing reads an unobserved lazy bind until later, it is only marked as if changed */
+  if(listenerProperty->bind.lazy && (!listenerProperty->listeners || chckIterPoolCount(listenerProperty->listeners) == 0))
+  {
+    if(!listenerProperty->bind.pending)
+    {
+      listenerProperty->bind.pending = true;
+      _guihckElementPropertyMark(ctx, listenerId, listenerProperty);
+    }
+    return;
+  }
+
+  /* Hidden elements of suspending types evaluate once when shown */
+  if(listener->hidden)
+  {
+    _guihckElementType* type = chckPoolGet(ctx->types->elementTypes, listener->type);
+    if(type->suspend & GUIHCK_SUSPEND_BINDS)
+    {
+      listenerProperty->stale = true;
+      listener->staleBinds = true;
+      return;
+    }
+  }
+
+  _guihckPropertyBindEvaluate(ctx, listenerId, listenerProperty);
+}
+
+void _guihckPropertyBindEvaluate(guihckContext* ctx, guihckElementId elementId, _guihckProperty* property)
+{
+  /* A stale lazy bind marked its element already */
+  bool pulled = property->bind.pending;
+  property->bind.pending = false;
+
+  guihckStackPushElement(ctx, elementId);
+  SCM paramsVector = scm_c_make_vector(chckIterPoolCount(property->bind.bound), SCM_UNDEFINED);
+  bool hasUndefined = false;
+
+  chckPoolIndex iter = 0;
+  _guihckBoundProperty* bound;
+  while((bound = chckIterPoolIter(property->bind.bound, &iter)))
+  {
     if(scm_is_eq(bound->value, SCM_UNDEFINED))
     {
       hasUndefined = true;
@@ -537,7 +747,7 @@ void _guihckPropertyBindListenerCallback(guihckContext* ctx, guihckElementId lis
   SCM newValue = SCM_UNDEFINED;
   if(!hasUndefined)
   {
-    SCM expression = scm_cons(listenerProperty->bind.function, scm_vector_to_list(paramsVector));
+    SCM expression = scm_cons(property->bind.function, scm_vector_to_list(paramsVector));
 #if 0
   char* paramsStr = scm_to_utf8_string(scm_object_to_string(paramsVector, SCM_UNDEFINED));
   printf("PARAMS VECTOR: %s\n", paramsStr);
@@ -546,17 +756,28 @@ void _guihckPropertyBindListenerCallback(guihckContext* ctx, guihckElementId lis
   printf("LISTENER EXPR: %s\n", expressionStr);
   free(expressionStr);
 #endif
+    if(ctx->profiler)
+      _guihckProfilerBeginBind(ctx, elementId);
+    _GUIHCK_TRACE_BEGIN(ctx, "bind", property->name, elementId);
     newValue = guihckContextExecuteExpression(ctx, expression);
-    if(!scm_is_eq(newValue, SCM_UNDEFINED))
-    {
-      scm_gc_protect_object(newValue);
-    }
+    _GUIHCK_TRACE_END(ctx, "bind");
+    _GUIHCK_PROFILE_END(ctx, GUIHCK_PHASE_BINDS);
   }
 
-  if(scm_is_false(scm_equal_p(listenerProperty->value, newValue)))
+  /* The property holds the only protection of its value, the old one is released on change */
+  if(scm_is_false(scm_equal_p(property->value, newValue)))
   {
-    listenerProperty->value = newValue;
-    _guihckElementPropertyNotifyListeners(ctx, listenerProperty);
+    if(!scm_is_eq(property->value, SCM_UNDEFINED))
+      _GUIHCK_UNPROTECT(ctx, property->value);
+    if(!scm_is_eq(newValue, SCM_UNDEFINED))
+      _GUIHCK_PROTECT(ctx, newValue);
+
+    property->value = newValue;
+    if(!pulled)
+      _guihckElementPropertyChanged(ctx, elementId, property);
+    else if(property->schema >= 0)
+      _guihckPropertySchemaConvert(ctx, elementId, property);
+    _guihckElementPropertyNotifyListeners(ctx, property);
   }
 
   guihckStackPopElement(ctx);
@@ -570,11 +791,11 @@ void _guihckPropertyCreateBind(guihckContext* ctx, guihckElementId elementId, co
   guihckStackPushElement(ctx, elementId);
 
   SCM boundVector = scm_vector(boundList);
-  char* paramsStr = scm_to_utf8_string(scm_object_to_string(boundVector, SCM_UNDEFINED));
-  free(paramsStr);
 
   property->bind.function = function;
-  scm_gc_protect_object(property->bind.function);
+  property->bind.lazy = scm_is_eq(SCM_CAR(value), scm_from_utf8_symbol("lazy-bind"));
+  property->bind.pending = false;
+  _GUIHCK_PROTECT(ctx, property->bind.function);
 
   size_t numBound = scm_c_vector_length(boundVector);
   property->bind.bound = chckIterPoolNew(8, numBound, sizeof(_guihckBoundProperty));
@@ -593,19 +814,19 @@ void _guihckPropertyCreateBind(guihckContext* ctx, guihckElementId elementId, co
 
     _guihckBoundProperty b;
     b.index = i;
-    _guihckBoundPropertyRef* ref = calloc(1, sizeof(_guihckBoundPropertyRef));
-    ref->propertyName = strdup(propertyName);
+    _guihckBoundPropertyRef* ref = _GUIHCK_CALLOC(ctx, GUIHCK_MEMORY_BINDINGS, sizeof(_guihckBoundPropertyRef));
+    ref->propertyName = _GUIHCK_STRDUP(ctx, GUIHCK_MEMORY_BINDINGS, propertyName);
     ref->index = i;
 
-
+    /* Read before listening, like aliases */
+    b.value = guihckElementGetProperty(ctx, boundElementId, boundPropertyName);
     b.listenerId = guihckElementAddListener(ctx, elementId, boundElementId, boundPropertyName, _guihckPropertyBindListenerCallback, ref,
                                             _guihckPropertyListenerFreeCallback);
-
-    b.value = guihckElementGetProperty(ctx, boundElementId, boundPropertyName);
+    free(boundPropertyName);
 
     if(!scm_is_eq(b.value, SCM_UNDEFINED))
     {
-      scm_gc_protect_object(b.value);
+      _GUIHCK_PROTECT(ctx, b.value);
     }
     else
     {
@@ -624,11 +845,15 @@ void _guihckPropertyCreateBind(guihckContext* ctx, guihckElementId elementId, co
   else
   {
     SCM expression = scm_cons(property->bind.function, scm_vector_to_list(paramsVector));
-    char* expressionStr = scm_to_utf8_string(scm_object_to_string(expression, SCM_UNDEFINED));
-    free(expressionStr);
 
+    if(ctx->profiler)
+      _guihckProfilerBeginBind(ctx, elementId);
+    _GUIHCK_TRACE_BEGIN(ctx, "bind", propertyName, elementId);
     property->value = guihckContextExecuteExpression(ctx, expression);
-    scm_gc_protect_object(property->value);
+    _GUIHCK_TRACE_END(ctx, "bind");
+    _GUIHCK_PROFILE_END(ctx, GUIHCK_PHASE_BINDS);
+    if(!scm_is_eq(property->value, SCM_UNDEFINED))
+      _GUIHCK_PROTECT(ctx, property->value);
   }
   guihckStackPopElement(ctx);
 }
@@ -639,7 +864,13 @@ void _guihckPropertyCreate(guihckContext* ctx, guihckElementId elementId, const
       _guihckPropertyIsAnAlias(value) ? GUIHCK_PROPERTY_ALIAS :
       _guihckPropertyIsBound(value) ? GUIHCK_PROPERTY_BIND :
       GUIHCK_PROPERTY_VALUE;
+  property->name = NULL;
   property->listeners = NULL;
+  property->stale = false;
+  property->schema = -1;
+  property->nativeType = GUIHCK_VALUE_SCM;
+  property->hasNative = false;
+  memset(&property->native, 0, sizeof(guihckValue));
   /* Set value contents based on type */
   switch(property->type)
   {
@@ -656,7 +887,7 @@ void _guihckPropertyCreate(guihckContext* ctx, guihckElementId elementId, const
     case GUIHCK_PROPERTY_VALUE:
     {
       if(!scm_is_eq(value, SCM_UNDEFINED))
-        scm_gc_protect_object(value);
+        _GUIHCK_PROTECT(ctx, value);
       property->value = value;
       break;
     }
@@ -675,8 +906,8 @@ void _guihckPropertyListenerFreeCallback(guihckContext* ctx, guihckElementId lis
   if(data)
   {
     _guihckBoundPropertyRef* ref = data;
-    free(ref->propertyName);
-    free(ref);
+    _GUIHCK_FREE(ctx, ref->propertyName);
+    _GUIHCK_FREE(ctx, ref);
   }
 }
 
@@ -690,7 +921,7 @@ void _guihckPropertyAliasFreeCallback(guihckContext* ctx, guihckElementId listen
 
   if(data)
   {
-    free(data);
+    _GUIHCK_FREE(ctx, data);
   }
 }
 
@@ -703,6 +934,88 @@ void _guihckVisibleListenerCallback(guihckContext* ctx, guihckElementId listener
   (void) data;
 
   ctx->renderOrderChanged = true;
+  ctx->cullChanged = true;
+
+  guihckElement* parent = chckPoolGet(ctx->elements, guihckElementGetParent(ctx, listenerId));
+  _guihckElementPropagateHidden(ctx, listenerId, parent ? parent->hidden : false);
+}
+
+void _guihckElementPropagateHidden(guihckContext* ctx, guihckElementId elementId, bool parentHidden)
+{
+  guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  bool hidden = parentHidden || scm_is_false(guihckElementGetProperty(ctx, elementId, "visible"));
+
+  /* Descendants only depend on their ancestors, an unchanged element ends the walk */
+  if(element->hidden == hidden)
+    return;
+
+  element->hidden = hidden;
+
+  /* Children read their parent's binds, those are brought up to date first */
+  if(!hidden)
+    _guihckElementResumeBinds(ctx, elementId);
+
+  /* Resumed binds may add children, the element is looked up again for each */
+  size_t i;
+  for(i = 0; (element = chckPoolGet(ctx->elements, elementId)) && i < chckIterPoolCount(element->children); ++i)
+  {
+    guihckElementId* childId = chckIterPoolGet(element->children, i);
+    _guihckElementPropagateHidden(ctx, *childId, hidden);
+  }
+}
+
+void _guihckElementResumeBinds(guihckContext* ctx, guihckElementId elementId)
+{
+  guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  if(!element || !element->staleBinds)
+    return;
+
+  element->staleBinds = false;
+
+  /* Stale names are gathered in one walk as evaluating may add properties */
+  size_t count = 0;
+  size_t length = 0;
+  chckHashTableIterator iter = {NULL, 0};
+  _guihckProperty* property;
+  while((property = chckHashTableIter(element->properties, &iter)))
+  {
+    if(property->stale)
+    {
+      count += 1;
+      length += strlen(property->name) + 1;
+    }
+  }
+
+  if(count == 0)
+    return;
+
+  char* names = _GUIHCK_CALLOC(ctx, GUIHCK_MEMORY_SCRATCH, length);
+  char* name = names;
+  chckHashTableIterator copyIter = {NULL, 0};
+  while((property = chckHashTableIter(element->properties, &copyIter)))
+  {
+    if(property->stale)
+    {
+      property->stale = false;
+      size_t size = strlen(property->name) + 1;
+      memcpy(name, property->name, size);
+      name += size;
+    }
+  }
+
+  size_t i;
+  for(i = 0, name = names; i < count; ++i, name += strlen(name) + 1)
+  {
+    element = chckPoolGet(ctx->elements, elementId);
+    if(!element)
+      break;
+
+    property = chckHashTableStrGet(element->properties, name);
+    if(property && property->type == GUIHCK_PROPERTY_BIND)
+      _guihckPropertyBindEvaluate(ctx, elementId, property);
+  }
+
+  _GUIHCK_FREE(ctx, names);
 }
 
 void _guihckOrderListenerCallback(guihckContext* ctx, guihckElementId listenerId, guihckElementId listenedId, const char* property, SCM value, void* data)
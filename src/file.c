@@ -0,0 +1,139 @@
+#include "internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+# include <sys/stat.h>
+#else
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <dirent.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+bool _guihckMappedFileOpen(_guihckMappedFile* file, const char* path)
+{
+  memset(file, 0, sizeof(_guihckMappedFile));
+
+#if defined(_WIN32)
+  /* No mmap, read the file in instead */
+  struct stat st;
+  if(stat(path, &st) != 0)
+    return false;
+
+  FILE* f = fopen(path, "rb");
+  if(!f)
+    return false;
+
+  char* data = malloc(st.st_size + 1);
+  size_t size = fread(data, 1, st.st_size, f);
+  fclose(f);
+  data[size] = '\0';
+
+  file->data = data;
+  file->size = size;
+  file->mtime = st.st_mtime;
+  return true;
+#else
+  int fd = open(path, O_RDONLY);
+  if(fd < 0)
+    return false;
+
+  struct stat st;
+  if(fstat(fd, &st) != 0)
+  {
+    close(fd);
+    return false;
+  }
+
+  file->size = st.st_size;
+  file->mtime = st.st_mtime;
+
+  /* Zero-length mappings are not allowed, an empty file has no data */
+  if(file->size > 0)
+  {
+    void* data = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(data == MAP_FAILED)
+    {
+      close(fd);
+      return false;
+    }
+    file->data = data;
+    file->mapped = true;
+  }
+  else
+  {
+    file->data = "";
+  }
+
+  close(fd);
+  return true;
+#endif
+}
+
+void _guihckMappedFileClose(_guihckMappedFile* file)
+{
+#if defined(_WIN32)
+  free((void*) file->data);
+#else
+  if(file->mapped)
+    munmap((void*) file->data, file->size);
+#endif
+  memset(file, 0, sizeof(_guihckMappedFile));
+}
+
+void _guihckCacheEvict(const char* path, size_t prefixLength)
+{
+#if defined(_WIN32)
+  /* No directory listing, stale entries stay until the directory is cleared */
+  (void) path;
+  (void) prefixLength;
+#else
+  const char* slash = strrchr(path, '/');
+  const char* name = slash ? slash + 1 : path;
+  size_t directoryLength = slash ? (size_t) (slash - path) : 1;
+  char directory[1024];
+  if(directoryLength >= sizeof(directory) || strlen(name) < prefixLength)
+    return;
+  memcpy(directory, slash ? path : ".", directoryLength);
+  directory[directoryLength] = '\0';
+
+  DIR* dir = opendir(directory);
+  if(!dir)
+    return;
+
+  /* Removing the entry just returned does not disturb the listing */
+  struct dirent* entry;
+  while((entry = readdir(dir)))
+  {
+    if(strncmp(entry->d_name, name, prefixLength) != 0 || strcmp(entry->d_name, name) == 0)
+      continue;
+
+    /* Another process may still be writing its entry */
+    size_t length = strlen(entry->d_name);
+    if(length > 4 && strcmp(entry->d_name + length - 4, ".tmp") == 0)
+      continue;
+
+    char stale[1024];
+    if(snprintf(stale, sizeof(stale), "%s/%s", directory, entry->d_name) < (int) sizeof(stale))
+      remove(stale);
+  }
+  closedir(dir);
+#endif
+}
+
+uint64_t _guihckHashBytes(uint64_t hash, const void* data, size_t size)
+{
+  /* 64-bit FNV-1a, start with _GUIHCK_HASH_INIT */
+  const unsigned char* bytes = data;
+  size_t i;
+  for(i = 0; i < size; ++i)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
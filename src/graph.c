@@ -0,0 +1,270 @@
+#include "internal.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Every listener is an edge from the property it listens to. Aliases and binds
+ * end at the property they set, plain listeners at their element as what they
+ * change is up to the callback. Nodes are named "element.property" and "element". */
+
+#define _GUIHCK_GRAPH_NAME_LENGTH 128
+
+static const char* _guihckGraphKindNames[] = { "listener", "alias", "bind" };
+static const char* _guihckGraphPropertyTypeNames[] = { "value", "alias", "bind" };
+
+static void _guihckGraphWriteDot(guihckContext* ctx, FILE* file);
+static void _guihckGraphWriteJson(guihckContext* ctx, FILE* file);
+static bool _guihckGraphIsNode(const _guihckProperty* property);
+static bool _guihckGraphHasPlainListener(guihckContext* ctx, const guihckElement* element);
+static void _guihckGraphNodeId(guihckElementId elementId, const char* propertyName, char* buffer, size_t size);
+static void _guihckGraphLabel(guihckContext* ctx, guihckElementId elementId, const char* propertyName, char* buffer, size_t size);
+
+bool guihckContextBindingGraphDump(guihckContext* ctx, const char* path, guihckGraphFormat format)
+{
+  FILE* file = fopen(path, "w");
+  if(!file)
+    return false;
+
+  if(format == GUIHCK_GRAPH_DOT)
+    _guihckGraphWriteDot(ctx, file);
+  else
+    _guihckGraphWriteJson(ctx, file);
+
+  return fclose(file) == 0;
+}
+
+void guihckContextResetBindingCounters(guihckContext* ctx)
+{
+  chckPoolIndex iter = 0;
+  _guihckPropertyListener* listener;
+  while((listener = chckPoolIter(ctx->propertyListeners, &iter)))
+    listener->calls = 0;
+}
+
+void guihckContextNotifyDepthLimit(guihckContext* ctx, unsigned int limit)
+{
+  assert(ctx->notifyDepth == 0 && "Notify depth limit can not be changed while notifying");
+
+  free(ctx->notifyPath);
+  free(ctx->notifyCycle);
+  ctx->notifyPath = limit > 0 ? calloc(limit, sizeof(guihckPropertyListenerId)) : NULL;
+  ctx->notifyCycle = limit > 0 ? calloc(limit, sizeof(guihckPropertyListenerId)) : NULL;
+  ctx->notifyCycleLength = 0;
+  ctx->notifyDepthLimit = limit;
+}
+
+unsigned int guihckContextGetNotifyDepthLimit(guihckContext* ctx)
+{
+  return ctx->notifyDepthLimit;
+}
+
+size_t guihckContextGetNotifyCycle(guihckContext* ctx, const guihckPropertyListenerId** path)
+{
+  *path = ctx->notifyCycle;
+  return ctx->notifyCycleLength;
+}
+
+void _guihckGraphNotifyCut(guihckContext* ctx)
+{
+  /* Siblings of the cut notification hit the limit too, the first one is reported */
+  if(ctx->notifyCut)
+    return;
+  ctx->notifyCut = true;
+
+  /* A cycle repeats the innermost listener, only the loop is kept */
+  size_t depth = ctx->notifyDepth;
+  size_t start = 0;
+  size_t i;
+  for(i = depth - 1; i > 0; --i)
+  {
+    if(ctx->notifyPath[i - 1] == ctx->notifyPath[depth - 1])
+    {
+      start = i;
+      break;
+    }
+  }
+
+  ctx->notifyCycleLength = depth - start;
+  memcpy(ctx->notifyCycle, ctx->notifyPath + start, ctx->notifyCycleLength * sizeof(guihckPropertyListenerId));
+}
+
+void _guihckGraphWriteDot(guihckContext* ctx, FILE* file)
+{
+  char id[_GUIHCK_GRAPH_NAME_LENGTH];
+  char label[_GUIHCK_GRAPH_NAME_LENGTH];
+
+  fprintf(file, "digraph bindings {\n  node [shape=box];\n");
+
+  chckPoolIndex iter = 0;
+  guihckElement* element;
+  while((element = chckPoolIter(ctx->elements, &iter)))
+  {
+    guihckElementId elementId = iter - 1;
+    if(_guihckGraphHasPlainListener(ctx, element))
+    {
+      _guihckGraphNodeId(elementId, NULL, id, sizeof(id));
+      _guihckGraphLabel(ctx, elementId, NULL, label, sizeof(label));
+      fprintf(file, "  ");
+      _guihckTraceWriteString(file, id);
+      fprintf(file, " [shape=ellipse, label=");
+      _guihckTraceWriteString(file, label);
+      fprintf(file, "];\n");
+    }
+
+    chckHashTableIterator pIter = {NULL, 0};
+    _guihckProperty* property;
+    while((property = chckHashTableIter(element->properties, &pIter)))
+    {
+      if(!_guihckGraphIsNode(property))
+        continue;
+
+      _guihckGraphNodeId(elementId, property->name, id, sizeof(id));
+      _guihckGraphLabel(ctx, elementId, property->name, label, sizeof(label));
+      fprintf(file, "  ");
+      _guihckTraceWriteString(file, id);
+      fprintf(file, " [label=");
+      _guihckTraceWriteString(file, label);
+      fprintf(file, "];\n");
+    }
+  }
+
+  iter = 0;
+  _guihckPropertyListener* listener;
+  while((listener = chckPoolIter(ctx->propertyListeners, &iter)))
+  {
+    const char* target;
+    _guihckListenerKind kind = _guihckPropertyListenerGetKind(listener, &target);
+    _guihckGraphNodeId(listener->listenedId, listener->propertyName, id, sizeof(id));
+    fprintf(file, "  ");
+    _guihckTraceWriteString(file, id);
+    fprintf(file, " -> ");
+    _guihckGraphNodeId(listener->listenerId, target, id, sizeof(id));
+    _guihckTraceWriteString(file, id);
+    fprintf(file, " [label=\"%s %u\"%s];\n", _guihckGraphKindNames[kind], listener->calls,
+            kind == GUIHCK_LISTENER_ALIAS ? ", style=dashed" : kind == GUIHCK_LISTENER_PLAIN ? ", style=dotted" : "");
+  }
+
+  fprintf(file, "}\n");
+}
+
+void _guihckGraphWriteJson(guihckContext* ctx, FILE* file)
+{
+  char id[_GUIHCK_GRAPH_NAME_LENGTH];
+  char label[_GUIHCK_GRAPH_NAME_LENGTH];
+  bool comma = false;
+
+  fprintf(file, "{\"nodes\": [");
+
+  chckPoolIndex iter = 0;
+  guihckElement* element;
+  while((element = chckPoolIter(ctx->elements, &iter)))
+  {
+    guihckElementId elementId = iter - 1;
+    if(_guihckGraphHasPlainListener(ctx, element))
+    {
+      _guihckGraphNodeId(elementId, NULL, id, sizeof(id));
+      _guihckGraphLabel(ctx, elementId, NULL, label, sizeof(label));
+      fprintf(file, "%s\n{\"id\": ", comma ? "," : "");
+      _guihckTraceWriteString(file, id);
+      fprintf(file, ", \"element\": %lu, \"label\": ", (unsigned long) elementId);
+      _guihckTraceWriteString(file, label);
+      fprintf(file, ", \"property\": null}");
+      comma = true;
+    }
+
+    chckHashTableIterator pIter = {NULL, 0};
+    _guihckProperty* property;
+    while((property = chckHashTableIter(element->properties, &pIter)))
+    {
+      if(!_guihckGraphIsNode(property))
+        continue;
+
+      _guihckGraphNodeId(elementId, property->name, id, sizeof(id));
+      _guihckGraphLabel(ctx, elementId, property->name, label, sizeof(label));
+      fprintf(file, "%s\n{\"id\": ", comma ? "," : "");
+      _guihckTraceWriteString(file, id);
+      fprintf(file, ", \"element\": %lu, \"label\": ", (unsigned long) elementId);
+      _guihckTraceWriteString(file, label);
+      fprintf(file, ", \"property\": ");
+      _guihckTraceWriteString(file, property->name);
+      fprintf(file, ", \"type\": \"%s\"", _guihckGraphPropertyTypeNames[property->type]);
+      if(property->type == GUIHCK_PROPERTY_BIND && property->bind.lazy)
+        fprintf(file, ", \"lazy\": true");
+      fprintf(file, "}");
+      comma = true;
+    }
+  }
+
+  fprintf(file, "\n], \"edges\": [");
+  comma = false;
+
+  iter = 0;
+  _guihckPropertyListener* listener;
+  while((listener = chckPoolIter(ctx->propertyListeners, &iter)))
+  {
+    const char* target;
+    _guihckListenerKind kind = _guihckPropertyListenerGetKind(listener, &target);
+    _guihckGraphNodeId(listener->listenedId, listener->propertyName, id, sizeof(id));
+    fprintf(file, "%s\n{\"listener\": %lu, \"from\": ", comma ? "," : "", (unsigned long) (iter - 1));
+    _guihckTraceWriteString(file, id);
+    _guihckGraphNodeId(listener->listenerId, target, id, sizeof(id));
+    fprintf(file, ", \"to\": ");
+    _guihckTraceWriteString(file, id);
+    fprintf(file, ", \"kind\": \"%s\", \"calls\": %u}", _guihckGraphKindNames[kind], listener->calls);
+    comma = true;
+  }
+
+  fprintf(file, "\n]}\n");
+}
+
+bool _guihckGraphIsNode(const _guihckProperty* property)
+{
+  return property->type != GUIHCK_PROPERTY_VALUE || (property->listeners && chckIterPoolCount(property->listeners) > 0);
+}
+
+bool _guihckGraphHasPlainListener(guihckContext* ctx, const guihckElement* element)
+{
+  if(!element->listened)
+    return false;
+
+  chckPoolIndex iter = 0;
+  guihckPropertyListenerId* listenerId;
+  while((listenerId = chckIterPoolIter(element->listened, &iter)))
+  {
+    const char* target;
+    _guihckPropertyListener* listener = chckPoolGet(ctx->propertyListeners, *listenerId);
+    if(listener && _guihckPropertyListenerGetKind(listener, &target) == GUIHCK_LISTENER_PLAIN)
+      return true;
+  }
+  return false;
+}
+
+void _guihckGraphNodeId(guihckElementId elementId, const char* propertyName, char* buffer, size_t size)
+{
+  if(propertyName)
+    snprintf(buffer, size, "%lu.%s", (unsigned long) elementId, propertyName);
+  else
+    snprintf(buffer, size, "%lu", (unsigned long) elementId);
+}
+
+void _guihckGraphLabel(guihckContext* ctx, guihckElementId elementId, const char* propertyName, char* buffer, size_t size)
+{
+  /* Elements are shown by their id when they have one, by their type otherwise */
+  guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  char* name = NULL;
+  if(element)
+  {
+    _guihckProperty* idProperty = chckHashTableStrGet(element->properties, "id");
+    if(idProperty && scm_is_symbol(idProperty->value))
+      name = scm_to_utf8_string(scm_symbol_to_string(idProperty->value));
+  }
+
+  const char* typeName = "removed";
+  if(element)
+    typeName = ((_guihckElementType*) chckPoolGet(ctx->types->elementTypes, element->type))->name;
+
+  snprintf(buffer, size, "%s#%lu%s%s", name ? name : typeName, (unsigned long) elementId, propertyName ? "." : "", propertyName ? propertyName : "");
+  free(name);
+}
@@ -1,6 +1,7 @@
 #include "guihck.h"
 #include "guihckGuile.h"
 #include "internal.h"
+#include "guihckKeysTable.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -8,7 +9,14 @@
 #include <assert.h>
 #include <stdint.h>
 
-static void _guihckContextAddDefaultKeybindings(guihckContext* ctx);
+/* Script cache entries start with the 16 hex digit path hash and a dash */
+#define _GUIHCK_SCRIPT_CACHE_PREFIX_LENGTH 17
+
+static const char* _guihckDefaultKeyName(guihckKey keyCode);
+static guihckKey _guihckDefaultKeyCode(const char* keyName);
+static void _guihckContextCreateKeyValues(guihckContext* ctx);
+static void _guihckContextFreeKeyHandlers(guihckContext* ctx);
+static void _guihckContextBuildKeyHandlers(guihckContext* ctx, guihckElementId elementId);
 
 void guihckInit()
 {
@@ -20,39 +28,66 @@ void guihckRegisterFunction(const char* name, int req, int opt, int rst, scm_t_s
   guihckGuileRegisterFunction(name, req, opt, rst, func);
 }
 
+void guihckLoadDefinitions(const char* name, const char* source)
+{
+  /* Loaded once per process, from name.go if precompiled and source otherwise */
+  guihckGuileLoadDefinitions(name, source);
+}
+
 guihckContext* guihckContextNew()
+{
+  guihckTypeRegistry* types = guihckTypeRegistryNew();
+  guihckContext* ctx = guihckContextNewWithTypes(types);
+  guihckTypeRegistryFree(types);
+  return ctx;
+}
+
+guihckContext* guihckContextNewWithTypes(guihckTypeRegistry* types)
 {
   guihckContext* ctx = calloc(1, sizeof(guihckContext));
+  guihckContextNotifyDepthLimit(ctx, _GUIHCK_NOTIFY_DEPTH_LIMIT);
   ctx->elements = chckPoolNew(64, 64, sizeof(guihckElement));
-  ctx->elementTypes = chckPoolNew(16, 16, sizeof(_guihckElementType));
-  ctx->elementTypesByName = chckHashTableNew(32);
+  ctx->types = guihckTypeRegistryRef(types);
   ctx->renderOrder = chckIterPoolNew(64, 64, sizeof(guihckElementId));
   ctx->renderOrderChanged = false;
 
   ctx->mouseAreas = chckPoolNew(16, 16, sizeof(_guihckMouseArea));
+  ctx->hoveredMouseAreas = chckIterPoolNew(4, 4, sizeof(guihckMouseAreaId));
+  ctx->pressedMouseAreas = chckIterPoolNew(4, 4, sizeof(guihckMouseAreaId));
+  ctx->capturedMouseArea = GUIHCK_NO_MOUSE_AREA;
+  ctx->pointerX = 0;
+  ctx->pointerY = 0;
+  ctx->pointerDirty = false;
   ctx->stack = chckIterPoolNew(16, 16, sizeof(guihckElementId));
   ctx->propertyListeners = chckPoolNew(16, 16, sizeof(_guihckPropertyListener));
+  ctx->keyHandlers = chckIterPoolNew(8, 8, sizeof(_guihckKeyHandler));
+  ctx->keyHandlersChanged = true;
+  ctx->accelerators = chckHashTableNew(32);
 
-  guihckElementTypeFunctionMap rootElementFunctionMap = { NULL, NULL, NULL, NULL, NULL, NULL };
-  guihckElementTypeId rootTypeId = guihckElementTypeAdd(ctx, "root", rootElementFunctionMap, 0);
-  ctx->rootElementId = guihckElementNew(ctx, rootTypeId, GUIHCK_NO_PARENT);
+  ctx->rootElementId = guihckElementNew(ctx, guihckTypeRegistryGetType(types, "root"), GUIHCK_NO_PARENT);
   guihckElementProperty(ctx, ctx->rootElementId, "id", scm_from_utf8_symbol("root"));
   guihckStackPushElement(ctx, ctx->rootElementId);
   ctx->focused = ctx->rootElementId;
 
-  ctx->keyCodesByName = chckHashTableNew(32);
-  ctx->keyNamesByCode = chckHashTableNew(32);
+  /* Default key names live in static tables, these only hold custom bindings */
+  ctx->keyCodesByName = NULL;
+  ctx->keyNamesByCode = NULL;
 
-  _guihckContextAddDefaultKeybindings(ctx);
+  _guihckContextCreateKeyValues(ctx);
 
   ctx->time = 0;
 
+  const char* scriptCacheDirectory = getenv("GUIHCK_SCRIPT_CACHE_DIR");
+  ctx->scriptCacheDirectory = scriptCacheDirectory ? strdup(scriptCacheDirectory) : NULL;
+
   return ctx;
 }
 
 
 void guihckContextFree(guihckContext* ctx)
 {
+  _guihckAnimationsFree(ctx);
+
   {
     chckPoolIndex iter = 0;
     _guihckPropertyListener* listener;
@@ -60,7 +95,8 @@ void guihckContextFree(guihckContext* ctx)
     {
       if(listener->freeCallback)
         listener->freeCallback(ctx, listener->listenerId, listener->listenedId, listener->propertyName, SCM_UNDEFINED, listener->data);
-      free(listener->propertyName);
+      _GUIHCK_FREE(ctx, listener->propertyName);
+      _GUIHCK_MEMORY_UNCOUNT(ctx, GUIHCK_MEMORY_LISTENERS, sizeof(_guihckPropertyListener));
     }
     chckPoolFree(ctx->propertyListeners);
   }
@@ -70,7 +106,7 @@ void guihckContextFree(guihckContext* ctx)
     guihckElement* current;
     while ((current = chckPoolIter(ctx->elements, &iter)))
     {
-      _guihckElementType* type = chckPoolGet(ctx->elementTypes, current->type);
+      _guihckElementType* type = chckPoolGet(ctx->types->elementTypes, current->type);
       if(type->functionMap.destroy)
         type->functionMap.destroy(ctx, iter - 1, current->data); /* id = iter - 1 */
 
@@ -81,13 +117,27 @@ void guihckContextFree(guihckContext* ctx)
       chckHashTableIterator pIter = {NULL, 0};
       while((property = chckHashTableIter(current->properties, &pIter)))
       {
+        _GUIHCK_FREE(ctx, property->name);
+        _guihckPropertyFreeNative(ctx, property);
+        _GUIHCK_MEMORY_UNCOUNT(ctx, GUIHCK_MEMORY_PROPERTIES, sizeof(_guihckProperty));
         if(property->listeners)
           chckIterPoolFree(property->listeners);
 
         if(property->type == GUIHCK_PROPERTY_BIND)
         {
+          _guihckBoundProperty* bound;
+          chckPoolIndex bIter = 0;
+          while((bound = chckIterPoolIter(property->bind.bound, &bIter)))
+          {
+            if(!scm_is_eq(bound->value, SCM_UNDEFINED))
+              _GUIHCK_UNPROTECT(ctx, bound->value);
+          }
           chckIterPoolFree(property->bind.bound);
+          _GUIHCK_UNPROTECT(ctx, property->bind.function);
         }
+
+        if(!scm_is_eq(property->value, SCM_UNDEFINED))
+          _GUIHCK_UNPROTECT(ctx, property->value);
       }
 
       if(current->properties)
@@ -95,15 +145,35 @@ void guihckContextFree(guihckContext* ctx)
       if(current->children)
         chckIterPoolFree(current->children);
       if(current->data)
-        free(current->data);
+        _GUIHCK_FREE(ctx, current->data);
+      _GUIHCK_MEMORY_UNCOUNT(ctx, GUIHCK_MEMORY_ELEMENTS, sizeof(guihckElement));
     }
   }
 
+  guihckContextProfiling(ctx, false);
+  guihckContextRetainedRendering(ctx, false);
+  guihckContextRecordStop(ctx);
+  if(ctx->trace)
+  {
+    free(ctx->trace->events);
+    free(ctx->trace);
+  }
+  free(ctx->notifyPath);
+  free(ctx->notifyCycle);
+  _GUIHCK_FREE(ctx, ctx->convertedString);
+
+  {
+    chckPoolIndex iter = 0;
+    while(chckPoolIter(ctx->mouseAreas, &iter))
+      _GUIHCK_MEMORY_UNCOUNT(ctx, GUIHCK_MEMORY_MOUSE_AREAS, sizeof(_guihckMouseArea));
+  }
+  chckIterPoolFree(ctx->hoveredMouseAreas);
+  chckIterPoolFree(ctx->pressedMouseAreas);
   chckPoolFree(ctx->mouseAreas);
   chckPoolFree(ctx->elements);
-  chckHashTableFree(ctx->elementTypesByName);
-  chckPoolFree(ctx->elementTypes);
+  guihckTypeRegistryFree(ctx->types);
 
+  if(ctx->keyNamesByCode)
   {
     char** keyName;
     chckHashTableIterator knIter = {NULL, 0};
@@ -111,41 +181,126 @@ void guihckContextFree(guihckContext* ctx)
     {
       free(*keyName);
     }
+
+    chckHashTableFree(ctx->keyNamesByCode);
+    chckHashTableFree(ctx->keyCodesByName);
+  }
+
+  {
+    _guihckAccelerator* accelerator;
+    chckHashTableIterator aIter = {NULL, 0};
+    while((accelerator = chckHashTableIter(ctx->accelerators, &aIter)))
+    {
+      if(accelerator->callback && accelerator->freeCallback)
+        accelerator->freeCallback(ctx, accelerator->key, accelerator->mods, accelerator->data);
+    }
+    chckHashTableFree(ctx->accelerators);
   }
 
-  chckHashTableFree(ctx->keyNamesByCode);
-  chckHashTableFree(ctx->keyCodesByName);
+  _guihckContextFreeKeyHandlers(ctx);
+  {
+    unsigned int i;
+    for(i = 0; i < sizeof(ctx->keyActions) / sizeof(SCM); ++i)
+      _GUIHCK_UNPROTECT(ctx, ctx->keyActions[i]);
+    for(i = 0; i < sizeof(ctx->keyMods) / sizeof(SCM); ++i)
+      _GUIHCK_UNPROTECT(ctx, ctx->keyMods[i]);
+  }
 
+#if defined(GUIHCK_MEMORY_ACCOUNTING)
+  _guihckMemoryReportLeaks(ctx);
+#endif
+
+  free(ctx->damage.elements);
+  free(ctx->scriptCacheDirectory);
   free(ctx);
 }
 
 void guihckContextUpdate(guihckContext* ctx)
 {
+  if(ctx->recording)
+    _guihckRecordFrame(ctx, GUIHCK_RECORD_UPDATE);
+
+  _GUIHCK_PROFILE_BEGIN(ctx, GUIHCK_PHASE_UPDATE);
+  _GUIHCK_TRACE_BEGIN(ctx, "context", "guihckContextUpdate", GUIHCK_NO_PARENT);
+
+  /* Animated values are in place before the elements that show them update */
+  if(ctx->animations)
+  {
+    _GUIHCK_PROFILE_BEGIN(ctx, GUIHCK_PHASE_ANIMATION);
+    _GUIHCK_TRACE_BEGIN(ctx, "animation", "animations", GUIHCK_NO_PARENT);
+    _guihckAnimationsUpdate(ctx);
+    _GUIHCK_TRACE_END(ctx, "animation");
+    _GUIHCK_PROFILE_END(ctx, GUIHCK_PHASE_ANIMATION);
+  }
+
   chckPoolIndex iter = 0;
   guihckElement* current;
   while ((current = chckPoolIter(ctx->elements, &iter)))
   {
-    if(current->dirty)
+    if(current->changed && !(current->culled && ctx->cullUpdates))
     {
-      _guihckElementType* type = chckPoolGet(ctx->elementTypes, current->type);
+      _guihckElementType* type = chckPoolGet(ctx->types->elementTypes, current->type);
       assert(type && "Invalid element type");
-      current->dirty = false;
+
+      /* Stays dirty until the subtree is shown */
+      if(current->hidden && (type->suspend & GUIHCK_SUSPEND_UPDATE))
+        continue;
+
+      guihckPropertyMask changed = current->changed;
+      current->changed = 0;
       if(type->functionMap.update)
       {
-        if(type->functionMap.update(ctx, iter - 1, current->data)) /* id = iterator - 1 */
+        guihckTypeStats* stats = NULL;
+        double start = 0;
+        if(ctx->profiler)
+        {
+          stats = _guihckProfilerGetTypeStats(ctx, current->type);
+          start = _guihckProfilerNow();
+        }
+
+        _GUIHCK_TRACE_BEGIN(ctx, "update", type->name, iter - 1);
+        bool dirty = type->functionMap.update(ctx, iter - 1, current->data, changed); /* id = iterator - 1 */
+        _GUIHCK_TRACE_END(ctx, "update");
+
+        if(stats && ctx->profiler)
+        {
+          stats = _guihckProfilerGetTypeStats(ctx, current->type);
+          stats->updateCalls += 1;
+          stats->updateTime += _guihckProfilerNow() - start;
+        }
+
+        if(dirty)
         {
           guihckElementDirty(ctx, iter - 1);
         }
       }
     }
   }
+
+  /* Mouse areas may have moved under a still pointer */
+  if(ctx->pointerDirty)
+    _guihckContextSyncPointer(ctx);
+
+  _GUIHCK_TRACE_END(ctx, "context");
+  _GUIHCK_PROFILE_END(ctx, GUIHCK_PHASE_UPDATE);
 }
 
 
 void guihckContextRender(guihckContext* ctx)
 {
-  if(ctx->renderOrderChanged)
+  if(ctx->recording)
+    _guihckRecordFrame(ctx, GUIHCK_RECORD_RENDER);
+
+  /* Damage is measured on screen, after translations are resolved */
+  _guihckCullRefresh(ctx);
+  _guihckDamageResolve(ctx);
+
+  /* Hit testing sorts overlapping mouse areas by the render order, retained rendering needs it too */
+  bool orderChanged = ctx->renderOrderChanged;
+  if(orderChanged)
   {
+    _GUIHCK_PROFILE_BEGIN(ctx, GUIHCK_PHASE_RENDER_ORDER);
+    _GUIHCK_TRACE_BEGIN(ctx, "render-order", "render order rebuild", GUIHCK_NO_PARENT);
     ctx->renderOrderChanged = false;
     chckIterPoolFree(ctx->renderOrder);
     ctx->renderOrder = chckIterPoolNew(64, chckPoolCount(ctx->elements), sizeof(guihckElementId));
@@ -159,9 +314,14 @@ void guihckContextRender(guihckContext* ctx)
       if(!guihckElementGetVisible(ctx, *elementId))
         continue;
 
-      chckIterPoolAdd(ctx->renderOrder, elementId, NULL);
-
+      /* A culled clipping element takes its subtree with it */
       _guihckElement* element = chckPoolGet(ctx->elements, *elementId);
+      if(element->culled && element->clips)
+        continue;
+
+      if(!element->culled)
+        chckIterPoolAdd(ctx->renderOrder, elementId, NULL);
+
       chckPoolIndex iter = 0;
       guihckElementId* child;
       while((child = chckIterPoolIter(element->children, &iter)))
@@ -170,20 +330,57 @@ void guihckContextRender(guihckContext* ctx)
       }
     }
     chckRingPoolFree(stack);
+    _GUIHCK_TRACE_END(ctx, "render-order");
+    _GUIHCK_PROFILE_END(ctx, GUIHCK_PHASE_RENDER_ORDER);
   }
 
+  /* Retained rendering only refreshes the command list, the backend draws it */
+  if(ctx->commands)
+  {
+    _GUIHCK_PROFILE_BEGIN(ctx, GUIHCK_PHASE_RENDER);
+    _GUIHCK_TRACE_BEGIN(ctx, "render", "render commands", GUIHCK_NO_PARENT);
+    if(orderChanged)
+      ctx->commands->rebuild = true;
+    _guihckCommandsRefresh(ctx);
+    _GUIHCK_TRACE_END(ctx, "render");
+    _GUIHCK_PROFILE_END(ctx, GUIHCK_PHASE_RENDER);
+
+    if(ctx->profiler)
+      _guihckProfilerEndFrame(ctx);
+    return;
+  }
+
+  _GUIHCK_PROFILE_BEGIN(ctx, GUIHCK_PHASE_RENDER);
+
   chckPoolIndex iter = 0;
   guihckElementId* elementId;
   while((elementId = chckIterPoolIter(ctx->renderOrder, &iter)))
   {
     _guihckElement* element = chckPoolGet(ctx->elements, *elementId);
-    _guihckElementType* type = chckPoolGet(ctx->elementTypes, element->type);
+    _guihckElementType* type = chckPoolGet(ctx->types->elementTypes, element->type);
     if(type->functionMap.render)
     {
+      _GUIHCK_TRACE_BEGIN(ctx, "render", type->name, *elementId);
+      bool profiled = ctx->profiler != NULL;
+      double start = profiled ? _guihckProfilerNow() : 0;
       type->functionMap.render(ctx, *elementId, element->data);
+
+      /* The render callback may have disabled profiling */
+      if(profiled && ctx->profiler)
+      {
+        guihckTypeStats* stats = _guihckProfilerGetTypeStats(ctx, element->type);
+        stats->renderCalls += 1;
+        stats->renderTime += _guihckProfilerNow() - start;
+      }
+      _GUIHCK_TRACE_END(ctx, "render");
     }
   }
 
+  _GUIHCK_PROFILE_END(ctx, GUIHCK_PHASE_RENDER);
+
+  /* A frame ends with its render */
+  if(ctx->profiler)
+    _guihckProfilerEndFrame(ctx);
 }
 
 guihckElementId guihckContextGetRootElement(guihckContext* ctx)
@@ -193,28 +390,29 @@ guihckElementId guihckContextGetRootElement(guihckContext* ctx)
 
 guihckElementTypeId guihckElementTypeAdd(guihckContext* ctx, const char* name, guihckElementTypeFunctionMap functionMap, size_t dataSize)
 {
-  chckPoolIndex iter = 0;
-  _guihckElementType* current;
-  while ((current = chckPoolIter(ctx->elementTypes, &iter)))
-  {
-    assert(strcmp(current->name, name) != 0 && "Element type with this name already exists");
-  }
+  return guihckTypeRegistryAddType(guihckContextGetMutableTypes(ctx), name, functionMap, dataSize);
+}
 
-  _guihckElementType type;
-  type.name = strdup(name);
-  type.functionMap = functionMap;
-  type.dataSize = dataSize;
+void guihckElementTypeSuspendHidden(guihckContext* ctx, guihckElementTypeId typeId, int flags)
+{
+  guihckTypeRegistrySuspendHidden(guihckContextGetMutableTypes(ctx), typeId, flags);
+}
 
-  guihckElementTypeId id = -1;
-  chckPoolAdd(ctx->elementTypes, &type, &id);
-  chckHashTableStrSet(ctx->elementTypesByName, name, &id, sizeof(guihckElementTypeId));
+void guihckElementTypeEmitsCommands(guihckContext* ctx, guihckElementTypeId typeId, bool emits)
+{
+  guihckTypeRegistryEmitsCommands(guihckContextGetMutableTypes(ctx), typeId, emits);
+}
 
-  return id;
+void guihckElementTypeSchema(guihckContext* ctx, guihckElementTypeId typeId, const guihckPropertySchema* schema, size_t count)
+{
+  guihckTypeRegistrySchema(guihckContextGetMutableTypes(ctx), typeId, schema, count);
 }
+
 void guihckContextKeyboardFocus(guihckContext* ctx, guihckElementId elementId)
 {
   guihckElementProperty(ctx, ctx->focused, "focus", SCM_BOOL_F);
   ctx->focused = elementId;
+  ctx->keyHandlersChanged = true;
   guihckElementProperty(ctx, elementId, "focus", SCM_BOOL_T);
 }
 
@@ -225,13 +423,20 @@ guihckElementId guihckContextGetKeyboardFocus(guihckContext* ctx)
 
 void guihckContextAddKeyBinding(guihckContext* ctx, guihckKey keyCode, const char* keyName)
 {
-  if(chckHashTableGet(ctx->keyNamesByCode, keyCode) == NULL)
+  if(!ctx->keyNamesByCode)
+  {
+    ctx->keyNamesByCode = chckHashTableNew(32);
+    ctx->keyCodesByName = chckHashTableNew(32);
+  }
+
+  /* Existing bindings, default ones included, are never overridden */
+  if(guihckContextGetKeyName(ctx, keyCode) == NULL)
   {
     char* keyNameCopy = strdup(keyName);
     chckHashTableSet(ctx->keyNamesByCode, keyCode, &keyNameCopy, sizeof(char*));
   }
 
-  if(chckHashTableStrGet(ctx->keyCodesByName, keyName) == NULL)
+  if(guihckContextGetKeyCode(ctx, keyName) == GUIHCK_KEY_UNKNOWN)
   {
     chckHashTableStrSet(ctx->keyCodesByName, keyName, &keyCode, sizeof(guihckKey));
   }
@@ -239,111 +444,177 @@ void guihckContextAddKeyBinding(guihckContext* ctx, guihckKey keyCode, const cha
 
 const char* guihckContextGetKeyName(guihckContext* ctx, guihckKey keyCode)
 {
+  const char* name = _guihckDefaultKeyName(keyCode);
+  if(name || !ctx->keyNamesByCode)
+    return name;
+
   const char** result = chckHashTableGet(ctx->keyNamesByCode, keyCode);
   return result ? *result : NULL;
 }
 
 guihckKey guihckContextGetKeyCode(guihckContext* ctx, const char* keyName)
 {
+  guihckKey code = _guihckDefaultKeyCode(keyName);
+  if(code != GUIHCK_KEY_UNKNOWN || !ctx->keyCodesByName)
+    return code;
+
   guihckKey* result = chckHashTableStrGet(ctx->keyCodesByName, keyName);
   return result ? *result : GUIHCK_KEY_UNKNOWN;
 }
 
+void guihckContextAddAccelerator(guihckContext* ctx, guihckKey key, guihckKeyMods mods, guihckAcceleratorCallback callback, void* data,
+                                 guihckAcceleratorFreeCallback freeCallback)
+{
+  guihckContextRemoveAccelerator(ctx, key, mods);
+
+  _guihckAccelerator accelerator;
+  accelerator.key = key;
+  accelerator.mods = mods & _GUIHCK_KEY_MODS_MASK;
+  accelerator.callback = callback;
+  accelerator.data = data;
+  accelerator.freeCallback = freeCallback;
+
+  _guihckAccelerator* existing = chckHashTableGet(ctx->accelerators, _GUIHCK_ACCELERATOR_KEY(key, mods));
+  if(existing)
+    *existing = accelerator;
+  else
+    chckHashTableSet(ctx->accelerators, _GUIHCK_ACCELERATOR_KEY(key, mods), &accelerator, sizeof(_guihckAccelerator));
+}
+
+void guihckContextRemoveAccelerator(guihckContext* ctx, guihckKey key, guihckKeyMods mods)
+{
+  /* Removed entries stay in the table with no callback and are reused */
+  _guihckAccelerator* accelerator = chckHashTableGet(ctx->accelerators, _GUIHCK_ACCELERATOR_KEY(key, mods));
+  if(!accelerator || !accelerator->callback)
+    return;
+
+  guihckAcceleratorFreeCallback freeCallback = accelerator->freeCallback;
+  void* data = accelerator->data;
+  accelerator->callback = NULL;
+  accelerator->data = NULL;
+  accelerator->freeCallback = NULL;
+
+  if(freeCallback)
+    freeCallback(ctx, key, mods & _GUIHCK_KEY_MODS_MASK, data);
+}
+
 void guihckContextKeyboardKey(guihckContext* ctx, guihckKey key, int scancode, guihckKeyAction action, guihckKeyMods mods)
 {
-  guihckElementId id = ctx->focused;
+  if(ctx->recording)
+    _guihckRecordKey(ctx, key, scancode, action, mods);
+
+  _GUIHCK_PROFILE_BEGIN(ctx, GUIHCK_PHASE_EVENTS);
+
+  /* Accelerators take precedence over the focus chain */
+  _guihckAccelerator* accelerator = chckHashTableGet(ctx->accelerators, _GUIHCK_ACCELERATOR_KEY(key, mods));
+  if(accelerator && accelerator->callback && accelerator->callback(ctx, key, action, mods & _GUIHCK_KEY_MODS_MASK, accelerator->data))
+  {
+    _GUIHCK_PROFILE_END(ctx, GUIHCK_PHASE_EVENTS);
+    return;
+  }
+
+  if(ctx->keyHandlersChanged && ctx->keyDispatching == 0)
+    _guihckContextBuildKeyHandlers(ctx, ctx->focused);
 
   SCM keyScm = scm_from_int32(key);
   SCM scancodeScm = scm_from_int32(scancode);
-  SCM actionScm =
-      action == GUIHCK_KEY_PRESS ? scm_from_utf8_symbol("press") :
-      action == GUIHCK_KEY_RELEASE ? scm_from_utf8_symbol("release") :
-      action == GUIHCK_KEY_PRESS ? scm_from_utf8_symbol("repeat") :
-      scm_from_utf8_symbol("unknown");
-  actionScm = scm_list_2(scm_sym_quote, actionScm);
-
-  SCM modsScm = SCM_EOL;
-  if(mods & GUIHCK_MOD_SHIFT)
-    modsScm = scm_cons(scm_from_utf8_symbol("shift"), modsScm);
-  if(mods & GUIHCK_MOD_ALT)
-    modsScm = scm_cons(scm_from_utf8_symbol("alt"), modsScm);
-  if(mods & GUIHCK_MOD_CONTROL)
-    modsScm = scm_cons(scm_from_utf8_symbol("control"), modsScm);
-  if(mods & GUIHCK_MOD_SUPER)
-    modsScm = scm_cons(scm_from_utf8_symbol("super"), modsScm);
-  modsScm = scm_list_2(scm_sym_quote, modsScm);
-
-  /* Move up the element tree until someone handles the event */
+  SCM actionScm = _guihckContextGetKeyAction(ctx, action);
+  SCM modsScm = ctx->keyMods[mods & _GUIHCK_KEY_MODS_MASK];
+
+  /* Move up the cached handler chain until someone handles the event */
   bool handled = false;
-  while(!handled && id != GUIHCK_NO_PARENT)
+  chckPoolIndex iter = 0;
+  _guihckKeyHandler* handler;
+  ctx->keyDispatching += 1;
+  while(!handled && (handler = chckIterPoolIter(ctx->keyHandlers, &iter)))
   {
-    /* First attempt to call native handler */
+    guihckElementId id = handler->elementId;
+
+    /* A handler may have removed the rest of the chain, the rebuild waits for the next event */
     guihckElement* element = chckPoolGet(ctx->elements, id);
-    _guihckElementType* elementType = chckPoolGet(ctx->elementTypes, element->type);
-    if(elementType->functionMap.keyChar)
+    if(!element)
+      continue;
+
+    /* First attempt to call native handler */
+    _guihckElementType* elementType = chckPoolGet(ctx->types->elementTypes, element->type);
+    if(elementType->functionMap.keyEvent)
     {
       handled = elementType->functionMap.keyEvent(ctx, id, key, scancode, action, mods, element->data);
     }
 
     /* Second try to call a script handler */
-    if(!handled)
+    if(!handled && !scm_is_eq(handler->onKey, SCM_UNDEFINED))
     {
-      SCM handler = guihckElementGetProperty(ctx, id, "on-key");
-      if(scm_is_true(scm_procedure_p(handler)))
-      {
-        SCM expression = scm_list_5(handler, keyScm, scancodeScm, actionScm, modsScm);
-        guihckStackPushElement(ctx, id);
-        SCM result = guihckContextExecuteExpression(ctx, expression);
-        guihckStackPopElement(ctx);
-        handled = scm_is_eq(result, SCM_BOOL_T);
-      }
+      SCM expression = scm_list_5(handler->onKey, keyScm, scancodeScm, actionScm, modsScm);
+      guihckStackPushElement(ctx, id);
+      SCM result = guihckContextExecuteExpression(ctx, expression);
+      guihckStackPopElement(ctx);
+      handled = scm_is_eq(result, SCM_BOOL_T);
     }
 
-    id = guihckElementGetParent(ctx, id);
   }
+  ctx->keyDispatching -= 1;
 
+  _GUIHCK_PROFILE_END(ctx, GUIHCK_PHASE_EVENTS);
 }
 
 void guihckContextKeyboardChar(guihckContext* ctx, unsigned int codepoint)
 {
-  guihckElementId id = ctx->focused;
+  if(ctx->recording)
+    _guihckRecordChar(ctx, codepoint);
+
+  _GUIHCK_PROFILE_BEGIN(ctx, GUIHCK_PHASE_EVENTS);
+
+  if(ctx->keyHandlersChanged && ctx->keyDispatching == 0)
+    _guihckContextBuildKeyHandlers(ctx, ctx->focused);
+
   SCM codepointChar = scm_integer_to_char(scm_from_uint32(codepoint));
 
-  /* Move up the element tree until someone handles the event */
+  /* Move up the cached handler chain until someone handles the event */
   bool handled = false;
-  while(!handled && id != GUIHCK_NO_PARENT)
+  chckPoolIndex iter = 0;
+  _guihckKeyHandler* handler;
+  ctx->keyDispatching += 1;
+  while(!handled && (handler = chckIterPoolIter(ctx->keyHandlers, &iter)))
   {
-    /* First attempt to call native handler */
+    guihckElementId id = handler->elementId;
+
+    /* A handler may have removed the rest of the chain, the rebuild waits for the next event */
     guihckElement* element = chckPoolGet(ctx->elements, id);
-    _guihckElementType* elementType = chckPoolGet(ctx->elementTypes, element->type);
+    if(!element)
+      continue;
+
+    /* First attempt to call native handler */
+    _guihckElementType* elementType = chckPoolGet(ctx->types->elementTypes, element->type);
     if(elementType->functionMap.keyChar)
     {
       handled = elementType->functionMap.keyChar(ctx, id, codepoint, element->data);
     }
 
     /* Second try to call a script handler */
-    if(!handled)
+    if(!handled && !scm_is_eq(handler->onChar, SCM_UNDEFINED))
     {
-      SCM handler = guihckElementGetProperty(ctx, id, "on-char");
-      if(scm_is_true(scm_procedure_p(handler)))
-      {
-        SCM expression = scm_list_2(handler, codepointChar);
-        guihckStackPushElement(ctx, id);
-        SCM result = guihckContextExecuteExpression(ctx, expression);
-        guihckStackPopElement(ctx);
+      SCM expression = scm_list_2(handler->onChar, codepointChar);
+      guihckStackPushElement(ctx, id);
+      SCM result = guihckContextExecuteExpression(ctx, expression);
+      guihckStackPopElement(ctx);
 
-        handled = scm_is_eq(result, SCM_BOOL_T);
-      }
+      handled = scm_is_eq(result, SCM_BOOL_T);
     }
 
-    id = guihckElementGetParent(ctx, id);
   }
+  ctx->keyDispatching -= 1;
+
+  _GUIHCK_PROFILE_END(ctx, GUIHCK_PHASE_EVENTS);
 }
 
 void guihckContextTime(guihckContext* ctx, double time)
 {
   assert(time >= ctx->time && "Backwards time travel not allowed");
   ctx->time = time;
+
+  if(ctx->recording)
+    _guihckRecordTime(ctx, time);
 }
 
 double guihckContextGetTime(guihckContext* ctx)
@@ -355,46 +626,176 @@ double guihckContextGetTime(guihckContext* ctx)
 
 SCM guihckContextExecuteExpression(guihckContext* ctx, SCM expression)
 {
-  return guihckGuileRunExpression(ctx, expression);
+  _GUIHCK_PROFILE_COUNT(ctx, schemeCalls);
+  _GUIHCK_TRACE_BEGIN(ctx, "scheme", "expression", guihckStackGetElement(ctx));
+  SCM result = guihckGuileRunExpression(ctx, expression);
+  _GUIHCK_TRACE_END(ctx, "scheme");
+  return result;
 }
 
 SCM guihckContextExecuteScript(guihckContext* ctx, const char* script)
 {
-  return guihckGuileRunScript(ctx, script);
+  _GUIHCK_PROFILE_COUNT(ctx, schemeCalls);
+  _GUIHCK_TRACE_BEGIN(ctx, "scheme", "script", GUIHCK_NO_PARENT);
+  SCM result = guihckGuileRunScript(ctx, script);
+  _GUIHCK_TRACE_END(ctx, "scheme");
+  return result;
 }
 
 SCM guihckContextExecuteScriptFile(guihckContext* ctx, const char* path)
 {
-  FILE* file;
+  _GUIHCK_PROFILE_COUNT(ctx, schemeCalls);
 
-  SCM result = SCM_UNDEFINED;
+  _guihckMappedFile file;
+  if(!_guihckMappedFileOpen(&file, path))
+    return SCM_UNDEFINED;
 
-  if((file = fopen(path, "rb")))
+  char cachePath[1024];
+  bool cached = false;
+  bool compiled = false;
+  if(ctx->scriptCacheDirectory)
   {
-    /* Read file into memory */
-    fseek(file, 0, SEEK_END);
-    long pos = ftell(file);
-    fseek(file, 0, SEEK_SET);
-    char* contents = calloc(pos, 1);
-    fread(contents, pos, 1, file);
-    fclose(file);
-
-    result = guihckContextExecuteScript(ctx, contents);
-    free(contents);
+    /* Entries are named by the script path and by anything that changes its
+     * bytecode, any change to the script or the Guile version gets a new one */
+    const int version[] = {SCM_MAJOR_VERSION, SCM_MINOR_VERSION, SCM_MICRO_VERSION};
+    int64_t mtime = file.mtime;
+    uint64_t pathHash = _guihckHashBytes(_GUIHCK_HASH_INIT, path, strlen(path) + 1);
+    uint64_t hash = _GUIHCK_HASH_INIT;
+    hash = _guihckHashBytes(hash, version, sizeof(version));
+    hash = _guihckHashBytes(hash, &mtime, sizeof(mtime));
+    hash = _guihckHashBytes(hash, file.data, file.size);
+
+    int n = snprintf(cachePath, sizeof(cachePath), "%s/%016llx-%016llx.go", ctx->scriptCacheDirectory,
+                     (unsigned long long) pathHash, (unsigned long long) hash);
+    cached = n > 0 && n < (int) sizeof(cachePath);
+
+    FILE* existing = cached ? fopen(cachePath, "rb") : NULL;
+    if(existing)
+      fclose(existing);
+    compiled = cached && !existing;
   }
 
+  SCM result = guihckGuileRunScriptFile(ctx, path, file.data, file.size, cached ? cachePath : NULL);
+  _guihckMappedFileClose(&file);
+
+  /* A new entry replaces the ones of earlier versions of the same script */
+  if(compiled)
+    _guihckCacheEvict(cachePath, _GUIHCK_SCRIPT_CACHE_PREFIX_LENGTH);
+
   return result;
 }
 
-void _guihckContextAddDefaultKeybindings(guihckContext* ctx)
+void guihckContextSetScriptCacheDirectory(guihckContext* ctx, const char* path)
 {
-  size_t n;
-  const guihckDefaultKeyBinding* bindings = guihckGetDefaultKeyBindings(&n);
+  free(ctx->scriptCacheDirectory);
+  ctx->scriptCacheDirectory = path ? strdup(path) : NULL;
+}
+
+const char* guihckContextGetScriptCacheDirectory(guihckContext* ctx)
+{
+  return ctx->scriptCacheDirectory;
+}
+
+const char* _guihckDefaultKeyName(guihckKey keyCode)
+{
+  return (unsigned int) keyCode <= GUIHCK_KEY_LAST ? _guihckKeyNames[keyCode] : NULL;
+}
+
+guihckKey _guihckDefaultKeyCode(const char* keyName)
+{
+  /* Every default name has a slot of its own, one comparison tells if it's there */
+  uint32_t displacement = _guihckKeyHashDisplacements[_guihckKeyHashGetBucket(keyName)];
+  const _guihckKeyHashSlot* slot = &_guihckKeyHashSlots[_guihckKeyHashGetSlot(keyName, displacement)];
+  return strcmp(slot->name, keyName) == 0 ? slot->code : GUIHCK_KEY_UNKNOWN;
+}
+
+SCM _guihckContextGetKeyAction(guihckContext* ctx, guihckKeyAction action)
+{
+  return ctx->keyActions[action >= GUIHCK_KEY_RELEASE && action <= GUIHCK_KEY_REPEAT ? (int) action : GUIHCK_KEY_REPEAT + 1];
+}
+
+void _guihckContextCreateKeyValues(guihckContext* ctx)
+{
+  /* Handler arguments are passed in an evaluated expression, quote them once */
+  ctx->keyActions[GUIHCK_KEY_RELEASE] = scm_list_2(scm_sym_quote, scm_from_utf8_symbol("release"));
+  ctx->keyActions[GUIHCK_KEY_PRESS] = scm_list_2(scm_sym_quote, scm_from_utf8_symbol("press"));
+  ctx->keyActions[GUIHCK_KEY_REPEAT] = scm_list_2(scm_sym_quote, scm_from_utf8_symbol("repeat"));
+  ctx->keyActions[GUIHCK_KEY_REPEAT + 1] = scm_list_2(scm_sym_quote, scm_from_utf8_symbol("unknown"));
 
   unsigned int i;
-  for(i = 0; i < n; ++i)
+  for(i = 0; i < sizeof(ctx->keyActions) / sizeof(SCM); ++i)
+    _GUIHCK_PROTECT(ctx, ctx->keyActions[i]);
+
+  guihckKeyMods mods;
+  for(mods = 0; mods <= _GUIHCK_KEY_MODS_MASK; ++mods)
+  {
+    SCM modsScm = SCM_EOL;
+    if(mods & GUIHCK_MOD_SHIFT)
+      modsScm = scm_cons(scm_from_utf8_symbol("shift"), modsScm);
+    if(mods & GUIHCK_MOD_ALT)
+      modsScm = scm_cons(scm_from_utf8_symbol("alt"), modsScm);
+    if(mods & GUIHCK_MOD_CONTROL)
+      modsScm = scm_cons(scm_from_utf8_symbol("control"), modsScm);
+    if(mods & GUIHCK_MOD_SUPER)
+      modsScm = scm_cons(scm_from_utf8_symbol("super"), modsScm);
+    ctx->keyMods[mods] = scm_list_2(scm_sym_quote, modsScm);
+    _GUIHCK_PROTECT(ctx, ctx->keyMods[mods]);
+  }
+}
+
+void _guihckContextFreeKeyHandlers(guihckContext* ctx)
+{
+  if(!ctx->keyHandlers)
+    return;
+
+  chckPoolIndex iter = 0;
+  _guihckKeyHandler* handler;
+  while((handler = chckIterPoolIter(ctx->keyHandlers, &iter)))
+  {
+    if(!scm_is_eq(handler->onKey, SCM_UNDEFINED))
+      _GUIHCK_UNPROTECT(ctx, handler->onKey);
+    if(!scm_is_eq(handler->onChar, SCM_UNDEFINED))
+      _GUIHCK_UNPROTECT(ctx, handler->onChar);
+  }
+  chckIterPoolFree(ctx->keyHandlers);
+  ctx->keyHandlers = NULL;
+}
+
+void _guihckContextBuildKeyHandlers(guihckContext* ctx, guihckElementId elementId)
+{
+  _guihckContextFreeKeyHandlers(ctx);
+  ctx->keyHandlers = chckIterPoolNew(8, 8, sizeof(_guihckKeyHandler));
+  ctx->keyHandlersChanged = false;
+
+  /* Collect only the elements on the path to root that have a handler */
+  guihckElementId id = elementId;
+  while(id != GUIHCK_NO_PARENT)
   {
-    const guihckDefaultKeyBinding* b = &(bindings[i]);
-    guihckContextAddKeyBinding(ctx, b->code, b->name);
+    guihckElement* element = chckPoolGet(ctx->elements, id);
+    _guihckElementType* elementType = chckPoolGet(ctx->types->elementTypes, element->type);
+
+    _guihckKeyHandler handler;
+    handler.elementId = id;
+    handler.parentId = element->parent;
+    handler.onKey = guihckElementGetProperty(ctx, id, "on-key");
+    handler.onChar = guihckElementGetProperty(ctx, id, "on-char");
+
+    if(!scm_is_true(scm_procedure_p(handler.onKey)))
+      handler.onKey = SCM_UNDEFINED;
+    if(!scm_is_true(scm_procedure_p(handler.onChar)))
+      handler.onChar = SCM_UNDEFINED;
+
+    if(elementType->functionMap.keyEvent || elementType->functionMap.keyChar
+       || !scm_is_eq(handler.onKey, SCM_UNDEFINED) || !scm_is_eq(handler.onChar, SCM_UNDEFINED))
+    {
+      /* The procedures can be replaced on the element while the chain is cached */
+      if(!scm_is_eq(handler.onKey, SCM_UNDEFINED))
+        _GUIHCK_PROTECT(ctx, handler.onKey);
+      if(!scm_is_eq(handler.onChar, SCM_UNDEFINED))
+        _GUIHCK_PROTECT(ctx, handler.onChar);
+      chckIterPoolAdd(ctx->keyHandlers, &handler, NULL);
+    }
+
+    id = element->parent;
   }
 }
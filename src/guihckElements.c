@@ -1,139 +1,125 @@
 #include "guihckElements.h"
 #include "guihckElementUtils.h"
+#include "guihckElementsScm.h"
 
 #include <stdio.h>
 
-static const char GUIHCK_ITEM_SCM[] =
-    "(define (item . args)"
-    "  (define default-args (list (prop 'x 0) (prop 'y 0)))"
-    "  (create-element 'item (append default-args args)))";
-static const char GUIHCK_MOUSEAREA_SCM[] =
-    "(define (mouse-area . args)"
-    "  (define default-args (list (prop 'x 0) (prop 'y 0) (prop 'width 0) (prop 'height 0)"
-    "                             (prop 'hover #f) (prop 'pressed #f)))"
-    "  (create-element 'mouse-area (append default-args args)))";
-static const char GUIHCK_ROW_SCM[] =
-    "(define (row-gen)"
-    "  (define (align-width w)"
-    "    (let ((x 0) (spacing (get-prop 'spacing)))"
-    "      (for-each"
-    "        (lambda (child)"
-    "          (set-prop! child 'x x)"
-    "          (set! x (+ x spacing (get-prop child 'width))))"
-    "        (get-prop 'children))"
-    "      (set-prop! 'width (- x spacing))))"
-
-    "  (define (align-height h) "
-    "    (set-prop! 'height"
-    "      (apply max "
-    "        (cons 0 (map "
-    "          (lambda (c) (get-prop c 'height)) "
-    "          (get-prop 'children))))))"
-
-    "  (define (update-bindings cs)"
-    "    (let ((previous (get-prop 'listeners)))"
-    "      (if (pair? previous)"
-    "        (for-each unbind previous)))"
-    "    (align-width 0)"
-    "    (align-height 0)"
-    "    (flatmap"
-    "      (lambda (c) "
-    "        (list "
-    "          (bind c 'width align-width)"
-    "          (bind c 'height align-height)))"
-    "      cs))"
-
-    "  (define default-args (list"
-    "    (prop 'spacing 0)"
-    "    (prop 'init (lambda ()"
-    "      (bind 'spacing align-width)"
-    "      (align-width 0)))"
-    "    (prop 'listeners"
-    "      (bound '(this children) update-bindings))))"
-
-    "  (apply composite (cons item default-args)))"
-    "(define row (row-gen))"
-    ;
-
-static const char GUIHCK_COLUMN_SCM[] =
-    "(define (column-gen)"
-    "  (define (align-height h)"
-    "    (let ((y 0) (spacing (get-prop 'spacing)))"
-    "      (for-each"
-    "        (lambda (child)"
-    "          (set-prop! child 'y y)"
-    "          (set! y (+ y spacing (get-prop child 'height))))"
-    "        (get-prop 'children))"
-    "      (set-prop! 'height (- y spacing))))"
-
-    "  (define (align-width w) "
-    "    (set-prop! 'width"
-    "      (apply max "
-    "        (cons 0 (map "
-    "          (lambda (c) (get-prop c 'width)) "
-    "          (get-prop 'children))))))"
-
-    "  (define (update-bindings cs)"
-    "    (let ((previous (get-prop 'listeners)))"
-    "      (if (pair? previous)"
-    "        (for-each unbind previous)))"
-    "    (align-width 0)"
-    "    (align-height 0)"
-    "    (flatmap"
-    "      (lambda (c) "
-    "        (list "
-    "          (bind c 'width align-width)"
-    "          (bind c 'height align-height)))"
-    "      cs))"
-
-    "  (define default-args (list"
-    "    (prop 'spacing 0)"
-    "    (prop 'init (lambda ()"
-    "      (bind 'spacing align-height)"
-    "      (align-height 0)))"
-    "    (prop 'listeners"
-    "      (bound '(this children) update-bindings))))"
-
-    "  (apply composite (cons item default-args)))"
-    "(define column (column-gen))"
-    ;
-
-static const char GUIHCK_TIMER_SCM[] =
-    "(define (timer . args)"
-    "  (define default-args (list (prop 'running #f) (prop 'next-timeout -1) (prop 'interval 0) (prop 'repeat 1) (prop 'on-timeout (lambda () #f))))"
-    "  (create-element 'timer (append default-args args)))";
-
 static void initItem(guihckContext* ctx, guihckElementId id, void* data);
 
 static void initMouseArea(guihckContext* ctx, guihckElementId id, void* data);
 static void destroyMouseArea(guihckContext* ctx, guihckElementId id, void* data);
-static bool updateMouseArea(guihckContext* ctx, guihckElementId id, void* data);
+static bool updateMouseArea(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed);
 static bool mouseAreaMouseDown(guihckContext* ctx, guihckElementId id, void* data, int button, float x, float y);
 static bool mouseAreaMouseUp(guihckContext* ctx, guihckElementId id, void* data, int button, float x, float y);
 static bool mouseAreaMouseMove(guihckContext* ctx, guihckElementId id, void* data, float sx, float sy, float dx, float dy);
 static bool mouseAreaMouseEnter(guihckContext* ctx, guihckElementId id, void* data, float sx, float sy, float dx, float dy);
 static bool mouseAreaMouseExit(guihckContext* ctx, guihckElementId id, void* data, float sx, float sy, float dx, float dy);
 
-static void initTimer(guihckContext* ctx, guihckElementId id, void* data);
-static bool updateTimer(guihckContext* ctx, guihckElementId id, void* data);
+static bool updateTimer(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed);
+
+typedef struct _guihckScrollView
+{
+  guihckMouseAreaId mouseAreaId;
+  bool pressed;
+  bool dragging;
+  float pressX, pressY;
+  float pointerX, pointerY;
+  float travelX, travelY; /* pointer movement since sampleTime */
+  float velocityX, velocityY; /* content units per second */
+  double sampleTime;
+  double lastTime;
+} _guihckScrollView;
+
+static void initScrollView(guihckContext* ctx, guihckElementId id, void* data);
+static void destroyScrollView(guihckContext* ctx, guihckElementId id, void* data);
+static bool updateScrollView(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed);
+static bool scrollViewMouseDown(guihckContext* ctx, guihckElementId id, void* data, int button, float x, float y);
+static bool scrollViewMouseUp(guihckContext* ctx, guihckElementId id, void* data, int button, float x, float y);
+static bool scrollViewMouseMove(guihckContext* ctx, guihckElementId id, void* data, float sx, float sy, float dx, float dy);
+static float getReal(guihckContext* ctx, guihckElementId id, const char* key, float fallback);
+static float clampContent(float value, float contentSize, float viewSize);
+static float decelerate(float velocity, float amount);
+
+/* SCM entries keep no native value, they only mark the element dirty when the property changes */
+static const guihckPropertySchema mouseAreaSchema[] = {
+  {"absolute-x", GUIHCK_VALUE_SCM, {0}, true},
+  {"absolute-y", GUIHCK_VALUE_SCM, {0}, true},
+  {"width", GUIHCK_VALUE_SCM, {0}, true},
+  {"height", GUIHCK_VALUE_SCM, {0}, true}
+};
+
+static const guihckPropertySchema timerSchema[] = {
+  {"running", GUIHCK_VALUE_SCM, {0}, true}
+};
+
+/* The first four move the mouse area, the rest only the content */
+static const guihckPropertySchema scrollViewSchema[] = {
+  {"absolute-x", GUIHCK_VALUE_SCM, {0}, true},
+  {"absolute-y", GUIHCK_VALUE_SCM, {0}, true},
+  {"width", GUIHCK_VALUE_SCM, {0}, true},
+  {"height", GUIHCK_VALUE_SCM, {0}, true},
+  {"content-x", GUIHCK_VALUE_SCM, {0}, true},
+  {"content-y", GUIHCK_VALUE_SCM, {0}, true},
+  {"content-width", GUIHCK_VALUE_SCM, {0}, true},
+  {"content-height", GUIHCK_VALUE_SCM, {0}, true}
+};
+#define SCROLL_VIEW_RECT_CHANGED (GUIHCK_PROPERTY_BIT(0) | GUIHCK_PROPERTY_BIT(1) | GUIHCK_PROPERTY_BIT(2) | GUIHCK_PROPERTY_BIT(3))
 
 void guihckElementsAddAllTypes(guihckContext* ctx)
 {
-  guihckElementsAddItemType(ctx);
-  guihckElementsAddMouseAreaType(ctx);
-  guihckElementsAddRowType(ctx);
-  guihckElementsAddColumnType(ctx);
-  guihckElementsAddTimerType(ctx);
+  guihckElementsRegisterAllTypes(guihckContextGetMutableTypes(ctx));
 }
 
 void guihckElementsAddItemType(guihckContext* ctx)
 {
-  guihckElementTypeFunctionMap functionMap = { initItem, NULL, NULL, NULL, NULL, NULL };
-  guihckElementTypeAdd(ctx, "item", functionMap, 0);
-  guihckContextExecuteScript(ctx, GUIHCK_ITEM_SCM);
+  guihckElementsRegisterItemType(guihckContextGetMutableTypes(ctx));
 }
 
 void guihckElementsAddMouseAreaType(guihckContext* ctx)
+{
+  guihckElementsRegisterMouseAreaType(guihckContextGetMutableTypes(ctx));
+}
+
+void guihckElementsAddRowType(guihckContext* ctx)
+{
+  /* Built from items in Scheme, a shared registry is left shared */
+  guihckElementsRegisterRowType(guihckContextGetTypes(ctx));
+}
+
+void guihckElementsAddColumnType(guihckContext* ctx)
+{
+  /* Built from items in Scheme, a shared registry is left shared */
+  guihckElementsRegisterColumnType(guihckContextGetTypes(ctx));
+}
+
+void guihckElementsAddTimerType(guihckContext* ctx)
+{
+  guihckElementsRegisterTimerType(guihckContextGetMutableTypes(ctx));
+}
+
+void guihckElementsAddScrollViewType(guihckContext* ctx)
+{
+  guihckElementsRegisterScrollViewType(guihckContextGetMutableTypes(ctx));
+}
+
+void guihckElementsRegisterAllTypes(guihckTypeRegistry* types)
+{
+  guihckElementsRegisterItemType(types);
+  guihckElementsRegisterMouseAreaType(types);
+  guihckElementsRegisterRowType(types);
+  guihckElementsRegisterColumnType(types);
+  guihckElementsRegisterTimerType(types);
+  guihckElementsRegisterScrollViewType(types);
+}
+
+void guihckElementsRegisterItemType(guihckTypeRegistry* types)
+{
+  guihckElementTypeFunctionMap functionMap = { initItem, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+  guihckTypeRegistryAddType(types, "item", functionMap, 0);
+  guihckLoadDefinitions(GUIHCK_SCM_ITEM_NAME, GUIHCK_SCM_ITEM);
+}
+
+void guihckElementsRegisterMouseAreaType(guihckTypeRegistry* types)
 {
   guihckElementTypeFunctionMap functionMap = {
     initMouseArea,
@@ -141,33 +127,62 @@ void guihckElementsAddMouseAreaType(guihckContext* ctx)
     updateMouseArea,
     NULL,
     NULL,
+    NULL,
+    NULL,
     NULL
   };
-  guihckElementTypeAdd(ctx, "mouse-area", functionMap, sizeof(guihckMouseAreaId));
-  guihckContextExecuteScript(ctx, GUIHCK_MOUSEAREA_SCM);
+  guihckElementTypeId typeId = guihckTypeRegistryAddType(types, "mouse-area", functionMap, sizeof(guihckMouseAreaId));
+  guihckTypeRegistrySchema(types, typeId, mouseAreaSchema, sizeof(mouseAreaSchema) / sizeof(guihckPropertySchema));
+  guihckTypeRegistrySuspendHidden(types, typeId, GUIHCK_SUSPEND_UPDATE);
+  guihckLoadDefinitions(GUIHCK_SCM_MOUSE_AREA_NAME, GUIHCK_SCM_MOUSE_AREA);
 }
 
-void guihckElementsAddRowType(guihckContext* ctx)
+void guihckElementsRegisterRowType(guihckTypeRegistry* types)
 {
-  guihckContextExecuteScript(ctx, GUIHCK_ROW_SCM);
+  (void) types;
+  guihckLoadDefinitions(GUIHCK_SCM_ROW_NAME, GUIHCK_SCM_ROW);
 }
-void guihckElementsAddColumnType(guihckContext* ctx)
+
+void guihckElementsRegisterColumnType(guihckTypeRegistry* types)
 {
-  guihckContextExecuteScript(ctx, GUIHCK_COLUMN_SCM);
+  (void) types;
+  guihckLoadDefinitions(GUIHCK_SCM_COLUMN_NAME, GUIHCK_SCM_COLUMN);
 }
 
-void guihckElementsAddTimerType(guihckContext* ctx)
+void guihckElementsRegisterTimerType(guihckTypeRegistry* types)
 {
   guihckElementTypeFunctionMap functionMap = {
-    initTimer,
+    NULL,
     NULL,
     updateTimer,
     NULL,
     NULL,
+    NULL,
+    NULL,
+    NULL
+  };
+  guihckElementTypeId typeId = guihckTypeRegistryAddType(types, "timer", functionMap, 0);
+  guihckTypeRegistrySchema(types, typeId, timerSchema, sizeof(timerSchema) / sizeof(guihckPropertySchema));
+  guihckTypeRegistrySuspendHidden(types, typeId, GUIHCK_SUSPEND_UPDATE);
+  guihckLoadDefinitions(GUIHCK_SCM_TIMER_NAME, GUIHCK_SCM_TIMER);
+}
+
+void guihckElementsRegisterScrollViewType(guihckTypeRegistry* types)
+{
+  guihckElementTypeFunctionMap functionMap = {
+    initScrollView,
+    destroyScrollView,
+    updateScrollView,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
     NULL
   };
-  guihckElementTypeAdd(ctx, "timer", functionMap, 0);
-  guihckContextExecuteScript(ctx, GUIHCK_TIMER_SCM);
+  guihckElementTypeId typeId = guihckTypeRegistryAddType(types, "scroll-view", functionMap, sizeof(_guihckScrollView));
+  guihckTypeRegistrySchema(types, typeId, scrollViewSchema, sizeof(scrollViewSchema) / sizeof(guihckPropertySchema));
+  guihckTypeRegistrySuspendHidden(types, typeId, GUIHCK_SUSPEND_UPDATE);
+  guihckLoadDefinitions(GUIHCK_SCM_SCROLL_VIEW_NAME, GUIHCK_SCM_SCROLL_VIEW);
 }
 
 void initItem(guihckContext* ctx, guihckElementId id, void* data)
@@ -188,10 +203,6 @@ void initMouseArea(guihckContext* ctx, guihckElementId id, void* data)
   };
   *((guihckMouseAreaId*) data) = guihckMouseAreaNew(ctx, id, functionMap);
   guihckElementAddParentPositionListeners(ctx, id);
-  guihckElementAddUpdateProperty(ctx, id, "absolute-x");
-  guihckElementAddUpdateProperty(ctx, id, "absolute-y");
-  guihckElementAddUpdateProperty(ctx, id, "width");
-  guihckElementAddUpdateProperty(ctx, id, "height");
 }
 
 void destroyMouseArea(guihckContext* ctx, guihckElementId id, void* data)
@@ -201,20 +212,22 @@ void destroyMouseArea(guihckContext* ctx, guihckElementId id, void* data)
   guihckMouseAreaRemove(ctx, *((guihckMouseAreaId*) data));
 }
 
-bool updateMouseArea(guihckContext* ctx, guihckElementId id, void* data)
+bool updateMouseArea(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
 {
-  SCM x = guihckElementGetProperty(ctx, id, "absolute-x");
-  SCM y = guihckElementGetProperty(ctx, id, "absolute-y");
-  SCM w = guihckElementGetProperty(ctx, id, "width");
-  SCM h = guihckElementGetProperty(ctx, id, "height");
-
   float px, py, pw, ph;
   guihckMouseAreaGetRect(ctx, *((guihckMouseAreaId*) data), &px, &py, &pw, &ph);
 
-  if(scm_to_bool(scm_real_p(x))) px = scm_to_double(x);
-  if(scm_to_bool(scm_real_p(y))) py = scm_to_double(y);
-  if(scm_to_bool(scm_real_p(w))) pw = scm_to_double(w);
-  if(scm_to_bool(scm_real_p(h))) ph = scm_to_double(h);
+  /* Schema entries are in rect order, only the changed ones are read */
+  float* rect[] = {&px, &py, &pw, &ph};
+  size_t i;
+  for(i = 0; i < sizeof(mouseAreaSchema) / sizeof(guihckPropertySchema); ++i)
+  {
+    if(!(changed & GUIHCK_PROPERTY_BIT(i)))
+      continue;
+
+    SCM value = guihckElementGetProperty(ctx, id, mouseAreaSchema[i].name);
+    if(scm_to_bool(scm_real_p(value))) *rect[i] = scm_to_double(value);
+  }
 
   guihckMouseAreaRect(ctx, *((guihckMouseAreaId*) data), px, py, pw, ph);
 
@@ -345,16 +358,13 @@ bool mouseAreaMouseExit(guihckContext* ctx, guihckElementId id, void* data, floa
   return handled;
 }
 
-void initTimer(guihckContext* ctx, guihckElementId id, void* data)
+bool updateTimer(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
 {
   (void) data;
 
-  guihckElementAddUpdateProperty(ctx, id, "running");
-}
-
-bool updateTimer(guihckContext* ctx, guihckElementId id, void* data)
-{
-  (void) data;
+  /* A running timer keeps itself dirty and gets every bit each frame, so the mask
+   * can not tell a change of running apart. The state is read in full each time */
+  (void) changed;
 
   bool running = scm_is_true(guihckElementGetProperty(ctx, id, "running"));
   if(running)
@@ -376,8 +386,10 @@ bool updateTimer(guihckContext* ctx, guihckElementId id, void* data)
 
       if(repeat < 0 || repeat > cycle)
       {
+        /* Timeouts missed while suspended or stalled fire once */
         double interval = scm_to_double(guihckElementGetProperty(ctx, id, "interval"));
-        guihckElementProperty(ctx, id, "next-timeout", scm_from_double(nextTimeout + interval));
+        double next = nextTimeout + interval;
+        guihckElementProperty(ctx, id, "next-timeout", scm_from_double(next > current ? next : current + interval));
       }
       else
       {
@@ -396,3 +408,187 @@ bool updateTimer(guihckContext* ctx, guihckElementId id, void* data)
   }
   return running;
 }
+
+/* Content is moved with a child offset, so scrolling leaves the properties of
+ * everything inside alone. content-x and content-y are the scrolled distance,
+ * released drags keep moving at the release velocity until decelerated.
+ * The view observes its mouse area, so drags past drag-threshold are taken over
+ * even when content under the pointer handled the press. That content does not
+ * get the release of a taken over drag. */
+
+void initScrollView(guihckContext* ctx, guihckElementId id, void* data)
+{
+  guihckMouseAreaFunctionMap functionMap = {
+    scrollViewMouseDown,
+    scrollViewMouseUp,
+    scrollViewMouseMove,
+    NULL,
+    NULL
+  };
+  _guihckScrollView* d = data;
+  d->mouseAreaId = guihckMouseAreaNew(ctx, id, functionMap);
+  guihckMouseAreaObserve(ctx, d->mouseAreaId, true);
+  d->lastTime = guihckContextGetTime(ctx);
+  guihckElementAddParentPositionListeners(ctx, id);
+}
+
+void destroyScrollView(guihckContext* ctx, guihckElementId id, void* data)
+{
+  (void) id;
+
+  _guihckScrollView* d = data;
+  if(guihckContextGetPointerCapture(ctx) == d->mouseAreaId)
+    guihckContextReleasePointer(ctx);
+  guihckMouseAreaRemove(ctx, d->mouseAreaId);
+}
+
+bool updateScrollView(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
+{
+  _guihckScrollView* d = data;
+  float width = getReal(ctx, id, "width", 0);
+  float height = getReal(ctx, id, "height", 0);
+  if(changed & SCROLL_VIEW_RECT_CHANGED)
+    guihckMouseAreaRect(ctx, d->mouseAreaId, getReal(ctx, id, "absolute-x", 0), getReal(ctx, id, "absolute-y", 0), width, height);
+
+  double time = guihckContextGetTime(ctx);
+  float elapsed = time > d->lastTime ? time - d->lastTime : 0;
+  d->lastTime = time;
+
+  float contentX = getReal(ctx, id, "content-x", 0);
+  float contentY = getReal(ctx, id, "content-y", 0);
+  if(!d->dragging)
+  {
+    float deceleration = getReal(ctx, id, "deceleration", 0) * elapsed;
+    contentX += d->velocityX * elapsed;
+    contentY += d->velocityY * elapsed;
+    d->velocityX = decelerate(d->velocityX, deceleration);
+    d->velocityY = decelerate(d->velocityY, deceleration);
+  }
+
+  /* Flicks stop at the edges */
+  float contentWidth = getReal(ctx, id, "content-width", 0);
+  float contentHeight = getReal(ctx, id, "content-height", 0);
+  float clampedX = clampContent(contentX, contentWidth, width);
+  float clampedY = clampContent(contentY, contentHeight, height);
+  if(clampedX != contentX)
+    d->velocityX = 0;
+  if(clampedY != contentY)
+    d->velocityY = 0;
+
+  if(clampedX != getReal(ctx, id, "content-x", 0))
+    guihckElementProperty(ctx, id, "content-x", scm_from_double(clampedX));
+  if(clampedY != getReal(ctx, id, "content-y", 0))
+    guihckElementProperty(ctx, id, "content-y", scm_from_double(clampedY));
+  guihckElementChildOffset(ctx, id, -clampedX, -clampedY);
+
+  bool moving = d->dragging || d->velocityX != 0 || d->velocityY != 0;
+  if(scm_is_true(guihckElementGetProperty(ctx, id, "moving")) != moving)
+    guihckElementProperty(ctx, id, "moving", scm_from_bool(moving));
+
+  return moving;
+}
+
+bool scrollViewMouseDown(guihckContext* ctx, guihckElementId id, void* data, int button, float x, float y)
+{
+  (void) button;
+
+  _guihckScrollView* d = data;
+  if(!scm_is_true(guihckElementGetProperty(ctx, id, "interactive")))
+    return false;
+
+  /* Content under the pointer gets the press until it turns into a drag */
+  d->pressed = true;
+  d->pressX = d->pointerX = x;
+  d->pressY = d->pointerY = y;
+  d->travelX = d->travelY = 0;
+  d->velocityX = d->velocityY = 0;
+  d->sampleTime = guihckContextGetTime(ctx);
+  return false;
+}
+
+bool scrollViewMouseUp(guihckContext* ctx, guihckElementId id, void* data, int button, float x, float y)
+{
+  (void) button;
+  (void) x;
+  (void) y;
+
+  _guihckScrollView* d = data;
+  bool dragged = d->dragging;
+  d->pressed = false;
+  d->dragging = false;
+
+  /* A pointer held still before release does not flick */
+  double time = guihckContextGetTime(ctx);
+  if(time - d->sampleTime > 0.1)
+    d->velocityX = d->velocityY = 0;
+
+  d->lastTime = time;
+  guihckElementDirty(ctx, id);
+  return dragged;
+}
+
+bool scrollViewMouseMove(guihckContext* ctx, guihckElementId id, void* data, float sx, float sy, float dx, float dy)
+{
+  (void) sx;
+  (void) sy;
+
+  _guihckScrollView* d = data;
+  if(!d->pressed)
+    return false;
+
+  if(!d->dragging)
+  {
+    float threshold = getReal(ctx, id, "drag-threshold", 0);
+    float distanceX = dx - d->pressX;
+    float distanceY = dy - d->pressY;
+    if(distanceX * distanceX + distanceY * distanceY <= threshold * threshold)
+      return false;
+
+    d->dragging = true;
+    guihckContextCapturePointer(ctx, d->mouseAreaId);
+  }
+
+  float moveX = dx - d->pointerX;
+  float moveY = dy - d->pointerY;
+  d->pointerX = dx;
+  d->pointerY = dy;
+  d->travelX += moveX;
+  d->travelY += moveY;
+
+  /* Velocity is sampled whenever time has advanced since the last sample */
+  double time = guihckContextGetTime(ctx);
+  if(time > d->sampleTime)
+  {
+    d->velocityX = -d->travelX / (time - d->sampleTime);
+    d->velocityY = -d->travelY / (time - d->sampleTime);
+    d->travelX = d->travelY = 0;
+    d->sampleTime = time;
+  }
+
+  float contentX = getReal(ctx, id, "content-x", 0) - moveX;
+  float contentY = getReal(ctx, id, "content-y", 0) - moveY;
+  guihckElementProperty(ctx, id, "content-x", scm_from_double(contentX));
+  guihckElementProperty(ctx, id, "content-y", scm_from_double(contentY));
+  return true;
+}
+
+float getReal(guihckContext* ctx, guihckElementId id, const char* key, float fallback)
+{
+  SCM value = guihckElementGetProperty(ctx, id, key);
+  return scm_is_real(value) ? scm_to_double(value) : fallback;
+}
+
+float clampContent(float value, float contentSize, float viewSize)
+{
+  float limit = contentSize > viewSize ? contentSize - viewSize : 0;
+  return value < 0 ? 0 : (value > limit ? limit : value);
+}
+
+float decelerate(float velocity, float amount)
+{
+  if(velocity > amount)
+    return velocity - amount;
+  if(velocity < -amount)
+    return velocity + amount;
+  return 0;
+}
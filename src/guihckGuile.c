@@ -1,7 +1,14 @@
 #include "guihckGuile.h"
 #include "internal.h"
-#include "guihckGuileDefaultScm.h"
+#include "guihckPreludeScm.h"
 #include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef GUIHCK_SCM_COMPILED_DIR
+# define GUIHCK_SCM_COMPILED_DIR NULL
+#endif
 
 typedef struct _guihckGuileContext
 {
@@ -18,13 +25,37 @@ typedef struct _functionDefinition
   scm_t_subr func;
 } _functionDefinition;
 
+typedef struct _scriptFile
+{
+  const char* path;
+  const char* contents;
+  size_t length;
+  const char* cachePath;
+} _scriptFile;
+
+typedef struct _definitions
+{
+  const char* name;
+  const char* source;
+} _definitions;
+
 /* Thread-local storage for guile context */
 static _GUIHCK_TLS _guihckGuileContext threadLocalContext = {NULL, 0};
 
+/* Names of definitions already loaded, shared by every context in the process */
+static SCM loadedDefinitions = NULL;
+
 static void* initGuile(void*);
 static void* registerFunction(void*);
 static void* runStringInGuile(void* data);
 static void* runExpressionInGuile(void* data);
+static void* runScriptFileInGuile(void* data);
+static SCM compileScriptBody(void* data);
+static void removeTemporaryFile(void* path);
+static void* loadDefinitionsInGuile(void* data);
+static bool loadCompiledDefinitions(const char* name);
+static SCM loadCompiledBody(void* data);
+static SCM loadCompiledHandler(void* data, SCM key, SCM args);
 static SCM guilePushNewElement(SCM typeSymbol);
 static SCM guilePushElement(SCM elementSymbol);
 static SCM guilePushElementById(SCM idSymbol);
@@ -40,6 +71,21 @@ static SCM guilePopElement();
 static SCM guileSetKeyboardFocus();
 static SCM guileKeyCode(SCM keyName);
 static SCM guileKeyName(SCM keyCode);
+static SCM guileAddAccelerator(SCM key, SCM mods, SCM handler);
+static SCM guileRemoveAccelerator(SCM key, SCM mods);
+static SCM guileCapturePointer();
+static SCM guileFrameStats();
+static SCM guileMakeTemplate(SCM description);
+static SCM guileInstantiateTemplate(SCM tmpl, SCM parent, SCM overrides);
+static void guileFreeTemplate(void* tmpl);
+static SCM guileReleasePointer();
+static SCM guileAnimationOption(SCM options, const char* name);
+static guihckEasing guileToEasing(SCM name);
+static void guileAnimationCompleteCallback(guihckContext* ctx, guihckAnimationId animationId, guihckElementId elementId, void* data);
+static void guileAnimationFreeCallback(guihckContext* ctx, guihckAnimationId animationId, void* data);
+static guihckAnimationId guileBuildAnimation(guihckContext* ctx, guihckElementId elementId, SCM description);
+static SCM guileAnimate(SCM element, SCM description, SCM options);
+static SCM guileStopAnimation(SCM animation);
 
 void guihckGuileInit()
 {
@@ -53,6 +99,12 @@ void guihckGuileRegisterFunction(const char* name, int req, int opt, int rst, sc
   scm_with_guile(registerFunction, &fd);
 }
 
+void guihckGuileLoadDefinitions(const char* name, const char* source)
+{
+  _definitions definitions = {name, source};
+  scm_with_guile(loadDefinitionsInGuile, &definitions);
+}
+
 SCM guihckGuileRunScript(guihckContext* ctx, const char* script)
 {
   threadLocalContext.ctx = ctx;
@@ -80,6 +132,22 @@ SCM guihckGuileRunScript(guihckContext* ctx, const char* script)
   return result;
 }
 
+SCM guihckGuileRunScriptFile(guihckContext* ctx, const char* path, const char* contents, size_t length, const char* cachePath)
+{
+  threadLocalContext.ctx = ctx;
+  threadLocalContext.ctxRefs += 1;
+
+  _scriptFile scriptFile = {path, contents, length, cachePath};
+  SCM result = scm_with_guile(runScriptFileInGuile, &scriptFile);
+
+  threadLocalContext.ctxRefs -= 1;
+  if(threadLocalContext.ctxRefs <= 0)
+  {
+    threadLocalContext.ctx = NULL;
+    threadLocalContext.ctxRefs = 0;
+  }
+  return result;
+}
 
 SCM guihckGuileRunExpression(guihckContext* ctx, SCM expression)
 {
@@ -129,8 +197,21 @@ void* initGuile(void* data)
   scm_c_define_gsubr("keyboard-focus!", 0, 0, 0, guileSetKeyboardFocus);
   scm_c_define_gsubr("keyboard", 1, 0, 0, guileKeyCode);
   scm_c_define_gsubr("keyboard-name", 1, 0, 0, guileKeyName);
-
-  scm_c_eval_string(GUIHCK_GUILE_DEFAULT_SCM);
+  scm_c_define_gsubr("accelerator!", 3, 0, 0, guileAddAccelerator);
+  scm_c_define_gsubr("remove-accelerator!", 2, 0, 0, guileRemoveAccelerator);
+  scm_c_define_gsubr("capture-pointer!", 0, 0, 0, guileCapturePointer);
+  scm_c_define_gsubr("release-pointer!", 0, 0, 0, guileReleasePointer);
+  scm_c_define_gsubr("frame-stats", 0, 0, 0, guileFrameStats);
+  scm_c_define_gsubr("%make-template", 1, 0, 0, guileMakeTemplate);
+  scm_c_define_gsubr("%instantiate-template!", 3, 0, 0, guileInstantiateTemplate);
+  scm_c_define_gsubr("%animate!", 3, 0, 0, guileAnimate);
+  scm_c_define_gsubr("stop-animation!", 1, 0, 0, guileStopAnimation);
+
+  if(!loadedDefinitions)
+    loadedDefinitions = scm_permanent_object(scm_c_make_hash_table(16));
+
+  _definitions prelude = {GUIHCK_SCM_PRELUDE_NAME, GUIHCK_SCM_PRELUDE};
+  loadDefinitionsInGuile(&prelude);
 
   return NULL;
 }
@@ -146,6 +227,126 @@ void* runStringInGuile(void* data)
   return scm_c_eval_string((*(const char**) data));
 }
 
+void* runScriptFileInGuile(void* data)
+{
+  _scriptFile* scriptFile = data;
+
+  if(scriptFile->cachePath)
+  {
+    FILE* cached = fopen(scriptFile->cachePath, "rb");
+    if(cached)
+      fclose(cached);
+
+    /* Only compilation is guarded, errors raised by the script itself must not run it twice */
+    if(cached || scm_is_true(scm_internal_catch(SCM_BOOL_T, compileScriptBody, scriptFile, loadCompiledHandler, (void*) scriptFile->path)))
+      return scm_load_compiled_with_vm(scm_from_locale_string(scriptFile->cachePath));
+  }
+
+  return scm_eval_string(scm_from_utf8_stringn(scriptFile->contents, scriptFile->length));
+}
+
+SCM compileScriptBody(void* data)
+{
+  _scriptFile* scriptFile = data;
+
+  /* Compile the contents that were hashed, in the module holding the prelude's
+   * bindings and syntax, the file on disk may have changed since */
+  SCM port = scm_open_input_string(scm_from_utf8_stringn(scriptFile->contents, scriptFile->length));
+  SCM forms = SCM_EOL;
+  SCM form;
+  while(!SCM_EOF_OBJECT_P(form = scm_read(port)))
+    forms = scm_cons(form, forms);
+
+  /* An empty (begin) is a syntax error, the leading unspecified value lets empty scripts compile */
+  forms = scm_cons(scm_list_3(scm_from_utf8_symbol("if"), SCM_BOOL_F, SCM_BOOL_F), scm_reverse_x(forms, SCM_EOL));
+
+  SCM objcode = scm_call_5(scm_c_public_ref("system base compile", "compile"),
+                           scm_cons(scm_from_utf8_symbol("begin"), forms),
+                           scm_from_locale_keyword("env"), scm_current_module(),
+                           scm_from_locale_keyword("to"), scm_from_utf8_symbol("objcode"));
+
+  /* Written next to the cache file and renamed, a failed write never leaves a partial object */
+  scm_dynwind_begin(0);
+  size_t pathLength = strlen(scriptFile->cachePath);
+  char* tmpPath = malloc(pathLength + 5);
+  memcpy(tmpPath, scriptFile->cachePath, pathLength);
+  memcpy(tmpPath + pathLength, ".tmp", 5);
+  scm_dynwind_free(tmpPath);
+  scm_dynwind_unwind_handler(removeTemporaryFile, tmpPath, 0);
+
+  SCM output = scm_open_file(scm_from_locale_string(tmpPath), scm_from_locale_string("wb"));
+  scm_call_2(scm_c_public_ref("system vm objcode", "write-objcode"), objcode, output);
+  scm_close_port(output);
+
+  bool renamed = rename(tmpPath, scriptFile->cachePath) == 0;
+  if(!renamed)
+    remove(tmpPath);
+  scm_dynwind_end();
+
+  return scm_from_bool(renamed);
+}
+
+void removeTemporaryFile(void* path)
+{
+  /* Only reached when writing threw, the port is left to the collector */
+  remove(path);
+}
+
+void* loadDefinitionsInGuile(void* data)
+{
+  _definitions* definitions = data;
+  SCM name = scm_from_utf8_symbol(definitions->name);
+  if(scm_is_true(scm_hash_ref(loadedDefinitions, name, SCM_BOOL_F)))
+    return NULL;
+
+  scm_hash_set_x(loadedDefinitions, name, SCM_BOOL_T);
+  if(!loadCompiledDefinitions(definitions->name))
+    scm_c_eval_string(definitions->source);
+
+  return NULL;
+}
+
+bool loadCompiledDefinitions(const char* name)
+{
+  /* Bytecode names carry a hash of the source, stale files are never found */
+  const char* directories[] = {getenv("GUIHCK_SCM_COMPILED_PATH"), GUIHCK_SCM_COMPILED_DIR};
+  unsigned int i;
+  for(i = 0; i < sizeof(directories) / sizeof(directories[0]); ++i)
+  {
+    if(!directories[i])
+      continue;
+
+    char path[1024];
+    if(snprintf(path, sizeof(path), "%s/%s.go", directories[i], name) >= (int) sizeof(path))
+      continue;
+
+    FILE* file = fopen(path, "rb");
+    if(!file)
+      continue;
+    fclose(file);
+
+    if(scm_is_true(scm_internal_catch(SCM_BOOL_T, loadCompiledBody, path, loadCompiledHandler, path)))
+      return true;
+  }
+
+  return false;
+}
+
+SCM loadCompiledBody(void* data)
+{
+  scm_load_compiled_with_vm(scm_from_locale_string(data));
+  return SCM_BOOL_T;
+}
+
+SCM loadCompiledHandler(void* data, SCM key, SCM args)
+{
+  (void) key;
+  (void) args;
+
+  fprintf(stderr, "Could not load %s, falling back to source\n", (const char*) data);
+  return SCM_BOOL_F;
+}
+
 void* runExpressionInGuile(void* data)
 {
   SCM expression = data;
@@ -166,6 +367,7 @@ SCM guilePushNewElement(SCM typeSymbol)
   {
     char* typeName = scm_to_utf8_string(scm_symbol_to_string(typeSymbol));
     guihckStackPushNewElement(threadLocalContext.ctx, typeName);
+    free(typeName);
     return SCM_BOOL_T;
   }
   else
@@ -193,6 +395,7 @@ SCM guilePushElementById(SCM idSymbol)
   {
     char* id = scm_to_utf8_string(scm_symbol_to_string(idSymbol));
     guihckStackPushElementById(threadLocalContext.ctx, id);
+    free(id);
     return SCM_BOOL_T;
   }
   else
@@ -252,7 +455,7 @@ static void guilePropertyListenerFreeCallback(guihckContext* ctx, guihckElementI
   (void) value;
 
   SCM callback = data;
-  scm_gc_unprotect_object(callback);
+  _GUIHCK_UNPROTECT(ctx, callback);
 }
 
 static SCM guileAddPropertyListener(SCM element, SCM keySymbol, SCM callback)
@@ -261,7 +464,7 @@ static SCM guileAddPropertyListener(SCM element, SCM keySymbol, SCM callback)
   guihckElementId listenerId = guihckStackGetElement(threadLocalContext.ctx);
   guihckPropertyListenerId id = guihckElementAddListener(threadLocalContext.ctx, listenerId, scm_to_uint64(element), key,
                                                          guilePropertyListenerCallback, callback, guilePropertyListenerFreeCallback);
-  scm_gc_protect_object(callback);
+  _GUIHCK_PROTECT(threadLocalContext.ctx, callback);
   free(key);
   return scm_from_uint64(id);
 }
@@ -283,7 +486,9 @@ SCM guileGetElementProperty(SCM keySymbol)
   if(scm_is_symbol(keySymbol))
   {
     char* key = scm_to_utf8_string(scm_symbol_to_string(keySymbol));
-    return guihckStackGetElementProperty(threadLocalContext.ctx, key);
+    SCM value = guihckStackGetElementProperty(threadLocalContext.ctx, key);
+    free(key);
+    return value;
   }
   else
   {
@@ -330,3 +535,308 @@ SCM guileKeyName(SCM keyCode)
   return keyName ? scm_from_utf8_string(keyName) : SCM_UNDEFINED;
 }
 
+static guihckKey guileToKeyCode(SCM key)
+{
+  if(scm_is_integer(key))
+    return scm_to_int32(key);
+
+  char* keyNameStr;
+  if(scm_is_symbol(key))
+    keyNameStr = scm_to_utf8_string(scm_symbol_to_string(key));
+  else if(scm_is_string(key))
+    keyNameStr = scm_to_utf8_string(key);
+  else
+    return GUIHCK_KEY_UNKNOWN;
+
+  guihckKey keyCode = guihckContextGetKeyCode(threadLocalContext.ctx, keyNameStr);
+  free(keyNameStr);
+  return keyCode;
+}
+
+static guihckKeyMods guileToKeyMods(SCM mods)
+{
+  guihckKeyMods result = 0;
+  for(; scm_is_pair(mods); mods = scm_cdr(mods))
+  {
+    SCM mod = scm_car(mods);
+    if(scm_is_eq(mod, scm_from_utf8_symbol("shift")))
+      result |= GUIHCK_MOD_SHIFT;
+    else if(scm_is_eq(mod, scm_from_utf8_symbol("control")))
+      result |= GUIHCK_MOD_CONTROL;
+    else if(scm_is_eq(mod, scm_from_utf8_symbol("alt")))
+      result |= GUIHCK_MOD_ALT;
+    else if(scm_is_eq(mod, scm_from_utf8_symbol("super")))
+      result |= GUIHCK_MOD_SUPER;
+  }
+  return result;
+}
+
+static bool guileAcceleratorCallback(guihckContext* ctx, guihckKey key, guihckKeyAction action, guihckKeyMods mods, void* data)
+{
+  (void) key;
+  (void) mods;
+
+  SCM handler = data;
+  SCM result = guihckGuileRunExpression(ctx, scm_list_2(handler, _guihckContextGetKeyAction(ctx, action)));
+  return scm_is_true(result);
+}
+
+static void guileAcceleratorFreeCallback(guihckContext* ctx, guihckKey key, guihckKeyMods mods, void* data)
+{
+  (void) ctx;
+  (void) key;
+  (void) mods;
+
+  SCM handler = data;
+  _GUIHCK_UNPROTECT(ctx, handler);
+}
+
+SCM guileAddAccelerator(SCM key, SCM mods, SCM handler)
+{
+  guihckKey keyCode = guileToKeyCode(key);
+  if(keyCode == GUIHCK_KEY_UNKNOWN || !scm_is_true(scm_procedure_p(handler)))
+    return SCM_BOOL_F;
+
+  _GUIHCK_PROTECT(threadLocalContext.ctx, handler);
+  guihckContextAddAccelerator(threadLocalContext.ctx, keyCode, guileToKeyMods(mods),
+                              guileAcceleratorCallback, handler, guileAcceleratorFreeCallback);
+  return SCM_BOOL_T;
+}
+
+SCM guileRemoveAccelerator(SCM key, SCM mods)
+{
+  guihckKey keyCode = guileToKeyCode(key);
+  if(keyCode == GUIHCK_KEY_UNKNOWN)
+    return SCM_BOOL_F;
+
+  guihckContextRemoveAccelerator(threadLocalContext.ctx, keyCode, guileToKeyMods(mods));
+  return SCM_BOOL_T;
+}
+
+SCM guileCapturePointer()
+{
+  guihckElementId elementId = guihckStackGetElement(threadLocalContext.ctx);
+  guihckMouseAreaId mouseAreaId = _guihckContextFindMouseArea(threadLocalContext.ctx, elementId);
+  if(mouseAreaId == GUIHCK_NO_MOUSE_AREA)
+    return SCM_BOOL_F;
+
+  guihckContextCapturePointer(threadLocalContext.ctx, mouseAreaId);
+  return SCM_BOOL_T;
+}
+
+SCM guileReleasePointer()
+{
+  guihckContextReleasePointer(threadLocalContext.ctx);
+  return SCM_BOOL_T;
+}
+
+SCM guileFrameStats()
+{
+  /* Association lists of the last finished frame, #f when not profiling */
+  guihckFrameStats stats;
+  if(!guihckContextGetFrameStats(threadLocalContext.ctx, &stats))
+    return SCM_BOOL_F;
+
+  const char* phaseNames[GUIHCK_PHASE_COUNT] = {"events", "binds", "animation", "update", "render-order", "render"};
+  SCM phases = SCM_EOL;
+  int i;
+  for(i = GUIHCK_PHASE_COUNT - 1; i >= 0; --i)
+  {
+    SCM phase = scm_cons(scm_from_double(stats.phases[i].time), scm_from_uint32(stats.phases[i].calls));
+    phases = scm_acons(scm_from_utf8_symbol(phaseNames[i]), phase, phases);
+  }
+
+  SCM types = SCM_EOL;
+  size_t t;
+  for(t = stats.typeCount; t > 0; --t)
+  {
+    const guihckTypeStats* type = &stats.types[t - 1];
+    if(!type->updateCalls && !type->renderCalls && !type->bindEvaluations && !type->listenerNotifications)
+      continue;
+
+    SCM typeStats = SCM_EOL;
+    typeStats = scm_acons(scm_from_utf8_symbol("listener-notifications"), scm_from_uint32(type->listenerNotifications), typeStats);
+    typeStats = scm_acons(scm_from_utf8_symbol("bind-evaluations"), scm_from_uint32(type->bindEvaluations), typeStats);
+    typeStats = scm_acons(scm_from_utf8_symbol("render-time"), scm_from_double(type->renderTime), typeStats);
+    typeStats = scm_acons(scm_from_utf8_symbol("render-calls"), scm_from_uint32(type->renderCalls), typeStats);
+    typeStats = scm_acons(scm_from_utf8_symbol("update-time"), scm_from_double(type->updateTime), typeStats);
+    typeStats = scm_acons(scm_from_utf8_symbol("update-calls"), scm_from_uint32(type->updateCalls), typeStats);
+    types = scm_acons(scm_from_utf8_symbol(type->name), typeStats, types);
+  }
+
+  SCM result = SCM_EOL;
+  result = scm_acons(scm_from_utf8_symbol("types"), types, result);
+  result = scm_acons(scm_from_utf8_symbol("phases"), phases, result);
+  result = scm_acons(scm_from_utf8_symbol("allocations"), scm_from_uint32(stats.allocations), result);
+  result = scm_acons(scm_from_utf8_symbol("scheme-calls"), scm_from_uint32(stats.schemeCalls), result);
+  result = scm_acons(scm_from_utf8_symbol("listener-notifications"), scm_from_uint32(stats.listenerNotifications), result);
+  result = scm_acons(scm_from_utf8_symbol("bind-evaluations"), scm_from_uint32(stats.bindEvaluations), result);
+  result = scm_acons(scm_from_utf8_symbol("frame-time"), scm_from_double(stats.frameTime), result);
+  result = scm_acons(scm_from_utf8_symbol("frame"), scm_from_uint64(stats.frame), result);
+  return result;
+}
+
+SCM guileMakeTemplate(SCM description)
+{
+  /* The pair holds the description, the finalizer must not touch GC protection */
+  guihckTemplate* tmpl = _guihckTemplateNew(threadLocalContext.ctx, description, false);
+  return tmpl ? scm_cons(scm_from_pointer(tmpl, guileFreeTemplate), description) : SCM_BOOL_F;
+}
+
+SCM guileInstantiateTemplate(SCM tmpl, SCM parent, SCM overrides)
+{
+  if(!scm_is_pair(tmpl) || !SCM_POINTER_P(SCM_CAR(tmpl)) || !scm_is_integer(parent))
+    return SCM_BOOL_F;
+
+  guihckElementId id = guihckTemplateInstantiate(threadLocalContext.ctx, scm_to_pointer(SCM_CAR(tmpl)), scm_to_uint64(parent), overrides);
+  return id != GUIHCK_NO_PARENT ? scm_from_uint64(id) : SCM_BOOL_F;
+}
+
+void guileFreeTemplate(void* tmpl)
+{
+  guihckTemplateFree(tmpl);
+}
+
+SCM guileAnimationOption(SCM options, const char* name)
+{
+  for(; scm_is_pair(options); options = scm_cdr(options))
+  {
+    SCM option = scm_car(options);
+    if(scm_is_pair(option) && scm_is_eq(scm_car(option), scm_from_utf8_symbol(name)) && scm_is_pair(scm_cdr(option)))
+      return scm_cdr(option);
+  }
+  return SCM_BOOL_F;
+}
+
+guihckEasing guileToEasing(SCM name)
+{
+  const char* names[] = {"linear", "in-quad", "out-quad", "in-out-quad", "in-cubic", "out-cubic", "in-out-cubic", "step"};
+  unsigned int i;
+  for(i = 0; scm_is_symbol(name) && i < sizeof(names) / sizeof(names[0]); ++i)
+  {
+    if(scm_is_eq(name, scm_from_utf8_symbol(names[i])))
+      return (guihckEasing) i;
+  }
+  return GUIHCK_EASING_LINEAR;
+}
+
+void guileAnimationCompleteCallback(guihckContext* ctx, guihckAnimationId animationId, guihckElementId elementId, void* data)
+{
+  (void) animationId;
+
+  /* The element may be gone when a step of another element's sequence completes */
+  if(elementId == GUIHCK_NO_PARENT)
+    return;
+
+  guihckStackPushElement(ctx, elementId);
+  SCM callback = data;
+  guihckContextExecuteExpression(ctx, scm_list_1(callback));
+  guihckStackPopElement(ctx);
+}
+
+void guileAnimationFreeCallback(guihckContext* ctx, guihckAnimationId animationId, void* data)
+{
+  (void) animationId;
+
+  SCM callback = data;
+  _GUIHCK_UNPROTECT(ctx, callback);
+}
+
+guihckAnimationId guileBuildAnimation(guihckContext* ctx, guihckElementId elementId, SCM description)
+{
+  /* (tween property to duration options), (spring property to options) or (sequence steps options) */
+  long length = scm_ilength(description);
+  if(length < 3)
+    return GUIHCK_NO_ANIMATION;
+
+  SCM kind = scm_car(description);
+  SCM options = scm_list_ref(description, scm_from_long(length - 1));
+  guihckAnimationId animationId = GUIHCK_NO_ANIMATION;
+
+  if(scm_is_eq(kind, scm_from_utf8_symbol("sequence")))
+  {
+    SCM steps = scm_cadr(description);
+    long count = scm_ilength(steps);
+    if(count < 0)
+      return GUIHCK_NO_ANIMATION;
+
+    guihckAnimationId* stepIds = calloc(count ? count : 1, sizeof(guihckAnimationId));
+    long i;
+    for(i = 0; i < count; ++i, steps = scm_cdr(steps))
+      stepIds[i] = guileBuildAnimation(ctx, elementId, scm_car(steps));
+
+    animationId = guihckAnimationSequence(ctx, stepIds, count);
+    free(stepIds);
+  }
+  else if(scm_is_symbol(scm_cadr(description)))
+  {
+    char* key = scm_to_utf8_string(scm_symbol_to_string(scm_cadr(description)));
+    SCM to = scm_caddr(description);
+    if(scm_is_eq(kind, scm_from_utf8_symbol("tween")) && length == 5 && scm_is_real(scm_cadddr(description)))
+    {
+      SCM from = guileAnimationOption(options, "from");
+      SCM easing = guileAnimationOption(options, "easing");
+      animationId = guihckAnimationTween(ctx, elementId, key, scm_is_false(from) ? SCM_UNDEFINED : scm_car(from), to,
+                                         scm_to_double(scm_cadddr(description)),
+                                         scm_is_false(easing) ? GUIHCK_EASING_LINEAR : guileToEasing(scm_car(easing)));
+    }
+    else if(scm_is_eq(kind, scm_from_utf8_symbol("spring")) && length == 4)
+    {
+      SCM stiffness = guileAnimationOption(options, "stiffness");
+      SCM damping = guileAnimationOption(options, "damping");
+      animationId = guihckAnimationSpring(ctx, elementId, key, to,
+                                          scm_is_false(stiffness) ? 170 : scm_to_double(scm_car(stiffness)),
+                                          scm_is_false(damping) ? 26 : scm_to_double(scm_car(damping)));
+    }
+    free(key);
+  }
+
+  if(animationId != GUIHCK_NO_ANIMATION)
+  {
+    SCM repeat = guileAnimationOption(options, "repeat");
+    if(scm_is_true(repeat))
+    {
+      guihckAnimationRepeat(ctx, animationId, scm_to_int(scm_car(repeat)),
+                            scm_is_pair(scm_cdr(repeat)) && scm_is_true(scm_cadr(repeat)));
+    }
+
+    SCM onComplete = guileAnimationOption(options, "on-complete");
+    if(scm_is_true(onComplete) && scm_is_true(scm_procedure_p(scm_car(onComplete))))
+    {
+      SCM callback = scm_car(onComplete);
+      _GUIHCK_PROTECT(ctx, callback);
+      guihckAnimationOnComplete(ctx, animationId, guileAnimationCompleteCallback, callback, guileAnimationFreeCallback);
+    }
+  }
+
+  return animationId;
+}
+
+SCM guileAnimate(SCM element, SCM description, SCM options)
+{
+  guihckContext* ctx = threadLocalContext.ctx;
+  if(!scm_is_integer(element) || scm_ilength(description) < 3)
+    return SCM_BOOL_F;
+
+  /* Options given to animate! apply to the whole description */
+  SCM length = scm_from_long(scm_ilength(description) - 1);
+  SCM described = scm_append(scm_list_2(scm_list_head(description, length),
+                                        scm_list_1(scm_append(scm_list_2(scm_list_ref(description, length), options)))));
+
+  guihckAnimationId animationId = guileBuildAnimation(ctx, scm_to_uint64(element), described);
+  if(animationId == GUIHCK_NO_ANIMATION)
+    return SCM_BOOL_F;
+
+  _guihckAnimationAutoRemove(ctx, animationId);
+  guihckAnimationStart(ctx, animationId);
+  return scm_from_uint64(animationId);
+}
+
+SCM guileStopAnimation(SCM animation)
+{
+  if(!scm_is_integer(animation))
+    return SCM_BOOL_F;
+
+  guihckAnimationRemove(threadLocalContext.ctx, scm_to_uint64(animation));
+  return SCM_BOOL_T;
+}
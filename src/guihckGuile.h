@@ -5,7 +5,9 @@
 
 void guihckGuileInit();
 void guihckGuileRegisterFunction(const char* name, int req, int opt, int rst, scm_t_subr func);
+void guihckGuileLoadDefinitions(const char* name, const char* source);
 SCM guihckGuileRunExpression(guihckContext* ctx, SCM expression);
 SCM guihckGuileRunScript(guihckContext* ctx, const char* script);
+SCM guihckGuileRunScriptFile(guihckContext* ctx, const char* path, const char* contents, size_t length, const char* cachePath);
 
 #endif
@@ -0,0 +1,41 @@
+#ifndef GUIHCKKEYHASH_H
+#define GUIHCKKEYHASH_H
+
+#include <stdint.h>
+
+/* Shared by the key table generator and the library, both sides must hash
+ * identically. Names are looked up by hash-and-displace: the first hash picks
+ * a bucket, the bucket's displacement seeds the second hash which picks the
+ * slot. Every default name ends up in its own slot. */
+
+#define _GUIHCK_KEY_HASH_BUCKETS 64
+#define _GUIHCK_KEY_HASH_SLOTS 256
+
+typedef struct _guihckKeyHashSlot
+{
+  const char* name;
+  int code;
+} _guihckKeyHashSlot;
+
+static inline uint32_t _guihckKeyHash(const char* name, uint32_t seed)
+{
+  uint32_t hash = 2166136261u ^ (seed * 16777619u);
+  for(; *name; ++name)
+  {
+    hash ^= (unsigned char) *name;
+    hash *= 16777619u;
+  }
+  return hash ^ (hash >> 15);
+}
+
+static inline unsigned int _guihckKeyHashGetBucket(const char* name)
+{
+  return _guihckKeyHash(name, 0) & (_GUIHCK_KEY_HASH_BUCKETS - 1);
+}
+
+static inline unsigned int _guihckKeyHashGetSlot(const char* name, uint32_t displacement)
+{
+  return _guihckKeyHash(name, displacement) & (_GUIHCK_KEY_HASH_SLOTS - 1);
+}
+
+#endif
@@ -5,7 +5,14 @@
 #include "pool.h"
 #include "lut.h"
 
+#include <stdio.h>
+#include <time.h>
+#include <stdint.h>
+
 #define GUIHCK_NO_PARENT SIZE_MAX
+#define _GUIHCK_HASH_INIT 14695981039346656037ull
+#define _GUIHCK_KEY_MODS_MASK (GUIHCK_MOD_SHIFT | GUIHCK_MOD_CONTROL | GUIHCK_MOD_ALT | GUIHCK_MOD_SUPER)
+#define _GUIHCK_ACCELERATOR_KEY(key, mods) ((((unsigned int) (key)) << 4) | ((mods) & _GUIHCK_KEY_MODS_MASK))
 
 #if defined(_MSC_VER)
 # define _GUIHCK_TLS __declspec(thread)
@@ -18,38 +25,109 @@
 # warning "No Thread-local storage! Multi-threaded guihck applications may have unexpected behaviour!"
 #endif
 
+typedef struct _guihckRect
+{
+    float x;
+    float y;
+    float w;
+    float h;
+
+} _guihckRect;
+
+typedef struct _guihckDamage
+{
+  _guihckRect pending[GUIHCK_MAX_DAMAGE_RECTS]; /* collected for the next render */
+  size_t pendingCount;
+  guihckDamageRect frame[GUIHCK_MAX_DAMAGE_RECTS];
+  size_t frameCount;
+  guihckElementId* elements; /* visual elements changed since the last render */
+  size_t elementCount;
+  size_t elementCapacity;
+} _guihckDamage;
+
 typedef struct _guihckContext
 {
   chckPool* elements;
-  chckPool* elementTypes;
-  chckHashTable* elementTypesByName;
+  guihckTypeRegistry* types;
   chckIterPool* renderOrder;
   bool renderOrderChanged;
   chckPool* mouseAreas;  /* should also have a quadtree for references */
+  chckIterPool* hoveredMouseAreas;
+  chckIterPool* pressedMouseAreas; /* got the last press, exited when another area captures the pointer */
+  guihckMouseAreaId capturedMouseArea;
+  float pointerX;
+  float pointerY;
+  bool pointerDirty;
   chckIterPool* stack;
   guihckElementId rootElementId;
   chckPool* propertyListeners;
   guihckElementId focused;
-  chckHashTable* keyCodesByName;
+  chckIterPool* keyHandlers; /* _guihckKeyHandler from focused element to root */
+  bool keyHandlersChanged;
+  unsigned int keyDispatching; /* nested key events keep the chain until the outermost ends */
+  SCM keyActions[GUIHCK_KEY_REPEAT + 2];
+  SCM keyMods[_GUIHCK_KEY_MODS_MASK + 1];
+  chckHashTable* accelerators; /* _guihckAccelerator by _GUIHCK_ACCELERATOR_KEY */
+  chckHashTable* keyCodesByName; /* custom bindings only, NULL until one is added */
   chckHashTable* keyNamesByCode;
   double time;
+  int constructing; /* nesting depth of guihckElementNew */
+  struct _guihckProfiler* profiler; /* NULL unless profiling */
+  struct _guihckTrace* trace; /* NULL unless a trace has been started */
+  FILE* recording; /* input log, NULL unless recording */
+  guihckMemoryStats memory; /* zero unless built with GUIHCK_MEMORY_ACCOUNTING */
+  char* scriptCacheDirectory; /* compiled scripts, NULL disables the cache */
+  struct _guihckCommandList* commands; /* NULL unless rendering is retained */
+  _guihckDamage damage;
+  bool cullChanged; /* geometry changed since the last cull pass */
+  bool cullUpdates; /* culled elements are not updated */
+  chckPool* animations; /* _guihckAnimation, NULL until one is added */
+  unsigned int notifyDepthLimit; /* 0 if unlimited */
+  unsigned int notifyDepth;
+  guihckPropertyListenerId* notifyPath; /* listeners being notified, outermost first */
+  guihckPropertyListenerId* notifyCycle; /* last path cut at the limit */
+  size_t notifyCycleLength;
+  bool notifyCut; /* reported since the outermost notification began */
+  char* convertedString; /* last undeclared string returned by guihckElementGetString */
 } _guihckContext;
 
+#define _GUIHCK_NOTIFY_DEPTH_LIMIT 256
+
+typedef struct _guihckKeyHandler
+{
+  guihckElementId elementId;
+  guihckElementId parentId;
+  SCM onKey;
+  SCM onChar;
+} _guihckKeyHandler;
+
+typedef struct _guihckAccelerator
+{
+  guihckKey key;
+  guihckKeyMods mods;
+  guihckAcceleratorCallback callback;
+  void* data;
+  guihckAcceleratorFreeCallback freeCallback;
+} _guihckAccelerator;
+
 typedef struct _guihckElementType
 {
   char* name;
   guihckElementTypeFunctionMap functionMap;
   size_t dataSize;
+  int suspend; /* guihckSuspendFlags applied in hidden subtrees */
+  bool emitsCommands;
+  guihckPropertySchema* schema; /* owned copy, names and default strings included */
+  size_t schemaCount;
+  chckHashTable* schemaByName; /* index into schema, NULL without one */
 } _guihckElementType;
 
-typedef struct _guihckRect
+typedef struct _guihckTypeRegistry
 {
-    float x;
-    float y;
-    float w;
-    float h;
-
-} _guihckRect;
+  int references; /* not atomic, shared registries stay on one thread */
+  chckPool* elementTypes;
+  chckHashTable* elementTypesByName;
+} _guihckTypeRegistry;
 
 typedef struct _guihckPropertyListener
 {
@@ -59,8 +137,12 @@ typedef struct _guihckPropertyListener
   guihckPropertyListenerCallback callback;
   void* data;
   guihckPropertyListenerFreeCallback freeCallback;
+  bool constructed; /* added by guihckElementNew or a type init */
+  unsigned int calls; /* notifications since added or reset */
 } _guihckPropertyListener;
 
+typedef enum _guihckListenerKind { GUIHCK_LISTENER_PLAIN, GUIHCK_LISTENER_ALIAS, GUIHCK_LISTENER_BIND } _guihckListenerKind;
+
 typedef enum _guihckPropertyType { GUIHCK_PROPERTY_VALUE, GUIHCK_PROPERTY_ALIAS, GUIHCK_PROPERTY_BIND } _guihckPropertyType;
 typedef struct _guihckBoundProperty
 {
@@ -77,9 +159,15 @@ typedef struct _guihckBoundPropertyRef
 
 typedef struct _guihckProperty
 {
+  char* name;
   _guihckPropertyType type;
   SCM value;
   chckIterPool* listeners;
+  bool stale; /* bind evaluation deferred while hidden */
+  int schema; /* index in the element type's schema, -1 if not declared */
+  guihckValueType nativeType;
+  bool hasNative; /* native holds the value, false while it is invalid */
+  guihckValue native;
   union
   {
     struct
@@ -90,6 +178,8 @@ typedef struct _guihckProperty
     {
       SCM function;
       chckIterPool* bound; /* _guihckBoundProperty for each bound property */
+      bool lazy; /* evaluated when read, right away only while something listens */
+      bool pending; /* inputs of a lazy bind changed since it was evaluated */
     } bind;
   };
 
@@ -103,7 +193,19 @@ typedef struct _guihckElement
   chckIterPool* children;
   chckHashTable* properties;
   chckIterPool* listened;
-  bool dirty;
+  struct _guihckElementCommands* commands; /* NULL until the element emits a render command */
+  _guihckRect bounds; /* last damaged area, valid if hasBounds */
+  bool hasBounds;
+  bool damaged;
+  _guihckRect visibleBounds; /* part inside the root and clip ancestors on screen, valid unless culled */
+  bool culled;
+  bool clips;
+  bool offsets; /* children are moved by offsetX and offsetY */
+  float offsetX, offsetY;
+  float translationX, translationY; /* ancestors' offsets, resolved with culling */
+  bool hidden; /* the element or an ancestor is not visible */
+  bool staleBinds;
+  guihckPropertyMask changed; /* dirty when not zero */
 } _guihckElement;
 
 typedef struct _guihckMouseArea
@@ -111,6 +213,226 @@ typedef struct _guihckMouseArea
   guihckElementId elementId;
   _guihckRect rect;
   guihckMouseAreaFunctionMap functionMap;
+  bool observes; /* gets presses and moves handled above it */
 } _guihckMouseArea;
 
+typedef struct _guihckElementCommands
+{
+  guihckRenderCommand* items;
+  size_t count;
+  size_t capacity;
+  size_t clips; /* pushes, popped after the element's children */
+  size_t transforms;
+  size_t offset; /* span in the context list */
+  size_t listed;
+  size_t listedClips;
+  size_t listedTransforms;
+  unsigned long generation; /* list build the span belongs to */
+  bool changed;
+} _guihckElementCommands;
+
+typedef struct _guihckCommandList
+{
+  guihckRenderCommand* items; /* reused between frames */
+  size_t count;
+  size_t capacity;
+  guihckElementId* changed; /* elements whose commands changed since the last render */
+  size_t changedCount;
+  size_t changedCapacity;
+  unsigned long generation;
+  bool rebuild;
+} _guihckCommandList;
+
+#define _GUIHCK_ANIMATION_MAX_COMPONENTS 4
+
+typedef enum _guihckAnimationKind { GUIHCK_ANIMATION_TWEEN, GUIHCK_ANIMATION_SPRING, GUIHCK_ANIMATION_SEQUENCE } _guihckAnimationKind;
+
+typedef struct _guihckAnimationValue
+{
+  double components[_GUIHCK_ANIMATION_MAX_COMPONENTS];
+  size_t count;
+  bool list;
+  bool integral; /* written back as exact integers */
+} _guihckAnimationValue;
+
+typedef struct _guihckAnimation
+{
+  _guihckAnimationKind kind;
+  guihckElementId elementId; /* GUIHCK_NO_PARENT once the element is removed */
+  char* propertyName;
+  guihckAnimationId owner; /* sequence playing this step */
+  bool running;
+  bool autoRemove; /* once completed */
+  bool alternate;
+  bool reversed;
+  double start;
+  int repeat;
+  int played;
+  guihckAnimationCallback onComplete;
+  void* data;
+  guihckAnimationFreeCallback freeCallback;
+
+  union
+  {
+    struct
+    {
+      _guihckAnimationValue from;
+      _guihckAnimationValue to;
+      bool fromCurrent;
+      double duration;
+      guihckEasing easing;
+    } tween;
+    struct
+    {
+      _guihckAnimationValue to;
+      _guihckAnimationValue value;
+      double velocity[_GUIHCK_ANIMATION_MAX_COMPONENTS];
+      double stiffness;
+      double damping;
+      double time; /* integrated up to */
+    } spring;
+    struct
+    {
+      guihckAnimationId* steps;
+      size_t count;
+      size_t index;
+    } sequence;
+  };
+} _guihckAnimation;
+
+typedef struct _guihckProfiler
+{
+  guihckFrameStats current;
+  guihckFrameStats last;
+  guihckTypeStats* currentTypes;
+  guihckTypeStats* lastTypes;
+  size_t typeCapacity;
+  double frameStart;
+  double phaseStart[GUIHCK_PHASE_COUNT];
+  int phaseDepth[GUIHCK_PHASE_COUNT];
+  bool hasFrame;
+} _guihckProfiler;
+
+/* Profiling hooks cost a pointer test when disabled */
+#define _GUIHCK_PROFILE_BEGIN(ctx, phase) do { if((ctx)->profiler) _guihckProfilerBegin((ctx), (phase)); } while(0)
+#define _GUIHCK_PROFILE_END(ctx, phase) do { if((ctx)->profiler) _guihckProfilerEnd((ctx), (phase)); } while(0)
+#define _GUIHCK_PROFILE_COUNT(ctx, counter) do { if((ctx)->profiler) (ctx)->profiler->current.counter += 1; } while(0)
+
+#define _GUIHCK_TRACE_NAME_LENGTH 32
+
+typedef struct _guihckTraceEvent
+{
+  double time;
+  const char* category; /* static string */
+  guihckElementId elementId;
+  char phase; /* 'B' or 'E' */
+  char name[_GUIHCK_TRACE_NAME_LENGTH];
+} _guihckTraceEvent;
+
+typedef struct _guihckTrace
+{
+  _guihckTraceEvent* events; /* ring, the oldest events are overwritten */
+  size_t capacity;
+  size_t next;
+  size_t count;
+  bool recording;
+} _guihckTrace;
+
+#define _GUIHCK_TRACE_BEGIN(ctx, category, name, elementId) \
+  do { if((ctx)->trace && (ctx)->trace->recording) _guihckTraceRecord((ctx)->trace, 'B', (category), (name), (elementId)); } while(0)
+#define _GUIHCK_TRACE_END(ctx, category) \
+  do { if((ctx)->trace && (ctx)->trace->recording) _guihckTraceRecord((ctx)->trace, 'E', (category), NULL, GUIHCK_NO_PARENT); } while(0)
+
+/* Allocations owned by a context go through these so they can be accounted,
+ * without GUIHCK_MEMORY_ACCOUNTING they are the plain libc calls */
+#if defined(GUIHCK_MEMORY_ACCOUNTING)
+# define _GUIHCK_CALLOC(ctx, category, size) _guihckMemoryCalloc((ctx), (category), (size))
+# define _GUIHCK_STRDUP(ctx, category, str) _guihckMemoryStrdup((ctx), (category), (str))
+# define _GUIHCK_FREE(ctx, ptr) _guihckMemoryFree((ctx), (ptr))
+# define _GUIHCK_MEMORY_COUNT(ctx, category, size) _guihckMemoryCount((ctx), (category), (size), 1)
+# define _GUIHCK_MEMORY_UNCOUNT(ctx, category, size) _guihckMemoryCount((ctx), (category), (size), -1)
+# define _GUIHCK_PROTECT(ctx, value) do { scm_gc_protect_object(value); (ctx)->memory.protectedObjects += 1; } while(0)
+# define _GUIHCK_UNPROTECT(ctx, value) do { scm_gc_unprotect_object(value); (ctx)->memory.protectedObjects -= 1; } while(0)
+#else
+# define _GUIHCK_CALLOC(ctx, category, size) calloc(1, (size))
+# define _GUIHCK_STRDUP(ctx, category, str) strdup(str)
+# define _GUIHCK_FREE(ctx, ptr) free(ptr)
+# define _GUIHCK_MEMORY_COUNT(ctx, category, size) ((void) 0)
+# define _GUIHCK_MEMORY_UNCOUNT(ctx, category, size) ((void) 0)
+# define _GUIHCK_PROTECT(ctx, value) scm_gc_protect_object(value)
+# define _GUIHCK_UNPROTECT(ctx, value) scm_gc_unprotect_object(value)
+#endif
+
+typedef struct _guihckMappedFile
+{
+  const char* data;
+  size_t size;
+  time_t mtime;
+  bool mapped;
+} _guihckMappedFile;
+
+bool _guihckMappedFileOpen(_guihckMappedFile* file, const char* path);
+void _guihckMappedFileClose(_guihckMappedFile* file);
+/* Removes the other files next to path whose names share its first prefixLength characters */
+void _guihckCacheEvict(const char* path, size_t prefixLength);
+uint64_t _guihckHashBytes(uint64_t hash, const void* data, size_t size);
+
+double _guihckProfilerNow();
+void _guihckProfilerBegin(guihckContext* ctx, guihckFramePhase phase);
+void _guihckProfilerEnd(guihckContext* ctx, guihckFramePhase phase);
+guihckTypeStats* _guihckProfilerGetTypeStats(guihckContext* ctx, guihckElementTypeId typeId);
+void _guihckProfilerBeginBind(guihckContext* ctx, guihckElementId elementId);
+void _guihckProfilerCountListener(guihckContext* ctx, guihckElementId listenerId);
+void _guihckProfilerEndFrame(guihckContext* ctx);
+
+void _guihckTraceRecord(_guihckTrace* trace, char phase, const char* category, const char* name, guihckElementId elementId);
+
+void* _guihckMemoryCalloc(guihckContext* ctx, guihckMemoryCategory category, size_t size);
+char* _guihckMemoryStrdup(guihckContext* ctx, guihckMemoryCategory category, const char* str);
+void _guihckMemoryFree(guihckContext* ctx, void* ptr);
+void _guihckMemoryCount(guihckContext* ctx, guihckMemoryCategory category, size_t size, int sign);
+void _guihckMemoryReportLeaks(guihckContext* ctx);
+
+void _guihckRecordTime(guihckContext* ctx, double time);
+void _guihckRecordMouseButton(guihckContext* ctx, guihckRecordType type, float x, float y, int button);
+void _guihckRecordMouseMove(guihckContext* ctx, float sx, float sy, float dx, float dy);
+void _guihckRecordKey(guihckContext* ctx, guihckKey key, int scancode, guihckKeyAction action, guihckKeyMods mods);
+void _guihckRecordChar(guihckContext* ctx, unsigned int codepoint);
+void _guihckRecordFrame(guihckContext* ctx, guihckRecordType type);
+
+void _guihckCommandsRefresh(guihckContext* ctx);
+void _guihckElementCommandsFree(guihckContext* ctx, _guihckElement* element);
+
+void _guihckDamagePropertyChanged(guihckContext* ctx, guihckElementId elementId, const char* propertyName);
+void _guihckDamageRemoved(guihckContext* ctx, _guihckElement* element);
+void _guihckDamageResolve(guihckContext* ctx);
+
+void _guihckCullPropertyChanged(guihckContext* ctx, const char* propertyName);
+void _guihckCullRefresh(guihckContext* ctx);
+
+int _guihckPropertySchemaIndex(guihckContext* ctx, guihckElementId elementId, const char* propertyName);
+void _guihckPropertySchemaConvert(guihckContext* ctx, guihckElementId elementId, _guihckProperty* property);
+void _guihckPropertySchemaMark(guihckContext* ctx, guihckElementId elementId, _guihckProperty* property);
+void _guihckPropertyFreeNative(guihckContext* ctx, _guihckProperty* property);
+
+void _guihckAnimationsUpdate(guihckContext* ctx);
+void _guihckAnimationsElementRemoved(guihckContext* ctx, guihckElementId elementId);
+void _guihckAnimationsFree(guihckContext* ctx);
+void _guihckAnimationAutoRemove(guihckContext* ctx, guihckAnimationId animationId);
+
+/* Same as guihckTemplateNew, unprotected templates rely on the caller keeping the description alive */
+guihckTemplate* _guihckTemplateNew(guihckContext* ctx, SCM description, bool protect);
+
+/* Same as guihckElementProperty, a plain value is replaced in place */
+void _guihckElementPropertyAssign(guihckContext* ctx, guihckElementId elementId, const char* key, SCM value);
+
+bool _guihckPropertyListenerIsRestorable(const _guihckPropertyListener* listener);
+/* Aliases and binds give the property they set, plain listeners NULL */
+_guihckListenerKind _guihckPropertyListenerGetKind(const _guihckPropertyListener* listener, const char** targetProperty);
+void _guihckGraphNotifyCut(guihckContext* ctx);
+void _guihckTraceWriteString(FILE* file, const char* str);
+SCM _guihckContextGetKeyAction(guihckContext* ctx, guihckKeyAction action);
+void _guihckContextSyncPointer(guihckContext* ctx);
+guihckMouseAreaId _guihckContextFindMouseArea(guihckContext* ctx, guihckElementId elementId);
+
 #endif
@@ -0,0 +1,111 @@
+#include "internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Accounted blocks carry their size and category in front of the data so
+ * they can be uncounted on free. Records stored inside pools are counted
+ * with _GUIHCK_MEMORY_COUNT instead, chck's own bookkeeping is not included. */
+
+typedef union _guihckMemoryHeader
+{
+  struct
+  {
+    size_t size;
+    guihckMemoryCategory category;
+  } info;
+  long double align;
+} _guihckMemoryHeader;
+
+static const char* _guihckMemoryCategoryNames[GUIHCK_MEMORY_CATEGORY_COUNT] = {
+  "elements", "properties", "listeners", "bindings", "mouse areas", "animations", "scratch"
+};
+
+bool guihckContextGetMemoryStats(guihckContext* ctx, guihckMemoryStats* stats)
+{
+#if defined(GUIHCK_MEMORY_ACCOUNTING)
+  *stats = ctx->memory;
+  return true;
+#else
+  (void) ctx;
+  memset(stats, 0, sizeof(guihckMemoryStats));
+  return false;
+#endif
+}
+
+const char* guihckMemoryCategoryName(guihckMemoryCategory category)
+{
+  return category < GUIHCK_MEMORY_CATEGORY_COUNT ? _guihckMemoryCategoryNames[category] : NULL;
+}
+
+void* _guihckMemoryCalloc(guihckContext* ctx, guihckMemoryCategory category, size_t size)
+{
+  _guihckMemoryHeader* header = calloc(1, sizeof(_guihckMemoryHeader) + size);
+  if(!header)
+    return NULL;
+
+  header->info.size = size;
+  header->info.category = category;
+  _guihckMemoryCount(ctx, category, size, 1);
+  return header + 1;
+}
+
+char* _guihckMemoryStrdup(guihckContext* ctx, guihckMemoryCategory category, const char* str)
+{
+  size_t size = strlen(str) + 1;
+  char* copy = _guihckMemoryCalloc(ctx, category, size);
+  if(copy)
+    memcpy(copy, str, size);
+  return copy;
+}
+
+void _guihckMemoryFree(guihckContext* ctx, void* ptr)
+{
+  if(!ptr)
+    return;
+
+  _guihckMemoryHeader* header = (_guihckMemoryHeader*) ptr - 1;
+  _guihckMemoryCount(ctx, header->info.category, header->info.size, -1);
+  free(header);
+}
+
+void _guihckMemoryCount(guihckContext* ctx, guihckMemoryCategory category, size_t size, int sign)
+{
+  guihckMemoryStats* memory = &ctx->memory;
+  if(sign > 0)
+  {
+    memory->bytes[category] += size;
+    memory->allocations[category] += 1;
+
+    size_t total = 0;
+    int i;
+    for(i = 0; i < GUIHCK_MEMORY_CATEGORY_COUNT; ++i)
+      total += memory->bytes[i];
+    if(total > memory->peakBytes)
+      memory->peakBytes = total;
+  }
+  else
+  {
+    memory->bytes[category] -= size;
+    memory->allocations[category] -= 1;
+  }
+}
+
+void _guihckMemoryReportLeaks(guihckContext* ctx)
+{
+  /* Everything a context owns has been released by now, what is left was never uncounted */
+  guihckMemoryStats* memory = &ctx->memory;
+  int i;
+  for(i = 0; i < GUIHCK_MEMORY_CATEGORY_COUNT; ++i)
+  {
+    if(memory->allocations[i] > 0)
+    {
+      fprintf(stderr, "Memory: %lu bytes in %lu allocations of %s leaked\n",
+              (unsigned long) memory->bytes[i], (unsigned long) memory->allocations[i], _guihckMemoryCategoryNames[i]);
+    }
+  }
+
+  if(memory->protectedObjects > 0)
+    fprintf(stderr, "Memory: %lu protected objects leaked\n", (unsigned long) memory->protectedObjects);
+}
@@ -1,79 +1,176 @@
 #include "internal.h"
 
+#include <assert.h>
+#include <string.h>
+
 static bool pointInRect(float x, float y, const _guihckRect* r);
+static bool isPointInMouseArea(guihckContext* ctx, const _guihckMouseArea* mouseArea, float x, float y);
+static bool isHovered(guihckContext* ctx, guihckMouseAreaId mouseAreaId, chckPoolIndex* index);
+static bool findMouseArea(chckIterPool* mouseAreas, guihckMouseAreaId mouseAreaId, chckPoolIndex* index);
+static void clearMouseAreas(chckIterPool* mouseAreas);
+static void updateHoveredMouseAreas(guihckContext* ctx, float sx, float sy, float dx, float dy, bool moved);
 static chckIterPool* queryMouseAreasContainingPoint(guihckContext* ctx, float x, float y);
-static chckIterPool* queryMouseAreasIntersectingLine(guihckContext* ctx, float sx, float sy, float dx, float dy);
 static chckIterPool* sortMouseAreasByElementOrder(guihckContext* ctx, chckIterPool* mouseAreas);
 
 void guihckContextMouseDown(guihckContext* ctx, float x, float y, int button)
 {
+  if(ctx->recording)
+    _guihckRecordMouseButton(ctx, GUIHCK_RECORD_MOUSE_DOWN, x, y, button);
+
+  _GUIHCK_PROFILE_BEGIN(ctx, GUIHCK_PHASE_EVENTS);
+  ctx->pointerX = x;
+  ctx->pointerY = y;
+
+  /* Captured pointer goes straight to the capturing area */
+  if(ctx->capturedMouseArea != GUIHCK_NO_MOUSE_AREA)
+  {
+    _guihckMouseArea* mouseArea = chckPoolGet(ctx->mouseAreas, ctx->capturedMouseArea);
+    if(mouseArea->functionMap.mouseDown)
+      mouseArea->functionMap.mouseDown(ctx, mouseArea->elementId, guihckElementGetData(ctx, mouseArea->elementId), button, x, y);
+    _GUIHCK_PROFILE_END(ctx, GUIHCK_PHASE_EVENTS);
+    return;
+  }
+
+  /* Areas given the press are remembered so a later capture can take it from them */
+  clearMouseAreas(ctx->pressedMouseAreas);
+
   chckPoolIndex iter = 0;
   guihckMouseAreaId* mouseAreaId = NULL;
   chckIterPool* mouseAreas = queryMouseAreasContainingPoint(ctx, x, y);
   bool handled = false;
-  while(!handled && (mouseAreaId = chckIterPoolIter(mouseAreas, &iter)))
+  while((mouseAreaId = chckIterPoolIter(mouseAreas, &iter)))
   {
+    /* Callbacks may remove areas still waiting for the press */
     _guihckMouseArea* mouseArea = chckPoolGet(ctx->mouseAreas, *mouseAreaId);
-    if(mouseArea->functionMap.mouseDown)
+    if(!mouseArea)
+      continue;
+
+    if(mouseArea->functionMap.mouseDown && (!handled || mouseArea->observes))
     {
-      handled = mouseArea->functionMap.mouseDown(ctx, mouseArea->elementId, guihckElementGetData(ctx, mouseArea->elementId), button, x, y);
+      chckIterPoolAdd(ctx->pressedMouseAreas, mouseAreaId, NULL);
+      if(mouseArea->functionMap.mouseDown(ctx, mouseArea->elementId, guihckElementGetData(ctx, mouseArea->elementId), button, x, y))
+        handled = true;
     }
   }
-  free(mouseAreas);
+  chckIterPoolFree(mouseAreas);
+  _GUIHCK_PROFILE_END(ctx, GUIHCK_PHASE_EVENTS);
 }
 
 
 void guihckContextMouseUp(guihckContext* ctx, float x, float y, int button)
 {
+  if(ctx->recording)
+    _guihckRecordMouseButton(ctx, GUIHCK_RECORD_MOUSE_UP, x, y, button);
+
+  _GUIHCK_PROFILE_BEGIN(ctx, GUIHCK_PHASE_EVENTS);
+  ctx->pointerX = x;
+  ctx->pointerY = y;
+
+  clearMouseAreas(ctx->pressedMouseAreas);
+
+  /* Releasing a button ends the capture, hover state is resolved afterwards */
+  if(ctx->capturedMouseArea != GUIHCK_NO_MOUSE_AREA)
+  {
+    _guihckMouseArea* mouseArea = chckPoolGet(ctx->mouseAreas, ctx->capturedMouseArea);
+    if(mouseArea->functionMap.mouseUp)
+      mouseArea->functionMap.mouseUp(ctx, mouseArea->elementId, guihckElementGetData(ctx, mouseArea->elementId), button, x, y);
+    guihckContextReleasePointer(ctx);
+    _GUIHCK_PROFILE_END(ctx, GUIHCK_PHASE_EVENTS);
+    return;
+  }
+
   chckPoolIndex iter = 0;
   guihckMouseAreaId* mouseAreaId = NULL;
   chckIterPool* mouseAreas = queryMouseAreasContainingPoint(ctx, x, y);
   bool handled = false;
-  while(!handled && (mouseAreaId = chckIterPoolIter(mouseAreas, &iter)))
+  while((mouseAreaId = chckIterPoolIter(mouseAreas, &iter)))
   {
     _guihckMouseArea* mouseArea = chckPoolGet(ctx->mouseAreas, *mouseAreaId);
-    if(mouseArea->functionMap.mouseUp)
+    if(!mouseArea)
+      continue;
+
+    if(mouseArea->functionMap.mouseUp && (!handled || mouseArea->observes))
     {
-      handled = mouseArea->functionMap.mouseUp(ctx, mouseArea->elementId, guihckElementGetData(ctx, mouseArea->elementId), button, x, y);
+      if(mouseArea->functionMap.mouseUp(ctx, mouseArea->elementId, guihckElementGetData(ctx, mouseArea->elementId), button, x, y))
+        handled = true;
     }
   }
-  free(mouseAreas);
+  chckIterPoolFree(mouseAreas);
+  _GUIHCK_PROFILE_END(ctx, GUIHCK_PHASE_EVENTS);
 }
 
 void guihckContextMouseMove(guihckContext* ctx, float sx, float sy, float dx, float dy)
 {
-  chckPoolIndex iter = 0;
-  guihckMouseAreaId* mouseAreaId = NULL;
-  chckIterPool* mouseAreas = queryMouseAreasIntersectingLine(ctx, sx, sy, dx, dy);
-  bool handled = false;
-  while(!handled && (mouseAreaId = chckIterPoolIter(mouseAreas, &iter)))
+  if(ctx->recording)
+    _guihckRecordMouseMove(ctx, sx, sy, dx, dy);
+
+  _GUIHCK_PROFILE_BEGIN(ctx, GUIHCK_PHASE_EVENTS);
+  ctx->pointerX = dx;
+  ctx->pointerY = dy;
+
+  /* Captured pointer skips hit testing entirely */
+  if(ctx->capturedMouseArea != GUIHCK_NO_MOUSE_AREA)
   {
-    _guihckMouseArea* mouseArea = chckPoolGet(ctx->mouseAreas, *mouseAreaId);
-    if(!mouseArea->functionMap.mouseMove && !mouseArea->functionMap.mouseEnter && !mouseArea->functionMap.mouseExit)
+    _guihckMouseArea* mouseArea = chckPoolGet(ctx->mouseAreas, ctx->capturedMouseArea);
+    if(mouseArea->functionMap.mouseMove)
+      mouseArea->functionMap.mouseMove(ctx, mouseArea->elementId, guihckElementGetData(ctx, mouseArea->elementId), sx, sy, dx, dy);
+    _GUIHCK_PROFILE_END(ctx, GUIHCK_PHASE_EVENTS);
+    return;
+  }
+
+  updateHoveredMouseAreas(ctx, sx, sy, dx, dy, true);
+  _GUIHCK_PROFILE_END(ctx, GUIHCK_PHASE_EVENTS);
+}
+
+void guihckContextCapturePointer(guihckContext* ctx, guihckMouseAreaId mouseAreaId)
+{
+  assert(chckPoolGet(ctx->mouseAreas, mouseAreaId) && "Tried to capture pointer to an invalid mouse area");
+  ctx->capturedMouseArea = mouseAreaId;
+
+  /* Other areas holding the press lose it, the exit clears their pressed state.
+   * They are entered again when the capture ends with the pointer over them */
+  size_t count;
+  guihckMouseAreaId* pressedOrig = chckIterPoolToCArray(ctx->pressedMouseAreas, &count);
+  if(count == 0)
+    return;
+
+  guihckMouseAreaId* pressedIds = _GUIHCK_CALLOC(ctx, GUIHCK_MEMORY_SCRATCH, count * sizeof(guihckMouseAreaId));
+  memcpy(pressedIds, pressedOrig, count * sizeof(guihckMouseAreaId));
+  clearMouseAreas(ctx->pressedMouseAreas);
+
+  float x = ctx->pointerX;
+  float y = ctx->pointerY;
+  size_t i;
+  for(i = 0; i < count; ++i)
+  {
+    chckPoolIndex index;
+    if(pressedIds[i] == mouseAreaId)
       continue;
 
-    bool s = pointInRect(sx, sy, &mouseArea->rect);
-    bool d = pointInRect(dx, dy, &mouseArea->rect);
+    if(isHovered(ctx, pressedIds[i], &index))
+      chckIterPoolRemove(ctx->hoveredMouseAreas, index);
 
-    if(s && d)
-    {
-      if(mouseArea->functionMap.mouseMove)
-        handled = mouseArea->functionMap.mouseMove(ctx, mouseArea->elementId, guihckElementGetData(ctx, mouseArea->elementId), sx, sy, dx, dy);
-    }
-    else if(s)
-    {
-      if(mouseArea->functionMap.mouseExit)
-        handled = mouseArea->functionMap.mouseExit(ctx, mouseArea->elementId, guihckElementGetData(ctx, mouseArea->elementId), sx, sy, dx, dy);
-    }
-    else if(d)
-    {
-      if(mouseArea->functionMap.mouseEnter)
-        handled = mouseArea->functionMap.mouseEnter(ctx, mouseArea->elementId, guihckElementGetData(ctx, mouseArea->elementId), sx, sy, dx, dy);
-    }
+    _guihckMouseArea* mouseArea = chckPoolGet(ctx->mouseAreas, pressedIds[i]);
+    if(mouseArea && mouseArea->functionMap.mouseExit)
+      mouseArea->functionMap.mouseExit(ctx, mouseArea->elementId, guihckElementGetData(ctx, mouseArea->elementId), x, y, x, y);
   }
-  free(mouseAreas);
+
+  _GUIHCK_FREE(ctx, pressedIds);
 }
 
+void guihckContextReleasePointer(guihckContext* ctx)
+{
+  if(ctx->capturedMouseArea == GUIHCK_NO_MOUSE_AREA)
+    return;
+
+  ctx->capturedMouseArea = GUIHCK_NO_MOUSE_AREA;
+  _guihckContextSyncPointer(ctx);
+}
+
+guihckMouseAreaId guihckContextGetPointerCapture(guihckContext* ctx)
+{
+  return ctx->capturedMouseArea;
+}
 
 guihckMouseAreaId guihckMouseAreaNew(guihckContext* ctx, guihckElementId elementId, guihckMouseAreaFunctionMap functionMap)
 {
@@ -84,15 +181,28 @@ guihckMouseAreaId guihckMouseAreaNew(guihckContext* ctx, guihckElementId element
   mouseArea.rect.w = 0;
   mouseArea.rect.h = 0;
   mouseArea.functionMap = functionMap;
+  mouseArea.observes = false;
   guihckMouseAreaId id;
   chckPoolAdd(ctx->mouseAreas, &mouseArea, &id);
+  _GUIHCK_MEMORY_COUNT(ctx, GUIHCK_MEMORY_MOUSE_AREAS, sizeof(_guihckMouseArea));
   return id;
 }
 
 
 void guihckMouseAreaRemove(guihckContext* ctx, guihckMouseAreaId mouseAreaId)
 {
+  chckPoolIndex index;
+  if(isHovered(ctx, mouseAreaId, &index))
+    chckIterPoolRemove(ctx->hoveredMouseAreas, index);
+
+  if(findMouseArea(ctx->pressedMouseAreas, mouseAreaId, &index))
+    chckIterPoolRemove(ctx->pressedMouseAreas, index);
+
+  if(ctx->capturedMouseArea == mouseAreaId)
+    ctx->capturedMouseArea = GUIHCK_NO_MOUSE_AREA;
+
   chckPoolRemove(ctx->mouseAreas, mouseAreaId);
+  _GUIHCK_MEMORY_UNCOUNT(ctx, GUIHCK_MEMORY_MOUSE_AREAS, sizeof(_guihckMouseArea));
 }
 
 
@@ -105,6 +215,13 @@ void guihckMouseAreaRect(guihckContext* ctx, guihckMouseAreaId mouseAreaId, floa
     mouseArea->rect.y = y;
     mouseArea->rect.w = width;
     mouseArea->rect.h = height;
+
+    /* Hover state is resolved on next update if the area moved in or out under the pointer */
+    _guihckElement* element = chckPoolGet(ctx->elements, mouseArea->elementId);
+    float px = ctx->pointerX - (element ? element->translationX : 0);
+    float py = ctx->pointerY - (element ? element->translationY : 0);
+    if(pointInRect(px, py, &mouseArea->rect) != isHovered(ctx, mouseAreaId, NULL))
+      ctx->pointerDirty = true;
   }
 }
 
@@ -121,39 +238,151 @@ void guihckMouseAreaGetRect(guihckContext* ctx, guihckMouseAreaId mouseAreaId, f
   }
 }
 
+void guihckMouseAreaObserve(guihckContext* ctx, guihckMouseAreaId mouseAreaId, bool observe)
+{
+  _guihckMouseArea* mouseArea = chckPoolGet(ctx->mouseAreas, mouseAreaId);
+  if(mouseArea)
+    mouseArea->observes = observe;
+}
+
 bool pointInRect(float x, float y, const _guihckRect* r)
 {
   return x >= r->x && x <= r->x + r->w && y >= r->y && y <= r->y + r->h;
 }
 
-chckIterPool* queryMouseAreasContainingPoint(guihckContext* ctx, float x, float y)
+bool isPointInMouseArea(guihckContext* ctx, const _guihckMouseArea* mouseArea, float x, float y)
 {
-  chckIterPool* result = chckIterPoolNew(4, 4, sizeof(guihckMouseAreaId));
-  guihckMouseAreaId mouseAreaIter = 0;
-  _guihckMouseArea* mouseArea  = NULL;
-  while((mouseArea = chckPoolIter(ctx->mouseAreas, &mouseAreaIter)))
+  _guihckElement* element = chckPoolGet(ctx->elements, mouseArea->elementId);
+  if(!element || element->culled || element->hidden)
+    return false;
+
+  /* Rects are in the element's own space, scrolled content is moved by its translation.
+   * Areas partly inside a clip only take the pointer over the part that is shown */
+  return pointInRect(x - element->translationX, y - element->translationY, &mouseArea->rect)
+      && pointInRect(x, y, &element->visibleBounds);
+}
+
+bool isHovered(guihckContext* ctx, guihckMouseAreaId mouseAreaId, chckPoolIndex* index)
+{
+  return findMouseArea(ctx->hoveredMouseAreas, mouseAreaId, index);
+}
+
+bool findMouseArea(chckIterPool* mouseAreas, guihckMouseAreaId mouseAreaId, chckPoolIndex* index)
+{
+  chckPoolIndex iter = 0;
+  guihckMouseAreaId* current;
+  while((current = chckIterPoolIter(mouseAreas, &iter)))
   {
-    /* Should be replaced by querying a quad tree*/
-    if(pointInRect(x, y, &mouseArea->rect))
+    if(*current == mouseAreaId)
     {
-      guihckMouseAreaId id = mouseAreaIter - 1;
-      chckIterPoolAdd(result, &id, NULL);
+      if(index)
+        *index = iter - 1;
+      return true;
     }
   }
+  return false;
+}
 
-  return sortMouseAreasByElementOrder(ctx, result);
+void clearMouseAreas(chckIterPool* mouseAreas)
+{
+  size_t count;
+  while((count = chckIterPoolCount(mouseAreas)) > 0)
+    chckIterPoolRemove(mouseAreas, count - 1);
+}
+
+void updateHoveredMouseAreas(guihckContext* ctx, float sx, float sy, float dx, float dy, bool moved)
+{
+  chckIterPool* previous = ctx->hoveredMouseAreas;
+  chckIterPool* current = queryMouseAreasContainingPoint(ctx, dx, dy);
+  ctx->hoveredMouseAreas = current;
+
+  /* Exit everything that is no longer under the pointer */
+  chckPoolIndex iter = 0;
+  guihckMouseAreaId* mouseAreaId;
+  while((mouseAreaId = chckIterPoolIter(previous, &iter)))
+  {
+    if(isHovered(ctx, *mouseAreaId, NULL))
+      continue;
+
+    _guihckMouseArea* mouseArea = chckPoolGet(ctx->mouseAreas, *mouseAreaId);
+    if(mouseArea && mouseArea->functionMap.mouseExit)
+      mouseArea->functionMap.mouseExit(ctx, mouseArea->elementId, guihckElementGetData(ctx, mouseArea->elementId), sx, sy, dx, dy);
+  }
+
+  /* Callbacks may remove areas from the hovered pool, the ids are copied before walking them */
+  size_t count;
+  guihckMouseAreaId* currentOrig = chckIterPoolToCArray(current, &count);
+  guihckMouseAreaId* currentIds = NULL;
+  if(count > 0)
+  {
+    currentIds = _GUIHCK_CALLOC(ctx, GUIHCK_MEMORY_SCRATCH, count * sizeof(guihckMouseAreaId));
+    memcpy(currentIds, currentOrig, count * sizeof(guihckMouseAreaId));
+  }
+
+  /* Enter new areas, move within the ones already hovered until handled */
+  bool handled = false;
+  size_t i;
+  for(i = 0; i < count; ++i)
+  {
+    mouseAreaId = &currentIds[i];
+    _guihckMouseArea* mouseArea = chckPoolGet(ctx->mouseAreas, *mouseAreaId);
+    if(!mouseArea)
+      continue;
+
+    bool wasHovered = false;
+    chckPoolIndex pIter = 0;
+    guihckMouseAreaId* p;
+    while(!wasHovered && (p = chckIterPoolIter(previous, &pIter)))
+      wasHovered = *p == *mouseAreaId;
+
+    if(!wasHovered)
+    {
+      if(mouseArea->functionMap.mouseEnter)
+        mouseArea->functionMap.mouseEnter(ctx, mouseArea->elementId, guihckElementGetData(ctx, mouseArea->elementId), sx, sy, dx, dy);
+    }
+    else if(moved && (!handled || mouseArea->observes) && mouseArea->functionMap.mouseMove)
+    {
+      if(mouseArea->functionMap.mouseMove(ctx, mouseArea->elementId, guihckElementGetData(ctx, mouseArea->elementId), sx, sy, dx, dy))
+        handled = true;
+    }
+  }
+
+  if(currentIds)
+    _GUIHCK_FREE(ctx, currentIds);
+  chckIterPoolFree(previous);
+}
+
+void _guihckContextSyncPointer(guihckContext* ctx)
+{
+  ctx->pointerDirty = false;
+  if(ctx->capturedMouseArea == GUIHCK_NO_MOUSE_AREA)
+    updateHoveredMouseAreas(ctx, ctx->pointerX, ctx->pointerY, ctx->pointerX, ctx->pointerY, false);
+}
+
+guihckMouseAreaId _guihckContextFindMouseArea(guihckContext* ctx, guihckElementId elementId)
+{
+  guihckMouseAreaId mouseAreaIter = 0;
+  _guihckMouseArea* mouseArea = NULL;
+  while((mouseArea = chckPoolIter(ctx->mouseAreas, &mouseAreaIter)))
+  {
+    if(mouseArea->elementId == elementId)
+      return mouseAreaIter - 1;
+  }
+  return GUIHCK_NO_MOUSE_AREA;
 }
 
-chckIterPool* queryMouseAreasIntersectingLine(guihckContext* ctx, float sx, float sy, float dx, float dy)
+chckIterPool* queryMouseAreasContainingPoint(guihckContext* ctx, float x, float y)
 {
+  /* Geometry may have changed since the last render */
+  _guihckCullRefresh(ctx);
+
   chckIterPool* result = chckIterPoolNew(4, 4, sizeof(guihckMouseAreaId));
   guihckMouseAreaId mouseAreaIter = 0;
   _guihckMouseArea* mouseArea  = NULL;
   while((mouseArea = chckPoolIter(ctx->mouseAreas, &mouseAreaIter)))
   {
     /* Should be replaced by querying a quad tree*/
-    if(pointInRect(sx, sy, &mouseArea->rect)
-       || pointInRect(dx, dy, &mouseArea->rect))
+    if(isPointInMouseArea(ctx, mouseArea, x, y))
     {
       guihckMouseAreaId id = mouseAreaIter - 1;
       chckIterPoolAdd(result, &id, NULL);
@@ -196,7 +425,7 @@ chckIterPool* sortMouseAreasByElementOrder(guihckContext* ctx, chckIterPool* mou
 
   for(i = 0; i < left; ++i)
   {
-    chckIterPoolRemove(mouseAreas, n - i);
+    chckIterPoolRemove(mouseAreas, n - 1 - i);
   }
 
   return mouseAreas;
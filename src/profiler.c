@@ -0,0 +1,148 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+# include <windows.h>
+#endif
+
+static void _guihckProfilerResetFrame(_guihckProfiler* profiler);
+
+void guihckContextProfiling(guihckContext* ctx, bool enabled)
+{
+  if(enabled && !ctx->profiler)
+  {
+    ctx->profiler = calloc(1, sizeof(_guihckProfiler));
+    ctx->profiler->frameStart = _guihckProfilerNow();
+  }
+  else if(!enabled && ctx->profiler)
+  {
+    free(ctx->profiler->currentTypes);
+    free(ctx->profiler->lastTypes);
+    free(ctx->profiler);
+    ctx->profiler = NULL;
+  }
+}
+
+bool guihckContextGetProfiling(guihckContext* ctx)
+{
+  return ctx->profiler != NULL;
+}
+
+bool guihckContextGetFrameStats(guihckContext* ctx, guihckFrameStats* stats)
+{
+  if(!ctx->profiler || !ctx->profiler->hasFrame)
+    return false;
+
+  *stats = ctx->profiler->last;
+  return true;
+}
+
+double _guihckProfilerNow()
+{
+#if defined(_WIN32)
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return (double) counter.QuadPart / frequency.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+void _guihckProfilerBegin(guihckContext* ctx, guihckFramePhase phase)
+{
+  /* Only the outermost span of a phase is timed, binds nest into binds */
+  _guihckProfiler* profiler = ctx->profiler;
+  if(profiler->phaseDepth[phase]++ == 0)
+    profiler->phaseStart[phase] = _guihckProfilerNow();
+  profiler->current.phases[phase].calls += 1;
+}
+
+void _guihckProfilerEnd(guihckContext* ctx, guihckFramePhase phase)
+{
+  /* Profiling may have been enabled inside the span */
+  _guihckProfiler* profiler = ctx->profiler;
+  if(profiler->phaseDepth[phase] > 0 && --profiler->phaseDepth[phase] == 0)
+    profiler->current.phases[phase].time += _guihckProfilerNow() - profiler->phaseStart[phase];
+}
+
+guihckTypeStats* _guihckProfilerGetTypeStats(guihckContext* ctx, guihckElementTypeId typeId)
+{
+  _guihckProfiler* profiler = ctx->profiler;
+  if(typeId >= profiler->typeCapacity)
+  {
+    size_t capacity = chckPoolCount(ctx->types->elementTypes);
+    if(capacity <= typeId)
+      capacity = typeId + 1;
+
+    profiler->currentTypes = realloc(profiler->currentTypes, capacity * sizeof(guihckTypeStats));
+    profiler->lastTypes = realloc(profiler->lastTypes, capacity * sizeof(guihckTypeStats));
+    memset(profiler->currentTypes + profiler->typeCapacity, 0, (capacity - profiler->typeCapacity) * sizeof(guihckTypeStats));
+    memset(profiler->lastTypes + profiler->typeCapacity, 0, (capacity - profiler->typeCapacity) * sizeof(guihckTypeStats));
+    profiler->typeCapacity = capacity;
+
+    /* The finished frame keeps its count, only its table moved */
+    if(profiler->last.types)
+      profiler->last.types = profiler->lastTypes;
+  }
+
+  return &profiler->currentTypes[typeId];
+}
+
+void _guihckProfilerBeginBind(guihckContext* ctx, guihckElementId elementId)
+{
+  guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  ctx->profiler->current.bindEvaluations += 1;
+  _guihckProfilerGetTypeStats(ctx, element->type)->bindEvaluations += 1;
+  _guihckProfilerBegin(ctx, GUIHCK_PHASE_BINDS);
+}
+
+void _guihckProfilerCountListener(guihckContext* ctx, guihckElementId listenerId)
+{
+  guihckElement* element = chckPoolGet(ctx->elements, listenerId);
+  ctx->profiler->current.listenerNotifications += 1;
+  if(element)
+    _guihckProfilerGetTypeStats(ctx, element->type)->listenerNotifications += 1;
+}
+
+void _guihckProfilerEndFrame(guihckContext* ctx)
+{
+  _guihckProfiler* profiler = ctx->profiler;
+  double now = _guihckProfilerNow();
+
+  unsigned long frame = profiler->last.frame + (profiler->hasFrame ? 1 : 0);
+  profiler->last = profiler->current;
+  profiler->last.frame = frame;
+  profiler->last.frameTime = now - profiler->frameStart;
+
+  /* Swap the type tables, the returned stats point at the finished one */
+  guihckTypeStats* types = profiler->lastTypes;
+  profiler->lastTypes = profiler->currentTypes;
+  profiler->currentTypes = types;
+  profiler->last.types = profiler->lastTypes;
+  profiler->last.typeCount = profiler->typeCapacity;
+
+  /* Names are looked up here, the registry may have been copied during the frame */
+  size_t i;
+  for(i = 0; i < profiler->typeCapacity; ++i)
+  {
+    _guihckElementType* type = chckPoolGet(ctx->types->elementTypes, i);
+    profiler->lastTypes[i].name = type ? type->name : "";
+  }
+
+  profiler->hasFrame = true;
+  profiler->frameStart = now;
+  _guihckProfilerResetFrame(profiler);
+}
+
+void _guihckProfilerResetFrame(_guihckProfiler* profiler)
+{
+  memset(&profiler->current, 0, sizeof(guihckFrameStats));
+  memset(profiler->currentTypes, 0, profiler->typeCapacity * sizeof(guihckTypeStats));
+}
@@ -0,0 +1,225 @@
+#include "internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Recording layout, all values in host byte order:
+ *
+ *   "GUIHCKR1" u32 version
+ *   records, each a u8 guihckRecordType followed by its arguments:
+ *     time:           f64 time
+ *     mouse down/up:  f32 x, f32 y, i32 button
+ *     mouse move:     f32 sx, f32 sy, f32 dx, f32 dy
+ *     key:            i32 key, i32 scancode, i32 action, i32 mods
+ *     char:           u32 codepoint
+ *     update/render:  nothing
+ *
+ * Update and render calls mark the frames, a replay repeats them in the
+ * same order as the input so every frame sees the same events. */
+
+#define _GUIHCK_RECORD_MAGIC "GUIHCKR1"
+#define _GUIHCK_RECORD_VERSION 1
+
+struct _guihckReplay
+{
+  _guihckMappedFile file;
+  size_t offset;
+};
+
+static void _guihckRecordWrite(guihckContext* ctx, guihckRecordType type, const void* data, size_t size);
+static const void* _guihckReplayRead(guihckReplay* replay, size_t size);
+
+bool guihckContextRecordStart(guihckContext* ctx, const char* path)
+{
+  guihckContextRecordStop(ctx);
+
+  FILE* file = fopen(path, "wb");
+  if(!file)
+    return false;
+
+  uint32_t version = _GUIHCK_RECORD_VERSION;
+  if(fwrite(_GUIHCK_RECORD_MAGIC, 1, 8, file) != 8 || fwrite(&version, sizeof(version), 1, file) != 1)
+  {
+    fclose(file);
+    return false;
+  }
+
+  ctx->recording = file;
+  return true;
+}
+
+void guihckContextRecordStop(guihckContext* ctx)
+{
+  if(ctx->recording)
+  {
+    fclose(ctx->recording);
+    ctx->recording = NULL;
+  }
+}
+
+guihckReplay* guihckReplayOpen(const char* path)
+{
+  guihckReplay* replay = calloc(1, sizeof(guihckReplay));
+  if(!_guihckMappedFileOpen(&replay->file, path))
+  {
+    free(replay);
+    return NULL;
+  }
+
+  const char* magic = _guihckReplayRead(replay, 8);
+  const uint32_t* version = _guihckReplayRead(replay, sizeof(uint32_t));
+  if(!magic || !version || memcmp(magic, _GUIHCK_RECORD_MAGIC, 8) != 0 || *version != _GUIHCK_RECORD_VERSION)
+  {
+    fprintf(stderr, "Replay: %s is not a guihck recording\n", path);
+    guihckReplayClose(replay);
+    return NULL;
+  }
+
+  return replay;
+}
+
+void guihckReplayClose(guihckReplay* replay)
+{
+  _guihckMappedFileClose(&replay->file);
+  free(replay);
+}
+
+guihckRecordType guihckReplayStep(guihckReplay* replay, guihckContext* ctx)
+{
+  const uint8_t* type = _guihckReplayRead(replay, 1);
+  if(!type)
+    return GUIHCK_RECORD_END;
+
+  /* Arguments are copied out, the mapping gives no alignment guarantees */
+  switch(*type)
+  {
+    case GUIHCK_RECORD_TIME:
+    {
+      double time;
+      const void* data = _guihckReplayRead(replay, sizeof(time));
+      if(!data)
+        return GUIHCK_RECORD_END;
+      memcpy(&time, data, sizeof(time));
+      guihckContextTime(ctx, time);
+      break;
+    }
+    case GUIHCK_RECORD_MOUSE_DOWN:
+    case GUIHCK_RECORD_MOUSE_UP:
+    {
+      float position[2];
+      int32_t button;
+      const char* data = _guihckReplayRead(replay, sizeof(position) + sizeof(button));
+      if(!data)
+        return GUIHCK_RECORD_END;
+      memcpy(position, data, sizeof(position));
+      memcpy(&button, data + sizeof(position), sizeof(button));
+      if(*type == GUIHCK_RECORD_MOUSE_DOWN)
+        guihckContextMouseDown(ctx, position[0], position[1], button);
+      else
+        guihckContextMouseUp(ctx, position[0], position[1], button);
+      break;
+    }
+    case GUIHCK_RECORD_MOUSE_MOVE:
+    {
+      float position[4];
+      const void* data = _guihckReplayRead(replay, sizeof(position));
+      if(!data)
+        return GUIHCK_RECORD_END;
+      memcpy(position, data, sizeof(position));
+      guihckContextMouseMove(ctx, position[0], position[1], position[2], position[3]);
+      break;
+    }
+    case GUIHCK_RECORD_KEY:
+    {
+      int32_t args[4];
+      const void* data = _guihckReplayRead(replay, sizeof(args));
+      if(!data)
+        return GUIHCK_RECORD_END;
+      memcpy(args, data, sizeof(args));
+      guihckContextKeyboardKey(ctx, args[0], args[1], args[2], args[3]);
+      break;
+    }
+    case GUIHCK_RECORD_CHAR:
+    {
+      uint32_t codepoint;
+      const void* data = _guihckReplayRead(replay, sizeof(codepoint));
+      if(!data)
+        return GUIHCK_RECORD_END;
+      memcpy(&codepoint, data, sizeof(codepoint));
+      guihckContextKeyboardChar(ctx, codepoint);
+      break;
+    }
+    case GUIHCK_RECORD_UPDATE:
+      guihckContextUpdate(ctx);
+      break;
+    case GUIHCK_RECORD_RENDER:
+      guihckContextRender(ctx);
+      break;
+    default:
+      fprintf(stderr, "Replay: unknown record type %d\n", (int) *type);
+      replay->offset = replay->file.size;
+      return GUIHCK_RECORD_END;
+  }
+
+  return *type;
+}
+
+void _guihckRecordTime(guihckContext* ctx, double time)
+{
+  _guihckRecordWrite(ctx, GUIHCK_RECORD_TIME, &time, sizeof(time));
+}
+
+void _guihckRecordMouseButton(guihckContext* ctx, guihckRecordType type, float x, float y, int button)
+{
+  char data[2 * sizeof(float) + sizeof(int32_t)];
+  float position[2] = {x, y};
+  int32_t button32 = button;
+  memcpy(data, position, sizeof(position));
+  memcpy(data + sizeof(position), &button32, sizeof(button32));
+  _guihckRecordWrite(ctx, type, data, sizeof(data));
+}
+
+void _guihckRecordMouseMove(guihckContext* ctx, float sx, float sy, float dx, float dy)
+{
+  float position[4] = {sx, sy, dx, dy};
+  _guihckRecordWrite(ctx, GUIHCK_RECORD_MOUSE_MOVE, position, sizeof(position));
+}
+
+void _guihckRecordKey(guihckContext* ctx, guihckKey key, int scancode, guihckKeyAction action, guihckKeyMods mods)
+{
+  int32_t args[4] = {key, scancode, action, mods};
+  _guihckRecordWrite(ctx, GUIHCK_RECORD_KEY, args, sizeof(args));
+}
+
+void _guihckRecordChar(guihckContext* ctx, unsigned int codepoint)
+{
+  uint32_t codepoint32 = codepoint;
+  _guihckRecordWrite(ctx, GUIHCK_RECORD_CHAR, &codepoint32, sizeof(codepoint32));
+}
+
+void _guihckRecordFrame(guihckContext* ctx, guihckRecordType type)
+{
+  _guihckRecordWrite(ctx, type, NULL, 0);
+}
+
+void _guihckRecordWrite(guihckContext* ctx, guihckRecordType type, const void* data, size_t size)
+{
+  /* A failed write stops the recording rather than leaving a log with holes */
+  uint8_t type8 = type;
+  if(fwrite(&type8, 1, 1, ctx->recording) != 1 || (size > 0 && fwrite(data, size, 1, ctx->recording) != 1))
+  {
+    fprintf(stderr, "Record: write failed, recording stopped\n");
+    guihckContextRecordStop(ctx);
+  }
+}
+
+const void* _guihckReplayRead(guihckReplay* replay, size_t size)
+{
+  if(replay->file.size - replay->offset < size)
+    return NULL;
+
+  const void* data = replay->file.data + replay->offset;
+  replay->offset += size;
+  return data;
+}
@@ -0,0 +1,196 @@
+#include "internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Declared properties keep a native copy of their value next to the SCM one, converted
+ * when the property changes. Invalid values drop the copy so they read as the default */
+
+static bool _guihckValueFromScm(guihckContext* ctx, guihckValueType type, SCM value, guihckValue* result);
+static const guihckValue* _guihckElementGetValue(guihckContext* ctx, guihckElementId elementId, const char* key,
+                                                 guihckValueType type, guihckValue* converted);
+static unsigned char _guihckColorComponent(double value);
+
+int _guihckPropertySchemaIndex(guihckContext* ctx, guihckElementId elementId, const char* propertyName)
+{
+  guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  _guihckElementType* type = chckPoolGet(ctx->types->elementTypes, element->type);
+  if(!type->schemaByName)
+    return -1;
+
+  size_t* index = chckHashTableStrGet(type->schemaByName, propertyName);
+  return index ? (int) *index : -1;
+}
+
+void _guihckPropertySchemaConvert(guihckContext* ctx, guihckElementId elementId, _guihckProperty* property)
+{
+  guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  _guihckElementType* type = chckPoolGet(ctx->types->elementTypes, element->type);
+  const guihckPropertySchema* schema = &type->schema[property->schema];
+
+  guihckValue value;
+  bool valid = _guihckValueFromScm(ctx, schema->type, property->value, &value);
+  _guihckPropertyFreeNative(ctx, property);
+  if(valid)
+  {
+    property->nativeType = schema->type;
+    property->native = value;
+    property->hasNative = true;
+  }
+}
+
+void _guihckPropertySchemaMark(guihckContext* ctx, guihckElementId elementId, _guihckProperty* property)
+{
+  guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  _guihckElementType* type = chckPoolGet(ctx->types->elementTypes, element->type);
+  if(type->schema[property->schema].marksDirty)
+    element->changed |= GUIHCK_PROPERTY_BIT(property->schema);
+}
+
+void _guihckPropertyFreeNative(guihckContext* ctx, _guihckProperty* property)
+{
+  if(property->hasNative && property->nativeType == GUIHCK_VALUE_STRING)
+    _GUIHCK_FREE(ctx, (char*) property->native.string);
+
+  property->hasNative = false;
+}
+
+float guihckElementGetFloat(guihckContext* ctx, guihckElementId elementId, const char* key)
+{
+  guihckValue converted;
+  const guihckValue* value = _guihckElementGetValue(ctx, elementId, key, GUIHCK_VALUE_F32, &converted);
+  return value ? value->f32 : 0;
+}
+
+int32_t guihckElementGetInt(guihckContext* ctx, guihckElementId elementId, const char* key)
+{
+  guihckValue converted;
+  const guihckValue* value = _guihckElementGetValue(ctx, elementId, key, GUIHCK_VALUE_I32, &converted);
+  return value ? value->i32 : 0;
+}
+
+bool guihckElementGetBool(guihckContext* ctx, guihckElementId elementId, const char* key)
+{
+  guihckValue converted;
+  const guihckValue* value = _guihckElementGetValue(ctx, elementId, key, GUIHCK_VALUE_BOOL, &converted);
+  return value ? value->boolean : false;
+}
+
+guihckColor guihckElementGetColor(guihckContext* ctx, guihckElementId elementId, const char* key)
+{
+  guihckValue converted;
+  const guihckValue* value = _guihckElementGetValue(ctx, elementId, key, GUIHCK_VALUE_COLOR, &converted);
+  guihckColor white = {255, 255, 255, 255};
+  return value ? value->color : white;
+}
+
+const char* guihckElementGetString(guihckContext* ctx, guihckElementId elementId, const char* key)
+{
+  guihckValue converted;
+  const guihckValue* value = _guihckElementGetValue(ctx, elementId, key, GUIHCK_VALUE_STRING, &converted);
+  if(value != &converted)
+    return value ? value->string : NULL;
+
+  /* Undeclared strings have no property to own them, the context keeps the last one */
+  _GUIHCK_FREE(ctx, ctx->convertedString);
+  ctx->convertedString = (char*) converted.string;
+  return ctx->convertedString;
+}
+
+const guihckValue* _guihckElementGetValue(guihckContext* ctx, guihckElementId elementId, const char* key,
+                                          guihckValueType type, guihckValue* converted)
+{
+  guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  _guihckProperty* property = chckHashTableStrGet(element->properties, key);
+
+  /* Reading evaluates a stale lazy bind */
+  if(property && property->type == GUIHCK_PROPERTY_BIND && property->bind.pending)
+  {
+    guihckElementGetProperty(ctx, elementId, key);
+    element = chckPoolGet(ctx->elements, elementId);
+    property = chckHashTableStrGet(element->properties, key);
+  }
+
+  if(property && property->hasNative && property->nativeType == type)
+    return &property->native;
+
+  /* Undeclared properties are converted on each call */
+  if(property && property->schema < 0 && converted && _guihckValueFromScm(ctx, type, property->value, converted))
+    return converted;
+
+  _guihckElementType* elementType = chckPoolGet(ctx->types->elementTypes, element->type);
+  size_t* index = elementType->schemaByName ? chckHashTableStrGet(elementType->schemaByName, key) : NULL;
+  if(index && elementType->schema[*index].type == type)
+    return &elementType->schema[*index].defaultValue;
+
+  return NULL;
+}
+
+bool _guihckValueFromScm(guihckContext* ctx, guihckValueType type, SCM value, guihckValue* result)
+{
+  switch(type)
+  {
+    case GUIHCK_VALUE_SCM:
+      return false;
+    case GUIHCK_VALUE_F32:
+    {
+      if(!scm_is_real(value))
+        return false;
+      result->f32 = (float) scm_to_double(value);
+      return true;
+    }
+    case GUIHCK_VALUE_I32:
+    {
+      if(!scm_is_real(value))
+        return false;
+      double real = scm_to_double(value);
+      real = real < INT32_MIN ? INT32_MIN : real > INT32_MAX ? INT32_MAX : real;
+      result->i32 = (int32_t) (real < 0 ? real - 0.5 : real + 0.5);
+      return true;
+    }
+    case GUIHCK_VALUE_BOOL:
+    {
+      if(!scm_is_bool(value))
+        return false;
+      result->boolean = scm_is_true(value);
+      return true;
+    }
+    case GUIHCK_VALUE_COLOR:
+    {
+      long length = scm_ilength(value);
+      if(length != 3 && length != 4)
+        return false;
+
+      double components[4] = {0, 0, 0, 255};
+      long i;
+      for(i = 0; i < length; ++i, value = scm_cdr(value))
+      {
+        SCM component = scm_car(value);
+        if(!scm_is_real(component))
+          return false;
+        components[i] = scm_to_double(component);
+      }
+
+      result->color.r = _guihckColorComponent(components[0]);
+      result->color.g = _guihckColorComponent(components[1]);
+      result->color.b = _guihckColorComponent(components[2]);
+      result->color.a = _guihckColorComponent(components[3]);
+      return true;
+    }
+    case GUIHCK_VALUE_STRING:
+    {
+      if(!scm_is_string(value))
+        return false;
+      char* str = scm_to_utf8_string(value);
+      result->string = _GUIHCK_STRDUP(ctx, GUIHCK_MEMORY_PROPERTIES, str);
+      free(str);
+      return true;
+    }
+  }
+  return false;
+}
+
+unsigned char _guihckColorComponent(double value)
+{
+  return value <= 0 ? 0 : value >= 255 ? 255 : (unsigned char) (value + 0.5);
+}
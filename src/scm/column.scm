@@ -0,0 +1,40 @@
+(define (column-gen)
+  (define (align-height h)
+    (let ((y 0) (spacing (get-prop 'spacing)))
+      (for-each
+        (lambda (child)
+          (set-prop! child 'y y)
+          (set! y (+ y spacing (get-prop child 'height))))
+        (get-prop 'children))
+      (set-prop! 'height (- y spacing))))
+
+  (define (align-width w)
+    (set-prop! 'width
+      (apply max
+        (cons 0 (map
+          (lambda (c) (get-prop c 'width))
+          (get-prop 'children))))))
+
+  (define (update-bindings cs)
+    (let ((previous (get-prop 'listeners)))
+      (if (pair? previous)
+        (for-each unbind previous)))
+    (align-width 0)
+    (align-height 0)
+    (flatmap
+      (lambda (c)
+        (list
+          (bind c 'width align-width)
+          (bind c 'height align-height)))
+      cs))
+
+  (define default-args (list
+    (prop 'spacing 0)
+    (prop 'init (lambda ()
+      (bind 'spacing align-height)
+      (align-height 0)))
+    (prop 'listeners
+      (bound '(this children) update-bindings))))
+
+  (apply composite (cons item default-args)))
+(define column (column-gen))
@@ -0,0 +1,3 @@
+(define (item . args)
+  (define default-args (list (prop 'x 0) (prop 'y 0)))
+  (create-element 'item (append default-args args)))
@@ -0,0 +1,4 @@
+(define (mouse-area . args)
+  (define default-args (list (prop 'x 0) (prop 'y 0) (prop 'width 0) (prop 'height 0)
+                             (prop 'hover #f) (prop 'pressed #f)))
+  (create-element 'mouse-area (append default-args args)))
@@ -0,0 +1,40 @@
+(define (row-gen)
+  (define (align-width w)
+    (let ((x 0) (spacing (get-prop 'spacing)))
+      (for-each
+        (lambda (child)
+          (set-prop! child 'x x)
+          (set! x (+ x spacing (get-prop child 'width))))
+        (get-prop 'children))
+      (set-prop! 'width (- x spacing))))
+
+  (define (align-height h)
+    (set-prop! 'height
+      (apply max
+        (cons 0 (map
+          (lambda (c) (get-prop c 'height))
+          (get-prop 'children))))))
+
+  (define (update-bindings cs)
+    (let ((previous (get-prop 'listeners)))
+      (if (pair? previous)
+        (for-each unbind previous)))
+    (align-width 0)
+    (align-height 0)
+    (flatmap
+      (lambda (c)
+        (list
+          (bind c 'width align-width)
+          (bind c 'height align-height)))
+      cs))
+
+  (define default-args (list
+    (prop 'spacing 0)
+    (prop 'init (lambda ()
+      (bind 'spacing align-width)
+      (align-width 0)))
+    (prop 'listeners
+      (bound '(this children) update-bindings))))
+
+  (apply composite (cons item default-args)))
+(define row (row-gen))
@@ -0,0 +1,5 @@
+(define (scroll-view . args)
+  (define default-args (list (prop 'x 0) (prop 'y 0) (prop 'width 0) (prop 'height 0) (prop 'clip #t)
+                             (prop 'content-x 0) (prop 'content-y 0) (prop 'content-width 0) (prop 'content-height 0)
+                             (prop 'deceleration 1500) (prop 'drag-threshold 4) (prop 'interactive #t) (prop 'moving #f)))
+  (create-element 'scroll-view (append default-args args)))
@@ -0,0 +1,3 @@
+(define (timer . args)
+  (define default-args (list (prop 'running #f) (prop 'next-timeout -1) (prop 'interval 0) (prop 'repeat 1) (prop 'on-timeout (lambda () #f))))
+  (create-element 'timer (append default-args args)))
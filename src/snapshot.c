@@ -0,0 +1,842 @@
+#include "internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Snapshot layout, all integers in host byte order:
+ *
+ *   "GUIHCKS1" u32 version, 2 added lazy binds and 1 is still read
+ *   u32 type count, type names
+ *   u32 element count, u32 focused element index
+ *   elements in pre-order, the root first:
+ *     u32 type index, u32 parent index, u32 data size, data
+ *     u32 property count, properties:
+ *       string name, u8 kind (property type, lazy binds use their own)
+ *       value:  tagged value
+ *       alias:  u32 element index, string property
+ *       bind:   string procedure, u32 count, (u32 element index, string property) * count, same for lazy binds
+ *
+ * Strings are a u32 length followed by the bytes. Element indices refer to
+ * the pre-order position. Procedures are stored by their top-level name. */
+
+#define _GUIHCK_SNAPSHOT_MAGIC "GUIHCKS1"
+#define _GUIHCK_SNAPSHOT_VERSION 2
+#define _GUIHCK_SNAPSHOT_MIN_VERSION 1
+#define _GUIHCK_SNAPSHOT_NO_PARENT UINT32_MAX
+#define _GUIHCK_SNAPSHOT_LAZY_BIND (GUIHCK_PROPERTY_BIND + 1)
+#define _GUIHCK_SNAPSHOT_MAX_DEPTH 256 /* nested pairs and vectors, list tails do not count */
+
+typedef enum _guihckSnapshotValueTag
+{
+  _GUIHCK_SNAPSHOT_UNDEFINED,
+  _GUIHCK_SNAPSHOT_FALSE,
+  _GUIHCK_SNAPSHOT_TRUE,
+  _GUIHCK_SNAPSHOT_NULL,
+  _GUIHCK_SNAPSHOT_INTEGER,
+  _GUIHCK_SNAPSHOT_REAL,
+  _GUIHCK_SNAPSHOT_STRING,
+  _GUIHCK_SNAPSHOT_SYMBOL,
+  _GUIHCK_SNAPSHOT_CHAR,
+  _GUIHCK_SNAPSHOT_PAIR,
+  _GUIHCK_SNAPSHOT_VECTOR,
+  _GUIHCK_SNAPSHOT_PROCEDURE
+} _guihckSnapshotValueTag;
+
+typedef struct _guihckSnapshotWriter
+{
+  char* data;
+  size_t size;
+  size_t capacity;
+  bool failed;
+  unsigned int depth;
+} _guihckSnapshotWriter;
+
+typedef struct _guihckSnapshotReader
+{
+  const char* data;
+  size_t size;
+  size_t offset;
+  bool failed;
+  unsigned int depth;
+} _guihckSnapshotReader;
+
+typedef struct _guihckSnapshotElement
+{
+  uint32_t typeIndex;
+  uint32_t parentIndex;
+  uint32_t dataSize;
+  const void* data;
+  size_t propertyOffset;
+} _guihckSnapshotElement;
+
+static void _guihckSnapshotWrite(_guihckSnapshotWriter* writer, const void* data, size_t size);
+static void _guihckSnapshotWriteU8(_guihckSnapshotWriter* writer, uint8_t value);
+static void _guihckSnapshotWriteU32(_guihckSnapshotWriter* writer, uint32_t value);
+static void _guihckSnapshotWriteString(_guihckSnapshotWriter* writer, const char* str, size_t length);
+static void _guihckSnapshotWriteValue(_guihckSnapshotWriter* writer, SCM value, const char* propertyName);
+static void _guihckSnapshotWriteElement(guihckContext* ctx, _guihckSnapshotWriter* writer, chckHashTable* indices, chckHashTable* typeIndices,
+                                        guihckElementId elementId, uint32_t parentIndex);
+static bool _guihckSnapshotReadElements(_guihckSnapshotReader* reader, _guihckSnapshotElement* elements, uint32_t elementCount,
+                                        uint32_t typeCount, uint32_t version);
+static void _guihckSnapshotSkipProperty(_guihckSnapshotReader* reader, uint8_t kind, uint32_t elementCount, uint32_t version);
+static SCM _guihckSnapshotProcedureName(SCM procedure);
+static const void* _guihckSnapshotRead(_guihckSnapshotReader* reader, size_t size);
+static uint8_t _guihckSnapshotReadU8(_guihckSnapshotReader* reader);
+static uint32_t _guihckSnapshotReadU32(_guihckSnapshotReader* reader);
+static const char* _guihckSnapshotReadString(_guihckSnapshotReader* reader, uint32_t* length);
+static char* _guihckSnapshotReadStringCopy(_guihckSnapshotReader* reader);
+static SCM _guihckSnapshotReadValue(_guihckSnapshotReader* reader, bool skip);
+static chckIterPool* _guihckSnapshotCollectElements(guihckContext* ctx, chckHashTable* indices, chckHashTable* typeIndices, chckIterPool* types);
+
+bool guihckContextSaveSnapshot(guihckContext* ctx, const char* path)
+{
+  /* Listeners added after construction, like Scheme binds in init procedures, can not be stored */
+  chckPoolIndex lIter = 0;
+  _guihckPropertyListener* listener;
+  while((listener = chckPoolIter(ctx->propertyListeners, &lIter)))
+  {
+    if(!_guihckPropertyListenerIsRestorable(listener))
+    {
+      fprintf(stderr, "Snapshot: element %d has a listener on '%s' that can not be stored\n",
+              (int) listener->listenerId, listener->propertyName);
+      return false;
+    }
+  }
+
+  chckHashTable* indices = chckHashTableNew(256);
+  chckHashTable* typeIndices = chckHashTableNew(32);
+  chckIterPool* types = chckIterPoolNew(16, 16, sizeof(guihckElementTypeId));
+  chckIterPool* order = _guihckSnapshotCollectElements(ctx, indices, typeIndices, types);
+  size_t elementCount = chckIterPoolCount(order);
+
+  _guihckSnapshotWriter writer = {NULL, 0, 0, false, 0};
+  _guihckSnapshotWrite(&writer, _GUIHCK_SNAPSHOT_MAGIC, 8);
+  _guihckSnapshotWriteU32(&writer, _GUIHCK_SNAPSHOT_VERSION);
+
+  _guihckSnapshotWriteU32(&writer, chckIterPoolCount(types));
+  chckPoolIndex tIter = 0;
+  guihckElementTypeId* typeId;
+  while((typeId = chckIterPoolIter(types, &tIter)))
+  {
+    _guihckElementType* type = chckPoolGet(ctx->types->elementTypes, *typeId);
+    _guihckSnapshotWriteString(&writer, type->name, strlen(type->name));
+  }
+
+  uint32_t* focusedIndex = chckHashTableGet(indices, ctx->focused);
+  _guihckSnapshotWriteU32(&writer, elementCount);
+  _guihckSnapshotWriteU32(&writer, focusedIndex ? *focusedIndex : 0);
+
+  size_t e;
+  for(e = 0; e < elementCount && !writer.failed; ++e)
+  {
+    guihckElementId elementId = *(guihckElementId*) chckIterPoolGet(order, e);
+    guihckElement* element = chckPoolGet(ctx->elements, elementId);
+    uint32_t parentIndex = e == 0 ? _GUIHCK_SNAPSHOT_NO_PARENT : *(uint32_t*) chckHashTableGet(indices, element->parent);
+    _guihckSnapshotWriteElement(ctx, &writer, indices, typeIndices, elementId, parentIndex);
+  }
+
+  chckIterPoolFree(order);
+  chckIterPoolFree(types);
+  chckHashTableFree(typeIndices);
+  chckHashTableFree(indices);
+
+  bool success = !writer.failed;
+  if(success)
+  {
+    FILE* file = fopen(path, "wb");
+    success = file && fwrite(writer.data, 1, writer.size, file) == writer.size;
+    if(file && fclose(file) != 0)
+      success = false;
+  }
+
+  free(writer.data);
+  return success;
+}
+
+bool guihckContextLoadSnapshot(guihckContext* ctx, const char* path)
+{
+  /* Snapshots hold a whole tree, merging one into existing elements is not supported */
+  if(guihckElementGetChildCount(ctx, ctx->rootElementId) > 0)
+  {
+    fprintf(stderr, "Snapshot: %s can only be loaded into an empty context\n", path);
+    return false;
+  }
+
+  _guihckMappedFile file;
+  if(!_guihckMappedFileOpen(&file, path))
+    return false;
+
+  _guihckSnapshotReader reader = {file.data, file.size, 0, false, 0};
+  const char* magic = _guihckSnapshotRead(&reader, 8);
+  uint32_t version = magic ? _guihckSnapshotReadU32(&reader) : 0;
+  if(!magic || memcmp(magic, _GUIHCK_SNAPSHOT_MAGIC, 8) != 0
+     || version < _GUIHCK_SNAPSHOT_MIN_VERSION || version > _GUIHCK_SNAPSHOT_VERSION)
+  {
+    fprintf(stderr, "Snapshot: %s is not a guihck snapshot\n", path);
+    _guihckMappedFileClose(&file);
+    return false;
+  }
+
+  /* Resolve every type before creating anything */
+  uint32_t typeCount = _guihckSnapshotReadU32(&reader);
+  guihckElementTypeId* typeIds = calloc(typeCount ? typeCount : 1, sizeof(guihckElementTypeId));
+  uint32_t i;
+  for(i = 0; i < typeCount && !reader.failed; ++i)
+  {
+    char* name = _guihckSnapshotReadStringCopy(&reader);
+    guihckElementTypeId* typeId = name ? chckHashTableStrGet(ctx->types->elementTypesByName, name) : NULL;
+    if(!typeId)
+    {
+      fprintf(stderr, "Snapshot: element type '%s' is not registered\n", name ? name : "");
+      reader.failed = true;
+    }
+    else
+    {
+      typeIds[i] = *typeId;
+    }
+    free(name);
+  }
+
+  uint32_t elementCount = _guihckSnapshotReadU32(&reader);
+  uint32_t focusedIndex = _guihckSnapshotReadU32(&reader);
+  if(reader.failed || elementCount == 0 || elementCount > file.size)
+  {
+    free(typeIds);
+    _guihckMappedFileClose(&file);
+    return false;
+  }
+
+  /* The whole file is checked before the tree is touched, a corrupt snapshot changes nothing */
+  _guihckSnapshotElement* elements = calloc(elementCount, sizeof(_guihckSnapshotElement));
+  guihckElementId* ids = calloc(elementCount, sizeof(guihckElementId));
+  if(!_guihckSnapshotReadElements(&reader, elements, elementCount, typeCount, version))
+    fprintf(stderr, "Snapshot: %s is truncated or corrupt\n", path);
+
+  /* Elements and their native data first, a failing deserialize removes what was created */
+  uint32_t created = 0;
+  for(i = 0; i < elementCount && !reader.failed; ++i)
+  {
+    if(i == 0)
+    {
+      ids[i] = ctx->rootElementId;
+      created = 1;
+      continue;
+    }
+
+    ids[i] = guihckElementNew(ctx, typeIds[elements[i].typeIndex], ids[elements[i].parentIndex]);
+    created = i + 1;
+    guihckElement* element = chckPoolGet(ctx->elements, ids[i]);
+    _guihckElementType* type = chckPoolGet(ctx->types->elementTypes, element->type);
+    if(elements[i].dataSize > 0 && type->functionMap.deserialize
+       && !type->functionMap.deserialize(ctx, ids[i], element->data, elements[i].data, elements[i].dataSize))
+    {
+      fprintf(stderr, "Snapshot: could not restore data of a '%s' element\n", type->name);
+      reader.failed = true;
+    }
+  }
+
+  if(reader.failed)
+  {
+    /* Children of the root take their subtrees with them */
+    for(i = 1; i < created; ++i)
+    {
+      if(elements[i].parentIndex == 0)
+        guihckElementRemove(ctx, ids[i]);
+    }
+  }
+
+  /* Plain values next, references need every element to exist */
+  for(i = 0; i < elementCount && !reader.failed; ++i)
+  {
+    reader.offset = elements[i].propertyOffset;
+    uint32_t propertyCount = _guihckSnapshotReadU32(&reader);
+    uint32_t p;
+    for(p = 0; p < propertyCount && !reader.failed; ++p)
+    {
+      char* name = _guihckSnapshotReadStringCopy(&reader);
+      uint8_t kind = _guihckSnapshotReadU8(&reader);
+      if(kind == GUIHCK_PROPERTY_VALUE)
+      {
+        SCM value = _guihckSnapshotReadValue(&reader, false);
+        if(!reader.failed)
+          guihckElementProperty(ctx, ids[i], name, value);
+      }
+      else
+      {
+        _guihckSnapshotSkipProperty(&reader, kind, elementCount, version);
+      }
+      free(name);
+    }
+  }
+
+  /* Last pass connects aliases and binds, everything they refer to was checked */
+  for(i = 0; i < elementCount && !reader.failed; ++i)
+  {
+    reader.offset = elements[i].propertyOffset;
+    uint32_t propertyCount = _guihckSnapshotReadU32(&reader);
+    uint32_t p;
+    for(p = 0; p < propertyCount && !reader.failed; ++p)
+    {
+      char* name = _guihckSnapshotReadStringCopy(&reader);
+      uint8_t kind = _guihckSnapshotReadU8(&reader);
+      if(kind == GUIHCK_PROPERTY_VALUE)
+      {
+        _guihckSnapshotReadValue(&reader, true);
+      }
+      else if(kind == GUIHCK_PROPERTY_ALIAS)
+      {
+        uint32_t targetIndex = _guihckSnapshotReadU32(&reader);
+        uint32_t length;
+        const char* targetProperty = _guihckSnapshotReadString(&reader, &length);
+        SCM alias = scm_list_3(scm_from_utf8_symbol("alias"), scm_from_uint64(ids[targetIndex]),
+                               scm_from_utf8_symboln(targetProperty, length));
+        guihckElementProperty(ctx, ids[i], name, alias);
+      }
+      else
+      {
+        uint32_t length;
+        const char* procedureName = _guihckSnapshotReadString(&reader, &length);
+        SCM variable = scm_module_variable(scm_current_module(), scm_from_utf8_symboln(procedureName, length));
+        uint32_t boundCount = _guihckSnapshotReadU32(&reader);
+        SCM bound = SCM_EOL;
+        uint32_t b;
+        for(b = 0; b < boundCount; ++b)
+        {
+          uint32_t boundIndex = _guihckSnapshotReadU32(&reader);
+          uint32_t boundLength;
+          const char* boundProperty = _guihckSnapshotReadString(&reader, &boundLength);
+          bound = scm_cons(scm_cons(scm_from_uint64(ids[boundIndex]), scm_from_utf8_symboln(boundProperty, boundLength)), bound);
+        }
+
+        SCM head = scm_from_utf8_symbol(kind == GUIHCK_PROPERTY_BIND ? "bind" : "lazy-bind");
+        SCM bind = scm_list_3(head, scm_reverse(bound), scm_variable_ref(variable));
+        guihckElementProperty(ctx, ids[i], name, bind);
+      }
+      free(name);
+    }
+  }
+
+  bool success = !reader.failed;
+  if(success && focusedIndex < elementCount)
+    guihckContextKeyboardFocus(ctx, ids[focusedIndex]);
+
+  free(elements);
+  free(ids);
+  free(typeIds);
+  _guihckMappedFileClose(&file);
+  return success;
+}
+
+/*
+ * Private
+ */
+
+chckIterPool* _guihckSnapshotCollectElements(guihckContext* ctx, chckHashTable* indices, chckHashTable* typeIndices, chckIterPool* types)
+{
+  /* Pre-order through an explicit stack, deep trees do not grow the C stack */
+  chckIterPool* order = chckIterPoolNew(64, 64, sizeof(guihckElementId));
+  chckIterPool* stack = chckIterPoolNew(32, 32, sizeof(guihckElementId));
+  chckIterPoolAdd(stack, &ctx->rootElementId, NULL);
+
+  size_t stackSize;
+  while((stackSize = chckIterPoolCount(stack)) > 0)
+  {
+    guihckElementId elementId = *(guihckElementId*) chckIterPoolGetLast(stack);
+    chckIterPoolRemove(stack, stackSize - 1);
+
+    guihckElement* element = chckPoolGet(ctx->elements, elementId);
+    uint32_t index = chckIterPoolCount(order);
+    chckHashTableSet(indices, elementId, &index, sizeof(uint32_t));
+    chckIterPoolAdd(order, &elementId, NULL);
+
+    if(!chckHashTableGet(typeIndices, element->type))
+    {
+      uint32_t typeIndex = chckIterPoolCount(types);
+      chckIterPoolAdd(types, &element->type, NULL);
+      chckHashTableSet(typeIndices, element->type, &typeIndex, sizeof(uint32_t));
+    }
+
+    /* Pushed last to first, the first child is written next */
+    size_t childCount = chckIterPoolCount(element->children);
+    while(childCount > 0)
+      chckIterPoolAdd(stack, chckIterPoolGet(element->children, --childCount), NULL);
+  }
+
+  chckIterPoolFree(stack);
+  return order;
+}
+
+bool _guihckSnapshotReadElements(_guihckSnapshotReader* reader, _guihckSnapshotElement* elements, uint32_t elementCount,
+                                 uint32_t typeCount, uint32_t version)
+{
+  uint32_t i;
+  for(i = 0; i < elementCount && !reader->failed; ++i)
+  {
+    _guihckSnapshotElement* element = &elements[i];
+    element->typeIndex = _guihckSnapshotReadU32(reader);
+    element->parentIndex = _guihckSnapshotReadU32(reader);
+    element->dataSize = _guihckSnapshotReadU32(reader);
+    element->data = _guihckSnapshotRead(reader, element->dataSize);
+    if(reader->failed || element->typeIndex >= typeCount || (i > 0 && element->parentIndex >= i))
+    {
+      reader->failed = true;
+      break;
+    }
+
+    element->propertyOffset = reader->offset;
+    uint32_t propertyCount = _guihckSnapshotReadU32(reader);
+    uint32_t p;
+    for(p = 0; p < propertyCount && !reader->failed; ++p)
+    {
+      _guihckSnapshotReadString(reader, NULL);
+      uint8_t kind = _guihckSnapshotReadU8(reader);
+      _guihckSnapshotSkipProperty(reader, kind, elementCount, version);
+    }
+  }
+
+  return !reader->failed;
+}
+
+void _guihckSnapshotSkipProperty(_guihckSnapshotReader* reader, uint8_t kind, uint32_t elementCount, uint32_t version)
+{
+  /* Checks what the property refers to on the way */
+  if(kind == GUIHCK_PROPERTY_VALUE)
+  {
+    _guihckSnapshotReadValue(reader, true);
+  }
+  else if(kind == GUIHCK_PROPERTY_ALIAS)
+  {
+    if(_guihckSnapshotReadU32(reader) >= elementCount)
+      reader->failed = true;
+    _guihckSnapshotReadString(reader, NULL);
+  }
+  else if(kind == GUIHCK_PROPERTY_BIND || (kind == _GUIHCK_SNAPSHOT_LAZY_BIND && version >= 2))
+  {
+    uint32_t length;
+    const char* procedureName = _guihckSnapshotReadString(reader, &length);
+    if(!reader->failed && scm_is_false(scm_module_variable(scm_current_module(), scm_from_utf8_symboln(procedureName, length))))
+    {
+      fprintf(stderr, "Snapshot: bind procedure '%.*s' is not defined\n", (int) length, procedureName);
+      reader->failed = true;
+    }
+
+    uint32_t boundCount = _guihckSnapshotReadU32(reader);
+    uint32_t b;
+    for(b = 0; b < boundCount && !reader->failed; ++b)
+    {
+      if(_guihckSnapshotReadU32(reader) >= elementCount)
+        reader->failed = true;
+      _guihckSnapshotReadString(reader, NULL);
+    }
+  }
+  else
+  {
+    reader->failed = true;
+  }
+}
+
+void _guihckSnapshotWriteElement(guihckContext* ctx, _guihckSnapshotWriter* writer, chckHashTable* indices, chckHashTable* typeIndices,
+                                 guihckElementId elementId, uint32_t parentIndex)
+{
+  guihckElement* element = chckPoolGet(ctx->elements, elementId);
+  _guihckElementType* type = chckPoolGet(ctx->types->elementTypes, element->type);
+
+  _guihckSnapshotWriteU32(writer, *(uint32_t*) chckHashTableGet(typeIndices, element->type));
+  _guihckSnapshotWriteU32(writer, parentIndex);
+
+  size_t dataSize = 0;
+  void* data = NULL;
+  if(type->functionMap.serialize)
+  {
+    dataSize = type->functionMap.serialize(ctx, elementId, element->data, NULL, 0);
+    data = dataSize > 0 ? malloc(dataSize) : NULL;
+    if(data && type->functionMap.serialize(ctx, elementId, element->data, data, dataSize) != dataSize)
+      writer->failed = true;
+  }
+  _guihckSnapshotWriteU32(writer, dataSize);
+  _guihckSnapshotWrite(writer, data, dataSize);
+  free(data);
+
+  /* Children are maintained by the element tree itself */
+  uint32_t propertyCount = 0;
+  _guihckProperty* property;
+  chckHashTableIterator pIter = {NULL, 0};
+  while((property = chckHashTableIter(element->properties, &pIter)))
+  {
+    if(strcmp(property->name, "children") != 0)
+      ++propertyCount;
+  }
+  _guihckSnapshotWriteU32(writer, propertyCount);
+
+  pIter.p = NULL;
+  pIter.i = 0;
+  while((property = chckHashTableIter(element->properties, &pIter)))
+  {
+    if(strcmp(property->name, "children") == 0)
+      continue;
+
+    _guihckSnapshotWriteString(writer, property->name, strlen(property->name));
+    bool lazy = property->type == GUIHCK_PROPERTY_BIND && property->bind.lazy;
+    _guihckSnapshotWriteU8(writer, lazy ? _GUIHCK_SNAPSHOT_LAZY_BIND : property->type);
+
+    if(property->type == GUIHCK_PROPERTY_VALUE)
+    {
+      _guihckSnapshotWriteValue(writer, property->value, property->name);
+    }
+    else if(property->type == GUIHCK_PROPERTY_ALIAS)
+    {
+      _guihckPropertyListener* listener = chckPoolGet(ctx->propertyListeners, property->alias.listenerId);
+      _guihckSnapshotWriteU32(writer, *(uint32_t*) chckHashTableGet(indices, listener->listenedId));
+      _guihckSnapshotWriteString(writer, listener->propertyName, strlen(listener->propertyName));
+    }
+    else if(property->type == GUIHCK_PROPERTY_BIND)
+    {
+      SCM name = _guihckSnapshotProcedureName(property->bind.function);
+      if(scm_is_false(name))
+      {
+        fprintf(stderr, "Snapshot: property '%s' is bound through an unnamed procedure\n", property->name);
+        writer->failed = true;
+        return;
+      }
+
+      size_t length;
+      char* nameStr = scm_to_utf8_stringn(scm_symbol_to_string(name), &length);
+      _guihckSnapshotWriteString(writer, nameStr, length);
+      free(nameStr);
+
+      /* Bound properties are written in parameter order */
+      size_t boundCount = chckIterPoolCount(property->bind.bound);
+      _guihckSnapshotWriteU32(writer, boundCount);
+      size_t b;
+      for(b = 0; b < boundCount; ++b)
+      {
+        chckPoolIndex bIter = 0;
+        _guihckBoundProperty* bound;
+        while((bound = chckIterPoolIter(property->bind.bound, &bIter)) && bound->index != b);
+        _guihckPropertyListener* listener = bound ? chckPoolGet(ctx->propertyListeners, bound->listenerId) : NULL;
+        if(!listener)
+        {
+          writer->failed = true;
+          return;
+        }
+        _guihckSnapshotWriteU32(writer, *(uint32_t*) chckHashTableGet(indices, listener->listenedId));
+        _guihckSnapshotWriteString(writer, listener->propertyName, strlen(listener->propertyName));
+      }
+    }
+  }
+}
+
+void _guihckSnapshotWriteValue(_guihckSnapshotWriter* writer, SCM value, const char* propertyName)
+{
+  if(writer->failed)
+    return;
+
+  if(scm_is_eq(value, SCM_UNDEFINED))
+  {
+    _guihckSnapshotWriteU8(writer, _GUIHCK_SNAPSHOT_UNDEFINED);
+  }
+  else if(scm_is_bool(value))
+  {
+    _guihckSnapshotWriteU8(writer, scm_is_true(value) ? _GUIHCK_SNAPSHOT_TRUE : _GUIHCK_SNAPSHOT_FALSE);
+  }
+  else if(scm_is_null(value))
+  {
+    _guihckSnapshotWriteU8(writer, _GUIHCK_SNAPSHOT_NULL);
+  }
+  else if(scm_is_exact_integer(value) && scm_is_signed_integer(value, INT64_MIN, INT64_MAX))
+  {
+    int64_t integer = scm_to_int64(value);
+    _guihckSnapshotWriteU8(writer, _GUIHCK_SNAPSHOT_INTEGER);
+    _guihckSnapshotWrite(writer, &integer, sizeof(integer));
+  }
+  else if(scm_is_real(value) && !scm_is_exact(value))
+  {
+    double real = scm_to_double(value);
+    _guihckSnapshotWriteU8(writer, _GUIHCK_SNAPSHOT_REAL);
+    _guihckSnapshotWrite(writer, &real, sizeof(real));
+  }
+  else if(scm_is_string(value) || scm_is_symbol(value))
+  {
+    size_t length;
+    char* str = scm_to_utf8_stringn(scm_is_symbol(value) ? scm_symbol_to_string(value) : value, &length);
+    _guihckSnapshotWriteU8(writer, scm_is_symbol(value) ? _GUIHCK_SNAPSHOT_SYMBOL : _GUIHCK_SNAPSHOT_STRING);
+    _guihckSnapshotWriteString(writer, str, length);
+    free(str);
+  }
+  else if(SCM_CHARP(value))
+  {
+    _guihckSnapshotWriteU8(writer, _GUIHCK_SNAPSHOT_CHAR);
+    _guihckSnapshotWriteU32(writer, scm_to_uint32(scm_char_to_integer(value)));
+  }
+  else if((scm_is_pair(value) || scm_is_vector(value)) && writer->depth >= _GUIHCK_SNAPSHOT_MAX_DEPTH)
+  {
+    fprintf(stderr, "Snapshot: value of property '%s' is nested too deep\n", propertyName);
+    writer->failed = true;
+  }
+  else if(scm_is_pair(value))
+  {
+    /* Tails are written in a loop, only nested values recurse */
+    writer->depth += 1;
+    while(scm_is_pair(value) && !writer->failed)
+    {
+      _guihckSnapshotWriteU8(writer, _GUIHCK_SNAPSHOT_PAIR);
+      _guihckSnapshotWriteValue(writer, SCM_CAR(value), propertyName);
+      value = SCM_CDR(value);
+    }
+    _guihckSnapshotWriteValue(writer, value, propertyName);
+    writer->depth -= 1;
+  }
+  else if(scm_is_vector(value))
+  {
+    size_t n = scm_c_vector_length(value);
+    _guihckSnapshotWriteU8(writer, _GUIHCK_SNAPSHOT_VECTOR);
+    _guihckSnapshotWriteU32(writer, n);
+    writer->depth += 1;
+    size_t i;
+    for(i = 0; i < n; ++i)
+      _guihckSnapshotWriteValue(writer, scm_c_vector_ref(value, i), propertyName);
+    writer->depth -= 1;
+  }
+  else if(scm_is_true(scm_procedure_p(value)) && scm_is_true(_guihckSnapshotProcedureName(value)))
+  {
+    size_t length;
+    char* name = scm_to_utf8_stringn(scm_symbol_to_string(_guihckSnapshotProcedureName(value)), &length);
+    _guihckSnapshotWriteU8(writer, _GUIHCK_SNAPSHOT_PROCEDURE);
+    _guihckSnapshotWriteString(writer, name, length);
+    free(name);
+  }
+  else
+  {
+    fprintf(stderr, "Snapshot: value of property '%s' can not be stored\n", propertyName);
+    writer->failed = true;
+  }
+}
+
+SCM _guihckSnapshotProcedureName(SCM procedure)
+{
+  /* Only procedures reachable through their own top-level name can be restored */
+  SCM name = scm_procedure_name(procedure);
+  if(!scm_is_symbol(name))
+    return SCM_BOOL_F;
+
+  SCM variable = scm_module_variable(scm_current_module(), name);
+  return scm_is_true(variable) && scm_is_eq(scm_variable_ref(variable), procedure) ? name : SCM_BOOL_F;
+}
+
+void _guihckSnapshotWrite(_guihckSnapshotWriter* writer, const void* data, size_t size)
+{
+  if(writer->failed || size == 0)
+    return;
+
+  if(writer->size + size > writer->capacity)
+  {
+    size_t capacity = writer->capacity ? writer->capacity : 4096;
+    while(capacity < writer->size + size)
+      capacity *= 2;
+
+    char* grown = realloc(writer->data, capacity);
+    if(!grown)
+    {
+      writer->failed = true;
+      return;
+    }
+    writer->data = grown;
+    writer->capacity = capacity;
+  }
+
+  memcpy(writer->data + writer->size, data, size);
+  writer->size += size;
+}
+
+void _guihckSnapshotWriteU8(_guihckSnapshotWriter* writer, uint8_t value)
+{
+  _guihckSnapshotWrite(writer, &value, sizeof(value));
+}
+
+void _guihckSnapshotWriteU32(_guihckSnapshotWriter* writer, uint32_t value)
+{
+  _guihckSnapshotWrite(writer, &value, sizeof(value));
+}
+
+void _guihckSnapshotWriteString(_guihckSnapshotWriter* writer, const char* str, size_t length)
+{
+  _guihckSnapshotWriteU32(writer, length);
+  _guihckSnapshotWrite(writer, str, length);
+}
+
+const void* _guihckSnapshotRead(_guihckSnapshotReader* reader, size_t size)
+{
+  if(reader->failed || size > reader->size - reader->offset)
+  {
+    reader->failed = true;
+    return NULL;
+  }
+
+  const void* data = reader->data + reader->offset;
+  reader->offset += size;
+  return data;
+}
+
+uint8_t _guihckSnapshotReadU8(_guihckSnapshotReader* reader)
+{
+  const uint8_t* value = _guihckSnapshotRead(reader, sizeof(uint8_t));
+  return value ? *value : 0;
+}
+
+uint32_t _guihckSnapshotReadU32(_guihckSnapshotReader* reader)
+{
+  /* Data is not necessarily aligned */
+  uint32_t value = 0;
+  const void* data = _guihckSnapshotRead(reader, sizeof(uint32_t));
+  if(data)
+    memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+const char* _guihckSnapshotReadString(_guihckSnapshotReader* reader, uint32_t* length)
+{
+  uint32_t n = _guihckSnapshotReadU32(reader);
+  const char* str = _guihckSnapshotRead(reader, n);
+  if(length)
+    *length = str ? n : 0;
+  return str ? str : "";
+}
+
+char* _guihckSnapshotReadStringCopy(_guihckSnapshotReader* reader)
+{
+  uint32_t length;
+  const char* str = _guihckSnapshotReadString(reader, &length);
+  if(reader->failed)
+    return NULL;
+
+  char* copy = malloc(length + 1);
+  memcpy(copy, str, length);
+  copy[length] = '\0';
+  return copy;
+}
+
+SCM _guihckSnapshotReadValue(_guihckSnapshotReader* reader, bool skip)
+{
+  uint8_t tag = _guihckSnapshotReadU8(reader);
+  if(reader->failed)
+    return SCM_UNDEFINED;
+
+  if((tag == _GUIHCK_SNAPSHOT_PAIR || tag == _GUIHCK_SNAPSHOT_VECTOR) && reader->depth >= _GUIHCK_SNAPSHOT_MAX_DEPTH)
+  {
+    reader->failed = true;
+    return SCM_UNDEFINED;
+  }
+
+  switch(tag)
+  {
+    case _GUIHCK_SNAPSHOT_UNDEFINED:
+      return SCM_UNDEFINED;
+    case _GUIHCK_SNAPSHOT_FALSE:
+      return SCM_BOOL_F;
+    case _GUIHCK_SNAPSHOT_TRUE:
+      return SCM_BOOL_T;
+    case _GUIHCK_SNAPSHOT_NULL:
+      return SCM_EOL;
+    case _GUIHCK_SNAPSHOT_INTEGER:
+    {
+      int64_t integer;
+      const void* data = _guihckSnapshotRead(reader, sizeof(integer));
+      if(!data || skip)
+        return SCM_UNDEFINED;
+      memcpy(&integer, data, sizeof(integer));
+      return scm_from_int64(integer);
+    }
+    case _GUIHCK_SNAPSHOT_REAL:
+    {
+      double real;
+      const void* data = _guihckSnapshotRead(reader, sizeof(real));
+      if(!data || skip)
+        return SCM_UNDEFINED;
+      memcpy(&real, data, sizeof(real));
+      return scm_from_double(real);
+    }
+    case _GUIHCK_SNAPSHOT_STRING:
+    case _GUIHCK_SNAPSHOT_SYMBOL:
+    {
+      uint32_t length;
+      const char* str = _guihckSnapshotReadString(reader, &length);
+      if(reader->failed || skip)
+        return SCM_UNDEFINED;
+      return tag == _GUIHCK_SNAPSHOT_SYMBOL ? scm_from_utf8_symboln(str, length) : scm_from_utf8_stringn(str, length);
+    }
+    case _GUIHCK_SNAPSHOT_CHAR:
+    {
+      uint32_t codepoint = _guihckSnapshotReadU32(reader);
+      if(reader->failed || skip)
+        return SCM_UNDEFINED;
+      return scm_integer_to_char(scm_from_uint32(codepoint));
+    }
+    case _GUIHCK_SNAPSHOT_PAIR:
+    {
+      /* Read along the tail like it was written, only nested values recurse */
+      SCM items = SCM_EOL;
+      SCM tail = SCM_EOL;
+      bool more = true;
+      reader->depth += 1;
+      while(more && !reader->failed)
+      {
+        SCM car = _guihckSnapshotReadValue(reader, skip);
+        if(!skip)
+          items = scm_cons(car, items);
+
+        more = reader->offset < reader->size && (uint8_t) reader->data[reader->offset] == _GUIHCK_SNAPSHOT_PAIR;
+        if(more)
+          reader->offset += 1;
+        else
+          tail = _guihckSnapshotReadValue(reader, skip);
+      }
+      reader->depth -= 1;
+
+      if(reader->failed || skip)
+        return SCM_UNDEFINED;
+      return scm_reverse_x(items, tail);
+    }
+    case _GUIHCK_SNAPSHOT_VECTOR:
+    {
+      uint32_t n = _guihckSnapshotReadU32(reader);
+      if(reader->failed || n > reader->size - reader->offset)
+      {
+        reader->failed = true;
+        return SCM_UNDEFINED;
+      }
+
+      SCM vector = skip ? SCM_UNDEFINED : scm_c_make_vector(n, SCM_UNDEFINED);
+      reader->depth += 1;
+      uint32_t i;
+      for(i = 0; i < n && !reader->failed; ++i)
+      {
+        SCM item = _guihckSnapshotReadValue(reader, skip);
+        if(!skip)
+          scm_c_vector_set_x(vector, i, item);
+      }
+      reader->depth -= 1;
+      return vector;
+    }
+    case _GUIHCK_SNAPSHOT_PROCEDURE:
+    {
+      uint32_t length;
+      const char* name = _guihckSnapshotReadString(reader, &length);
+      if(reader->failed)
+        return SCM_UNDEFINED;
+
+      /* Looked up even when skipping, so a missing procedure fails the check before loading */
+      SCM variable = scm_module_variable(scm_current_module(), scm_from_utf8_symboln(name, length));
+      if(scm_is_false(variable))
+      {
+        fprintf(stderr, "Snapshot: procedure '%.*s' is not defined\n", (int) length, name);
+        reader->failed = true;
+        return SCM_UNDEFINED;
+      }
+      return skip ? SCM_UNDEFINED : scm_variable_ref(variable);
+    }
+    default:
+      reader->failed = true;
+      return SCM_UNDEFINED;
+  }
+}
@@ -4,7 +4,7 @@
 void guihckStackPushNewElement(guihckContext* ctx, const char* typeName)
 {
   guihckElementId* parentId = chckIterPoolGetLast(ctx->stack);
-  guihckElementTypeId* typeId = chckHashTableStrGet(ctx->elementTypesByName, typeName);
+  guihckElementTypeId* typeId = chckHashTableStrGet(ctx->types->elementTypesByName, typeName);
   assert(typeId && "Element type not found");
 
   guihckElementId id = guihckElementNew(ctx, *typeId, *parentId);
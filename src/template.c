@@ -0,0 +1,389 @@
+#include "internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* A template is the element tree recorded by make-template, flattened in
+ * pre-order. Instantiating creates every element and id first, then sets
+ * the properties and runs init children first, like create-element does. */
+
+typedef enum _guihckTemplatePropertyKind
+{
+  _GUIHCK_TEMPLATE_VALUE,
+  _GUIHCK_TEMPLATE_ALIAS,
+  _GUIHCK_TEMPLATE_BIND,
+  _GUIHCK_TEMPLATE_LAZY_BIND,
+  _GUIHCK_TEMPLATE_METHOD
+} _guihckTemplatePropertyKind;
+
+typedef struct _guihckTemplateProperty
+{
+  char* name;
+  _guihckTemplatePropertyKind kind;
+  SCM value; /* value, bind callback or method procedure */
+  SCM target; /* alias element, bind references or bind thunk */
+  SCM aliased;
+} _guihckTemplateProperty;
+
+typedef struct _guihckTemplateNode
+{
+  guihckElementTypeId type;
+  size_t parent;
+  size_t end; /* one past the last node of the subtree */
+  SCM id;
+  chckIterPool* properties;
+} _guihckTemplateNode;
+
+typedef struct _guihckTemplate
+{
+  chckIterPool* nodes;
+  SCM description; /* keeps the recorded values alive */
+  bool protected; /* false when the Scheme object owning the template holds the description */
+  guihckTypeRegistry* types; /* node types are ids in this registry */
+} _guihckTemplate;
+
+typedef struct _guihckTemplateSymbols
+{
+  SCM elementTemplate;
+  SCM id;
+  SCM prop;
+  SCM alias;
+  SCM bind;
+  SCM lazyBind;
+  SCM method;
+  SCM this;
+  SCM parent;
+} _guihckTemplateSymbols;
+
+static bool _guihckTemplateTypesMatch(guihckContext* ctx, _guihckTemplate* tmpl);
+static void _guihckTemplateGetSymbols(_guihckTemplateSymbols* symbols);
+static bool _guihckTemplateAddNode(guihckContext* ctx, _guihckTemplate* tmpl, const _guihckTemplateSymbols* symbols,
+                                   SCM description, size_t parent);
+static bool _guihckTemplateParseProperty(const _guihckTemplateSymbols* symbols, SCM arg, _guihckTemplateProperty* property);
+static void _guihckTemplateApplyProperty(guihckContext* ctx, const _guihckTemplateSymbols* symbols, guihckElementId elementId,
+                                         const _guihckTemplateProperty* property);
+static guihckElementId _guihckTemplateResolve(guihckContext* ctx, const _guihckTemplateSymbols* symbols, guihckElementId elementId, SCM reference);
+static void _guihckTemplateConfigure(guihckContext* ctx, _guihckTemplate* tmpl, const _guihckTemplateSymbols* symbols,
+                                     const guihckElementId* ids, size_t index, SCM overrides);
+
+guihckTemplate* guihckTemplateNew(guihckContext* ctx, SCM description)
+{
+  return _guihckTemplateNew(ctx, description, true);
+}
+
+guihckTemplate* _guihckTemplateNew(guihckContext* ctx, SCM description, bool protect)
+{
+  _guihckTemplateSymbols symbols;
+  _guihckTemplateGetSymbols(&symbols);
+
+  guihckTemplate* tmpl = calloc(1, sizeof(guihckTemplate));
+  tmpl->nodes = chckIterPoolNew(16, 16, sizeof(_guihckTemplateNode));
+  tmpl->description = description;
+  tmpl->protected = protect;
+  tmpl->types = guihckTypeRegistryRef(ctx->types);
+  if(protect)
+    scm_gc_protect_object(tmpl->description);
+
+  if(!_guihckTemplateAddNode(ctx, tmpl, &symbols, description, GUIHCK_NO_PARENT))
+  {
+    guihckTemplateFree(tmpl);
+    return NULL;
+  }
+
+  return tmpl;
+}
+
+void guihckTemplateFree(guihckTemplate* tmpl)
+{
+  chckPoolIndex iter = 0;
+  _guihckTemplateNode* node;
+  while((node = chckIterPoolIter(tmpl->nodes, &iter)))
+  {
+    chckPoolIndex pIter = 0;
+    _guihckTemplateProperty* property;
+    while((property = chckIterPoolIter(node->properties, &pIter)))
+    {
+      free(property->name);
+    }
+    chckIterPoolFree(node->properties);
+  }
+
+  chckIterPoolFree(tmpl->nodes);
+  guihckTypeRegistryFree(tmpl->types);
+  if(tmpl->protected)
+    scm_gc_unprotect_object(tmpl->description);
+  free(tmpl);
+}
+
+guihckElementId guihckTemplateInstantiate(guihckContext* ctx, guihckTemplate* tmpl, guihckElementId parentId, SCM overrides)
+{
+  if(tmpl->types != ctx->types && !_guihckTemplateTypesMatch(ctx, tmpl))
+  {
+    fprintf(stderr, "instantiate-template!: template was made for other element types\n");
+    return GUIHCK_NO_PARENT;
+  }
+
+  _guihckTemplateSymbols symbols;
+  _guihckTemplateGetSymbols(&symbols);
+
+  size_t count = chckIterPoolCount(tmpl->nodes);
+  guihckElementId* ids = calloc(count, sizeof(guihckElementId));
+
+  /* Every element and id exists before any reference is resolved */
+  size_t i;
+  for(i = 0; i < count; ++i)
+  {
+    _guihckTemplateNode* node = chckIterPoolGet(tmpl->nodes, i);
+    ids[i] = guihckElementNew(ctx, node->type, i == 0 ? parentId : ids[node->parent]);
+    if(!scm_is_eq(node->id, SCM_UNDEFINED))
+      guihckElementProperty(ctx, ids[i], "id", node->id);
+  }
+
+  SCM override;
+  for(override = overrides; scm_is_pair(override); override = SCM_CDR(override))
+  {
+    SCM arg = SCM_CAR(override);
+    if(scm_is_pair(arg) && scm_is_eq(SCM_CAR(arg), symbols.id) && scm_is_pair(SCM_CDR(arg)))
+      guihckElementProperty(ctx, ids[0], "id", SCM_CADR(arg));
+  }
+
+  _guihckTemplateConfigure(ctx, tmpl, &symbols, ids, 0, overrides);
+
+  guihckElementId rootId = ids[0];
+  free(ids);
+  return rootId;
+}
+
+bool _guihckTemplateTypesMatch(guihckContext* ctx, _guihckTemplate* tmpl)
+{
+  /* Copies of the registry keep the ids, another registry may have them all the same */
+  chckPoolIndex iter = 0;
+  _guihckTemplateNode* node;
+  while((node = chckIterPoolIter(tmpl->nodes, &iter)))
+  {
+    _guihckElementType* type = chckPoolGet(tmpl->types->elementTypes, node->type);
+    guihckElementTypeId* typeId = chckHashTableStrGet(ctx->types->elementTypesByName, type->name);
+    if(!typeId || *typeId != node->type)
+      return false;
+  }
+  return true;
+}
+
+void _guihckTemplateGetSymbols(_guihckTemplateSymbols* symbols)
+{
+  symbols->elementTemplate = scm_from_utf8_symbol("element-template");
+  symbols->id = scm_from_utf8_symbol("id");
+  symbols->prop = scm_from_utf8_symbol("prop");
+  symbols->alias = scm_from_utf8_symbol("alias");
+  symbols->bind = scm_from_utf8_symbol("bind");
+  symbols->lazyBind = scm_from_utf8_symbol("lazy-bind");
+  symbols->method = scm_from_utf8_symbol("method");
+  symbols->this = scm_from_utf8_symbol("this");
+  symbols->parent = scm_from_utf8_symbol("parent");
+}
+
+bool _guihckTemplateAddNode(guihckContext* ctx, _guihckTemplate* tmpl, const _guihckTemplateSymbols* symbols,
+                            SCM description, size_t parent)
+{
+  /* (element-template type args) */
+  if(scm_ilength(description) != 3 || !scm_is_eq(SCM_CAR(description), symbols->elementTemplate)
+     || !scm_is_symbol(SCM_CADR(description)))
+  {
+    fprintf(stderr, "make-template: expected an element, not a constructed one\n");
+    return false;
+  }
+
+  char* typeName = scm_to_utf8_string(scm_symbol_to_string(SCM_CADR(description)));
+  guihckElementTypeId* typeId = chckHashTableStrGet(ctx->types->elementTypesByName, typeName);
+  if(!typeId)
+  {
+    fprintf(stderr, "make-template: element type '%s' is not registered\n", typeName);
+    free(typeName);
+    return false;
+  }
+  free(typeName);
+
+  _guihckTemplateNode node;
+  node.type = *typeId;
+  node.parent = parent;
+  node.end = 0;
+  node.id = SCM_UNDEFINED;
+  node.properties = chckIterPoolNew(8, 8, sizeof(_guihckTemplateProperty));
+
+  chckPoolIndex index;
+  chckIterPoolAdd(tmpl->nodes, &node, &index);
+
+  SCM args;
+  for(args = SCM_CADDR(description); scm_is_pair(args); args = SCM_CDR(args))
+  {
+    SCM arg = SCM_CAR(args);
+    if(scm_is_pair(arg) && scm_is_eq(SCM_CAR(arg), symbols->elementTemplate))
+    {
+      if(!_guihckTemplateAddNode(ctx, tmpl, symbols, arg, index))
+        return false;
+    }
+    else if(scm_is_pair(arg) && scm_is_eq(SCM_CAR(arg), symbols->id) && scm_is_pair(SCM_CDR(arg)))
+    {
+      _guihckTemplateNode* current = chckIterPoolGet(tmpl->nodes, index);
+      current->id = SCM_CADR(arg);
+    }
+    else
+    {
+      _guihckTemplateProperty property;
+      if(!_guihckTemplateParseProperty(symbols, arg, &property))
+      {
+        fprintf(stderr, "make-template: unsupported element argument\n");
+        return false;
+      }
+
+      _guihckTemplateNode* current = chckIterPoolGet(tmpl->nodes, index);
+      chckIterPoolAdd(current->properties, &property, NULL);
+    }
+  }
+
+  /* The pool may have moved while adding children */
+  _guihckTemplateNode* current = chckIterPoolGet(tmpl->nodes, index);
+  current->end = chckIterPoolCount(tmpl->nodes);
+  return true;
+}
+
+bool _guihckTemplateParseProperty(const _guihckTemplateSymbols* symbols, SCM arg, _guihckTemplateProperty* property)
+{
+  /* (prop key value) */
+  if(scm_ilength(arg) != 3 || !scm_is_eq(SCM_CAR(arg), symbols->prop) || !scm_is_symbol(SCM_CADR(arg)))
+    return false;
+
+  SCM value = SCM_CADDR(arg);
+  property->kind = _GUIHCK_TEMPLATE_VALUE;
+  property->value = value;
+  property->target = SCM_UNDEFINED;
+  property->aliased = SCM_UNDEFINED;
+
+  if(scm_is_pair(value) && scm_is_symbol(SCM_CAR(value)))
+  {
+    long length = scm_ilength(value);
+    SCM head = SCM_CAR(value);
+    if(scm_is_eq(head, symbols->alias) && length == 3)
+    {
+      property->kind = _GUIHCK_TEMPLATE_ALIAS;
+      property->target = SCM_CADR(value);
+      property->aliased = SCM_CADDR(value);
+    }
+    else if((scm_is_eq(head, symbols->bind) || scm_is_eq(head, symbols->lazyBind)) && (length == 3 || length == 4))
+    {
+      /* bound records its references, plain (bind thunk callback) has to run the thunk */
+      property->kind = scm_is_eq(head, symbols->bind) ? _GUIHCK_TEMPLATE_BIND : _GUIHCK_TEMPLATE_LAZY_BIND;
+      property->target = length == 4 ? scm_list_ref(value, scm_from_int(3)) : SCM_CADR(value);
+      property->value = SCM_CADDR(value);
+    }
+    else if(scm_is_eq(head, symbols->method) && length == 2)
+    {
+      property->kind = _GUIHCK_TEMPLATE_METHOD;
+      property->value = SCM_CADR(value);
+    }
+  }
+
+  property->name = scm_to_utf8_string(scm_symbol_to_string(SCM_CADR(arg)));
+  return true;
+}
+
+void _guihckTemplateApplyProperty(guihckContext* ctx, const _guihckTemplateSymbols* symbols, guihckElementId elementId,
+                                  const _guihckTemplateProperty* property)
+{
+  SCM value = property->value;
+  if(property->kind == _GUIHCK_TEMPLATE_ALIAS)
+  {
+    guihckElementId targetId = _guihckTemplateResolve(ctx, symbols, elementId, property->target);
+    value = scm_list_3(symbols->alias, scm_from_uint64(targetId), property->aliased);
+  }
+  else if(property->kind == _GUIHCK_TEMPLATE_BIND || property->kind == _GUIHCK_TEMPLATE_LAZY_BIND)
+  {
+    SCM bound = SCM_EOL;
+    if(scm_is_true(scm_procedure_p(property->target)))
+    {
+      guihckStackPushElement(ctx, elementId);
+      bound = guihckContextExecuteExpression(ctx, scm_list_1(property->target));
+      guihckStackPopElement(ctx);
+    }
+    else
+    {
+      /* (element property element property ...) as given to bound */
+      SCM reference;
+      for(reference = property->target; scm_is_pair(reference) && scm_is_pair(SCM_CDR(reference)); reference = SCM_CDDR(reference))
+      {
+        guihckElementId boundId = _guihckTemplateResolve(ctx, symbols, elementId, SCM_CAR(reference));
+        bound = scm_cons(scm_cons(scm_from_uint64(boundId), SCM_CADR(reference)), bound);
+      }
+      bound = scm_reverse(bound);
+    }
+    value = scm_list_3(property->kind == _GUIHCK_TEMPLATE_BIND ? symbols->bind : symbols->lazyBind, bound, property->value);
+  }
+  else if(property->kind == _GUIHCK_TEMPLATE_METHOD)
+  {
+    SCM wrap = scm_variable_ref(scm_c_lookup("wrap-method-to-context"));
+    value = guihckContextExecuteExpression(ctx, scm_list_3(wrap, property->value, scm_from_uint64(elementId)));
+  }
+
+  guihckElementProperty(ctx, elementId, property->name, value);
+}
+
+guihckElementId _guihckTemplateResolve(guihckContext* ctx, const _guihckTemplateSymbols* symbols, guihckElementId elementId, SCM reference)
+{
+  if(scm_is_integer(reference))
+    return scm_to_uint64(reference);
+  if(scm_is_eq(reference, symbols->this))
+    return elementId;
+  if(scm_is_eq(reference, symbols->parent))
+    return guihckElementGetParent(ctx, elementId);
+
+  /* Same search as find-element from the element being configured */
+  char* id = scm_to_utf8_string(scm_symbol_to_string(reference));
+  guihckStackPushElement(ctx, elementId);
+  guihckStackPushElementById(ctx, id);
+  guihckElementId resolvedId = guihckStackGetElement(ctx);
+  guihckStackPopElement(ctx);
+  guihckStackPopElement(ctx);
+  free(id);
+  return resolvedId;
+}
+
+void _guihckTemplateConfigure(guihckContext* ctx, _guihckTemplate* tmpl, const _guihckTemplateSymbols* symbols,
+                              const guihckElementId* ids, size_t index, SCM overrides)
+{
+  _guihckTemplateNode* node = chckIterPoolGet(tmpl->nodes, index);
+  size_t end = node->end;
+
+  size_t child;
+  for(child = index + 1; child < end; child = ((_guihckTemplateNode*) chckIterPoolGet(tmpl->nodes, child))->end)
+  {
+    _guihckTemplateConfigure(ctx, tmpl, symbols, ids, child, SCM_EOL);
+  }
+
+  chckPoolIndex iter = 0;
+  _guihckTemplateProperty* property;
+  while((property = chckIterPoolIter(node->properties, &iter)))
+  {
+    _guihckTemplateApplyProperty(ctx, symbols, ids[index], property);
+  }
+
+  /* Overrides come last so they win over the recorded defaults, as with composite */
+  SCM override;
+  for(override = overrides; scm_is_pair(override); override = SCM_CDR(override))
+  {
+    _guihckTemplateProperty property;
+    if(_guihckTemplateParseProperty(symbols, SCM_CAR(override), &property))
+    {
+      _guihckTemplateApplyProperty(ctx, symbols, ids[index], &property);
+      free(property.name);
+    }
+  }
+
+  SCM init = guihckElementGetProperty(ctx, ids[index], "init");
+  if(scm_is_true(scm_procedure_p(init)))
+  {
+    guihckStackPushElement(ctx, ids[index]);
+    guihckContextExecuteExpression(ctx, scm_list_1(init));
+    guihckStackPopElement(ctx);
+  }
+}
@@ -0,0 +1,165 @@
+#include "guihckKeys.h"
+#include "guihckKeyHash.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Generates guihckKeysTable.h from GUIHCK_DEFAULT_KEY_BINDINGS */
+
+#define MAX_DISPLACEMENT 1000000
+
+typedef struct _bucket
+{
+  unsigned int index;
+  unsigned int count;
+  size_t keys[_GUIHCK_KEY_HASH_SLOTS];
+} _bucket;
+
+static int compareBuckets(const void* a, const void* b);
+static void writeString(FILE* out, const char* str);
+
+int main(int argc, char** argv)
+{
+  if(argc != 2)
+  {
+    fprintf(stderr, "Usage: %s <output header>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  size_t n;
+  const guihckDefaultKeyBinding* bindings = guihckGetDefaultKeyBindings(&n);
+
+  static _bucket buckets[_GUIHCK_KEY_HASH_BUCKETS];
+  static uint32_t displacements[_GUIHCK_KEY_HASH_BUCKETS];
+  static const guihckDefaultKeyBinding* slots[_GUIHCK_KEY_HASH_SLOTS];
+  static const char* names[GUIHCK_KEY_LAST + 1];
+
+  unsigned int i;
+  for(i = 0; i < _GUIHCK_KEY_HASH_BUCKETS; ++i)
+    buckets[i].index = i;
+
+  size_t j;
+  for(j = 0; j < n; ++j)
+  {
+    const guihckDefaultKeyBinding* b = &bindings[j];
+    if(b->code < 0 || b->code > GUIHCK_KEY_LAST)
+    {
+      fprintf(stderr, "Key code %d of '%s' is out of range\n", b->code, b->name);
+      return EXIT_FAILURE;
+    }
+
+    /* The first name of a code wins, like with guihckContextAddKeyBinding */
+    if(!names[b->code])
+      names[b->code] = b->name;
+
+    size_t k;
+    for(k = 0; k < j && strcmp(bindings[k].name, b->name) != 0; ++k);
+    if(k < j)
+      continue;
+
+    _bucket* bucket = &buckets[_guihckKeyHashGetBucket(b->name)];
+    bucket->keys[bucket->count++] = j;
+  }
+
+  /* Place the largest buckets first while the table is still sparse */
+  qsort(buckets, _GUIHCK_KEY_HASH_BUCKETS, sizeof(_bucket), compareBuckets);
+
+  for(i = 0; i < _GUIHCK_KEY_HASH_BUCKETS && buckets[i].count > 0; ++i)
+  {
+    _bucket* bucket = &buckets[i];
+    uint32_t displacement;
+    for(displacement = 1; displacement < MAX_DISPLACEMENT; ++displacement)
+    {
+      unsigned int taken[_GUIHCK_KEY_HASH_SLOTS];
+      unsigned int k;
+      for(k = 0; k < bucket->count; ++k)
+      {
+        unsigned int slot = _guihckKeyHashGetSlot(bindings[bucket->keys[k]].name, displacement);
+        unsigned int l;
+        for(l = 0; l < k && taken[l] != slot; ++l);
+        if(slots[slot] || l < k)
+          break;
+        taken[k] = slot;
+      }
+
+      if(k == bucket->count)
+      {
+        for(k = 0; k < bucket->count; ++k)
+          slots[taken[k]] = &bindings[bucket->keys[k]];
+        displacements[bucket->index] = displacement;
+        break;
+      }
+    }
+
+    if(displacement == MAX_DISPLACEMENT)
+    {
+      fprintf(stderr, "Could not place hash bucket %u, increase _GUIHCK_KEY_HASH_SLOTS\n", bucket->index);
+      return EXIT_FAILURE;
+    }
+  }
+
+  FILE* out = fopen(argv[1], "w");
+  if(!out)
+  {
+    perror(argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  fprintf(out, "/* Generated from GUIHCK_DEFAULT_KEY_BINDINGS by guihck-keytable, do not edit */\n");
+  fprintf(out, "#ifndef GUIHCKKEYSTABLE_H\n#define GUIHCKKEYSTABLE_H\n\n");
+  fprintf(out, "#include \"guihckKeyHash.h\"\n\n");
+
+  fprintf(out, "static const uint32_t _guihckKeyHashDisplacements[_GUIHCK_KEY_HASH_BUCKETS] = {");
+  for(i = 0; i < _GUIHCK_KEY_HASH_BUCKETS; ++i)
+    fprintf(out, "%s%s%u", i ? "," : "", i % 16 ? " " : "\n  ", displacements[i]);
+  fprintf(out, "\n};\n\n");
+
+  /* Empty slots hold an empty name so lookups can compare unconditionally */
+  fprintf(out, "static const _guihckKeyHashSlot _guihckKeyHashSlots[_GUIHCK_KEY_HASH_SLOTS] = {\n");
+  for(i = 0; i < _GUIHCK_KEY_HASH_SLOTS; ++i)
+  {
+    fprintf(out, "  {");
+    writeString(out, slots[i] ? slots[i]->name : "");
+    fprintf(out, ", %d},\n", slots[i] ? slots[i]->code : GUIHCK_KEY_UNKNOWN);
+  }
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "static const char* const _guihckKeyNames[GUIHCK_KEY_LAST + 1] = {\n");
+  for(i = 0; i <= GUIHCK_KEY_LAST; ++i)
+  {
+    fprintf(out, "  ");
+    if(names[i])
+      writeString(out, names[i]);
+    else
+      fprintf(out, "NULL");
+    fprintf(out, ",\n");
+  }
+  fprintf(out, "};\n\n#endif\n");
+
+  if(fclose(out) != 0)
+  {
+    perror(argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+int compareBuckets(const void* a, const void* b)
+{
+  const _bucket* ba = a;
+  const _bucket* bb = b;
+  return (int) bb->count - (int) ba->count;
+}
+
+void writeString(FILE* out, const char* str)
+{
+  fputc('"', out);
+  for(; *str; ++str)
+  {
+    if(*str == '"' || *str == '\\')
+      fputc('\\', out);
+    fputc(*str, out);
+  }
+  fputc('"', out);
+}
@@ -0,0 +1,123 @@
+#include "internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void guihckContextTraceStart(guihckContext* ctx, size_t capacity)
+{
+  if(capacity == 0)
+    capacity = 1;
+
+  /* Starting again keeps the buffer when the size matches, old events are dropped either way */
+  if(ctx->trace && ctx->trace->capacity != capacity)
+  {
+    free(ctx->trace->events);
+    free(ctx->trace);
+    ctx->trace = NULL;
+  }
+
+  if(!ctx->trace)
+  {
+    ctx->trace = calloc(1, sizeof(_guihckTrace));
+    ctx->trace->events = calloc(capacity, sizeof(_guihckTraceEvent));
+    ctx->trace->capacity = capacity;
+  }
+
+  ctx->trace->next = 0;
+  ctx->trace->count = 0;
+  ctx->trace->recording = true;
+}
+
+void guihckContextTraceStop(guihckContext* ctx)
+{
+  if(ctx->trace)
+    ctx->trace->recording = false;
+}
+
+bool guihckContextTraceDump(guihckContext* ctx, const char* path)
+{
+  if(!ctx->trace)
+    return false;
+
+  FILE* file = fopen(path, "w");
+  if(!file)
+    return false;
+
+  _guihckTrace* trace = ctx->trace;
+  size_t first = (trace->next + trace->capacity - trace->count) % trace->capacity;
+
+  /* Ends whose begin was overwritten would close unrelated spans */
+  fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+  bool comma = false;
+  int depth = 0;
+  size_t i;
+  for(i = 0; i < trace->count; ++i)
+  {
+    const _guihckTraceEvent* event = &trace->events[(first + i) % trace->capacity];
+    if(event->phase == 'E')
+    {
+      if(depth == 0)
+        continue;
+      --depth;
+    }
+    else
+    {
+      ++depth;
+    }
+
+    fprintf(file, "%s\n{\"ph\": \"%c\", \"ts\": %.3f, \"pid\": 1, \"tid\": 1, \"cat\": ", comma ? "," : "", event->phase, event->time * 1e6);
+    _guihckTraceWriteString(file, event->category);
+    if(event->phase == 'B')
+    {
+      fprintf(file, ", \"name\": ");
+      _guihckTraceWriteString(file, event->name);
+      if(event->elementId != GUIHCK_NO_PARENT)
+        fprintf(file, ", \"args\": {\"element\": %lu}", (unsigned long) event->elementId);
+    }
+    fprintf(file, "}");
+    comma = true;
+  }
+  fprintf(file, "\n]}\n");
+
+  return fclose(file) == 0;
+}
+
+void _guihckTraceRecord(_guihckTrace* trace, char phase, const char* category, const char* name, guihckElementId elementId)
+{
+  _guihckTraceEvent* event = &trace->events[trace->next];
+  event->time = _guihckProfilerNow();
+  event->category = category;
+  event->elementId = elementId;
+  event->phase = phase;
+
+  if(name)
+  {
+    strncpy(event->name, name, _GUIHCK_TRACE_NAME_LENGTH - 1);
+    event->name[_GUIHCK_TRACE_NAME_LENGTH - 1] = '\0';
+  }
+  else
+  {
+    event->name[0] = '\0';
+  }
+
+  trace->next = (trace->next + 1) % trace->capacity;
+  if(trace->count < trace->capacity)
+    trace->count += 1;
+}
+
+void _guihckTraceWriteString(FILE* file, const char* str)
+{
+  fputc('"', file);
+  for(; *str; ++str)
+  {
+    unsigned char c = *str;
+    if(c == '"' || c == '\\')
+      fprintf(file, "\\%c", c);
+    else if(c < 0x20)
+      fprintf(file, "\\u%04x", c);
+    else
+      fputc(c, file);
+  }
+  fputc('"', file);
+}
@@ -0,0 +1,204 @@
+#include "internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+static guihckTypeRegistry* _guihckTypeRegistryCopy(guihckTypeRegistry* types);
+static void _guihckElementTypeFreeSchema(_guihckElementType* type);
+
+guihckTypeRegistry* guihckTypeRegistryNew()
+{
+  guihckTypeRegistry* types = calloc(1, sizeof(guihckTypeRegistry));
+  types->references = 1;
+  types->elementTypes = chckPoolNew(16, 16, sizeof(_guihckElementType));
+  types->elementTypesByName = chckHashTableNew(32);
+
+  guihckElementTypeFunctionMap rootElementFunctionMap = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+  guihckTypeRegistryAddType(types, "root", rootElementFunctionMap, 0);
+
+  return types;
+}
+
+guihckTypeRegistry* guihckTypeRegistryRef(guihckTypeRegistry* types)
+{
+  types->references += 1;
+  return types;
+}
+
+void guihckTypeRegistryFree(guihckTypeRegistry* types)
+{
+  if(--types->references > 0)
+    return;
+
+  chckPoolIndex iter = 0;
+  _guihckElementType* current;
+  while((current = chckPoolIter(types->elementTypes, &iter)))
+  {
+    free(current->name);
+    _guihckElementTypeFreeSchema(current);
+  }
+
+  chckHashTableFree(types->elementTypesByName);
+  chckPoolFree(types->elementTypes);
+  free(types);
+}
+
+guihckElementTypeId guihckTypeRegistryAddType(guihckTypeRegistry* types, const char* name, guihckElementTypeFunctionMap functionMap, size_t dataSize)
+{
+  /* Contexts rely on the types they were created with, get a copy through guihckContextGetMutableTypes */
+  assert(types->references == 1 && "Type registry is shared and can not be modified");
+  if(types->references != 1)
+    return -1;
+  assert(!chckHashTableStrGet(types->elementTypesByName, name) && "Element type with this name already exists");
+
+  _guihckElementType type;
+  type.name = strdup(name);
+  type.functionMap = functionMap;
+  type.dataSize = dataSize;
+  type.suspend = GUIHCK_SUSPEND_NONE;
+  type.emitsCommands = false;
+  type.schema = NULL;
+  type.schemaCount = 0;
+  type.schemaByName = NULL;
+
+  guihckElementTypeId id = -1;
+  chckPoolAdd(types->elementTypes, &type, &id);
+  chckHashTableStrSet(types->elementTypesByName, name, &id, sizeof(guihckElementTypeId));
+
+  return id;
+}
+
+guihckElementTypeId guihckTypeRegistryGetType(guihckTypeRegistry* types, const char* name)
+{
+  guihckElementTypeId* id = chckHashTableStrGet(types->elementTypesByName, name);
+  return id ? *id : (guihckElementTypeId) -1;
+}
+
+void guihckTypeRegistrySuspendHidden(guihckTypeRegistry* types, guihckElementTypeId typeId, int flags)
+{
+  assert(types->references == 1 && "Type registry is shared and can not be modified");
+  if(types->references != 1)
+    return;
+  _guihckElementType* type = chckPoolGet(types->elementTypes, typeId);
+  assert(type && "Invalid element type");
+  type->suspend = flags;
+}
+
+int guihckTypeRegistryGetSuspendHidden(guihckTypeRegistry* types, guihckElementTypeId typeId)
+{
+  _guihckElementType* type = chckPoolGet(types->elementTypes, typeId);
+  return type ? type->suspend : GUIHCK_SUSPEND_NONE;
+}
+
+void guihckTypeRegistryEmitsCommands(guihckTypeRegistry* types, guihckElementTypeId typeId, bool emits)
+{
+  assert(types->references == 1 && "Type registry is shared and can not be modified");
+  if(types->references != 1)
+    return;
+  _guihckElementType* type = chckPoolGet(types->elementTypes, typeId);
+  assert(type && "Invalid element type");
+  type->emitsCommands = emits;
+}
+
+bool guihckTypeRegistryGetEmitsCommands(guihckTypeRegistry* types, guihckElementTypeId typeId)
+{
+  _guihckElementType* type = chckPoolGet(types->elementTypes, typeId);
+  return type && type->emitsCommands;
+}
+
+void guihckTypeRegistrySchema(guihckTypeRegistry* types, guihckElementTypeId typeId, const guihckPropertySchema* schema, size_t count)
+{
+  assert(types->references == 1 && "Type registry is shared and can not be modified");
+  if(types->references != 1)
+    return;
+  _guihckElementType* type = chckPoolGet(types->elementTypes, typeId);
+  assert(type && "Invalid element type");
+  assert(count <= GUIHCK_MAX_SCHEMA_PROPERTIES && "Too many schema properties for the change mask");
+  _guihckElementTypeFreeSchema(type);
+
+  if(count == 0)
+    return;
+
+  type->schema = calloc(count, sizeof(guihckPropertySchema));
+  type->schemaCount = count;
+  type->schemaByName = chckHashTableNew(count < 8 ? 16 : count * 2);
+
+  size_t i;
+  for(i = 0; i < count; ++i)
+  {
+    guihckPropertySchema* entry = &type->schema[i];
+    *entry = schema[i];
+    entry->name = strdup(schema[i].name);
+    if(entry->type == GUIHCK_VALUE_STRING && schema[i].defaultValue.string)
+      entry->defaultValue.string = strdup(schema[i].defaultValue.string);
+
+    chckHashTableStrSet(type->schemaByName, entry->name, &i, sizeof(size_t));
+  }
+}
+
+const guihckPropertySchema* guihckTypeRegistryGetSchema(guihckTypeRegistry* types, guihckElementTypeId typeId, size_t* count)
+{
+  _guihckElementType* type = chckPoolGet(types->elementTypes, typeId);
+  *count = type ? type->schemaCount : 0;
+  return type ? type->schema : NULL;
+}
+
+guihckTypeRegistry* guihckContextGetTypes(guihckContext* ctx)
+{
+  return ctx->types;
+}
+
+guihckTypeRegistry* guihckContextGetMutableTypes(guihckContext* ctx)
+{
+  if(ctx->types->references > 1)
+  {
+    guihckTypeRegistry* copy = _guihckTypeRegistryCopy(ctx->types);
+    guihckTypeRegistryFree(ctx->types);
+    ctx->types = copy;
+  }
+
+  return ctx->types;
+}
+
+guihckTypeRegistry* _guihckTypeRegistryCopy(guihckTypeRegistry* types)
+{
+  /* Types are never removed, adding them in order keeps every id */
+  guihckTypeRegistry* copy = calloc(1, sizeof(guihckTypeRegistry));
+  copy->references = 1;
+  copy->elementTypes = chckPoolNew(16, 16, sizeof(_guihckElementType));
+  copy->elementTypesByName = chckHashTableNew(32);
+
+  chckPoolIndex iter = 0;
+  _guihckElementType* current;
+  while((current = chckPoolIter(types->elementTypes, &iter)))
+  {
+    guihckElementTypeId id = guihckTypeRegistryAddType(copy, current->name, current->functionMap, current->dataSize);
+    assert(id == (guihckElementTypeId) (iter - 1));
+    guihckTypeRegistrySuspendHidden(copy, id, current->suspend);
+    guihckTypeRegistryEmitsCommands(copy, id, current->emitsCommands);
+    guihckTypeRegistrySchema(copy, id, current->schema, current->schemaCount);
+  }
+
+  return copy;
+}
+
+void _guihckElementTypeFreeSchema(_guihckElementType* type)
+{
+  if(!type->schema)
+    return;
+
+  size_t i;
+  for(i = 0; i < type->schemaCount; ++i)
+  {
+    free((char*) type->schema[i].name);
+    if(type->schema[i].type == GUIHCK_VALUE_STRING)
+      free((char*) type->schema[i].defaultValue.string);
+  }
+
+  chckHashTableFree(type->schemaByName);
+  free(type->schema);
+  type->schema = NULL;
+  type->schemaCount = 0;
+  type->schemaByName = NULL;
+}
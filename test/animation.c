@@ -0,0 +1,170 @@
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+static void countCompletion(guihckContext* ctx, guihckAnimationId animationId, guihckElementId elementId, void* data)
+{
+  (void) ctx;
+  (void) animationId;
+  (void) elementId;
+
+  *((int*) data) += 1;
+}
+
+static void countFree(guihckContext* ctx, guihckAnimationId animationId, void* data)
+{
+  (void) ctx;
+  (void) animationId;
+
+  *((int*) data) += 1;
+}
+
+static guihckElementId findElement(guihckContext* ctx, const char* id)
+{
+  guihckStackPushElementById(ctx, id);
+  guihckElementId elementId = guihckStackGetElement(ctx);
+  guihckStackPopElement(ctx);
+  return elementId;
+}
+
+static double getDouble(guihckContext* ctx, guihckElementId id, const char* key)
+{
+  return scm_to_double(guihckElementGetProperty(ctx, id, key));
+}
+
+static void frame(guihckContext* ctx, double time)
+{
+  guihckContextTime(ctx, time);
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+}
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  guihckInit();
+  guihckContext* ctx = guihckContextNew();
+  guihckElementsAddAllTypes(ctx);
+  guihckElementTypeId itemId = guihckTypeRegistryGetType(guihckContextGetTypes(ctx), "item");
+  guihckElementId root = guihckContextGetRootElement(ctx);
+  guihckElementId item = guihckElementNew(ctx, itemId, root);
+  guihckElementProperty(ctx, item, "x", scm_from_int(0));
+
+  // Tweens follow the context time, integers stay exact
+  int completed = 0;
+  guihckContextTime(ctx, 10);
+  guihckAnimationId tween = guihckAnimationTween(ctx, item, "x", SCM_UNDEFINED, scm_from_int(100), 1, GUIHCK_EASING_LINEAR);
+  guihckAnimationOnComplete(ctx, tween, countCompletion, &completed, NULL);
+  guihckAnimationStart(ctx, tween);
+  assert(guihckAnimationGetRunning(ctx, tween));
+  frame(ctx, 10.25);
+  assert(getDouble(ctx, item, "x") == 25);
+  assert(scm_is_true(scm_exact_p(guihckElementGetProperty(ctx, item, "x"))));
+  frame(ctx, 12);
+  assert(getDouble(ctx, item, "x") == 100);
+  assert(!guihckAnimationGetRunning(ctx, tween) && completed == 1);
+  frame(ctx, 13);
+  assert(completed == 1);
+  guihckAnimationRemove(ctx, tween);
+
+  // Colors are tweened per component
+  guihckContextTime(ctx, 0);
+  guihckAnimationId color = guihckAnimationTween(ctx, item, "color", scm_list_3(scm_from_int(0), scm_from_int(0), scm_from_int(0)),
+                                                 scm_list_3(scm_from_int(255), scm_from_int(0), scm_from_int(10)), 1,
+                                                 GUIHCK_EASING_LINEAR);
+  guihckAnimationStart(ctx, color);
+  frame(ctx, 0.5);
+  SCM value = guihckElementGetProperty(ctx, item, "color");
+  assert(scm_to_int(scm_car(value)) == 128 && scm_to_int(scm_list_ref(value, scm_from_int(2))) == 5);
+  assert(scm_is_true(scm_exact_p(scm_car(value))));
+  guihckAnimationRemove(ctx, color);
+  frame(ctx, 1);
+  assert(scm_to_int(scm_car(guihckElementGetProperty(ctx, item, "color"))) == 128);
+
+  // Sequences play their steps in order and backwards when alternating
+  guihckAnimationId steps[2];
+  steps[0] = guihckAnimationTween(ctx, item, "x", scm_from_int(0), scm_from_int(10), 1, GUIHCK_EASING_LINEAR);
+  steps[1] = guihckAnimationTween(ctx, item, "x", scm_from_int(10), scm_from_int(20), 1, GUIHCK_EASING_LINEAR);
+  guihckAnimationId sequence = guihckAnimationSequence(ctx, steps, 2);
+  guihckAnimationRepeat(ctx, sequence, 2, true);
+  completed = 0;
+  guihckAnimationOnComplete(ctx, sequence, countCompletion, &completed, NULL);
+  guihckContextTime(ctx, 0);
+  guihckAnimationStart(ctx, sequence);
+  frame(ctx, 1.5);
+  assert(getDouble(ctx, item, "x") == 15);
+  frame(ctx, 3.5);
+  assert(getDouble(ctx, item, "x") == 5);
+  assert(guihckAnimationGetRunning(ctx, sequence));
+  frame(ctx, 4.5);
+  assert(getDouble(ctx, item, "x") == 0);
+  assert(!guihckAnimationGetRunning(ctx, sequence) && completed == 1);
+  guihckAnimationRemove(ctx, sequence);
+
+  // Springs settle on their target
+  guihckContextTime(ctx, 0);
+  guihckAnimationId spring = guihckAnimationSpring(ctx, item, "x", scm_from_int(50), 170, 26);
+  guihckAnimationStart(ctx, spring);
+  int i;
+  for(i = 1; i <= 60 && guihckAnimationGetRunning(ctx, spring); ++i)
+  {
+    frame(ctx, i / 60.0);
+    assert(getDouble(ctx, item, "x") > 0);
+  }
+  assert(i > 2);
+  for(; i <= 300 && guihckAnimationGetRunning(ctx, spring); ++i)
+    frame(ctx, i / 60.0);
+  assert(!guihckAnimationGetRunning(ctx, spring));
+  assert(getDouble(ctx, item, "x") == 50);
+  guihckAnimationRemove(ctx, spring);
+
+  // Animations go away with their element
+  guihckElementId doomed = guihckElementNew(ctx, itemId, root);
+  int freed = 0;
+  guihckAnimationId orphan = guihckAnimationTween(ctx, doomed, "y", scm_from_int(0), scm_from_int(10), 1, GUIHCK_EASING_OUT_QUAD);
+  guihckAnimationOnComplete(ctx, orphan, countCompletion, &completed, countFree);
+  guihckAnimationStart(ctx, orphan);
+  guihckElementRemove(ctx, doomed);
+  assert(freed == 1 && !guihckAnimationGetRunning(ctx, orphan));
+  frame(ctx, 10);
+
+  // Running animations from Scheme calls nothing in Scheme until one completes
+  guihckContextTime(ctx, 0);
+  guihckContextExecuteScript(ctx,
+    "(create-elements!"
+    "  (item (id 'pulse) (prop 'opacity 0)"
+    "    (method 'init (lambda () (animate! (tween 'opacity 1.0 0.5 (easing 'in-out-quad)) (repeat -1 #t)))))"
+    "  (item (id 'once) (prop 'x 0) (prop 'done #f)"
+    "    (method 'init (lambda () (animate! (tween 'x 10 1 (on-complete (lambda () (set-prop! 'done #t)))))))))");
+  guihckElementId pulse = findElement(ctx, "pulse");
+  guihckElementId once = findElement(ctx, "once");
+
+  guihckContextProfiling(ctx, true);
+  guihckFrameStats stats;
+  for(i = 1; i < 10; ++i)
+  {
+    frame(ctx, i / 20.0);
+    assert(guihckContextGetFrameStats(ctx, &stats));
+    assert(stats.schemeCalls == 0);
+    assert(stats.phases[GUIHCK_PHASE_ANIMATION].calls == 1);
+  }
+  assert(getDouble(ctx, pulse, "opacity") > 0.5 && getDouble(ctx, pulse, "opacity") < 1);
+  assert(scm_is_false(guihckElementGetProperty(ctx, once, "done")));
+
+  frame(ctx, 1);
+  assert(guihckContextGetFrameStats(ctx, &stats));
+  assert(stats.schemeCalls > 0);
+  assert(scm_is_true(guihckElementGetProperty(ctx, once, "done")));
+  assert(getDouble(ctx, once, "x") == 10);
+  frame(ctx, 1.25);
+  assert(getDouble(ctx, pulse, "opacity") == 0.5);
+  guihckContextProfiling(ctx, false);
+
+  guihckContextFree(ctx);
+
+  return 0;
+}
@@ -0,0 +1,162 @@
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/* Emits a quad at its width, a clip when "clip" is set and a text run when "label" is */
+static bool updateProbe(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
+{
+  (void) data;
+  (void) changed;
+
+  guihckRenderCommand command;
+  memset(&command, 0, sizeof(guihckRenderCommand));
+  guihckElementClearCommands(ctx, id);
+
+  SCM width = guihckElementGetProperty(ctx, id, "width");
+  command.type = GUIHCK_COMMAND_QUAD;
+  command.width = scm_is_real(width) ? scm_to_double(width) : 0;
+  guihckElementAddCommand(ctx, id, &command);
+
+  if(scm_is_true(guihckElementGetProperty(ctx, id, "clip")))
+  {
+    command.type = GUIHCK_COMMAND_CLIP_PUSH;
+    guihckElementAddCommand(ctx, id, &command);
+  }
+
+  SCM label = guihckElementGetProperty(ctx, id, "label");
+  if(scm_is_string(label))
+  {
+    char* text = scm_to_utf8_string(label);
+    command.type = GUIHCK_COMMAND_TEXT;
+    command.text = text;
+    guihckElementAddCommand(ctx, id, &command);
+    free(text);
+  }
+
+  return false;
+}
+
+static guihckElementId pressed = (guihckElementId) -1;
+
+static bool mouseDown(guihckContext* ctx, guihckElementId id, void* data, int button, float x, float y)
+{
+  (void) ctx;
+  (void) data;
+  (void) button;
+  (void) x;
+  (void) y;
+
+  pressed = id;
+  return true;
+}
+
+static void renderProbe(guihckContext* ctx, guihckElementId id, void* data)
+{
+  (void) ctx;
+  (void) id;
+  (void) data;
+
+  assert(false && "Retained rendering must not call render");
+}
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  guihckElementTypeFunctionMap probeMap = {NULL, NULL, updateProbe, renderProbe, NULL, NULL, NULL, NULL};
+
+  guihckInit();
+  guihckContext* ctx = guihckContextNew();
+  guihckElementsAddItemType(ctx);
+  guihckElementTypeId probeId = guihckElementTypeAdd(ctx, "probe", probeMap, 0);
+
+  size_t count;
+  assert(!guihckContextGetRetainedRendering(ctx));
+  assert(!guihckContextGetRenderCommands(ctx, &count) && count == 0);
+
+  // Refused while a type only draws in render
+  assert(!guihckContextRetainedRendering(ctx, true));
+  assert(!guihckContextGetRetainedRendering(ctx));
+
+  guihckElementTypeEmitsCommands(ctx, probeId, true);
+  assert(guihckContextRetainedRendering(ctx, true));
+  assert(guihckContextGetRetainedRendering(ctx));
+
+  guihckElementId root = guihckContextGetRootElement(ctx);
+  guihckElementId a = guihckElementNew(ctx, probeId, root);
+  guihckElementProperty(ctx, a, "width", scm_from_int(1));
+  guihckElementProperty(ctx, a, "clip", SCM_BOOL_T);
+  guihckElementId b = guihckElementNew(ctx, probeId, a);
+  guihckElementProperty(ctx, b, "width", scm_from_int(2));
+  guihckElementProperty(ctx, b, "label", scm_from_utf8_string("hello"));
+
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+
+  // a's quad and clip, b's quad and text, then a's clip is popped
+  const guihckRenderCommand* commands = guihckContextGetRenderCommands(ctx, &count);
+  assert(count == 5);
+  assert(commands[0].type == GUIHCK_COMMAND_QUAD && commands[0].elementId == a && commands[0].width == 1);
+  assert(commands[1].type == GUIHCK_COMMAND_CLIP_PUSH && commands[1].elementId == a);
+  assert(commands[2].type == GUIHCK_COMMAND_QUAD && commands[2].elementId == b && commands[2].width == 2);
+  assert(commands[3].type == GUIHCK_COMMAND_TEXT && strcmp(commands[3].text, "hello") == 0);
+  assert(commands[4].type == GUIHCK_COMMAND_CLIP_POP && commands[4].elementId == a);
+
+  // Same sized changes are patched in place
+  guihckElementProperty(ctx, b, "width", scm_from_int(3));
+  guihckElementDirty(ctx, b);
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  const guihckRenderCommand* patched = guihckContextGetRenderCommands(ctx, &count);
+  assert(patched == commands && count == 5);
+  assert(patched[2].width == 3);
+  assert(strcmp(patched[3].text, "hello") == 0);
+
+  // Dropping the clip removes its pop too
+  guihckElementProperty(ctx, a, "clip", SCM_BOOL_F);
+  guihckElementDirty(ctx, a);
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  commands = guihckContextGetRenderCommands(ctx, &count);
+  assert(count == 3);
+  assert(commands[0].elementId == a && commands[1].elementId == b && commands[2].type == GUIHCK_COMMAND_TEXT);
+
+  // Hidden subtrees are left out
+  guihckElementVisible(ctx, a, false);
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  guihckContextGetRenderCommands(ctx, &count);
+  assert(count == 0);
+
+  guihckElementVisible(ctx, a, true);
+  guihckElementRemove(ctx, b);
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  commands = guihckContextGetRenderCommands(ctx, &count);
+  assert(count == 1 && commands[0].elementId == a);
+
+  // Hit testing still follows the render order of elements created since
+  guihckMouseAreaFunctionMap mouseAreaMap = {mouseDown, NULL, NULL, NULL, NULL};
+  guihckElementId below = guihckElementNew(ctx, probeId, root);
+  guihckElementId above = guihckElementNew(ctx, probeId, root);
+  guihckMouseAreaRect(ctx, guihckMouseAreaNew(ctx, below, mouseAreaMap), 0, 0, 10, 10);
+  guihckMouseAreaRect(ctx, guihckMouseAreaNew(ctx, above, mouseAreaMap), 5, 5, 10, 10);
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  guihckContextMouseDown(ctx, 7, 7, 0);
+  assert(pressed == above);
+  guihckContextMouseDown(ctx, 2, 2, 0);
+  assert(pressed == below);
+
+  guihckContextRetainedRendering(ctx, false);
+  assert(!guihckContextGetRenderCommands(ctx, &count) && count == 0);
+
+  guihckContextFree(ctx);
+
+  return 0;
+}
@@ -0,0 +1,170 @@
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+typedef struct probeData
+{
+  int updates;
+  int renders;
+} probeData;
+
+static bool updateProbe(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
+{
+  (void) changed;
+
+  guihckRenderCommand command;
+  memset(&command, 0, sizeof(guihckRenderCommand));
+  command.type = GUIHCK_COMMAND_QUAD;
+  guihckElementClearCommands(ctx, id);
+  guihckElementAddCommand(ctx, id, &command);
+
+  ((probeData*) data)->updates += 1;
+  return false;
+}
+
+static void renderProbe(guihckContext* ctx, guihckElementId id, void* data)
+{
+  (void) ctx;
+  (void) id;
+
+  ((probeData*) data)->renders += 1;
+}
+
+static guihckElementId newProbe(guihckContext* ctx, guihckElementTypeId typeId, guihckElementId parentId, float x, float y, float size)
+{
+  guihckElementId id = guihckElementNew(ctx, typeId, parentId);
+  guihckElementProperty(ctx, id, "absolute-x", scm_from_double(x));
+  guihckElementProperty(ctx, id, "absolute-y", scm_from_double(y));
+  guihckElementProperty(ctx, id, "width", scm_from_double(size));
+  guihckElementProperty(ctx, id, "height", scm_from_double(size));
+  return id;
+}
+
+static int renders(guihckContext* ctx, guihckElementId id)
+{
+  return ((probeData*) guihckElementGetData(ctx, id))->renders;
+}
+
+static int updates(guihckContext* ctx, guihckElementId id)
+{
+  return ((probeData*) guihckElementGetData(ctx, id))->updates;
+}
+
+static bool pressed(guihckContext* ctx, guihckElementId id)
+{
+  SCM value = guihckElementGetProperty(ctx, id, "pressed");
+  return scm_is_bool(value) && scm_is_true(value);
+}
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  guihckElementTypeFunctionMap probeMap = {NULL, NULL, updateProbe, renderProbe, NULL, NULL, NULL, NULL};
+
+  guihckInit();
+  guihckContext* ctx = guihckContextNew();
+  guihckElementsAddItemType(ctx);
+  guihckElementsAddMouseAreaType(ctx);
+  guihckElementTypeId probeId = guihckElementTypeAdd(ctx, "probe", probeMap, sizeof(probeData));
+  guihckElementTypeEmitsCommands(ctx, probeId, true);
+  guihckElementTypeId mouseAreaId = guihckTypeRegistryGetType(guihckContextGetTypes(ctx), "mouse-area");
+  guihckElementId root = guihckContextGetRootElement(ctx);
+
+  guihckElementProperty(ctx, root, "width", scm_from_int(100));
+  guihckElementProperty(ctx, root, "height", scm_from_int(100));
+
+  guihckElementId inside = newProbe(ctx, probeId, root, 10, 10, 10);
+  guihckElementId outside = newProbe(ctx, probeId, root, 200, 10, 10);
+
+  // Children of a clipping element are limited to its rect
+  guihckElementId clipper = newProbe(ctx, probeId, root, 50, 50, 20);
+  guihckElementClip(ctx, clipper, true);
+  assert(guihckElementGetClip(ctx, clipper) && !guihckElementGetClip(ctx, inside));
+  guihckElementId partial = newProbe(ctx, probeId, clipper, 65, 65, 10);
+  guihckElementId clipped = newProbe(ctx, probeId, clipper, 80, 80, 5);
+
+  guihckElementId area = guihckElementNew(ctx, mouseAreaId, clipper);
+  guihckElementProperty(ctx, area, "x", scm_from_int(10));
+  guihckElementProperty(ctx, area, "y", scm_from_int(10));
+  guihckElementProperty(ctx, area, "width", scm_from_int(20));
+  guihckElementProperty(ctx, area, "height", scm_from_int(20));
+
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+
+  assert(!guihckElementGetCulled(ctx, inside) && renders(ctx, inside) == 1);
+  assert(guihckElementGetCulled(ctx, outside) && renders(ctx, outside) == 0);
+  assert(!guihckElementGetCulled(ctx, partial) && renders(ctx, partial) == 1);
+  assert(guihckElementGetCulled(ctx, clipped) && renders(ctx, clipped) == 0);
+
+  float x, y, width, height;
+  assert(guihckElementGetVisibleBounds(ctx, partial, &x, &y, &width, &height));
+  assert(x == 65 && y == 65 && width == 5 && height == 5);
+  assert(!guihckElementGetVisibleBounds(ctx, outside, &x, &y, &width, &height));
+
+  // Only the shown part of a clipped mouse area takes the pointer
+  guihckContextMouseDown(ctx, 65, 65, 0);
+  assert(pressed(ctx, area));
+  guihckContextMouseUp(ctx, 65, 65, 0);
+  guihckContextMouseDown(ctx, 75, 75, 0);
+  assert(!pressed(ctx, area));
+  guihckContextMouseUp(ctx, 75, 75, 0);
+
+  // Moving the clipping element away culls everything below it
+  guihckElementProperty(ctx, clipper, "absolute-x", scm_from_int(150));
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  assert(guihckElementGetCulled(ctx, clipper) && renders(ctx, clipper) == 1);
+  assert(guihckElementGetCulled(ctx, partial) && renders(ctx, partial) == 1);
+  assert(guihckElementGetCulled(ctx, area));
+  guihckContextMouseDown(ctx, 65, 65, 0);
+  assert(!pressed(ctx, area));
+  guihckContextMouseUp(ctx, 65, 65, 0);
+
+  // Culled elements wait for their update when asked to
+  guihckContextCullUpdates(ctx, true);
+  assert(guihckContextGetCullUpdates(ctx));
+  int outsideUpdates = updates(ctx, outside);
+  guihckElementDirty(ctx, outside);
+  guihckElementDirty(ctx, inside);
+  guihckContextUpdate(ctx);
+  assert(updates(ctx, outside) == outsideUpdates);
+
+  guihckElementProperty(ctx, outside, "absolute-x", scm_from_int(90));
+  guihckContextRender(ctx);
+  assert(!guihckElementGetCulled(ctx, outside) && renders(ctx, outside) == 1);
+  guihckContextUpdate(ctx);
+  assert(updates(ctx, outside) == outsideUpdates + 1);
+
+  // Retained rendering leaves culled elements out and clips children of clipping elements
+  guihckElementProperty(ctx, clipper, "absolute-x", scm_from_int(50));
+  guihckContextCullUpdates(ctx, false);
+  guihckContextRetainedRendering(ctx, true);
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  size_t count;
+  const guihckRenderCommand* commands = guihckContextGetRenderCommands(ctx, &count);
+  size_t i;
+  bool pushed = false;
+  bool listed = false;
+  for(i = 0; i < count; ++i)
+  {
+    assert(commands[i].elementId != clipped);
+    listed = listed || commands[i].elementId == partial;
+    if(commands[i].type == GUIHCK_COMMAND_CLIP_PUSH && commands[i].elementId == clipper)
+    {
+      pushed = true;
+      assert(commands[i].x == 50 && commands[i].width == 20);
+    }
+  }
+  assert(pushed && listed);
+
+  guihckContextFree(ctx);
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+static void renderProbe(guihckContext* ctx, guihckElementId id, void* data)
+{
+  (void) ctx;
+  (void) id;
+  (void) data;
+}
+
+static guihckElementId newProbe(guihckContext* ctx, guihckElementTypeId typeId, guihckElementId parentId, float x, float y)
+{
+  guihckElementId id = guihckElementNew(ctx, typeId, parentId);
+  guihckElementProperty(ctx, id, "absolute-x", scm_from_double(x));
+  guihckElementProperty(ctx, id, "absolute-y", scm_from_double(y));
+  guihckElementProperty(ctx, id, "width", scm_from_double(10));
+  guihckElementProperty(ctx, id, "height", scm_from_double(10));
+  return id;
+}
+
+static bool hasRect(const guihckDamageRect* rects, size_t count, float x, float y, float width, float height)
+{
+  size_t i;
+  for(i = 0; i < count; ++i)
+  {
+    if(rects[i].x == x && rects[i].y == y && rects[i].width == width && rects[i].height == height)
+      return true;
+  }
+  return false;
+}
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  guihckElementTypeFunctionMap probeMap = {NULL, NULL, NULL, renderProbe, NULL, NULL, NULL, NULL};
+
+  guihckInit();
+  guihckContext* ctx = guihckContextNew();
+  guihckElementsAddItemType(ctx);
+  guihckElementTypeId probeId = guihckElementTypeAdd(ctx, "probe", probeMap, 0);
+  guihckElementTypeId itemId = guihckTypeRegistryGetType(guihckContextGetTypes(ctx), "item");
+  guihckElementId root = guihckContextGetRootElement(ctx);
+
+  const guihckDamageRect* rects;
+  assert(guihckContextGetDamage(ctx, &rects) == 0);
+
+  // New elements damage where they appear
+  guihckElementId a = newProbe(ctx, probeId, root, 0, 0);
+  guihckElementId group = guihckElementNew(ctx, itemId, root);
+  guihckElementId b = newProbe(ctx, probeId, group, 100, 100);
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  size_t count = guihckContextGetDamage(ctx, &rects);
+  assert(count == 2);
+  assert(hasRect(rects, count, 0, 0, 10, 10));
+  assert(hasRect(rects, count, 100, 100, 10, 10));
+
+  // Nothing changed
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  assert(guihckContextGetDamage(ctx, &rects) == 0);
+
+  // A color change damages only that element
+  guihckElementProperty(ctx, b, "color", scm_list_3(scm_from_int(1), scm_from_int(2), scm_from_int(3)));
+  guihckContextRender(ctx);
+  count = guihckContextGetDamage(ctx, &rects);
+  assert(count == 1 && hasRect(rects, count, 100, 100, 10, 10));
+
+  // Moving covers the old and the new position, overlapping areas merge
+  guihckElementProperty(ctx, a, "absolute-x", scm_from_double(5));
+  guihckContextRender(ctx);
+  count = guihckContextGetDamage(ctx, &rects);
+  assert(count == 1 && hasRect(rects, count, 0, 0, 15, 10));
+
+  // Hiding a non-visual parent damages its visual children
+  guihckElementVisible(ctx, group, false);
+  guihckContextRender(ctx);
+  count = guihckContextGetDamage(ctx, &rects);
+  assert(count == 1 && hasRect(rects, count, 100, 100, 10, 10));
+
+  // Hidden elements have no area to damage
+  guihckElementProperty(ctx, b, "absolute-x", scm_from_double(200));
+  guihckContextRender(ctx);
+  assert(guihckContextGetDamage(ctx, &rects) == 0);
+
+  guihckElementRemove(ctx, a);
+  guihckContextDamage(ctx, 50, 50, 1, 1);
+  guihckContextRender(ctx);
+  count = guihckContextGetDamage(ctx, &rects);
+  assert(count == 2);
+  assert(hasRect(rects, count, 5, 0, 10, 10));
+  assert(hasRect(rects, count, 50, 50, 1, 1));
+
+  // Scattered changes are merged down to the limit
+  int i;
+  for(i = 0; i < 3 * GUIHCK_MAX_DAMAGE_RECTS; ++i)
+    newProbe(ctx, probeId, root, i * 20, 300);
+  guihckContextRender(ctx);
+  count = guihckContextGetDamage(ctx, &rects);
+  assert(count > 0 && count <= GUIHCK_MAX_DAMAGE_RECTS);
+
+  guihckContextFree(ctx);
+
+  return 0;
+}
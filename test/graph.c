@@ -0,0 +1,110 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+
+static char* readFile(const char* path)
+{
+  FILE* file = fopen(path, "r");
+  assert(file);
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  char* contents = calloc(size + 1, 1);
+  size_t read = fread(contents, 1, size, file);
+  assert(read == (size_t) size);
+  (void) read;
+  fclose(file);
+  return contents;
+}
+
+static guihckElementId findElement(guihckContext* ctx, const char* id)
+{
+  guihckStackPushElementById(ctx, id);
+  guihckElementId elementId = guihckStackGetElement(ctx);
+  guihckStackPopElement(ctx);
+  return elementId;
+}
+
+static SCM bindTo(guihckElementId elementId, const char* property, SCM function)
+{
+  SCM ref = scm_cons(scm_from_uint64(elementId), scm_from_utf8_symbol(property));
+  return scm_list_3(scm_from_utf8_symbol("bind"), scm_list_1(ref), function);
+}
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  char path[] = "/tmp/guihck-graph-XXXXXX";
+  int fd = mkstemp(path);
+  assert(fd != -1);
+  close(fd);
+
+  guihckInit();
+  guihckContext* ctx = guihckContextNew();
+  guihckElementsAddAllTypes(ctx);
+  assert(guihckContextGetNotifyDepthLimit(ctx) > 0);
+
+  guihckContextExecuteScript(ctx,
+    "(create-elements!"
+    "  (item (id 'source) (prop 'width 1))"
+    "  (item (id 'label) (prop 'double (bound '(source width) (lambda (w) (* w 2)))) (alias 'size 'source 'width)))");
+  guihckElementId source = findElement(ctx, "source");
+
+  // Edges count the notifications through them since the reset
+  guihckContextResetBindingCounters(ctx);
+  guihckElementProperty(ctx, source, "width", scm_from_int(2));
+  guihckElementProperty(ctx, source, "width", scm_from_int(3));
+
+  assert(guihckContextBindingGraphDump(ctx, path, GUIHCK_GRAPH_JSON));
+  char* json = readFile(path);
+  assert(strstr(json, "\"nodes\": ["));
+  assert(strstr(json, "\"label\": \"source#"));
+  assert(strstr(json, "\"kind\": \"bind\", \"calls\": 2"));
+  assert(strstr(json, "\"kind\": \"alias\", \"calls\": 2"));
+  free(json);
+
+  assert(guihckContextBindingGraphDump(ctx, path, GUIHCK_GRAPH_DOT));
+  char* dot = readFile(path);
+  assert(strncmp(dot, "digraph bindings {", 18) == 0);
+  assert(strstr(dot, "style=dashed"));
+  assert(strstr(dot, "bind 2"));
+  free(dot);
+
+  guihckContextResetBindingCounters(ctx);
+  assert(guihckContextBindingGraphDump(ctx, path, GUIHCK_GRAPH_JSON));
+  json = readFile(path);
+  assert(!strstr(json, "\"calls\": 2"));
+  free(json);
+
+  // Two binds on each other are cut at the limit and reported as the cycle
+  guihckContextNotifyDepthLimit(ctx, 16);
+  guihckElementTypeId itemId = guihckTypeRegistryGetType(guihckContextGetTypes(ctx), "item");
+  guihckElementId root = guihckContextGetRootElement(ctx);
+  guihckElementId a = guihckElementNew(ctx, itemId, root);
+  guihckElementId b = guihckElementNew(ctx, itemId, root);
+  SCM increment = guihckContextExecuteScript(ctx, "(lambda (x) (+ x 1))");
+  scm_gc_protect_object(increment);
+  guihckElementProperty(ctx, a, "v", scm_from_int(0));
+  guihckElementProperty(ctx, b, "v", bindTo(a, "v", increment));
+
+  const guihckPropertyListenerId* cycle;
+  assert(guihckContextGetNotifyCycle(ctx, &cycle) == 0);
+  guihckElementProperty(ctx, a, "v", bindTo(b, "v", increment));
+  assert(guihckContextGetNotifyCycle(ctx, &cycle) == 2);
+  assert(cycle[0] != cycle[1]);
+  scm_gc_unprotect_object(increment);
+
+  guihckContextFree(ctx);
+  unlink(path);
+
+  return 0;
+}
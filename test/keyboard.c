@@ -55,6 +55,28 @@ bool keyChar(guihckContext* ctx, guihckElementId id, unsigned int codepoint, voi
   return probeData->accept;
 }
 
+bool accelerator(guihckContext* ctx, guihckKey key, guihckKeyAction action, guihckKeyMods mods, void* data)
+{
+  (void) ctx;
+  (void) action;
+
+  int* acceleratorCount = data;
+  *acceleratorCount += 1;
+  printf("accelerator %d %d, count = %d\n", (int) key, (int) mods, *acceleratorCount);
+
+  return key == GUIHCK_KEY_ESCAPE;
+}
+
+void acceleratorFree(guihckContext* ctx, guihckKey key, guihckKeyMods mods, void* data)
+{
+  (void) ctx;
+  (void) key;
+  (void) mods;
+
+  int* acceleratorCount = data;
+  *acceleratorCount = -1;
+}
+
 int main(int argc, char** argv)
 {
   (void) argc;
@@ -63,7 +85,7 @@ int main(int argc, char** argv)
   guihckInit();
   guihckContext* ctx = guihckContextNew();
 
-  guihckElementTypeFunctionMap keyboardProbeMap = { NULL, NULL, NULL, NULL, keyEvent, keyChar };
+  guihckElementTypeFunctionMap keyboardProbeMap = { NULL, NULL, NULL, NULL, keyEvent, keyChar, NULL, NULL };
   guihckElementTypeAdd(ctx, "keyboard-probe", keyboardProbeMap, sizeof(int*));
 
   int count = 0;
@@ -153,6 +175,35 @@ int main(int argc, char** argv)
   guihckContextKeyboardChar(ctx, 42);
   assert(count == 0);
 
+  int acceleratorCount = 0;
+  guihckContextKeyboardFocus(ctx, id4);
+  guihckContextAddAccelerator(ctx, GUIHCK_KEY_ESCAPE, 0, accelerator, &acceleratorCount, acceleratorFree);
+  guihckContextAddAccelerator(ctx, GUIHCK_KEY_Q, GUIHCK_MOD_CONTROL, accelerator, &acceleratorCount, NULL);
+
+  count = 0;
+  guihckContextKeyboardKey(ctx, GUIHCK_KEY_ESCAPE, 0, GUIHCK_KEY_PRESS, 0);
+  assert(acceleratorCount == 1);
+  assert(count == 0);
+
+  /* Unrelated keys and modifier combinations go to the focus chain */
+  guihckContextKeyboardKey(ctx, GUIHCK_KEY_ESCAPE, 0, GUIHCK_KEY_PRESS, GUIHCK_MOD_SHIFT);
+  guihckContextKeyboardKey(ctx, GUIHCK_KEY_Q, 0, GUIHCK_KEY_PRESS, 0);
+  assert(acceleratorCount == 1);
+  assert(count == 4);
+
+  /* Unhandled accelerators fall through */
+  count = 0;
+  guihckContextKeyboardKey(ctx, GUIHCK_KEY_Q, 0, GUIHCK_KEY_PRESS, GUIHCK_MOD_CONTROL);
+  assert(acceleratorCount == 2);
+  assert(count == 2);
+
+  guihckContextRemoveAccelerator(ctx, GUIHCK_KEY_ESCAPE, 0);
+  assert(acceleratorCount == -1);
+  count = 0;
+  guihckContextKeyboardKey(ctx, GUIHCK_KEY_ESCAPE, 0, GUIHCK_KEY_PRESS, 0);
+  assert(acceleratorCount == -1);
+  assert(count == 2);
+
   guihckContextFree(ctx);
 
   return EXIT_SUCCESS;
@@ -0,0 +1,118 @@
+#include "guihck.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+typedef struct mouseProbeCounts
+{
+  int enter;
+  int exit;
+  int move;
+  int up;
+} mouseProbeCounts;
+
+static mouseProbeCounts counts = {0, 0, 0, 0};
+
+bool mouseUp(guihckContext* ctx, guihckElementId id, void* data, int button, float x, float y)
+{
+  (void) ctx;
+  (void) data;
+  (void) button;
+
+  counts.up += 1;
+  printf("mouseUp %d %f %f\n", (int) id, x, y);
+  return true;
+}
+
+bool mouseMove(guihckContext* ctx, guihckElementId id, void* data, float sx, float sy, float dx, float dy)
+{
+  (void) ctx;
+  (void) data;
+
+  counts.move += 1;
+  printf("mouseMove %d %f %f -> %f %f\n", (int) id, sx, sy, dx, dy);
+  return true;
+}
+
+bool mouseEnter(guihckContext* ctx, guihckElementId id, void* data, float sx, float sy, float dx, float dy)
+{
+  (void) ctx;
+  (void) data;
+
+  counts.enter += 1;
+  printf("mouseEnter %d %f %f -> %f %f\n", (int) id, sx, sy, dx, dy);
+  return true;
+}
+
+bool mouseExit(guihckContext* ctx, guihckElementId id, void* data, float sx, float sy, float dx, float dy)
+{
+  (void) ctx;
+  (void) data;
+
+  counts.exit += 1;
+  printf("mouseExit %d %f %f -> %f %f\n", (int) id, sx, sy, dx, dy);
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  guihckElementTypeFunctionMap probeMap = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+  guihckMouseAreaFunctionMap mouseAreaMap = {NULL, mouseUp, mouseMove, mouseEnter, mouseExit};
+
+  guihckInit();
+  guihckContext* ctx = guihckContextNew();
+  guihckElementTypeId probeId = guihckElementTypeAdd(ctx, "probe", probeMap, 0);
+
+  guihckElementId id1 = guihckElementNew(ctx, probeId, guihckContextGetRootElement(ctx));
+  guihckElementId id2 = guihckElementNew(ctx, probeId, guihckContextGetRootElement(ctx));
+  guihckMouseAreaId ma1 = guihckMouseAreaNew(ctx, id1, mouseAreaMap);
+  guihckMouseAreaId ma2 = guihckMouseAreaNew(ctx, id2, mouseAreaMap);
+  guihckMouseAreaRect(ctx, ma1, 0, 0, 10, 10);
+  guihckMouseAreaRect(ctx, ma2, 20, 0, 10, 10);
+  guihckContextRender(ctx);
+
+  // Enter, move within and exit
+  guihckContextMouseMove(ctx, 50, 50, 5, 5);
+  assert(counts.enter == 1 && counts.exit == 0 && counts.move == 0);
+  guihckContextMouseMove(ctx, 5, 5, 6, 6);
+  assert(counts.enter == 1 && counts.exit == 0 && counts.move == 1);
+
+  // Jumping straight across areas exits the first one and enters the second
+  guihckContextMouseMove(ctx, 6, 6, 25, 5);
+  assert(counts.enter == 2 && counts.exit == 1 && counts.move == 1);
+
+  // Area moving away under a still pointer exits on update
+  guihckMouseAreaRect(ctx, ma2, 100, 100, 10, 10);
+  guihckContextUpdate(ctx);
+  assert(counts.enter == 2 && counts.exit == 2);
+
+  // Area moving under a still pointer enters on update
+  guihckMouseAreaRect(ctx, ma1, 20, 0, 10, 10);
+  guihckContextUpdate(ctx);
+  assert(counts.enter == 3 && counts.exit == 2);
+
+  // Captured pointer gets moves outside the area without hover changes
+  counts.move = 0;
+  guihckContextCapturePointer(ctx, ma1);
+  assert(guihckContextGetPointerCapture(ctx) == ma1);
+  guihckContextMouseMove(ctx, 25, 5, 105, 105);
+  assert(counts.move == 1 && counts.enter == 3 && counts.exit == 2);
+
+  // Releasing the button ends the capture and resolves hover state
+  guihckContextMouseUp(ctx, 105, 105, 0);
+  assert(counts.up == 1);
+  assert(guihckContextGetPointerCapture(ctx) == GUIHCK_NO_MOUSE_AREA);
+  assert(counts.enter == 4 && counts.exit == 3);
+
+  // Removed areas are dropped from hover tracking silently
+  guihckMouseAreaRemove(ctx, ma2);
+  guihckContextMouseMove(ctx, 105, 105, 0, 0);
+  assert(counts.exit == 3);
+
+  guihckContextFree(ctx);
+
+  return EXIT_SUCCESS;
+}
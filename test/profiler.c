@@ -0,0 +1,97 @@
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+static bool updateProbe(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
+{
+  (void) ctx;
+  (void) id;
+  (void) data;
+  (void) changed;
+
+  return false;
+}
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  guihckElementTypeFunctionMap probeMap = {NULL, NULL, updateProbe, NULL, NULL, NULL, NULL, NULL};
+
+  guihckInit();
+  guihckContext* ctx = guihckContextNew();
+  guihckElementsAddItemType(ctx);
+  guihckElementTypeId probeId = guihckElementTypeAdd(ctx, "probe", probeMap, 0);
+
+  // Disabled by default
+  guihckFrameStats stats;
+  assert(!guihckContextGetProfiling(ctx));
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  assert(!guihckContextGetFrameStats(ctx, &stats));
+
+  // No frame has finished yet
+  guihckContextProfiling(ctx, true);
+  assert(guihckContextGetProfiling(ctx));
+  assert(!guihckContextGetFrameStats(ctx, &stats));
+
+  guihckContextExecuteScript(ctx,
+    "(create-elements!"
+    "  (item (id 'a) (prop 'width 1))"
+    "  (item (id 'b) (prop 'width (bound '(a width) (lambda (w) (* w 2))))))");
+  guihckContextExecuteScript(ctx, "(set-prop! (find-element 'a) 'width 2)");
+  guihckElementNew(ctx, probeId, guihckContextGetRootElement(ctx));
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+
+  assert(guihckContextGetFrameStats(ctx, &stats));
+  assert(stats.frame == 0);
+  assert(stats.frameTime >= 0);
+  assert(stats.bindEvaluations == 2);
+  assert(stats.listenerNotifications >= 1);
+  assert(stats.schemeCalls >= 2);
+  assert(stats.allocations > 0);
+  assert(stats.phases[GUIHCK_PHASE_UPDATE].calls == 1);
+  assert(stats.phases[GUIHCK_PHASE_RENDER].calls == 1);
+  assert(stats.phases[GUIHCK_PHASE_RENDER_ORDER].calls == 1);
+  assert(stats.phases[GUIHCK_PHASE_BINDS].calls == 2);
+  assert(probeId < stats.typeCount);
+  assert(strcmp(stats.types[probeId].name, "probe") == 0);
+  assert(stats.types[probeId].updateCalls == 1);
+
+  // Scheme sees the same frame
+  assert(scm_is_true(guihckContextExecuteScript(ctx, "(= (assq-ref (frame-stats) 'bind-evaluations) 2)")));
+
+  // An idle frame starts from zero
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  assert(guihckContextGetFrameStats(ctx, &stats));
+  assert(stats.frame == 1);
+  assert(stats.bindEvaluations == 0);
+  assert(stats.phases[GUIHCK_PHASE_RENDER_ORDER].calls == 0);
+  assert(stats.types[probeId].updateCalls == 0);
+
+  // Types added later grow the tables, the finished frame stays readable
+  guihckElementTypeId lateId = guihckElementTypeAdd(ctx, "late", probeMap, 0);
+  guihckElementNew(ctx, lateId, guihckContextGetRootElement(ctx));
+  guihckContextUpdate(ctx);
+  assert(guihckContextGetFrameStats(ctx, &stats));
+  assert(stats.frame == 1);
+  assert(strcmp(stats.types[probeId].name, "probe") == 0);
+  guihckContextRender(ctx);
+  assert(guihckContextGetFrameStats(ctx, &stats));
+  assert(lateId < stats.typeCount);
+  assert(stats.types[lateId].updateCalls == 1);
+
+  guihckContextProfiling(ctx, false);
+  assert(!guihckContextGetFrameStats(ctx, &stats));
+  assert(scm_is_false(guihckContextExecuteScript(ctx, "(frame-stats)")));
+
+  guihckContextFree(ctx);
+
+  return EXIT_SUCCESS;
+}
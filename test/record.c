@@ -0,0 +1,157 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "guihck.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+
+static char eventLog[1024];
+
+static void logEvent(guihckContext* ctx, const char* event, double value)
+{
+  size_t length = strlen(eventLog);
+  snprintf(eventLog + length, sizeof(eventLog) - length, "%s %g @%g\n", event, value, guihckContextGetTime(ctx));
+}
+
+static bool updateProbe(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
+{
+  (void) id;
+  (void) data;
+  (void) changed;
+
+  logEvent(ctx, "update", 0);
+  return false;
+}
+
+static bool keyEventProbe(guihckContext* ctx, guihckElementId id, guihckKey key, int scancode, guihckKeyAction action, guihckKeyMods mods, void* data)
+{
+  (void) id;
+  (void) scancode;
+  (void) action;
+  (void) mods;
+  (void) data;
+
+  logEvent(ctx, "key", key);
+  return true;
+}
+
+static bool keyCharProbe(guihckContext* ctx, guihckElementId id, unsigned int codepoint, void* data)
+{
+  (void) id;
+  (void) data;
+
+  logEvent(ctx, "char", codepoint);
+  return true;
+}
+
+static bool mouseDownProbe(guihckContext* ctx, guihckElementId id, void* data, int button, float x, float y)
+{
+  (void) id;
+  (void) data;
+  (void) y;
+
+  logEvent(ctx, "down", x + button);
+  return true;
+}
+
+static bool mouseMoveProbe(guihckContext* ctx, guihckElementId id, void* data, float sx, float sy, float dx, float dy)
+{
+  (void) id;
+  (void) data;
+  (void) sx;
+  (void) sy;
+  (void) dy;
+
+  logEvent(ctx, "move", dx);
+  return true;
+}
+
+static guihckContext* createContext()
+{
+  guihckElementTypeFunctionMap probeMap = {NULL, NULL, updateProbe, NULL, keyEventProbe, keyCharProbe, NULL, NULL};
+  guihckMouseAreaFunctionMap mouseMap = {mouseDownProbe, NULL, mouseMoveProbe, NULL, NULL};
+
+  guihckContext* ctx = guihckContextNew();
+  guihckElementTypeId probeId = guihckElementTypeAdd(ctx, "probe", probeMap, 0);
+  guihckElementId probe = guihckElementNew(ctx, probeId, guihckContextGetRootElement(ctx));
+  guihckMouseAreaId mouseArea = guihckMouseAreaNew(ctx, probe, mouseMap);
+  guihckMouseAreaRect(ctx, mouseArea, 0, 0, 100, 100);
+  guihckContextKeyboardFocus(ctx, probe);
+  return ctx;
+}
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  char path[] = "/tmp/guihck-record-XXXXXX";
+  int fd = mkstemp(path);
+  assert(fd != -1);
+  close(fd);
+
+  guihckInit();
+
+  // Record a short session
+  guihckContext* ctx = createContext();
+  assert(guihckContextRecordStart(ctx, path));
+  guihckContextTime(ctx, 0.5);
+  guihckContextKeyboardKey(ctx, GUIHCK_KEY_A, 0, GUIHCK_KEY_PRESS, 0);
+  guihckContextKeyboardChar(ctx, 'a');
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  guihckContextTime(ctx, 1.25);
+  guihckContextMouseMove(ctx, 10, 10, 20, 20);
+  guihckContextMouseDown(ctx, 20, 20, 1);
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  guihckContextRecordStop(ctx);
+
+  // Calls after stopping are not recorded
+  guihckContextKeyboardChar(ctx, 'b');
+  guihckContextFree(ctx);
+
+  char recorded[sizeof(eventLog)];
+  strcpy(recorded, eventLog);
+  printf("%s", recorded);
+  assert(strstr(recorded, "char 98") != NULL);
+  eventLog[0] = '\0';
+
+  // Replaying on a fresh context gives the same events at the same times
+  ctx = createContext();
+  guihckReplay* replay = guihckReplayOpen(path);
+  assert(replay);
+
+  const guihckRecordType expected[] = {
+    GUIHCK_RECORD_TIME, GUIHCK_RECORD_KEY, GUIHCK_RECORD_CHAR, GUIHCK_RECORD_UPDATE, GUIHCK_RECORD_RENDER,
+    GUIHCK_RECORD_TIME, GUIHCK_RECORD_MOUSE_MOVE, GUIHCK_RECORD_MOUSE_DOWN, GUIHCK_RECORD_UPDATE, GUIHCK_RECORD_RENDER,
+    GUIHCK_RECORD_END
+  };
+  size_t i;
+  for(i = 0; i < sizeof(expected) / sizeof(expected[0]); ++i)
+  {
+    assert(guihckReplayStep(replay, ctx) == expected[i]);
+  }
+  assert(guihckReplayStep(replay, ctx) == GUIHCK_RECORD_END);
+  guihckReplayClose(replay);
+
+  printf("%s", eventLog);
+  assert(guihckContextGetTime(ctx) == 1.25);
+  assert(strncmp(recorded, eventLog, strlen(eventLog)) == 0);
+  assert(strlen(recorded) == strlen(eventLog) + strlen("char 98 @1.25\n"));
+  guihckContextFree(ctx);
+
+  // Anything else is rejected
+  assert(!guihckReplayOpen("/nonexistent/recording"));
+  FILE* file = fopen(path, "w");
+  fputs("not a recording", file);
+  fclose(file);
+  assert(!guihckReplayOpen(path));
+
+  unlink(path);
+
+  return EXIT_SUCCESS;
+}
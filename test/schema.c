@@ -0,0 +1,160 @@
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+typedef struct probeData
+{
+  int updates;
+  guihckPropertyMask changed;
+} probeData;
+
+static bool updateProbe(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
+{
+  (void) ctx;
+  (void) id;
+
+  ((probeData*) data)->updates += 1;
+  ((probeData*) data)->changed = changed;
+  return false;
+}
+
+static const guihckPropertySchema probeSchema[] = {
+  {"width", GUIHCK_VALUE_F32, {.f32 = 10}, true},
+  {"count", GUIHCK_VALUE_I32, {.i32 = 3}, false},
+  {"enabled", GUIHCK_VALUE_BOOL, {.boolean = true}, false},
+  {"color", GUIHCK_VALUE_COLOR, {.color = {1, 2, 3, 4}}, true},
+  {"label", GUIHCK_VALUE_STRING, {.string = "none"}, true}
+};
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  guihckElementTypeFunctionMap probeMap = {NULL, NULL, updateProbe, NULL, NULL, NULL, NULL, NULL};
+
+  guihckInit();
+  guihckContext* ctx = guihckContextNew();
+  guihckElementsAddAllTypes(ctx);
+  guihckElementTypeId probeId = guihckElementTypeAdd(ctx, "probe", probeMap, sizeof(probeData));
+  guihckElementTypeSchema(ctx, probeId, probeSchema, sizeof(probeSchema) / sizeof(guihckPropertySchema));
+  guihckElementTypeId itemId = guihckTypeRegistryGetType(guihckContextGetTypes(ctx), "item");
+
+  size_t count;
+  const guihckPropertySchema* schema = guihckTypeRegistryGetSchema(guihckContextGetTypes(ctx), probeId, &count);
+  assert(count == 5 && strcmp(schema[4].name, "label") == 0);
+  assert(!guihckTypeRegistryGetSchema(guihckContextGetTypes(ctx), itemId, &count) && count == 0);
+
+  guihckElementId root = guihckContextGetRootElement(ctx);
+  guihckElementId probe = guihckElementNew(ctx, probeId, root);
+  probeData* probeState = guihckElementGetData(ctx, probe);
+
+  // Unset properties read as their defaults
+  assert(guihckElementGetFloat(ctx, probe, "width") == 10);
+  assert(guihckElementGetInt(ctx, probe, "count") == 3);
+  assert(guihckElementGetBool(ctx, probe, "enabled"));
+  guihckColor color = guihckElementGetColor(ctx, probe, "color");
+  assert(color.r == 1 && color.g == 2 && color.b == 3 && color.a == 4);
+  assert(strcmp(guihckElementGetString(ctx, probe, "label"), "none") == 0);
+
+  // Values are converted when set
+  guihckElementProperty(ctx, probe, "width", scm_from_int(42));
+  guihckElementProperty(ctx, probe, "count", scm_from_double(2.6));
+  guihckElementProperty(ctx, probe, "enabled", SCM_BOOL_F);
+  guihckElementProperty(ctx, probe, "color", scm_list_3(scm_from_int(300), scm_from_double(127.6), scm_from_int(-5)));
+  guihckElementProperty(ctx, probe, "label", scm_from_utf8_string("hello"));
+  assert(guihckElementGetFloat(ctx, probe, "width") == 42);
+  assert(guihckElementGetInt(ctx, probe, "count") == 3);
+  assert(!guihckElementGetBool(ctx, probe, "enabled"));
+  color = guihckElementGetColor(ctx, probe, "color");
+  assert(color.r == 255 && color.g == 128 && color.b == 0 && color.a == 255);
+  assert(strcmp(guihckElementGetString(ctx, probe, "label"), "hello") == 0);
+
+  // Invalid values read as the default until a valid one is set
+  guihckElementProperty(ctx, probe, "width", scm_from_utf8_string("wide"));
+  guihckElementProperty(ctx, probe, "color", scm_list_2(scm_from_int(0), scm_from_int(0)));
+  guihckElementProperty(ctx, probe, "label", scm_from_int(5));
+  assert(guihckElementGetFloat(ctx, probe, "width") == 10);
+  assert(guihckElementGetColor(ctx, probe, "color").r == 1);
+  assert(strcmp(guihckElementGetString(ctx, probe, "label"), "none") == 0);
+  guihckElementProperty(ctx, probe, "width", scm_from_int(42));
+  assert(guihckElementGetFloat(ctx, probe, "width") == 42);
+
+  // Declared properties mark the element dirty without listeners, new elements get every bit
+  guihckContextUpdate(ctx);
+  assert(probeState->changed == GUIHCK_PROPERTY_MASK_ALL);
+  int before = probeState->updates;
+  guihckContextUpdate(ctx);
+  assert(probeState->updates == before);
+  guihckElementProperty(ctx, probe, "count", scm_from_int(7));
+  guihckContextUpdate(ctx);
+  assert(probeState->updates == before);
+  guihckElementProperty(ctx, probe, "width", scm_from_int(7));
+  guihckContextUpdate(ctx);
+  assert(probeState->updates == before + 1);
+  assert(probeState->changed == GUIHCK_PROPERTY_BIT(0));
+
+  // Changes add up until the update, the mask is cleared after it
+  guihckElementProperty(ctx, probe, "width", scm_from_int(8));
+  guihckElementProperty(ctx, probe, "count", scm_from_int(8));
+  guihckElementProperty(ctx, probe, "label", scm_from_utf8_string("bits"));
+  guihckContextUpdate(ctx);
+  assert(probeState->changed == (GUIHCK_PROPERTY_BIT(0) | GUIHCK_PROPERTY_BIT(4)));
+  guihckElementDirty(ctx, probe);
+  guihckContextUpdate(ctx);
+  assert(probeState->changed == GUIHCK_PROPERTY_MASK_ALL);
+  assert(probeState->updates == before + 3);
+
+  // Aliases and binds are converted like plain values
+  guihckStackPushElement(ctx, root);
+  guihckContextExecuteScript(ctx,
+    "(create-elements!"
+    "  (item (id 'source) (prop 'size 5) (prop 'name \"first\"))"
+    "  (create-element 'probe (list (id 'target) (prop 'width (bound '(source size) (lambda (s) (* s 2))))"
+    "                               (alias 'label 'source 'name))))");
+  guihckStackPopElement(ctx);
+  guihckStackPushElementById(ctx, "source");
+  guihckElementId source = guihckStackGetElement(ctx);
+  guihckStackPopElement(ctx);
+  guihckStackPushElementById(ctx, "target");
+  guihckElementId target = guihckStackGetElement(ctx);
+  guihckStackPopElement(ctx);
+
+  assert(guihckElementGetFloat(ctx, target, "width") == 10);
+  assert(strcmp(guihckElementGetString(ctx, target, "label"), "first") == 0);
+  guihckElementProperty(ctx, source, "size", scm_from_double(1.5));
+  guihckElementProperty(ctx, source, "name", scm_from_utf8_string("second"));
+  assert(guihckElementGetFloat(ctx, target, "width") == 3);
+  assert(strcmp(guihckElementGetString(ctx, target, "label"), "second") == 0);
+
+  // Undeclared properties are converted on read, strings are kept by the context
+  assert(guihckElementGetFloat(ctx, source, "size") == 1.5f);
+  assert(guihckElementGetInt(ctx, source, "size") == 2);
+  assert(guihckElementGetFloat(ctx, source, "missing") == 0);
+  assert(strcmp(guihckElementGetString(ctx, source, "name"), "second") == 0);
+  assert(!guihckElementGetString(ctx, source, "size"));
+
+  // Stale lazy binds mark their element and are evaluated by typed reads
+  guihckStackPushElement(ctx, root);
+  guihckContextExecuteScript(ctx,
+    "(create-elements!"
+    "  (create-element 'probe (list (id 'lazy) (prop 'width (lazy-bound '(source size) (lambda (s) (* s 4)))))))");
+  guihckStackPopElement(ctx);
+  guihckStackPushElementById(ctx, "lazy");
+  guihckElementId lazy = guihckStackGetElement(ctx);
+  guihckStackPopElement(ctx);
+  probeData* lazyState = guihckElementGetData(ctx, lazy);
+
+  guihckContextUpdate(ctx);
+  guihckElementProperty(ctx, source, "size", scm_from_int(2));
+  guihckContextUpdate(ctx);
+  assert(lazyState->changed == GUIHCK_PROPERTY_BIT(0));
+  assert(guihckElementGetFloat(ctx, lazy, "width") == 8);
+
+  guihckContextFree(ctx);
+
+  return 0;
+}
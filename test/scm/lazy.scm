@@ -0,0 +1,72 @@
+(import (rnrs (6)))
+
+(define evaluations 0)
+
+(create-elements!
+  (item
+    (id 'source)
+    (prop 'value 1))
+  (item
+    (id 'label)
+    (prop 'text (lazy-bound '(source value)
+      (lambda (v) (set! evaluations (+ evaluations 1)) (* v 10)))))
+  (item
+    (id 'observed)
+    (prop 'value (lazy-bound '(source value)
+      (lambda (v) (* v 2)))))
+  (item
+    (id 'watcher)
+    (prop 'value (bound '(observed value)
+      (lambda (v) (* v 2))))))
+
+(define (display-all . things) (for-each display things))
+
+(define (test id key value)
+  (begin
+    (display-all id ": " (get-prop (find-element id) key) " = " value "\n")
+    (assert (equal? (get-prop (find-element id) key) value))))
+
+; Evaluated once when created
+(assert (= evaluations 1))
+(test 'label 'text 10)
+
+; Changes only mark it stale
+(set-prop! (find-element 'source) 'value 2)
+(set-prop! (find-element 'source) 'value 3)
+(set-prop! (find-element 'source) 'value 4)
+(assert (= evaluations 1))
+
+; The next read evaluates once
+(test 'label 'text 40)
+(assert (= evaluations 2))
+(test 'label 'text 40)
+(assert (= evaluations 2))
+
+; Lazy binds with listeners notify right away
+(test 'observed 'value 8)
+(test 'watcher 'value 16)
+(set-prop! (find-element 'source) 'value 5)
+(test 'watcher 'value 20)
+(test 'observed 'value 10)
+
+; Binding or aliasing a stale lazy bind reads it before listening
+(create-elements!
+  (item
+    (id 'stale-1)
+    (prop 'value (lazy-bound '(source value) (lambda (v) (* v 3)))))
+  (item
+    (id 'stale-2)
+    (prop 'value (lazy-bound '(source value) (lambda (v) (* v 4))))))
+(set-prop! (find-element 'source) 'value 6)
+(create-elements!
+  (item
+    (id 'late-bind)
+    (prop 'value (bound '(stale-1 value) (lambda (v) (+ v 1)))))
+  (item
+    (id 'late-alias)
+    (alias 'value 'stale-2 'value)))
+(test 'late-bind 'value 19)
+(test 'late-alias 'value 24)
+(set-prop! (find-element 'source) 'value 7)
+(test 'late-bind 'value 22)
+(test 'late-alias 'value 28)
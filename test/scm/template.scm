@@ -0,0 +1,49 @@
+(import (rnrs (6)))
+
+(define (double x) (* x 2))
+(define init-count 0)
+
+(define button
+  (make-template
+    (item
+      (prop 'width 10)
+      (prop 'height (bound '(this width) double))
+      (prop 'init (lambda () (set! init-count (+ init-count 1))))
+      (item (alias 'width 'parent 'width)))))
+
+(create-elements! (item (id 'container)))
+
+(push-element! (find-element 'container))
+(define first-button (instantiate-template! button (id 'first)))
+(define second-button (instantiate-template! button (prop 'width 30)))
+(pop-element!)
+
+(define (display-all . things) (for-each display things))
+
+(define (test element property value)
+  (begin
+    (display-all element " " property ": " (get-prop element property) " = " value "\n")
+    (assert (equal? (get-prop element property) value))))
+
+; Each instance runs its own init
+(assert (= init-count 2))
+(assert (= (length (get-prop (find-element 'container) 'children)) 2))
+
+; Overrides win over recorded properties
+(test first-button 'id 'first)
+(test first-button 'height 20)
+(test second-button 'height 60)
+(test (child second-button 0) 'width 30)
+
+; Binds and aliases are wired per instance
+(set-prop! first-button 'width 5)
+(test first-button 'height 10)
+(test (child first-button 0) 'width 5)
+(test second-button 'height 60)
+
+; The template keeps its recorded values through collections
+(gc)
+(push-element! (find-element 'container))
+(define third-button (instantiate-template! button))
+(pop-element!)
+(test third-button 'height 20)
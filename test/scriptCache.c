@@ -0,0 +1,109 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <dirent.h>
+#include <unistd.h>
+
+static void writeScript(const char* path, const char* script)
+{
+  /* No terminating newline or NUL, the loader must not rely on either */
+  FILE* file = fopen(path, "wb");
+  assert(file);
+  fwrite(script, 1, strlen(script), file);
+  fclose(file);
+}
+
+static int countCachedScripts(const char* directory)
+{
+  int count = 0;
+  DIR* dir = opendir(directory);
+  assert(dir);
+
+  struct dirent* entry;
+  while((entry = readdir(dir)))
+  {
+    size_t length = strlen(entry->d_name);
+    if(length > 3 && strcmp(entry->d_name + length - 3, ".go") == 0)
+      ++count;
+  }
+
+  closedir(dir);
+  return count;
+}
+
+static void removeDirectory(const char* directory)
+{
+  DIR* dir = opendir(directory);
+  struct dirent* entry;
+  while((entry = readdir(dir)))
+  {
+    char path[1024];
+    if(strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+      continue;
+    snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+    unlink(path);
+  }
+  closedir(dir);
+  rmdir(directory);
+}
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  char directory[] = "/tmp/guihck-script-cache-XXXXXX";
+  assert(mkdtemp(directory));
+
+  char scriptPath[1024];
+  snprintf(scriptPath, sizeof(scriptPath), "%s/script.scm", directory);
+
+  guihckInit();
+  guihckContext* ctx = guihckContextNew();
+  guihckElementsAddItemType(ctx);
+
+  // Uncached
+  guihckContextSetScriptCacheDirectory(ctx, NULL);
+  writeScript(scriptPath, "(define cache-test-value (+ 40 2)) (= cache-test-value 42)");
+  assert(scm_is_true(guihckContextExecuteScriptFile(ctx, scriptPath)));
+  assert(countCachedScripts(directory) == 0);
+
+  // First run compiles, second loads from the cache
+  guihckContextSetScriptCacheDirectory(ctx, directory);
+  assert(strcmp(guihckContextGetScriptCacheDirectory(ctx), directory) == 0);
+  assert(scm_is_true(guihckContextExecuteScriptFile(ctx, scriptPath)));
+  assert(countCachedScripts(directory) == 1);
+  assert(scm_is_true(guihckContextExecuteScriptFile(ctx, scriptPath)));
+  assert(countCachedScripts(directory) == 1);
+
+  // Cached scripts define into the current module like uncached ones, the
+  // changed script replaces its earlier entry
+  writeScript(scriptPath, "(item (id 'cached)) (= cache-test-value 42)");
+  assert(scm_is_true(guihckContextExecuteScriptFile(ctx, scriptPath)));
+  assert(countCachedScripts(directory) == 1);
+
+  // Other scripts keep their own entries
+  char otherPath[1024];
+  snprintf(otherPath, sizeof(otherPath), "%s/other.scm", directory);
+  writeScript(otherPath, "(= cache-test-value 42)");
+  assert(scm_is_true(guihckContextExecuteScriptFile(ctx, otherPath)));
+  assert(countCachedScripts(directory) == 2);
+
+  // Empty scripts compile too
+  writeScript(otherPath, "");
+  guihckContextExecuteScriptFile(ctx, otherPath);
+  assert(countCachedScripts(directory) == 2);
+
+  // Missing files
+  assert(guihckContextExecuteScriptFile(ctx, "/nonexistent/script.scm") == SCM_UNDEFINED);
+
+  guihckContextFree(ctx);
+  removeDirectory(directory);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,164 @@
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+static bool updateProbe(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
+{
+  (void) data;
+  (void) changed;
+
+  guihckRenderCommand command;
+  memset(&command, 0, sizeof(guihckRenderCommand));
+  command.type = GUIHCK_COMMAND_QUAD;
+  command.x = scm_to_double(guihckElementGetProperty(ctx, id, "absolute-x"));
+  command.y = scm_to_double(guihckElementGetProperty(ctx, id, "absolute-y"));
+  guihckElementClearCommands(ctx, id);
+  guihckElementAddCommand(ctx, id, &command);
+  return false;
+}
+
+static guihckElementId findElement(guihckContext* ctx, const char* id)
+{
+  guihckStackPushElementById(ctx, id);
+  guihckElementId elementId = guihckStackGetElement(ctx);
+  guihckStackPopElement(ctx);
+  return elementId;
+}
+
+static double getReal(guihckContext* ctx, guihckElementId id, const char* key)
+{
+  return scm_to_double(guihckElementGetProperty(ctx, id, key));
+}
+
+static bool getBool(guihckContext* ctx, guihckElementId id, const char* key)
+{
+  return scm_is_true(guihckElementGetProperty(ctx, id, key));
+}
+
+static void frame(guihckContext* ctx, double time)
+{
+  guihckContextTime(ctx, time);
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+}
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  guihckElementTypeFunctionMap probeMap = {NULL, NULL, updateProbe, NULL, NULL, NULL, NULL, NULL};
+
+  guihckInit();
+  guihckContext* ctx = guihckContextNew();
+  guihckElementsAddAllTypes(ctx);
+  guihckElementTypeId probeId = guihckElementTypeAdd(ctx, "probe", probeMap, 0);
+  guihckElementId root = guihckContextGetRootElement(ctx);
+  guihckElementProperty(ctx, root, "width", scm_from_int(100));
+  guihckElementProperty(ctx, root, "height", scm_from_int(100));
+
+  guihckContextTime(ctx, 0);
+  guihckContextExecuteScript(ctx,
+    "(create-elements!"
+    "  (scroll-view (id 'view) (prop 'width 50) (prop 'height 50) (prop 'content-height 200)"
+    "    (mouse-area (id 'area) (prop 'y 70) (prop 'width 50) (prop 'height 10)"
+    "      (prop 'on-mouse-down (lambda (b x y) #t)) (prop 'on-mouse-move (lambda (sx sy dx dy) #t)))))");
+
+  guihckElementId view = findElement(ctx, "view");
+  guihckElementId area = findElement(ctx, "area");
+  guihckElementId probe = guihckElementNew(ctx, probeId, view);
+  guihckElementProperty(ctx, probe, "absolute-x", scm_from_int(0));
+  guihckElementProperty(ctx, probe, "absolute-y", scm_from_int(60));
+  guihckElementProperty(ctx, probe, "width", scm_from_int(10));
+  guihckElementProperty(ctx, probe, "height", scm_from_int(10));
+
+  frame(ctx, 0);
+  assert(guihckElementGetCulled(ctx, probe));
+
+  // Scrolling moves the content on screen without touching its properties
+  guihckElementProperty(ctx, view, "content-y", scm_from_int(30));
+  frame(ctx, 0);
+  float x, y, width, height;
+  guihckElementGetChildOffset(ctx, view, &x, &y);
+  assert(x == 0 && y == -30);
+  guihckElementGetTranslation(ctx, probe, &x, &y);
+  assert(x == 0 && y == -30);
+  assert(getReal(ctx, probe, "absolute-y") == 60);
+  assert(guihckElementGetVisibleBounds(ctx, probe, &x, &y, &width, &height));
+  assert(y == 30 && height == 10);
+
+  // Hit testing follows the content
+  guihckContextMouseDown(ctx, 10, 45, 0);
+  assert(getBool(ctx, area, "pressed"));
+  guihckContextMouseUp(ctx, 10, 45, 0);
+  guihckContextMouseDown(ctx, 10, 75, 0);
+  assert(!getBool(ctx, area, "pressed"));
+  guihckContextMouseUp(ctx, 10, 75, 0);
+
+  // Small moves stay with the content, larger ones drag it even over content handling the press
+  guihckContextTime(ctx, 1);
+  guihckContextMouseDown(ctx, 20, 40, 0);
+  assert(getBool(ctx, area, "pressed"));
+  guihckContextMouseMove(ctx, 20, 40, 20, 38);
+  assert(guihckContextGetPointerCapture(ctx) == GUIHCK_NO_MOUSE_AREA);
+  guihckContextTime(ctx, 1.1);
+  guihckContextMouseMove(ctx, 20, 38, 20, 20);
+  assert(guihckContextGetPointerCapture(ctx) != GUIHCK_NO_MOUSE_AREA);
+  assert(!getBool(ctx, area, "pressed"));
+  assert(getReal(ctx, view, "content-y") == 50);
+  frame(ctx, 1.1);
+  assert(getBool(ctx, view, "moving"));
+
+  // Released drags keep going and slow down
+  guihckContextMouseUp(ctx, 20, 20, 0);
+  assert(guihckContextGetPointerCapture(ctx) == GUIHCK_NO_MOUSE_AREA);
+  frame(ctx, 1.2);
+  double flicked = getReal(ctx, view, "content-y");
+  assert(flicked > 50 && getBool(ctx, view, "moving"));
+
+  int t;
+  for(t = 3; t < 10; ++t)
+    frame(ctx, 1 + t * 0.1);
+  assert(!getBool(ctx, view, "moving"));
+  assert(getReal(ctx, view, "content-y") > flicked);
+
+  // Content stops at its edges
+  guihckElementProperty(ctx, view, "content-y", scm_from_int(500));
+  frame(ctx, 2);
+  assert(getReal(ctx, view, "content-y") == 150);
+
+  // Retained rendering moves commands with a transform, their positions stay absolute
+  guihckElementProperty(ctx, view, "content-y", scm_from_int(30));
+  guihckContextRetainedRendering(ctx, true);
+  frame(ctx, 2);
+  size_t count;
+  const guihckRenderCommand* commands = guihckContextGetRenderCommands(ctx, &count);
+  size_t i;
+  int depth = 0;
+  bool drawn = false;
+  for(i = 0; i < count; ++i)
+  {
+    if(commands[i].type == GUIHCK_COMMAND_TRANSFORM_PUSH)
+    {
+      assert(commands[i].elementId == view && commands[i].y == -30);
+      depth += 1;
+    }
+    else if(commands[i].type == GUIHCK_COMMAND_TRANSFORM_POP)
+    {
+      depth -= 1;
+    }
+    else if(commands[i].elementId == probe)
+    {
+      assert(depth == 1 && commands[i].y == 60);
+      drawn = true;
+    }
+  }
+  assert(drawn && depth == 0);
+
+  guihckContextFree(ctx);
+
+  return 0;
+}
@@ -16,10 +16,11 @@ void destroyFoo(guihckContext* ctx, guihckElementId id, void* data)
 
   printf("Destroy foo %d\n", (int) id);
 }
-bool updateFoo(guihckContext* ctx, guihckElementId id, void* data)
+bool updateFoo(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
 {  
   (void) ctx;
   (void) data;
+  (void) changed;
 
   printf("Updating foo %d\n", (int) id);
   return true;
@@ -38,7 +39,7 @@ int main(int argc, char** argv)
   (void) argc;
   (void) argv;
 
-  guihckElementTypeFunctionMap fooMap = {initFoo, destroyFoo, updateFoo, renderFoo, NULL, NULL};
+  guihckElementTypeFunctionMap fooMap = {initFoo, destroyFoo, updateFoo, renderFoo, NULL, NULL, NULL, NULL};
 
   guihckInit();
   // Trivial test for context
@@ -0,0 +1,150 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+static const char* tree =
+  "(create-elements!"
+  "  (item"
+  "    (id 'a)"
+  "    (prop 'width 10)"
+  "    (prop 'label \"hello\")"
+  "    (prop 'values '(1 2.5 #\\x sym #(1 2)))"
+  "    (item"
+  "      (id 'b)"
+  "      (prop 'width (bound '(parent width) double))"
+  "      (alias 'label 'parent 'label))))";
+
+static guihckContext* newContext()
+{
+  guihckContext* ctx = guihckContextNew();
+  guihckElementsAddItemType(ctx);
+  guihckContextExecuteScript(ctx, "(define (double x) (* x 2))");
+  return ctx;
+}
+
+static void setVersion(const char* path, uint32_t version)
+{
+  /* The version follows the 8 byte magic */
+  FILE* file = fopen(path, "r+b");
+  assert(file);
+  fseek(file, 8, SEEK_SET);
+  size_t written = fwrite(&version, sizeof(uint32_t), 1, file);
+  assert(written == 1);
+  (void) written;
+  fclose(file);
+}
+
+static bool check(guihckContext* ctx, const char* expression)
+{
+  return scm_is_true(guihckContextExecuteScript(ctx, expression));
+}
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  char path[] = "/tmp/guihck-snapshot-XXXXXX";
+  int fd = mkstemp(path);
+  assert(fd >= 0);
+  close(fd);
+
+  guihckInit();
+  guihckContext* ctx = newContext();
+  guihckContextExecuteScript(ctx, tree);
+  assert(guihckContextSaveSnapshot(ctx, path));
+  guihckContextFree(ctx);
+
+  // Values, binds and aliases come back
+  ctx = newContext();
+  assert(guihckContextLoadSnapshot(ctx, path));
+  assert(check(ctx, "(= (get-prop (find-element 'b) 'width) 20)"));
+  assert(check(ctx, "(equal? (get-prop (find-element 'b) 'label) \"hello\")"));
+  assert(check(ctx, "(equal? (get-prop (find-element 'a) 'values) '(1 2.5 #\\x sym #(1 2)))"));
+
+  // and stay connected
+  guihckContextExecuteScript(ctx, "(set-prop! (find-element 'a) 'width 21)");
+  guihckContextExecuteScript(ctx, "(set-prop! (find-element 'b) 'label \"world\")");
+  assert(check(ctx, "(= (get-prop (find-element 'b) 'width) 42)"));
+  assert(check(ctx, "(equal? (get-prop (find-element 'a) 'label) \"world\")"));
+
+  // Snapshots of a restored tree restore again
+  assert(guihckContextSaveSnapshot(ctx, path));
+  guihckContextFree(ctx);
+  ctx = newContext();
+  assert(guihckContextLoadSnapshot(ctx, path));
+  assert(check(ctx, "(= (get-prop (find-element 'b) 'width) 42)"));
+  guihckContextFree(ctx);
+
+  // Version 1 files still load, unless they claim to hold lazy binds it did not have
+  setVersion(path, 1);
+  ctx = newContext();
+  assert(guihckContextLoadSnapshot(ctx, path));
+  assert(check(ctx, "(= (get-prop (find-element 'b) 'width) 42)"));
+  guihckContextFree(ctx);
+
+  ctx = newContext();
+  guihckContextExecuteScript(ctx, "(create-elements! (item (id 'a) (prop 'width 1) (item (id 'b) (prop 'width (lazy-bound '(parent width) double)))))");
+  assert(guihckContextSaveSnapshot(ctx, path));
+  guihckContextFree(ctx);
+  ctx = newContext();
+  assert(guihckContextLoadSnapshot(ctx, path));
+  assert(check(ctx, "(= (get-prop (find-element 'b) 'width) 2)"));
+  guihckContextFree(ctx);
+  setVersion(path, 1);
+  ctx = newContext();
+  assert(!guihckContextLoadSnapshot(ctx, path));
+  guihckContextFree(ctx);
+  setVersion(path, 3);
+  ctx = newContext();
+  assert(!guihckContextLoadSnapshot(ctx, path));
+  guihckContextFree(ctx);
+  setVersion(path, 2);
+
+  // Long lists are not nested in the file
+  ctx = newContext();
+  guihckContextExecuteScript(ctx, "(create-elements! (item (id 'long) (prop 'values (iota 100000))))");
+  assert(guihckContextSaveSnapshot(ctx, path));
+  guihckContextFree(ctx);
+  ctx = newContext();
+  assert(guihckContextLoadSnapshot(ctx, path));
+  assert(check(ctx, "(equal? (get-prop (find-element 'long) 'values) (iota 100000))"));
+
+  // Only empty contexts load snapshots
+  assert(!guihckContextLoadSnapshot(ctx, path));
+  guihckContextFree(ctx);
+
+  // Truncated files are refused without leaving a partial tree
+  ctx = newContext();
+  guihckContextExecuteScript(ctx, tree);
+  assert(guihckContextSaveSnapshot(ctx, path));
+  guihckContextFree(ctx);
+  int truncated = truncate(path, 64);
+  assert(truncated == 0);
+  (void) truncated;
+  ctx = newContext();
+  assert(!guihckContextLoadSnapshot(ctx, path));
+  assert(guihckElementGetChildCount(ctx, guihckContextGetRootElement(ctx)) == 0);
+  guihckContextFree(ctx);
+
+  // Anonymous procedures can not be stored
+  ctx = newContext();
+  guihckContextExecuteScript(ctx, "(create-elements! (item (id 'c) (prop 'width (bound '(parent width) (lambda (x) x)))))");
+  assert(!guihckContextSaveSnapshot(ctx, path));
+  guihckContextFree(ctx);
+
+  // Unknown element types are refused before anything is created
+  ctx = guihckContextNew();
+  assert(!guihckContextLoadSnapshot(ctx, path));
+  assert(guihckElementGetChildCount(ctx, guihckContextGetRootElement(ctx)) == 0);
+  guihckContextFree(ctx);
+
+  unlink(path);
+  return EXIT_SUCCESS;
+}
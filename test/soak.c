@@ -0,0 +1,85 @@
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define WARMUP_ROUNDS 20
+#define SOAK_ROUNDS 500
+
+/* Builds and tears down the same subtree over and over. Once warmed up
+ * the accounted memory and protected objects must not grow. */
+static void soakRound(guihckContext* ctx, guihckElementTypeId itemType, int i)
+{
+  guihckElementId container = guihckElementNew(ctx, itemType, guihckContextGetRootElement(ctx));
+  guihckStackPushElement(ctx, container);
+  guihckContextExecuteScript(ctx,
+    "(begin"
+    "  (create-elements!"
+    "    (item (id 'soak-a) (prop 'width 10) (prop 'label \"soak\")"
+    "      (mouse-area (id 'soak-m) (prop 'width (bound '(soak-a width)))))"
+    "    (item (id 'soak-b)"
+    "      (prop 'width (bound '(soak-a width) (lambda (w) (* w 2))))"
+    "      (alias 'label 'soak-a 'label)))"
+    "  (bind (find-element 'soak-a) 'width (lambda (w) w)))");
+  guihckStackPopElement(ctx);
+
+  guihckStackPushElement(ctx, container);
+  guihckStackPushElementById(ctx, "soak-a");
+  guihckStackElementProperty(ctx, "width", scm_from_int(i));
+  guihckStackElementProperty(ctx, "label", scm_from_utf8_string("changed"));
+  guihckStackPopElement(ctx);
+  guihckStackPopElement(ctx);
+
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  guihckElementRemove(ctx, container);
+}
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  guihckInit();
+  guihckContext* ctx = guihckContextNew();
+  guihckElementsAddAllTypes(ctx);
+  guihckElementTypeId itemType = guihckTypeRegistryGetType(guihckContextGetTypes(ctx), "item");
+
+  guihckMemoryStats before;
+  if(!guihckContextGetMemoryStats(ctx, &before))
+  {
+    printf("Built without GUIHCK_MEMORY_ACCOUNTING, nothing to check\n");
+    guihckContextFree(ctx);
+    return EXIT_SUCCESS;
+  }
+
+  int i;
+  for(i = 0; i < WARMUP_ROUNDS; ++i)
+    soakRound(ctx, itemType, i);
+  guihckContextGetMemoryStats(ctx, &before);
+
+  for(i = 0; i < SOAK_ROUNDS; ++i)
+    soakRound(ctx, itemType, i);
+
+  guihckMemoryStats after;
+  guihckContextGetMemoryStats(ctx, &after);
+
+  bool grew = after.protectedObjects > before.protectedObjects;
+  printf("protected objects: %lu -> %lu\n", (unsigned long) before.protectedObjects, (unsigned long) after.protectedObjects);
+  int c;
+  for(c = 0; c < GUIHCK_MEMORY_CATEGORY_COUNT; ++c)
+  {
+    printf("%-12s %8lu -> %8lu bytes, %6lu -> %6lu allocations\n", guihckMemoryCategoryName(c),
+           (unsigned long) before.bytes[c], (unsigned long) after.bytes[c],
+           (unsigned long) before.allocations[c], (unsigned long) after.allocations[c]);
+    grew = grew || after.bytes[c] > before.bytes[c] || after.allocations[c] > before.allocations[c];
+  }
+  assert(after.bytes[GUIHCK_MEMORY_SCRATCH] == 0);
+  assert(!grew && "Memory grew in steady state");
+
+  guihckContextFree(ctx);
+
+  return grew ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,94 @@
+#include "guihck.h"
+#include "guihckElements.h"
+#include "softElements.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+static uint32_t pixelAt(guihckSoftTarget* target, int x, int y)
+{
+  int width;
+  uint32_t* pixels = guihckSoftTargetGetPixels(target, &width, NULL);
+  return pixels[y * width + x];
+}
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  guihckInit();
+  guihckContext* ctx = guihckContextNew();
+  guihckElementsAddAllTypes(ctx);
+  guihckSoftAddAllTypes(ctx);
+
+  guihckSoftTarget* target = guihckSoftTargetNew(64, 48);
+  guihckSoftTargetBind(target);
+  assert(guihckSoftGetBoundTarget() == target);
+
+  guihckContextExecuteScript(ctx,
+    "(create-elements!"
+    "  (rectangle (prop 'x 4) (prop 'y 4) (prop 'width 10) (prop 'height 10) (prop 'color '(255 0 0)))"
+    "  (rectangle (prop 'x 8) (prop 'y 8) (prop 'width 10) (prop 'height 10) (prop 'color '(0 0 255 128)))"
+    "  (text (id 't) (prop 'x 0) (prop 'y 24) (prop 'size 16) (prop 'text \"Hi\")))");
+
+  guihckSoftTargetClear(target, GUIHCK_SOFT_RGBA(0, 0, 0, 255));
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+
+  // Opaque fill, the edges are exclusive
+  assert(pixelAt(target, 3, 3) == GUIHCK_SOFT_RGBA(0, 0, 0, 255));
+  assert(pixelAt(target, 4, 4) == GUIHCK_SOFT_RGBA(255, 0, 0, 255));
+  assert(pixelAt(target, 7, 7) == GUIHCK_SOFT_RGBA(255, 0, 0, 255));
+
+  // Half transparent blue over red and over black
+  assert(pixelAt(target, 10, 10) == GUIHCK_SOFT_RGBA(127, 0, 128, 255));
+  assert(pixelAt(target, 16, 16) == GUIHCK_SOFT_RGBA(0, 0, 128, 255));
+  assert(pixelAt(target, 18, 18) == GUIHCK_SOFT_RGBA(0, 0, 0, 255));
+
+  // Text sizes itself and draws something inside its box
+  guihckStackPushElementById(ctx, "t");
+  int w = scm_to_double(guihckStackGetElementProperty(ctx, "width"));
+  int h = scm_to_double(guihckStackGetElementProperty(ctx, "height"));
+  guihckStackPopElement(ctx);
+  assert(w > 10 && w < 30);
+  assert(h > 12 && h < 24);
+
+  int lit = 0;
+  int x, y;
+  for(y = 24; y < 24 + h; ++y)
+    for(x = 0; x < w; ++x)
+      lit += pixelAt(target, x, y) != GUIHCK_SOFT_RGBA(0, 0, 0, 255);
+  assert(lit > 20);
+
+  // The retained command list draws the same pixels
+  int width, height;
+  uint32_t* pixels = guihckSoftTargetGetPixels(target, &width, &height);
+  uint32_t* immediate = malloc(width * height * sizeof(uint32_t));
+  memcpy(immediate, pixels, width * height * sizeof(uint32_t));
+
+  guihckContextRetainedRendering(ctx, true);
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  size_t count;
+  const guihckRenderCommand* commands = guihckContextGetRenderCommands(ctx, &count);
+  assert(count == 3);
+  guihckSoftTargetClear(target, GUIHCK_SOFT_RGBA(0, 0, 0, 255));
+  guihckSoftTargetRenderCommands(target, commands, count);
+  assert(memcmp(immediate, pixels, width * height * sizeof(uint32_t)) == 0);
+  free(immediate);
+  guihckContextRetainedRendering(ctx, false);
+
+  // Unbound targets are left alone
+  guihckSoftTargetBind(NULL);
+  guihckSoftTargetClear(target, GUIHCK_SOFT_RGBA(1, 2, 3, 4));
+  guihckContextRender(ctx);
+  assert(pixelAt(target, 10, 10) == GUIHCK_SOFT_RGBA(1, 2, 3, 4));
+
+  guihckSoftTargetFree(target);
+  guihckContextFree(ctx);
+
+  return 0;
+}
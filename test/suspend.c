@@ -0,0 +1,116 @@
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+static bool updateProbe(guihckContext* ctx, guihckElementId id, void* data, guihckPropertyMask changed)
+{
+  (void) ctx;
+  (void) id;
+  (void) changed;
+
+  *((int*) data) += 1;
+  return false;
+}
+
+static guihckElementId findElement(guihckContext* ctx, const char* id)
+{
+  guihckStackPushElementById(ctx, id);
+  guihckElementId elementId = guihckStackGetElement(ctx);
+  guihckStackPopElement(ctx);
+  return elementId;
+}
+
+static int getInt(guihckContext* ctx, guihckElementId id, const char* key)
+{
+  return scm_to_int(guihckElementGetProperty(ctx, id, key));
+}
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  guihckElementTypeFunctionMap probeMap = {NULL, NULL, updateProbe, NULL, NULL, NULL, NULL, NULL};
+
+  guihckInit();
+  guihckContext* ctx = guihckContextNew();
+  guihckElementsAddAllTypes(ctx);
+  guihckElementTypeId probeId = guihckElementTypeAdd(ctx, "probe", probeMap, sizeof(int));
+  guihckElementTypeId itemId = guihckTypeRegistryGetType(guihckContextGetTypes(ctx), "item");
+  guihckElementTypeId timerId = guihckTypeRegistryGetType(guihckContextGetTypes(ctx), "timer");
+
+  // Opted in per type, timers suspend by default
+  assert(guihckTypeRegistryGetSuspendHidden(guihckContextGetTypes(ctx), itemId) == GUIHCK_SUSPEND_NONE);
+  assert(guihckTypeRegistryGetSuspendHidden(guihckContextGetTypes(ctx), timerId) == GUIHCK_SUSPEND_UPDATE);
+  guihckElementTypeSuspendHidden(ctx, probeId, GUIHCK_SUSPEND_UPDATE);
+  guihckElementTypeSuspendHidden(ctx, itemId, GUIHCK_SUSPEND_BINDS);
+
+  guihckElementId root = guihckContextGetRootElement(ctx);
+  guihckElementId page = guihckElementNew(ctx, itemId, root);
+  guihckStackPushElement(ctx, page);
+  guihckContextExecuteScript(ctx,
+    "(create-elements!"
+    "  (item (id 'source) (prop 'value 1))"
+    "  (item (id 'label) (prop 'double (bound '(source value) (lambda (v) (* v 2)))))"
+    "  (timer (id 'clock) (prop 'running #t) (prop 'interval 1) (prop 'repeat -1) (prop 'on-timeout (lambda (c) #f))))");
+  guihckStackPopElement(ctx);
+
+  guihckElementId source = findElement(ctx, "source");
+  guihckElementId label = findElement(ctx, "label");
+  guihckElementId clock = findElement(ctx, "clock");
+  guihckElementId probe = guihckElementNew(ctx, probeId, page);
+  int* probeUpdates = guihckElementGetData(ctx, probe);
+
+  guihckContextTime(ctx, 0);
+  guihckContextUpdate(ctx);
+  assert(*probeUpdates == 1);
+  assert(getInt(ctx, label, "double") == 2);
+
+  // Hiding the page hides everything below it
+  guihckElementVisible(ctx, page, false);
+  assert(!guihckElementGetEffectiveVisible(ctx, page));
+  assert(!guihckElementGetEffectiveVisible(ctx, label));
+  assert(guihckElementGetEffectiveVisible(ctx, root));
+
+  // Nothing runs while hidden
+  guihckElementDirty(ctx, probe);
+  guihckElementProperty(ctx, source, "value", scm_from_int(3));
+  guihckElementProperty(ctx, source, "value", scm_from_int(5));
+  int t;
+  for(t = 1; t <= 10; ++t)
+  {
+    guihckContextTime(ctx, t);
+    guihckContextUpdate(ctx);
+  }
+  assert(*probeUpdates == 1);
+  assert(getInt(ctx, label, "double") == 2);
+  assert(getInt(ctx, clock, "cycle") == 0);
+
+  // New children of hidden elements start hidden
+  guihckElementId late = guihckElementNew(ctx, probeId, page);
+  assert(!guihckElementGetEffectiveVisible(ctx, late));
+
+  // A child hidden on its own stays hidden when the page is shown
+  guihckElementVisible(ctx, late, false);
+
+  // Showing catches up once, binds right away and updates on the next frame
+  guihckElementVisible(ctx, page, true);
+  assert(guihckElementGetEffectiveVisible(ctx, label));
+  assert(!guihckElementGetEffectiveVisible(ctx, late));
+  assert(getInt(ctx, label, "double") == 10);
+
+  guihckContextUpdate(ctx);
+  assert(*probeUpdates == 2);
+  assert(*((int*) guihckElementGetData(ctx, late)) == 0);
+  assert(getInt(ctx, clock, "cycle") == 1);
+  assert(scm_to_double(guihckElementGetProperty(ctx, clock, "next-timeout")) == 11);
+
+  guihckContextUpdate(ctx);
+  assert(getInt(ctx, clock, "cycle") == 1);
+
+  guihckContextFree(ctx);
+
+  return 0;
+}
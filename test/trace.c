@@ -0,0 +1,96 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+
+static char* readFile(const char* path)
+{
+  FILE* file = fopen(path, "r");
+  assert(file);
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  char* contents = calloc(size + 1, 1);
+  size_t read = fread(contents, 1, size, file);
+  assert(read == (size_t) size);
+  (void) read;
+  fclose(file);
+  return contents;
+}
+
+static size_t countOccurrences(const char* haystack, const char* needle)
+{
+  size_t count = 0;
+  const char* current = haystack;
+  while((current = strstr(current, needle)))
+  {
+    ++count;
+    current += strlen(needle);
+  }
+  return count;
+}
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  char path[] = "/tmp/guihck-trace-XXXXXX";
+  int fd = mkstemp(path);
+  assert(fd != -1);
+  close(fd);
+
+  guihckInit();
+  guihckContext* ctx = guihckContextNew();
+  guihckElementsAddAllTypes(ctx);
+
+  // Nothing to dump before tracing has started
+  assert(!guihckContextTraceDump(ctx, path));
+
+  guihckContextTraceStart(ctx, 64);
+  guihckContextExecuteScript(ctx,
+    "(create-elements!"
+    "  (item (id 'a) (prop 'width 1))"
+    "  (item (id 'b) (prop 'width (bound '(a width) (lambda (w) (* w 2))))))");
+  guihckContextExecuteScript(ctx, "(set-prop! (find-element 'a) 'width 2)");
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  guihckContextTraceStop(ctx);
+
+  assert(guihckContextTraceDump(ctx, path));
+  char* contents = readFile(path);
+  assert(strstr(contents, "\"traceEvents\""));
+  assert(strstr(contents, "\"cat\": \"bind\""));
+  assert(strstr(contents, "\"name\": \"width\""));
+  assert(strstr(contents, "\"cat\": \"scheme\""));
+  assert(strstr(contents, "\"name\": \"guihckContextUpdate\""));
+  assert(countOccurrences(contents, "\"ph\": \"B\"") >= countOccurrences(contents, "\"ph\": \"E\""));
+  free(contents);
+
+  // A small ring keeps only the newest events and drops unmatched ends
+  guihckContextTraceStart(ctx, 5);
+  guihckContextExecuteScript(ctx, "(set-prop! (find-element 'a) 'width 3)");
+  guihckContextUpdate(ctx);
+  guihckContextRender(ctx);
+  guihckContextTraceStop(ctx);
+
+  assert(guihckContextTraceDump(ctx, path));
+  contents = readFile(path);
+  assert(strstr(contents, "\"traceEvents\""));
+  size_t begins = countOccurrences(contents, "\"ph\": \"B\"");
+  size_t ends = countOccurrences(contents, "\"ph\": \"E\"");
+  assert(begins + ends <= 5);
+  assert(begins >= ends);
+  free(contents);
+
+  guihckContextFree(ctx);
+  unlink(path);
+
+  return EXIT_SUCCESS;
+}
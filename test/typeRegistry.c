@@ -0,0 +1,75 @@
+#include "guihck.h"
+#include "guihckElements.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+static int fooCount = 0;
+
+static void initFoo(guihckContext* ctx, guihckElementId id, void* data)
+{
+  (void) ctx;
+  (void) id;
+  (void) data;
+
+  fooCount += 1;
+}
+
+int main(int argc, char** argv)
+{
+  (void) argc;
+  (void) argv;
+
+  guihckElementTypeFunctionMap fooMap = {initFoo, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+
+  guihckInit();
+  guihckTypeRegistry* types = guihckTypeRegistryNew();
+  guihckElementsRegisterAllTypes(types);
+  guihckElementTypeId fooId = guihckTypeRegistryAddType(types, "foo", fooMap, sizeof(int));
+  assert(guihckTypeRegistryGetType(types, "foo") == fooId);
+  assert(guihckTypeRegistryGetType(types, "missing") == (guihckElementTypeId) -1);
+
+  guihckContext* ctx1 = guihckContextNewWithTypes(types);
+  guihckContext* ctx2 = guihckContextNewWithTypes(types);
+  guihckTypeRegistryFree(types);
+
+  // Both contexts use the same registry and element constructors
+  assert(guihckContextGetTypes(ctx1) == guihckContextGetTypes(ctx2));
+  assert(scm_is_true(guihckContextExecuteScript(ctx1, "(create-elements! (item (id 'a))) (eq? (get-prop (find-element 'a) 'id) 'a)")));
+  assert(scm_is_true(guihckContextExecuteScript(ctx2, "(create-elements! (item (id 'a))) (eq? (get-prop (find-element 'a) 'id) 'a)")));
+  guihckElementNew(ctx1, fooId, guihckContextGetRootElement(ctx1));
+  guihckElementNew(ctx2, fooId, guihckContextGetRootElement(ctx2));
+  assert(fooCount == 2);
+
+  // Types built in Scheme only do not unshare the registry
+  guihckElementsAddRowType(ctx1);
+  guihckElementsAddColumnType(ctx1);
+  assert(guihckContextGetTypes(ctx1) == guihckContextGetTypes(ctx2));
+
+  // Adding a type copies the registry for that context only, keeping the ids
+  guihckElementTypeId barId = guihckElementTypeAdd(ctx1, "bar", fooMap, 0);
+  guihckTypeRegistry* types1 = guihckContextGetTypes(ctx1);
+  guihckTypeRegistry* types2 = guihckContextGetTypes(ctx2);
+  assert(types1 != types2);
+  assert(guihckTypeRegistryGetType(types1, "bar") == barId);
+  assert(guihckTypeRegistryGetType(types2, "bar") == (guihckElementTypeId) -1);
+  assert(guihckTypeRegistryGetType(types1, "foo") == fooId);
+  assert(guihckTypeRegistryGetType(types1, "item") == guihckTypeRegistryGetType(types2, "item"));
+
+  // Unshared registries are modified in place
+  guihckElementTypeAdd(ctx1, "baz", fooMap, 0);
+  assert(guihckContextGetTypes(ctx1) == types1);
+
+  // The registry outlives the context it was created for
+  types = guihckTypeRegistryRef(types2);
+  guihckContextFree(ctx2);
+  guihckContext* ctx3 = guihckContextNewWithTypes(types);
+  guihckTypeRegistryFree(types);
+  guihckElementNew(ctx3, fooId, guihckContextGetRootElement(ctx3));
+  assert(fooCount == 3);
+
+  guihckContextFree(ctx3);
+  guihckContextFree(ctx1);
+
+  return EXIT_SUCCESS;
+}
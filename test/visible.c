@@ -24,7 +24,7 @@ int main(int argc, char** argv)
   (void) argc;
   (void) argv;
 
-  guihckElementTypeFunctionMap fooMap = {initFoo, NULL, NULL, renderFoo, NULL, NULL};
+  guihckElementTypeFunctionMap fooMap = {initFoo, NULL, NULL, renderFoo, NULL, NULL, NULL, NULL};
 
   guihckInit();
   guihckContext* ctx = guihckContextNew();